@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/conf/environment.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/sig/Image.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using yarp::os::SystemClock;
+using yarp::sig::ImageOf;
+using yarp::sig::PixelBgr;
+using yarp::sig::PixelBgra;
+using yarp::sig::PixelMono;
+using yarp::sig::PixelRgb;
+using yarp::sig::PixelRgba;
+
+// Measures the throughput of the conversions between the pixel types done by
+// Image::copy(), in millions of pixels per second.
+//
+// The conversions are vectorized when the cpu supports it, run with
+// YARP_PIXEL_KERNELS=scalar (or ssse3) to compare with the portable
+// implementation.
+//
+// Usage: copy_pixels [width] [height] [iterations]
+
+namespace {
+
+template <class T1, class T2>
+void run(const char* label, size_t width, size_t height, int iterations, size_t quantum = 8)
+{
+    ImageOf<T1> src;
+    src.resize(width, height);
+    unsigned char* raw = src.getRawImage();
+    for (size_t i = 0; i < src.getRawImageSize(); i++) {
+        raw[i] = static_cast<unsigned char>(i * 7);
+    }
+
+    ImageOf<T2> dest;
+    dest.setQuantum(quantum);
+    dest.resize(width, height);
+    dest.copy(src);
+
+    double start = SystemClock::nowSystem();
+    for (int i = 0; i < iterations; i++) {
+        dest.copy(src);
+    }
+    double elapsed = SystemClock::nowSystem() - start;
+
+    printf("%-24s %10.1f MPix/s\n", label, static_cast<double>(width * height) * iterations / elapsed / 1e6);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    size_t width = (argc > 1) ? std::atoi(argv[1]) : 640;
+    size_t height = (argc > 2) ? std::atoi(argv[2]) : 480;
+    int iterations = (argc > 3) ? std::atoi(argv[3]) : 500;
+
+    std::string kernels = yarp::conf::environment::getEnvironment("YARP_PIXEL_KERNELS");
+    printf("%zux%zu, %d iterations, kernels: %s\n", width, height, iterations, kernels.empty() ? "default" : kernels.c_str());
+
+    run<PixelRgb, PixelBgr>("rgb -> bgr", width, height, iterations);
+    run<PixelBgr, PixelRgb>("bgr -> rgb", width, height, iterations);
+    run<PixelRgba, PixelBgra>("rgba -> bgra", width, height, iterations);
+    run<PixelRgb, PixelRgba>("rgb -> rgba", width, height, iterations);
+    run<PixelBgr, PixelRgba>("bgr -> rgba", width, height, iterations);
+    run<PixelRgba, PixelRgb>("rgba -> rgb", width, height, iterations);
+    run<PixelBgra, PixelRgb>("bgra -> rgb", width, height, iterations);
+    run<PixelRgb, PixelMono>("rgb -> mono", width, height, iterations);
+    run<PixelBgra, PixelMono>("bgra -> mono", width, height, iterations);
+    run<PixelMono, PixelRgb>("mono -> rgb", width, height, iterations);
+    run<PixelMono, PixelBgra>("mono -> bgra", width, height, iterations);
+    run<PixelRgb, PixelRgb>("rgb -> rgb (no padding)", width + 1, height, iterations, 1);
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/SystemClock.h>
+#include <yarp/sig/Image.h>
+#include <yarp/sig/impl/Demosaic.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+using yarp::os::SystemClock;
+using yarp::sig::FlexImage;
+using yarp::sig::ImageOf;
+using yarp::sig::PixelRgb;
+using yarp::sig::impl::BayerPattern;
+using yarp::sig::impl::DemosaicMethod;
+
+// Measures the throughput of the conversion of bayer images to rgb, in
+// millions of pixels and in frames per second, using one thread and all
+// the ones available.
+//
+// Usage: debayer [width] [height] [iterations]
+
+namespace {
+
+void run(const char* label, const FlexImage& src, DemosaicMethod method, size_t threads, int iterations)
+{
+    ImageOf<PixelRgb> dest;
+    yarp::sig::impl::demosaic(src, BayerPattern::GRBG, dest, method, threads);
+
+    double start = SystemClock::nowSystem();
+    for (int i = 0; i < iterations; i++) {
+        yarp::sig::impl::demosaic(src, BayerPattern::GRBG, dest, method, threads);
+    }
+    double elapsed = SystemClock::nowSystem() - start;
+
+    printf("%-36s %10.1f MPix/s %8.1f fps\n",
+           label,
+           static_cast<double>(src.width() * src.height()) * iterations / elapsed / 1e6,
+           iterations / elapsed);
+}
+
+FlexImage makeBayer(int code, size_t width, size_t height)
+{
+    FlexImage img;
+    img.setPixelCode(code);
+    img.resize(width, height);
+    unsigned char* raw = img.getRawImage();
+    for (size_t i = 0; i < img.getRawImageSize(); i++) {
+        raw[i] = static_cast<unsigned char>(i * 7);
+    }
+    return img;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    size_t width = (argc > 1) ? std::atoi(argv[1]) : 3840;
+    size_t height = (argc > 2) ? std::atoi(argv[2]) : 2160;
+    int iterations = (argc > 3) ? std::atoi(argv[3]) : 50;
+
+    printf("%zux%zu, %d iterations, %u hardware threads\n", width, height, iterations, std::thread::hardware_concurrency());
+
+    FlexImage bayer8 = makeBayer(VOCAB_PIXEL_MONO, width, height);
+    FlexImage bayer16 = makeBayer(VOCAB_PIXEL_MONO16, width, height);
+
+    run("bilinear, 8 bit, 1 thread", bayer8, DemosaicMethod::Bilinear, 1, iterations);
+    run("bilinear, 8 bit, all threads", bayer8, DemosaicMethod::Bilinear, 0, iterations);
+    run("edge aware, 8 bit, 1 thread", bayer8, DemosaicMethod::EdgeAware, 1, iterations);
+    run("edge aware, 8 bit, all threads", bayer8, DemosaicMethod::EdgeAware, 0, iterations);
+    run("bilinear, 16 bit, all threads", bayer16, DemosaicMethod::Bilinear, 0, iterations);
+    run("edge aware, 16 bit, all threads", bayer16, DemosaicMethod::EdgeAware, 0, iterations);
+
+    return 0;
+}
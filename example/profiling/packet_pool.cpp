@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/impl/PortCorePackets.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using yarp::os::Bottle;
+using yarp::os::impl::PortCorePacket;
+using yarp::os::impl::PortCorePackets;
+
+// Measures the cost of tracking messages sent by a port to several
+// connections, as done by PortCore::send() and by the output threads that
+// notify the completion of background writes.
+//
+// A sender thread gets a packet, increments its count once per connection,
+// and hands it to one thread per connection, that releases it.
+//
+//  * "locked" reproduces the previous implementation, i.e. std::list of
+//    active/inactive packets protected by the port mutex.
+//  * "lock-free" uses PortCorePackets.
+//
+// Usage: packet_pool [connections] [messages]
+
+namespace {
+
+// The packet tracking as it was done before the lock-free slab
+class LockedPackets
+{
+    std::list<PortCorePacket*> inactive;
+    std::list<PortCorePacket*> active;
+    std::mutex mutex;
+
+public:
+    ~LockedPackets()
+    {
+        for (auto* p : inactive) {
+            delete p;
+        }
+        for (auto* p : active) {
+            delete p;
+        }
+    }
+
+    PortCorePacket* get(const Bottle& content)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (inactive.empty()) {
+            inactive.push_back(new PortCorePacket());
+        }
+        PortCorePacket* next = inactive.front();
+        inactive.remove(next);
+        active.push_back(next);
+        next->setContent(&content);
+        return next;
+    }
+
+    void inc(PortCorePacket* packet)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        packet->inc();
+    }
+
+    void release(PortCorePacket* packet)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        packet->dec();
+        if (packet->getCount() <= 0) {
+            packet->complete();
+            packet->reset();
+            active.remove(packet);
+            inactive.push_back(packet);
+        }
+    }
+};
+
+class LockFreePackets
+{
+    PortCorePackets packets;
+
+public:
+    PortCorePacket* get(const Bottle& content)
+    {
+        PortCorePacket* next = packets.getFreePacket();
+        next->setContent(&content);
+        return next;
+    }
+
+    void inc(PortCorePacket* packet)
+    {
+        packet->inc();
+    }
+
+    void release(PortCorePacket* packet)
+    {
+        packets.releasePacket(packet);
+    }
+};
+
+// Single producer single consumer queue, standing for a connection
+class Connection
+{
+    static constexpr size_t size = 1024;
+    PortCorePacket* ring[size];
+    std::atomic<size_t> head{0};
+    std::atomic<size_t> tail{0};
+
+public:
+    void push(PortCorePacket* packet)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        while (t - head.load(std::memory_order_acquire) == size) {
+            std::this_thread::yield();
+        }
+        ring[t % size] = packet;
+        tail.store(t + 1, std::memory_order_release);
+    }
+
+    PortCorePacket* pop()
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        while (tail.load(std::memory_order_acquire) == h) {
+            std::this_thread::yield();
+        }
+        PortCorePacket* packet = ring[h % size];
+        head.store(h + 1, std::memory_order_release);
+        return packet;
+    }
+};
+
+template <typename Packets>
+double run(int connections, int messages)
+{
+    Packets packets;
+    Bottle content;
+    content.addString("hello");
+    std::vector<Connection> queues(connections);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> outputs;
+    for (int c = 0; c < connections; c++) {
+        outputs.emplace_back([&, c]() {
+            for (int i = 0; i < messages; i++) {
+                packets.release(queues[c].pop());
+            }
+        });
+    }
+    for (int i = 0; i < messages; i++) {
+        PortCorePacket* packet = packets.get(content);
+        for (int c = 0; c < connections; c++) {
+            packets.inc(packet);
+            queues[c].push(packet);
+        }
+        packets.release(packet);
+    }
+    for (auto& t : outputs) {
+        t.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int connections = (argc > 1) ? std::atoi(argv[1]) : 4;
+    int messages = (argc > 2) ? std::atoi(argv[2]) : 1000000;
+
+    printf("%d messages, %d connections\n", messages, connections);
+    for (int round = 0; round < 3; round++) {
+        double locked = run<LockedPackets>(connections, messages);
+        double lockFree = run<LockFreePackets>(connections, messages);
+        printf("locked:    %8.1f ns/message\n", locked * 1e9 / messages);
+        printf("lock-free: %8.1f ns/message\n", lockFree * 1e9 / messages);
+    }
+    return 0;
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/ConnectionReader.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Port.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/sig/Image.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <dlfcn.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+using yarp::os::Bottle;
+using yarp::os::ConnectionReader;
+using yarp::os::Network;
+using yarp::os::Port;
+using yarp::os::PortReader;
+using yarp::os::PortWriter;
+using yarp::os::SystemClock;
+using yarp::sig::ImageOf;
+using yarp::sig::PixelRgb;
+
+// Counts the system calls used by a port to send a message through a tcp
+// connection.
+//
+// The functions of the C library used to write on a socket are wrapped by
+// this program, and counted while the messages are written, in all the
+// threads (i.e. acknowledgements sent by the reader are included).  Only
+// works on Linux, where the definitions in the executable take precedence
+// over the ones of the C library.
+//
+// Usage: vectored_write [messages] [carrier]
+
+namespace {
+
+std::atomic<bool> counting {false};
+std::atomic<long> writeCalls {0};
+std::atomic<long> optionCalls {0};
+
+void count(std::atomic<long>& counter)
+{
+    if (counting.load(std::memory_order_relaxed)) {
+        counter++;
+    }
+}
+
+template <typename F>
+F next(const char* name)
+{
+    return reinterpret_cast<F>(dlsym(RTLD_NEXT, name));
+}
+
+} // namespace
+
+extern "C" {
+
+ssize_t send(int fd, const void* buf, size_t len, int flags)
+{
+    static auto real = next<ssize_t (*)(int, const void*, size_t, int)>("send");
+    count(writeCalls);
+    return real(fd, buf, len, flags);
+}
+
+ssize_t sendto(int fd, const void* buf, size_t len, int flags, const struct sockaddr* addr, socklen_t addrlen)
+{
+    static auto real = next<ssize_t (*)(int, const void*, size_t, int, const struct sockaddr*, socklen_t)>("sendto");
+    count(writeCalls);
+    return real(fd, buf, len, flags, addr, addrlen);
+}
+
+ssize_t sendmsg(int fd, const struct msghdr* msg, int flags)
+{
+    static auto real = next<ssize_t (*)(int, const struct msghdr*, int)>("sendmsg");
+    count(writeCalls);
+    return real(fd, msg, flags);
+}
+
+ssize_t writev(int fd, const struct iovec* iov, int iovcnt)
+{
+    static auto real = next<ssize_t (*)(int, const struct iovec*, int)>("writev");
+    count(writeCalls);
+    return real(fd, iov, iovcnt);
+}
+
+int setsockopt(int fd, int level, int name, const void* value, socklen_t len)
+{
+    static auto real = next<int (*)(int, int, int, const void*, socklen_t)>("setsockopt");
+    count(optionCalls);
+    return real(fd, level, name, value, len);
+}
+
+int getsockopt(int fd, int level, int name, void* value, socklen_t* len)
+{
+    static auto real = next<int (*)(int, int, int, void*, socklen_t*)>("getsockopt");
+    count(optionCalls);
+    return real(fd, level, name, value, len);
+}
+
+} // extern "C"
+
+namespace {
+
+// Reads and discards the messages
+class Sink : public PortReader
+{
+    std::vector<char> buffer;
+
+public:
+    bool read(ConnectionReader& connection) override
+    {
+        buffer.resize(connection.getSize());
+        return connection.expectBlock(buffer.data(), buffer.size());
+    }
+};
+
+void run(const char* label, Port& out, const PortWriter& message, int messages)
+{
+    writeCalls = 0;
+    optionCalls = 0;
+    counting = true;
+    double start = SystemClock::nowSystem();
+    for (int i = 0; i < messages; i++) {
+        out.write(message);
+    }
+    double elapsed = SystemClock::nowSystem() - start;
+    counting = false;
+
+    printf("%-24s %8.2f writes %8.2f socket options %10.2f us per message\n",
+           label,
+           static_cast<double>(writeCalls) / messages,
+           static_cast<double>(optionCalls) / messages,
+           elapsed * 1e6 / messages);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int messages = (argc > 1) ? std::atoi(argv[1]) : 2000;
+    const char* carrier = (argc > 2) ? argv[2] : "fast_tcp";
+
+    Network yarp;
+    Network::setLocalMode(true);
+
+    Port out;
+    Port in;
+    Sink sink;
+    in.setReader(sink);
+    if (!out.open("/vectored_write/out") || !in.open("/vectored_write/in")) {
+        return 1;
+    }
+    if (!Network::connect(out.getName(), in.getName(), carrier)) {
+        return 1;
+    }
+    printf("%d messages over %s\n", messages, carrier);
+
+    Bottle small;
+    small.addInt32(42);
+    small.addString("hello");
+    small.addFloat64(3.14);
+    run("bottle", out, small, messages);
+
+    Bottle list;
+    for (int i = 0; i < 100; i++) {
+        list.addList().addString("element");
+    }
+    run("nested bottle", out, list, messages);
+
+    ImageOf<PixelRgb> image;
+    image.resize(640, 480);
+    image.zero();
+    run("640x480 rgb image", out, image, messages / 10);
+
+    out.close();
+    in.close();
+    return 0;
+}
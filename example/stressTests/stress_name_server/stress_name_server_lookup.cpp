@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/all.h>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace yarp::os;
+
+// Sends the "query" command straight to the name server, bypassing any
+// client side cache, so that the rate measured is the one of the server.
+static bool query(const std::string& name)
+{
+    Bottle cmd;
+    Bottle reply;
+    cmd.addString("query");
+    cmd.addString(name);
+    ContactStyle style;
+    style.quiet = true;
+    return NetworkBase::writeToNameServer(cmd, reply, style) && reply.size() > 0;
+}
+
+static std::string portName(int i)
+{
+    char buf[256];
+    sprintf(buf, "/stress/lookup/%06d", i);
+    return buf;
+}
+
+int main(int argc, char *argv[]) {
+    Network yarp;
+
+    Property options;
+    options.fromCommand(argc, argv);
+    int ports = options.check("ports", Value(500)).asInt32();
+    int rounds = options.check("rounds", Value(20)).asInt32();
+    int threads = options.check("threads", Value(4)).asInt32();
+
+    double start = SystemClock::nowSystem();
+    for (int i=0; i<ports; i++) {
+        yarp.registerName(portName(i));
+    }
+    double registered = SystemClock::nowSystem();
+    printf("%d registrations in %.3f s: %.0f registrations/s\n",
+           ports, registered - start, ports / (registered - start));
+
+    std::vector<std::thread> clients;
+    std::vector<int> failures(threads, 0);
+    start = SystemClock::nowSystem();
+    for (int t=0; t<threads; t++) {
+        clients.emplace_back([=, &failures]() {
+            for (int r=0; r<rounds; r++) {
+                for (int i=t; i<ports; i+=threads) {
+                    if (!query(portName(i))) {
+                        failures[t]++;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    double looked = SystemClock::nowSystem();
+    int failed = 0;
+    for (int f : failures) {
+        failed += f;
+    }
+    int lookups = ports * rounds;
+    printf("%d lookups from %d threads in %.3f s: %.0f lookups/s (%d failed)\n",
+           lookups, threads, looked - start, lookups / (looked - start), failed);
+
+    for (int i=0; i<ports; i++) {
+        yarp.unregisterName(portName(i));
+    }
+
+    return (failed == 0) ? 0 : 1;
+}
@@ -11,6 +11,7 @@
 #include <yarp/os/LogComponent.h>
 #include <yarp/os/Route.h>
 #include <yarp/sig/ImageDraw.h>
+#include <algorithm>
 #include <cstring>
 #include <cstdlib>
 
@@ -24,6 +25,8 @@ extern "C" {
 
 using namespace yarp::os;
 using namespace yarp::sig;
+using yarp::sig::impl::BayerPattern;
+using yarp::sig::impl::DemosaicMethod;
 
 namespace {
 YARP_LOG_COMPONENT(BAYERCARRIER,
@@ -143,6 +146,11 @@ yarp::os::ConnectionReader& BayerCarrier::modifyIncomingData(yarp::os::Connectio
             }
         }
 
+        threads = 0;
+        if (config.check("threads")) {
+            threads = static_cast<size_t>(std::max(0, config.find("threads").asInt32()));
+        }
+
         setFormat(config.check("order",Value("grbg")).asString().c_str());
         header_in.setFromImage(in);
         yCTrace(BAYERCARRIER, "Need reset.");
@@ -159,50 +167,17 @@ yarp::os::ConnectionReader& BayerCarrier::modifyIncomingData(yarp::os::Connectio
 
 bool BayerCarrier::debayerHalf(yarp::sig::ImageOf<PixelMono>& src,
                                yarp::sig::ImageOf<PixelRgb>& dest) {
-    // dc1394 doesn't seem safe for arbitrary data widths
-    if (src.width()%8==0) {
-        dc1394video_frame_t dc_src;
-        dc1394video_frame_t dc_dest;
-        setDcImage(src,&dc_src,dcformat);
-        setDcImage(dest,&dc_dest,dcformat);
-        dc1394_debayer_frames(&dc_src,&dc_dest,DC1394_BAYER_METHOD_DOWNSAMPLE);
-        return true;
-    }
-
-    if (bayer_method_set) {
-        yCWarning/*Once*/(BAYERCARRIER, "Not using dc1394 debayer methods (image width not a multiple of 8)");
-    }
-
-    // a safer implementation that doesn't use dc1394
-    int w = src.width();
-    int h = src.height();
-    int wo = dest.width();
-    int ho = dest.height();
-    int goff1 = 1-goff;
-    int roffx = roff?goff:goff1;
-    int boff = 1-roff;
-    int boffx = boff?goff:goff1;
-    for (int yo=0; yo<ho; yo++) {
-        for (int xo=0; xo<wo; xo++) {
-            PixelRgb& po = dest.pixel(xo,yo);
-            int x = xo*2;
-            int y = yo*2;
-            if (x+1>=w-1 || y+1>=h-1) {
-                po = PixelRgb{0,0,0};
-                continue;
-            }
-            po.r = src.pixel(x+roffx,y+roff);
-            po.b = src.pixel(x+boffx,y+boff);
-            po.g = (PixelMono)(0.5*(src.pixel(x+goff,y)+src.pixel(x+goff1,y+1)));
-        }
-    }
-    return true;
+    // each 2x2 block becomes a pixel, as in the downsample method of dc1394
+    return yarp::sig::impl::demosaicHalf(src, pattern, dest, threads);
 }
 
 bool BayerCarrier::debayerFull(yarp::sig::ImageOf<PixelMono>& src,
                                yarp::sig::ImageOf<PixelRgb>& dest) {
-    // dc1394 doesn't seem safe for arbitrary data widths
-    if (src.width()%8==0) {
+    // bilinear and edgesense are done by YARP_sig, in parallel, the other
+    // methods by dc1394, that doesn't seem safe for arbitrary data widths
+    bool dc1394_method = (bayer_method != DC1394_BAYER_METHOD_BILINEAR &&
+                          bayer_method != DC1394_BAYER_METHOD_EDGESENSE);
+    if (dc1394_method && src.width()%8==0) {
         dc1394video_frame_t dc_src;
         dc1394video_frame_t dc_dest;
         setDcImage(src,&dc_src,dcformat);
@@ -212,91 +187,11 @@ bool BayerCarrier::debayerFull(yarp::sig::ImageOf<PixelMono>& src,
         return true;
     }
 
-    if (bayer_method_set) {
+    if (dc1394_method) {
         yCWarning/*Once*/(BAYERCARRIER, "Not using dc1394 debayer methods (image width not a multiple of 8)");
     }
-    int w = dest.width();
-    int h = dest.height();
-    int goff1 = 1-goff;
-    int roffx = roff?goff:goff1;
-    int boff = 1-roff;
-    int boffx = boff?goff:goff1;
-    for (int y=0; y<h; y++) {
-        for (int x=0; x<w; x++) {
-            PixelRgb& po = dest.pixel(x,y);
-
-            // G
-            if ((x+y)%2==goff) {
-                po.g = src.pixel(x,y);
-            } else {
-                float g = 0;
-                int ct = 0;
-                if (x>0) { g += src.pixel(x-1,y); ct++; }
-                if (x<w-1) { g += src.pixel(x+1,y); ct++; }
-                if (y>0) { g += src.pixel(x,y-1); ct++; }
-                if (y<h-1) { g += src.pixel(x,y+1); ct++; }
-                if (ct>0) g /= ct;
-                po.g = (int)g;
-            }
-
-            // B
-            if (y%2==boff && x%2==boffx) {
-                po.b = src.pixel(x,y);
-            } else if (y%2==boff) {
-                float b = 0;
-                int ct = 0;
-                if (x>0) { b += src.pixel(x-1,y); ct++; }
-                if (x<w-1) { b += src.pixel(x+1,y); ct++; }
-                if (ct>0) b /= ct;
-                po.b = (int)b;
-            } else if (x%2==boffx) {
-                float b = 0;
-                int ct = 0;
-                if (y>0) { b += src.pixel(x,y-1); ct++; }
-                if (y<h-1) { b += src.pixel(x,y+1); ct++; }
-                if (ct>0) b /= ct;
-                po.b = (int)b;
-            } else {
-                float b = 0;
-                int ct = 0;
-                if (x>0&&y>0) { b += src.pixel(x-1,y-1); ct++; }
-                if (x>0&&y<h-1) { b += src.pixel(x-1,y+1); ct++; }
-                if (x<w-1&&y>0) { b += src.pixel(x+1,y-1); ct++; }
-                if (x<w-1&&y<h-1) { b += src.pixel(x+1,y+1); ct++; }
-                if (ct>0) b /= ct;
-                po.b = (int)b;
-            }
-
-            // R
-            if (y%2==roff && x%2==roffx) {
-                po.r = src.pixel(x,y);
-            } else if (y%2==roff) {
-                float r = 0;
-                int ct = 0;
-                if (x>0) { r += src.pixel(x-1,y); ct++; }
-                if (x<w-1) { r += src.pixel(x+1,y); ct++; }
-                if (ct>0) r /= ct;
-                po.r = (int)r;
-            } else if (x%2==roffx) {
-                float r = 0;
-                int ct = 0;
-                if (y>0) { r += src.pixel(x,y-1); ct++; }
-                if (y<h-1) { r += src.pixel(x,y+1); ct++; }
-                if (ct>0) r /= ct;
-                po.r = (int)r;
-            } else {
-                float r = 0;
-                int ct = 0;
-                if (x>0&&y>0) { r += src.pixel(x-1,y-1); ct++; }
-                if (x>0&&y<h-1) { r += src.pixel(x-1,y+1); ct++; }
-                if (x<w-1&&y>0) { r += src.pixel(x+1,y-1); ct++; }
-                if (x<w-1&&y<h-1) { r += src.pixel(x+1,y+1); ct++; }
-                if (ct>0) r /= ct;
-                po.r = (int)r;
-            }
-        }
-    }
-    return true;
+    DemosaicMethod method = (bayer_method == DC1394_BAYER_METHOD_EDGESENSE) ? DemosaicMethod::EdgeAware : DemosaicMethod::Bilinear;
+    return yarp::sig::impl::demosaic(src, pattern, dest, method, threads);
 }
 
 bool BayerCarrier::processBuffered() const {
@@ -379,12 +274,16 @@ bool BayerCarrier::setFormat(const char *fmt) {
     roff = (f[0]=='r'||f[0]=='R'||f[1]=='r'||f[1]=='R')?0:1;
     if (goff==0&&roff==0) {
         dcformat = DC1394_COLOR_FILTER_GRBG;
+        pattern = BayerPattern::GRBG;
     } else if (goff==0&&roff==1) {
         dcformat = DC1394_COLOR_FILTER_GBRG;
+        pattern = BayerPattern::GBRG;
     } else if (goff==1&&roff==0) {
         dcformat = DC1394_COLOR_FILTER_RGGB;
+        pattern = BayerPattern::RGGB;
     } else if (goff==1&&roff==1) {
         dcformat = DC1394_COLOR_FILTER_BGGR;
+        pattern = BayerPattern::BGGR;
     }
     return true;
 }
@@ -13,6 +13,7 @@
 #include <yarp/os/ConnectionReader.h>
 #include <yarp/sig/Image.h>
 #include <yarp/sig/ImageNetworkHeader.h>
+#include <yarp/sig/impl/Demosaic.h>
 #include <yarp/os/DummyConnector.h>
 
 /**
@@ -47,11 +48,13 @@ private:
     bool bayer_method_set;
 
     int bayer_method;
+    size_t threads; // threads used by the conversions of YARP_sig (0 = all)
 
     // format offsets
     int goff; // x offset to green on even rows
     int roff; // y offset to red on even columns
     int dcformat;
+    yarp::sig::impl::BayerPattern pattern;
 
     bool setFormat(const char *fmt);
 public:
@@ -71,9 +74,11 @@ public:
         half(false),
         bayer_method_set(false),
         bayer_method(-1),
+        threads(0),
         goff(0),
         roff(1),
-        dcformat(-1)
+        dcformat(-1),
+        pattern(yarp::sig::impl::BayerPattern::GRBG)
     {}
 
     ~BayerCarrier() {
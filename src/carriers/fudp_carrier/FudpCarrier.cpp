@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "FudpCarrier.h"
+#include "FudpLogComponent.h"
+
+#include <yarp/os/ConnectionState.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/Value.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace yarp::os;
+
+namespace {
+
+// sendmmsg() and recvmmsg() take at most UIO_MAXIOV messages
+constexpr int maxBatch = 1024;
+
+// Sets the size of the system buffer of the socket, that should hold at
+// least a whole message.
+void setBufferSize(int fd, int option, int size)
+{
+    int actual = -1;
+    socklen_t len = sizeof(actual);
+    int setResult = ::setsockopt(fd, SOL_SOCKET, option, &size, sizeof(size));
+    int getResult = ::getsockopt(fd, SOL_SOCKET, option, &actual, &len);
+    // in linux the value returned by getsockopt is "doubled"
+    // (see https://linux.die.net/man/7/socket)
+    actual /= 2;
+    if (setResult < 0 || getResult < 0 || actual < size) {
+        yCWarning(FUDP_CARRIER,
+                  "Failed to set the %s socket buffer to %d bytes (actual: %d), messages may be dropped under heavy load. "
+                  "To change the limit: sysctl -w net.core.%s=%d",
+                  (option == SO_RCVBUF) ? "RECV" : "SND",
+                  size,
+                  actual,
+                  (option == SO_RCVBUF) ? "rmem_max" : "wmem_max",
+                  size);
+    }
+}
+
+} // namespace
+
+yarp::os::Carrier* FudpCarrier::create() const
+{
+    return new FudpCarrier();
+}
+
+std::string FudpCarrier::getName() const
+{
+    return name;
+}
+
+bool FudpCarrier::requireAck() const
+{
+    return false;
+}
+
+bool FudpCarrier::isConnectionless() const
+{
+    return true;
+}
+
+bool FudpCarrier::supportReply() const
+{
+    return false;
+}
+
+bool FudpCarrier::checkHeader(const Bytes& header)
+{
+    if (header.length() != headerSize) {
+        return false;
+    }
+    for (size_t i = 0; i < headerSize; i++) {
+        if (header.get()[i] != headerCode[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FudpCarrier::getHeader(Bytes& header) const
+{
+    for (size_t i = 0; i < headerSize && i < header.length(); i++) {
+        header.get()[i] = headerCode[i];
+    }
+}
+
+void FudpCarrier::setParameters(const Bytes& header)
+{
+    YARP_UNUSED(header);
+}
+
+bool FudpCarrier::configure(ConnectionState& proto)
+{
+    Property options;
+    options.fromString(proto.getSenderSpecifier());
+    return configureFromProperty(options);
+}
+
+bool FudpCarrier::configureFromProperty(Property& options)
+{
+    const FudpStream::Config defaults;
+    int fragmentSize = options.check("fragment_size", Value(static_cast<int>(defaults.fragmentSize))).asInt32();
+    int fec = options.check("fec", Value(static_cast<int>(defaults.fecGroup))).asInt32();
+    int batch = options.check("batch", Value(static_cast<int>(defaults.batch))).asInt32();
+    int buffer = options.check("buffer", Value(defaults.bufferSize)).asInt32();
+    int drop = options.check("drop", Value(static_cast<int>(defaults.dropEvery))).asInt32();
+    if (fragmentSize <= 0 || static_cast<size_t>(fragmentSize) > fudpMaxFragmentSize) {
+        yCError(FUDP_CARRIER, "Invalid fragment_size %d, it must be between 1 and %zu", fragmentSize, fudpMaxFragmentSize);
+        return false;
+    }
+    if (fec < 0 || fec > 255) {
+        yCError(FUDP_CARRIER, "Invalid fec %d, it must be between 0 (disabled) and 255", fec);
+        return false;
+    }
+    if (batch <= 0 || batch > maxBatch) {
+        yCError(FUDP_CARRIER, "Invalid batch %d, it must be between 1 and %d", batch, maxBatch);
+        return false;
+    }
+    if (buffer <= 0 || drop < 0 || drop == 1) {
+        yCError(FUDP_CARRIER, "Invalid buffer %d or drop %d", buffer, drop);
+        return false;
+    }
+    // A message is at most fudpMaxFragments datagrams
+    const std::int64_t maxSizeLimit = static_cast<std::int64_t>(fudpMaxFragments) * fragmentSize;
+    const std::int64_t maxSizeDefault = std::min(static_cast<std::int64_t>(defaults.maxMessageSize), maxSizeLimit);
+    const Value& maxSizeValue = options.find("max_size");
+    const std::int64_t maxSize = maxSizeValue.isNull() ? maxSizeDefault : maxSizeValue.asInt64();
+    if (maxSize <= 0 || maxSize > maxSizeLimit) {
+        yCError(FUDP_CARRIER, "Invalid max_size %s, it must be between 1 and %s", std::to_string(maxSize).c_str(), std::to_string(maxSizeLimit).c_str());
+        return false;
+    }
+    config.fragmentSize = static_cast<size_t>(fragmentSize);
+    config.fecGroup = static_cast<size_t>(fec);
+    config.batch = static_cast<size_t>(batch);
+    config.bufferSize = buffer;
+    config.dropEvery = static_cast<size_t>(drop);
+    config.maxMessageSize = static_cast<size_t>(maxSize);
+    return true;
+}
+
+bool FudpCarrier::respondToHeader(ConnectionState& proto)
+{
+    // I am the receiver
+    sender = false;
+
+    int fd = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (fd < 0) {
+        yCError(FUDP_CARRIER, "Could not create the socket: %s", strerror(errno));
+        return false;
+    }
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) < 0) {
+        yCError(FUDP_CARRIER, "Could not bind the socket: %s", strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    setBufferSize(fd, SO_RCVBUF, config.bufferSize);
+
+    // The receiver tells its port, the sender the size of its datagrams
+    const int port = ntohs(addr.sin_port);
+    writeYarpInt(port, proto);
+    proto.os().flush();
+    int fragmentSize = readYarpInt(proto);
+    if (fragmentSize <= 0 || static_cast<size_t>(fragmentSize) > fudpMaxFragmentSize) {
+        yCError(FUDP_CARRIER, "Invalid fragment size %d", fragmentSize);
+        ::close(fd);
+        return false;
+    }
+    config.fragmentSize = static_cast<size_t>(fragmentSize);
+    config.maxMessageSize = std::min(config.maxMessageSize, fudpMaxFragments * config.fragmentSize);
+
+    return becomeFudp(proto, fd);
+}
+
+bool FudpCarrier::expectReplyToHeader(ConnectionState& proto)
+{
+    // I am the sender
+    sender = true;
+
+    int port = readYarpInt(proto);
+    if (port <= 0) {
+        return false;
+    }
+    const std::string host = proto.getStreams().getRemoteAddress().getHost();
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* res = nullptr;
+    if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0 || res == nullptr) {
+        yCError(FUDP_CARRIER, "Could not resolve %s", host.c_str());
+        return false;
+    }
+    int fd = ::socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (fd < 0 || ::connect(fd, res->ai_addr, res->ai_addrlen) < 0) {
+        yCError(FUDP_CARRIER, "Could not connect to %s:%d: %s", host.c_str(), port, strerror(errno));
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        ::freeaddrinfo(res);
+        return false;
+    }
+    ::freeaddrinfo(res);
+    setBufferSize(fd, SO_SNDBUF, config.bufferSize);
+
+    writeYarpInt(static_cast<int>(config.fragmentSize), proto);
+    proto.os().flush();
+
+    return becomeFudp(proto, fd);
+}
+
+bool FudpCarrier::becomeFudp(ConnectionState& proto, int fd)
+{
+    if (!proto.os().isOk()) {
+        ::close(fd);
+        return false;
+    }
+
+    Contact remote = proto.getStreams().getRemoteAddress();
+    Contact local = proto.getStreams().getLocalAddress();
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    if (::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) == 0) {
+        local.setPort(ntohs(addr.sin_port));
+    }
+
+    proto.takeStreams(nullptr); // free up port from tcp
+
+    stream = new FudpStream(fd, sender, config);
+    stream->setLocalAddress(local);
+    stream->setRemoteAddress(remote);
+    proto.takeStreams(stream);
+
+    yCDebug(FUDP_CARRIER, "Connected as %s from %s to %s, fragments of %zu bytes",
+            (sender ? "sender" : "receiver"),
+            local.toURI().c_str(),
+            remote.toURI().c_str(),
+            config.fragmentSize);
+    return true;
+}
+
+bool FudpCarrier::write(ConnectionState& proto, SizedWriter& writer)
+{
+    YARP_UNUSED(proto);
+    if (stream == nullptr) {
+        return false;
+    }
+    return stream->writeMessage(writer);
+}
+
+bool FudpCarrier::expectIndex(ConnectionState& proto)
+{
+    if (stream == nullptr) {
+        return false;
+    }
+    yarp::conf::ssize_t len = stream->beginMessage();
+    if (len < 0) {
+        return false;
+    }
+    proto.setRemainingLength(static_cast<int>(len));
+    return true;
+}
+
+void FudpCarrier::getCarrierParams(Property& params) const
+{
+    params.put("fragment_size", static_cast<int>(config.fragmentSize));
+    if (stream == nullptr) {
+        return;
+    }
+    const FudpStream::Statistics stats = stream->getStatistics();
+    if (sender) {
+        params.put("fec", static_cast<int>(config.fecGroup));
+        params.put("packets_sent", Value::makeInt64(static_cast<std::int64_t>(stats.packetsSent)));
+        params.put("parity_sent", Value::makeInt64(static_cast<std::int64_t>(stats.paritySent)));
+        params.put("messages_sent", Value::makeInt64(static_cast<std::int64_t>(stats.messagesSent)));
+        return;
+    }
+    const FudpReassembler::Statistics& r = stats.received;
+    const std::uint64_t expected = r.packetsReceived + r.packetsLost;
+    params.put("packets_received", Value::makeInt64(static_cast<std::int64_t>(r.packetsReceived)));
+    params.put("packets_lost", Value::makeInt64(static_cast<std::int64_t>(r.packetsLost)));
+    params.put("loss_rate", (expected > 0) ? static_cast<double>(r.packetsLost) / expected : 0.0);
+    params.put("fragments_recovered", Value::makeInt64(static_cast<std::int64_t>(r.fragmentsRecovered)));
+    params.put("messages_received", Value::makeInt64(static_cast<std::int64_t>(r.messagesReceived)));
+    params.put("messages_dropped", Value::makeInt64(static_cast<std::int64_t>(r.messagesDropped)));
+    params.put("packets_rejected", Value::makeInt64(static_cast<std::int64_t>(r.packetsRejected)));
+    params.put("latency_mean", r.latencyMean);
+    params.put("latency_max", r.latencyMax);
+    params.put("reassembly_mean", r.reassemblyMean);
+    params.put("reassembly_max", r.reassemblyMax);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_FUDP_FUDPCARRIER_H
+#define YARP_FUDP_FUDPCARRIER_H
+
+#include <yarp/os/AbstractCarrier.h>
+
+#include "FudpStream.h"
+
+/**
+ * Communicating between two ports via UDP, with messages of any size.
+ *
+ * Messages are split in datagrams that fit in the network MTU, sent and
+ * received in batches, and reassembled by the receiver.  A message with a
+ * lost datagram is dropped without delaying the following ones, unless
+ * the datagram can be rebuilt from the optional parity datagrams, e.g.
+ * "fudp+fec.8" sends one parity datagram every 8 datagrams.
+ *
+ * The statistics of the connection (loss, recovered datagrams, latency)
+ * are reported as carrier parameters.  Replies are not supported.
+ */
+class FudpCarrier :
+        public yarp::os::AbstractCarrier
+{
+public:
+    FudpCarrier() = default;
+    FudpCarrier(const FudpCarrier&) = delete;
+    FudpCarrier(FudpCarrier&&) = delete;
+    FudpCarrier& operator=(const FudpCarrier&) = delete;
+    FudpCarrier& operator=(FudpCarrier&&) = delete;
+
+    ~FudpCarrier() override = default;
+
+    yarp::os::Carrier* create() const override;
+
+    std::string getName() const override;
+
+    bool requireAck() const override;
+    bool isConnectionless() const override;
+    bool supportReply() const override;
+
+    bool checkHeader(const yarp::os::Bytes& header) override;
+    void getHeader(yarp::os::Bytes& header) const override;
+    void setParameters(const yarp::os::Bytes& header) override;
+
+    // The sender reads the parameters from the connection string
+    bool configure(yarp::os::ConnectionState& proto) override;
+    bool configureFromProperty(yarp::os::Property& options) override;
+
+    bool respondToHeader(yarp::os::ConnectionState& proto) override;
+    bool expectReplyToHeader(yarp::os::ConnectionState& proto) override;
+
+    bool write(yarp::os::ConnectionState& proto, yarp::os::SizedWriter& writer) override;
+    bool expectIndex(yarp::os::ConnectionState& proto) override;
+
+    void getCarrierParams(yarp::os::Property& params) const override;
+
+private:
+    static constexpr const char* name = "fudp";
+    static constexpr const char* headerCode = "FRAG_UDP";
+    static constexpr size_t headerSize = 8;
+
+    FudpStream::Config config;
+    FudpStream* stream {nullptr};
+    bool sender {false};
+
+    bool becomeFudp(yarp::os::ConnectionState& proto, int fd);
+};
+
+#endif // YARP_FUDP_FUDPCARRIER_H
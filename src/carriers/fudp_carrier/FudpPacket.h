@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_FUDP_FUDPPACKET_H
+#define YARP_FUDP_FUDPPACKET_H
+
+#include <yarp/conf/system.h>
+#include <yarp/os/NetFloat64.h>
+#include <yarp/os/NetUint16.h>
+#include <yarp/os/NetUint32.h>
+#include <yarp/os/NetUint8.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Header of the datagrams of a fudp connection.
+ *
+ * A message is split in fragments of fragmentSize bytes (the last one can
+ * be shorter).  When FEC is enabled, each group of fecGroup consecutive
+ * fragments is followed by a parity datagram, the xor of the fragments of
+ * the group, that allows the receiver to rebuild one lost fragment of the
+ * group.
+ */
+YARP_BEGIN_PACK
+struct FudpHeader
+{
+    yarp::os::NetUint32 magic;
+    yarp::os::NetUint32 packet;        ///< Counter of the datagrams of the connection
+    yarp::os::NetUint32 message;       ///< Counter of the messages of the connection
+    yarp::os::NetUint32 messageLength;
+    yarp::os::NetFloat64 sendTime;     ///< System time of the sender when the message was sent
+    yarp::os::NetUint16 fragment;      ///< Index of the fragment, or of the group for the parity
+    yarp::os::NetUint16 fragments;     ///< Number of data fragments of the message
+    yarp::os::NetUint16 fragmentSize;
+    yarp::os::NetUint8 flags;
+    yarp::os::NetUint8 fecGroup;       ///< Fragments per parity datagram, 0 without FEC
+};
+YARP_END_PACK
+
+static_assert(sizeof(FudpHeader) == 32, "Unexpected size of FudpHeader");
+
+constexpr std::uint32_t fudpMagic = 0x50445546; // "FUDP"
+constexpr std::uint8_t fudpFlagParity = 0x01;
+
+constexpr size_t fudpMaxDatagram = 65507;
+constexpr size_t fudpMaxFragmentSize = fudpMaxDatagram - sizeof(FudpHeader);
+constexpr size_t fudpMaxFragments = 0xffff;
+
+/**
+ * dst ^= src, for the first len bytes.
+ */
+inline void fudpXor(char* dst, const char* src, size_t len)
+{
+    size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= len; i += sizeof(std::uint64_t)) {
+        std::uint64_t a;
+        std::uint64_t b;
+        std::memcpy(&a, dst + i, sizeof(a));
+        std::memcpy(&b, src + i, sizeof(b));
+        a ^= b;
+        std::memcpy(dst + i, &a, sizeof(a));
+    }
+    for (; i < len; i++) {
+        dst[i] ^= src[i];
+    }
+}
+
+#endif // YARP_FUDP_FUDPPACKET_H
@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "FudpReassembler.h"
+#include "FudpPacket.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Message and packet counters wrap around
+bool before(std::uint32_t a, std::uint32_t b)
+{
+    return static_cast<std::int32_t>(a - b) < 0;
+}
+
+} // namespace
+
+size_t FudpReassembler::Message::fragmentLength(size_t fragment) const
+{
+    const size_t offset = fragment * fragmentSize;
+    return std::min(fragmentSize, length - offset);
+}
+
+FudpReassembler::FudpReassembler(size_t fragmentSize,
+                                 size_t maxMessageSize,
+                                 size_t maxPendingBytes,
+                                 size_t maxPending) :
+        fragmentSize(std::max<size_t>(1, fragmentSize)),
+        maxMessageSize(maxMessageSize),
+        maxFragments(std::min<size_t>(fudpMaxFragments, (maxMessageSize + this->fragmentSize - 1) / this->fragmentSize)),
+        maxPendingBytes(maxPendingBytes),
+        maxPending(std::max<size_t>(1, maxPending))
+{
+    // Room for at least the biggest message, with a parity every datagram
+    this->maxPendingBytes = std::max(this->maxPendingBytes, maxMessageSize + maxFragments * this->fragmentSize);
+    pending.reserve(this->maxPending + 1);
+}
+
+void FudpReassembler::add(const char* datagram, size_t length, double now)
+{
+    if (length < sizeof(FudpHeader)) {
+        return;
+    }
+    FudpHeader header;
+    std::memcpy(&header, datagram, sizeof(header));
+    if (header.magic != fudpMagic) {
+        return;
+    }
+
+    const std::uint32_t packet = header.packet;
+    stats.packetsReceived++;
+    if (!packetsStarted) {
+        packetsStarted = true;
+        firstPacket = packet;
+        lastPacket = packet;
+    } else if (before(lastPacket, packet)) {
+        lastPacket = packet;
+    }
+
+    const std::uint32_t id = header.message;
+    const size_t messageLength = header.messageLength;
+    const size_t fragments = header.fragments;
+    const size_t fecGroup = header.fecGroup;
+    const size_t fragment = header.fragment;
+    const bool isParity = (header.flags & fudpFlagParity) != 0;
+    const char* payload = datagram + sizeof(header);
+    const size_t payloadLength = length - sizeof(header);
+
+    // The datagrams of the connection all have the size agreed in the
+    // handshake, that together with the limit on the message length bounds
+    // also the number of fragments.
+    if (static_cast<size_t>(header.fragmentSize) != fragmentSize || fragments == 0 ||
+        messageLength > maxMessageSize || fragments > maxFragments ||
+        messageLength > fragments * fragmentSize ||
+        (fragments > 1 && messageLength <= (fragments - 1) * fragmentSize) ||
+        (isParity && fecGroup == 0)) {
+        stats.packetsRejected++;
+        return;
+    }
+
+    if (started && !before(lastDone, id)) {
+        // Late datagram of a message already delivered or dropped
+        return;
+    }
+
+    Message* msg = find(id);
+    if (msg == nullptr) {
+        msg = start(id, messageLength, fragments, fecGroup, header.sendTime, now);
+        if (msg == nullptr) {
+            return;
+        }
+    } else if (msg->length != messageLength || msg->fragments != fragments || msg->fecGroup != fecGroup) {
+        stats.packetsRejected++;
+        return;
+    }
+
+    size_t group = 0;
+    if (isParity) {
+        group = fragment;
+        if (group >= msg->parity.size() || payloadLength > fragmentSize || !msg->parity[group].empty()) {
+            return;
+        }
+        msg->parity[group].assign(payload, payload + payloadLength);
+    } else {
+        if (fragment >= fragments || msg->received[fragment] || payloadLength != msg->fragmentLength(fragment)) {
+            return;
+        }
+        if (payloadLength > 0) {
+            std::memcpy(msg->data.data() + fragment * fragmentSize, payload, payloadLength);
+        }
+        msg->received[fragment] = true;
+        msg->receivedCount++;
+        if (fecGroup != 0) {
+            group = fragment / fecGroup;
+        }
+    }
+
+    if (msg->fecGroup != 0 && msg->receivedCount < msg->fragments) {
+        recover(*msg, group);
+    }
+    if (msg->receivedCount == msg->fragments) {
+        complete(*msg, now);
+    }
+}
+
+bool FudpReassembler::next(std::vector<char>& message)
+{
+    if (ready.empty()) {
+        return false;
+    }
+    message.swap(ready.front());
+    if (ready.front().capacity() > 0 && spare.size() < maxPending) {
+        spare.push_back(std::move(ready.front()));
+    }
+    ready.pop_front();
+    return true;
+}
+
+FudpReassembler::Statistics FudpReassembler::getStatistics() const
+{
+    Statistics ret = stats;
+    if (packetsStarted) {
+        const std::uint64_t expected = static_cast<std::uint64_t>(lastPacket - firstPacket) + 1;
+        ret.packetsLost = (expected > stats.packetsReceived) ? expected - stats.packetsReceived : 0;
+    }
+    if (stats.messagesReceived > 0) {
+        ret.latencyMean = latencySum / stats.messagesReceived;
+        ret.reassemblyMean = reassemblySum / stats.messagesReceived;
+    }
+    return ret;
+}
+
+FudpReassembler::Message* FudpReassembler::find(std::uint32_t id)
+{
+    for (auto& msg : pending) {
+        if (msg.id == id) {
+            return &msg;
+        }
+    }
+    return nullptr;
+}
+
+FudpReassembler::Message* FudpReassembler::start(std::uint32_t id,
+                                                 size_t length,
+                                                 size_t fragments,
+                                                 size_t fecGroup,
+                                                 double sendTime,
+                                                 double now)
+{
+    // The parity is allocated when it arrives, but it is reserved here, so
+    // that the datagrams of a message cannot take more than its share
+    const size_t groups = (fecGroup != 0) ? (fragments + fecGroup - 1) / fecGroup : 0;
+    const size_t footprint = length + groups * fragmentSize;
+    if (footprint > maxPendingBytes) {
+        stats.packetsRejected++;
+        return nullptr;
+    }
+
+    while (!pending.empty() && (pending.size() >= maxPending || pendingBytes + footprint > maxPendingBytes)) {
+        const size_t oldest = oldestPending();
+        if (before(id, pending[oldest].id)) {
+            // Even older than the messages being assembled
+            return nullptr;
+        }
+        drop(oldest);
+        stats.messagesDropped++;
+    }
+
+    pending.emplace_back();
+    Message& msg = pending.back();
+    msg.id = id;
+    msg.length = length;
+    msg.fragmentSize = fragmentSize;
+    msg.fragments = fragments;
+    msg.fecGroup = fecGroup;
+    msg.footprint = footprint;
+    msg.sendTime = sendTime;
+    msg.firstArrival = now;
+    if (!spare.empty()) {
+        msg.data.swap(spare.back());
+        spare.pop_back();
+    }
+    msg.data.resize(length);
+    msg.received.assign(fragments, false);
+    msg.parity.resize(groups);
+    pendingBytes += footprint;
+    return &msg;
+}
+
+size_t FudpReassembler::oldestPending() const
+{
+    size_t oldest = 0;
+    for (size_t i = 1; i < pending.size(); i++) {
+        if (before(pending[i].id, pending[oldest].id)) {
+            oldest = i;
+        }
+    }
+    return oldest;
+}
+
+void FudpReassembler::recover(Message& msg, size_t group)
+{
+    const std::vector<char>& parity = msg.parity[group];
+    if (parity.empty()) {
+        return;
+    }
+    const size_t first = group * msg.fecGroup;
+    const size_t last = std::min(first + msg.fecGroup, msg.fragments);
+    size_t missing = last;
+    for (size_t f = first; f < last; f++) {
+        if (!msg.received[f]) {
+            if (missing != last) {
+                // More than one fragment lost, the parity is not enough
+                return;
+            }
+            missing = f;
+        }
+    }
+    if (missing == last) {
+        return;
+    }
+
+    const size_t len = msg.fragmentLength(missing);
+    if (parity.size() < len) {
+        return;
+    }
+    char* dst = msg.data.data() + missing * msg.fragmentSize;
+    std::memcpy(dst, parity.data(), len);
+    for (size_t f = first; f < last; f++) {
+        if (f != missing) {
+            fudpXor(dst, msg.data.data() + f * msg.fragmentSize, std::min(len, msg.fragmentLength(f)));
+        }
+    }
+    msg.received[missing] = true;
+    msg.receivedCount++;
+    stats.fragmentsRecovered++;
+}
+
+void FudpReassembler::complete(Message& msg, double now)
+{
+    const double latency = now - msg.sendTime;
+    const double reassembly = now - msg.firstArrival;
+    stats.messagesReceived++;
+    latencySum += latency;
+    reassemblySum += reassembly;
+    stats.latencyMax = std::max(stats.latencyMax, latency);
+    stats.reassemblyMax = std::max(stats.reassemblyMax, reassembly);
+
+    started = true;
+    lastDone = msg.id;
+    ready.emplace_back();
+    ready.back().swap(msg.data);
+
+    // The older messages still incomplete are not waited for
+    for (size_t i = 0; i < pending.size();) {
+        if (!before(lastDone, pending[i].id)) {
+            if (pending[i].id != lastDone) {
+                stats.messagesDropped++;
+            }
+            drop(i);
+        } else {
+            i++;
+        }
+    }
+}
+
+void FudpReassembler::drop(size_t index)
+{
+    pendingBytes -= pending[index].footprint;
+    if (pending[index].data.capacity() > 0 && spare.size() < maxPending) {
+        spare.push_back(std::move(pending[index].data));
+    }
+    pending.erase(pending.begin() + static_cast<std::ptrdiff_t>(index));
+}
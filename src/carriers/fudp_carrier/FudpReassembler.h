@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_FUDP_FUDPREASSEMBLER_H
+#define YARP_FUDP_FUDPREASSEMBLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/**
+ * Rebuilds the messages of a fudp connection from their datagrams.
+ *
+ * Datagrams can be lost or arrive out of order.  A few messages are
+ * assembled at the same time; when a message is complete, the older ones
+ * that are still incomplete are dropped, so that a lost datagram never
+ * delays the following messages.  Lost fragments are rebuilt from the
+ * parity datagrams, when the sender adds them.
+ *
+ * The datagrams are not authenticated, therefore the headers are checked
+ * against the limits of the connection before allocating anything: the
+ * messages bigger than maxMessageSize are rejected, and the messages being
+ * assembled never take more than maxPendingBytes.
+ */
+class FudpReassembler
+{
+public:
+    struct Statistics
+    {
+        std::uint64_t packetsReceived {0};
+        std::uint64_t packetsRejected {0}; ///< Invalid, or beyond the limits of the connection
+        std::uint64_t packetsLost {0};
+        std::uint64_t fragmentsRecovered {0};
+        std::uint64_t messagesReceived {0};
+        std::uint64_t messagesDropped {0};
+        double latencyMean {0.0};    ///< From the sender to the receiver, needs synchronized clocks
+        double latencyMax {0.0};
+        double reassemblyMean {0.0}; ///< From the first datagram of a message to the last one
+        double reassemblyMax {0.0};
+    };
+
+    /**
+     * @param fragmentSize the size of the datagrams of the connection.
+     * @param maxMessageSize the size of the biggest message accepted.
+     * @param maxPendingBytes the memory that the messages being assembled
+     *        can take, including their parity.
+     * @param maxPending the number of messages assembled at the same time.
+     */
+    FudpReassembler(size_t fragmentSize,
+                    size_t maxMessageSize,
+                    size_t maxPendingBytes,
+                    size_t maxPending = defaultMaxPending);
+
+    /**
+     * Add a datagram received at time now.  Invalid datagrams are ignored.
+     */
+    void add(const char* datagram, size_t length, double now);
+
+    /**
+     * Take the oldest complete message.
+     * @param[in,out] message the message, its previous buffer is reused.
+     * @return false if no message is complete.
+     */
+    bool next(std::vector<char>& message);
+
+    Statistics getStatistics() const;
+
+private:
+    static constexpr size_t defaultMaxPending = 4;
+
+    struct Message
+    {
+        std::uint32_t id {0};
+        size_t length {0};
+        size_t fragmentSize {0};
+        size_t fragments {0};
+        size_t fecGroup {0};
+        size_t receivedCount {0};
+        size_t footprint {0}; ///< Bytes reserved for the data and the parity
+        double sendTime {0.0};
+        double firstArrival {0.0};
+        std::vector<char> data;
+        std::vector<bool> received;
+        std::vector<std::vector<char>> parity;
+
+        size_t fragmentLength(size_t fragment) const;
+    };
+
+    size_t fragmentSize;
+    size_t maxMessageSize;
+    size_t maxFragments;
+    size_t maxPendingBytes;
+    size_t maxPending;
+    size_t pendingBytes {0};
+    std::vector<Message> pending;
+    std::deque<std::vector<char>> ready;
+    std::vector<std::vector<char>> spare;
+
+    bool started {false};
+    std::uint32_t lastDone {0};
+
+    bool packetsStarted {false};
+    std::uint32_t firstPacket {0};
+    std::uint32_t lastPacket {0};
+
+    Statistics stats;
+    double latencySum {0.0};
+    double reassemblySum {0.0};
+
+    Message* find(std::uint32_t id);
+    Message* start(std::uint32_t id, size_t length, size_t fragments, size_t fecGroup, double sendTime, double now);
+    size_t oldestPending() const;
+    void recover(Message& msg, size_t group);
+    void complete(Message& msg, double now);
+    void drop(size_t index);
+};
+
+#endif // YARP_FUDP_FUDPREASSEMBLER_H
@@ -0,0 +1,389 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "FudpStream.h"
+#include "FudpLogComponent.h"
+
+#include <yarp/os/Bytes.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/SystemClock.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <unistd.h>
+
+using namespace yarp::os;
+
+namespace {
+
+// The receiver checks for interruptions at least this often
+constexpr int pollTimeoutMs = 100;
+
+// A fragment scattered in more blocks of the writer than this is copied
+// into a single buffer before being sent.
+constexpr size_t maxGather = 32;
+
+} // namespace
+
+FudpStream::FudpStream(int fd, bool sender, const Config& config) :
+        fd(fd),
+        sender(sender),
+        config(config),
+        // Up to two messages of the biggest size are assembled at once
+        reassembler(config.fragmentSize, config.maxMessageSize, 2 * config.maxMessageSize)
+{
+    this->config.batch = std::max<size_t>(1, config.batch);
+    const size_t batch = this->config.batch;
+    msgs.resize(batch);
+    if (sender) {
+        headers.resize(batch);
+        dropped.resize(batch);
+        scratch.assign(batch, std::vector<char>(config.fragmentSize));
+        parity.assign(config.fragmentSize, 0);
+        iovStart.reserve(batch);
+        iovs.reserve(batch * 2);
+    } else {
+        buffers.assign(batch, std::vector<char>(sizeof(FudpHeader) + config.fragmentSize));
+        iovs.resize(batch);
+        for (size_t i = 0; i < batch; i++) {
+            iovs[i].iov_base = buffers[i].data();
+            iovs[i].iov_len = buffers[i].size();
+            std::memset(&msgs[i], 0, sizeof(mmsghdr));
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+}
+
+FudpStream::~FudpStream()
+{
+    close();
+}
+
+InputStream& FudpStream::getInputStream()
+{
+    return *this;
+}
+
+OutputStream& FudpStream::getOutputStream()
+{
+    return *this;
+}
+
+const Contact& FudpStream::getLocalAddress() const
+{
+    return localAddress;
+}
+
+const Contact& FudpStream::getRemoteAddress() const
+{
+    return remoteAddress;
+}
+
+void FudpStream::setLocalAddress(const Contact& address)
+{
+    localAddress = address;
+}
+
+void FudpStream::setRemoteAddress(const Contact& address)
+{
+    remoteAddress = address;
+}
+
+void FudpStream::interrupt()
+{
+    yCDebug(FUDP_CARRIER, "Interrupting %s", localAddress.toURI().c_str());
+    interrupted = true;
+    happy = false;
+    // Wakes up the receiver, otherwise it notices within pollTimeoutMs
+    ::shutdown(fd, SHUT_RDWR);
+}
+
+void FudpStream::close()
+{
+    if (closed.exchange(true)) {
+        return;
+    }
+    interrupt();
+    if (!sender) {
+        Statistics s = getStatistics();
+        yCDebug(FUDP_CARRIER,
+                "%s: %llu messages received, %llu dropped, %llu datagrams lost, %llu fragments recovered",
+                localAddress.toURI().c_str(),
+                static_cast<unsigned long long>(s.received.messagesReceived),
+                static_cast<unsigned long long>(s.received.messagesDropped),
+                static_cast<unsigned long long>(s.received.packetsLost),
+                static_cast<unsigned long long>(s.received.fragmentsRecovered));
+    }
+    ::close(fd);
+    fd = -1;
+}
+
+yarp::conf::ssize_t FudpStream::read(Bytes& b)
+{
+    if (sender || !happy) {
+        return -1;
+    }
+    const size_t len = std::min(b.length(), message.size() - readAt);
+    if (len == 0 && b.length() != 0) {
+        return -1;
+    }
+    std::memcpy(b.get(), message.data() + readAt, len);
+    readAt += len;
+    return static_cast<yarp::conf::ssize_t>(len);
+}
+
+void FudpStream::write(const Bytes& b)
+{
+    // Messages are written as a whole by writeMessage(), replies are not
+    // supported.
+    YARP_UNUSED(b);
+}
+
+bool FudpStream::isOk() const
+{
+    return happy;
+}
+
+void FudpStream::reset()
+{
+}
+
+void FudpStream::beginPacket()
+{
+}
+
+void FudpStream::endPacket()
+{
+}
+
+bool FudpStream::setTypeOfService(int tos)
+{
+    return ::setsockopt(fd, IPPROTO_IP, IP_TOS, &tos, sizeof(tos)) == 0;
+}
+
+int FudpStream::getTypeOfService()
+{
+    int tos = -1;
+    socklen_t len = sizeof(tos);
+    ::getsockopt(fd, IPPROTO_IP, IP_TOS, &tos, &len);
+    return tos;
+}
+
+void FudpStream::queue(const FudpHeader& header)
+{
+    if (queued == config.batch) {
+        sendQueued();
+    }
+    const size_t slot = queued++;
+    headers[slot] = header;
+    headers[slot].packet = packetCount++;
+    dropped[slot] = (config.dropEvery != 0 && packetCount % config.dropEvery == 0);
+    iovStart.push_back(iovs.size());
+    iovs.push_back({&headers[slot], sizeof(FudpHeader)});
+}
+
+bool FudpStream::sendQueued()
+{
+    size_t count = 0;
+    for (size_t i = 0; i < queued; i++) {
+        if (dropped[i]) {
+            continue;
+        }
+        const size_t end = (i + 1 < queued) ? iovStart[i + 1] : iovs.size();
+        mmsghdr& m = msgs[count++];
+        std::memset(&m, 0, sizeof(mmsghdr));
+        m.msg_hdr.msg_iov = iovs.data() + iovStart[i];
+        m.msg_hdr.msg_iovlen = end - iovStart[i];
+    }
+
+    bool ok = true;
+    size_t sent = 0;
+    while (sent < count) {
+        int r = ::sendmmsg(fd, msgs.data() + sent, static_cast<unsigned int>(count - sent), 0);
+        if (r < 0) {
+            if (errno == EINTR || errno == ECONNREFUSED) {
+                // ECONNREFUSED reports that an earlier datagram was not
+                // received, the receiver is not listening yet.
+                continue;
+            }
+            yCError(FUDP_CARRIER, "Failed to send to %s: %s", remoteAddress.toURI().c_str(), strerror(errno));
+            happy = false;
+            ok = false;
+            break;
+        }
+        sent += static_cast<size_t>(r);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stats.packetsSent += sent;
+    }
+    queued = 0;
+    iovs.clear();
+    iovStart.clear();
+    return ok;
+}
+
+bool FudpStream::writeMessage(const SizedWriter& writer)
+{
+    if (!happy) {
+        return false;
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < writer.length(); i++) {
+        total += writer.length(i);
+    }
+    const size_t fragmentSize = config.fragmentSize;
+    const size_t fragments = std::max<size_t>(1, (total + fragmentSize - 1) / fragmentSize);
+    if (fragments > fudpMaxFragments || total > std::numeric_limits<std::uint32_t>::max()) {
+        // The message is dropped, the connection is kept.
+        yCError(FUDP_CARRIER, "Message of %zu bytes too big for fragments of %zu bytes, dropped", total, fragmentSize);
+        return false;
+    }
+    if (total > config.maxMessageSize) {
+        // The receiver would reject it
+        yCError(FUDP_CARRIER, "Message of %zu bytes bigger than max_size %zu, dropped", total, config.maxMessageSize);
+        return false;
+    }
+
+    const size_t fecGroup = config.fecGroup;
+    FudpHeader header;
+    header.magic = fudpMagic;
+    header.packet = 0;
+    header.message = messageCount++;
+    header.messageLength = static_cast<std::uint32_t>(total);
+    header.sendTime = SystemClock::nowSystem();
+    header.fragments = static_cast<std::uint16_t>(fragments);
+    header.fragmentSize = static_cast<std::uint16_t>(fragmentSize);
+    header.fecGroup = static_cast<std::uint8_t>(fecGroup);
+
+    size_t block = 0;
+    size_t blockOffset = 0;
+    size_t paritySent = 0;
+    for (size_t f = 0; f < fragments; f++) {
+        const size_t len = std::min(fragmentSize, total - f * fragmentSize);
+        header.fragment = static_cast<std::uint16_t>(f);
+        header.flags = 0;
+        queue(header);
+        const size_t slot = queued - 1;
+
+        // The datagram points to the blocks of the writer
+        const size_t first = iovs.size();
+        size_t pos = 0;
+        while (pos < len) {
+            const size_t avail = writer.length(block) - blockOffset;
+            if (avail == 0) {
+                block++;
+                blockOffset = 0;
+                continue;
+            }
+            const size_t n = std::min(avail, len - pos);
+            const char* src = writer.data(block) + blockOffset;
+            iovs.push_back({const_cast<char*>(src), n});
+            if (fecGroup != 0) {
+                fudpXor(parity.data() + pos, src, n);
+            }
+            pos += n;
+            blockOffset += n;
+        }
+        if (iovs.size() - first > maxGather) {
+            char* dst = scratch[slot].data();
+            for (size_t i = first; i < iovs.size(); i++) {
+                std::memcpy(dst, iovs[i].iov_base, iovs[i].iov_len);
+                dst += iovs[i].iov_len;
+            }
+            iovs.resize(first);
+            iovs.push_back({scratch[slot].data(), len});
+        }
+
+        if (fecGroup != 0) {
+            parityLength = std::max(parityLength, len);
+            if ((f + 1) % fecGroup == 0 || f + 1 == fragments) {
+                header.fragment = static_cast<std::uint16_t>(f / fecGroup);
+                header.flags = fudpFlagParity;
+                queue(header);
+                char* dst = scratch[queued - 1].data();
+                std::memcpy(dst, parity.data(), parityLength);
+                iovs.push_back({dst, parityLength});
+                std::fill(parity.begin(), parity.begin() + static_cast<std::ptrdiff_t>(parityLength), 0);
+                parityLength = 0;
+                paritySent++;
+            }
+        }
+    }
+
+    bool ok = sendQueued();
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    stats.paritySent += paritySent;
+    if (ok) {
+        stats.messagesSent++;
+    }
+    return ok;
+}
+
+yarp::conf::ssize_t FudpStream::beginMessage()
+{
+    readAt = 0;
+    while (happy && !interrupted) {
+        {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            if (reassembler.next(message)) {
+                return static_cast<yarp::conf::ssize_t>(message.size());
+            }
+        }
+
+        pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int r = ::poll(&pfd, 1, pollTimeoutMs);
+        if (r < 0 && errno != EINTR) {
+            yCError(FUDP_CARRIER, "Failed to wait on %s: %s", localAddress.toURI().c_str(), strerror(errno));
+            break;
+        }
+        if (r <= 0) {
+            continue;
+        }
+
+        int n = ::recvmmsg(fd, msgs.data(), static_cast<unsigned int>(msgs.size()), MSG_DONTWAIT, nullptr);
+        if (n < 0) {
+            // EWOULDBLOCK is the same as EAGAIN on Linux
+            if (errno == EAGAIN || errno == EINTR) {
+                continue;
+            }
+            if (!interrupted) {
+                yCError(FUDP_CARRIER, "Failed to receive on %s: %s", localAddress.toURI().c_str(), strerror(errno));
+            }
+            break;
+        }
+
+        const double now = SystemClock::nowSystem();
+        std::lock_guard<std::mutex> lock(statsMutex);
+        for (int i = 0; i < n; i++) {
+            reassembler.add(buffers[i].data(), msgs[i].msg_len, now);
+        }
+    }
+    happy = false;
+    return -1;
+}
+
+FudpStream::Statistics FudpStream::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    Statistics ret = stats;
+    ret.received = reassembler.getStatistics();
+    return ret;
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_FUDP_FUDPSTREAM_H
+#define YARP_FUDP_FUDPSTREAM_H
+
+#include <yarp/os/Contact.h>
+#include <yarp/os/InputStream.h>
+#include <yarp/os/OutputStream.h>
+#include <yarp/os/SizedWriter.h>
+#include <yarp/os/TwoWayStream.h>
+
+#include "FudpPacket.h"
+#include "FudpReassembler.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <sys/socket.h>
+
+/**
+ * One direction stream of fragmented messages over a UDP socket.
+ *
+ * The sender writes whole messages with writeMessage(), that are split in
+ * datagrams and sent in batches with sendmmsg().  The receiver waits for a
+ * complete message with beginMessage(), and reads it with read().  The
+ * datagrams are received in batches with recvmmsg().
+ */
+class FudpStream :
+        public yarp::os::TwoWayStream,
+        public yarp::os::InputStream,
+        public yarp::os::OutputStream
+{
+public:
+    struct Config
+    {
+        size_t fragmentSize {1400};
+        size_t fecGroup {0};
+        size_t batch {32};
+        int bufferSize {4 * 1024 * 1024};
+        size_t dropEvery {0}; ///< Drop one datagram every dropEvery, to simulate a lossy link
+        size_t maxMessageSize {64 * 1024 * 1024}; ///< Bigger messages are rejected by the receiver
+    };
+
+    struct Statistics
+    {
+        std::uint64_t packetsSent {0};
+        std::uint64_t paritySent {0};
+        std::uint64_t messagesSent {0};
+        FudpReassembler::Statistics received;
+    };
+
+    /**
+     * @param fd a UDP socket, connected to the receiver for the sender.
+     */
+    FudpStream(int fd, bool sender, const Config& config);
+    FudpStream(const FudpStream&) = delete;
+    FudpStream& operator=(const FudpStream&) = delete;
+
+    ~FudpStream() override;
+
+    InputStream& getInputStream() override;
+    OutputStream& getOutputStream() override;
+
+    const yarp::os::Contact& getLocalAddress() const override;
+    const yarp::os::Contact& getRemoteAddress() const override;
+    void setLocalAddress(const yarp::os::Contact& address);
+    void setRemoteAddress(const yarp::os::Contact& address);
+
+    void interrupt() override;
+    void close() override;
+
+    using yarp::os::InputStream::read;
+    yarp::conf::ssize_t read(yarp::os::Bytes& b) override;
+
+    using yarp::os::OutputStream::write;
+    void write(const yarp::os::Bytes& b) override;
+
+    bool isOk() const override;
+
+    void reset() override;
+
+    void beginPacket() override;
+    void endPacket() override;
+
+    bool setTypeOfService(int tos) override;
+    int getTypeOfService() override;
+
+    /**
+     * Sender side: send a message.
+     */
+    bool writeMessage(const yarp::os::SizedWriter& writer);
+
+    /**
+     * Receiver side: wait for the next complete message.
+     * @return the length of the message, or -1 on error.
+     */
+    yarp::conf::ssize_t beginMessage();
+
+    Statistics getStatistics() const;
+
+private:
+    int fd;
+    bool sender;
+    Config config;
+    std::atomic<bool> interrupted {false};
+    std::atomic<bool> happy {true};
+    std::atomic<bool> closed {false};
+    yarp::os::Contact localAddress;
+    yarp::os::Contact remoteAddress;
+
+    // Sender
+    std::uint32_t packetCount {0};
+    std::uint32_t messageCount {0};
+    std::vector<mmsghdr> msgs;
+    std::vector<FudpHeader> headers;
+    std::vector<iovec> iovs;
+    std::vector<size_t> iovStart;
+    std::vector<bool> dropped;
+    std::vector<std::vector<char>> scratch;
+    std::vector<char> parity;
+    size_t queued {0};
+    size_t parityLength {0};
+
+    // Receiver
+    std::vector<std::vector<char>> buffers;
+    FudpReassembler reassembler;
+    std::vector<char> message;
+    size_t readAt {0};
+
+    mutable std::mutex statsMutex;
+    Statistics stats;
+
+    void queue(const FudpHeader& header);
+    bool sendQueued();
+};
+
+#endif // YARP_FUDP_FUDPSTREAM_H
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "ShmRingCarrier.h"
+#include "ShmRingLogComponent.h"
+
+#include <yarp/os/ConnectionState.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/ManagedBytes.h>
+#include <yarp/os/NetInt32.h>
+#include <yarp/os/NetType.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/Route.h>
+
+#include <cstdio>
+#include <functional>
+
+#include <unistd.h>
+
+using namespace yarp::os;
+
+namespace {
+
+// Maximum length of a segment name, see shm_open()
+constexpr int max_name_length = 255;
+
+std::string segmentName(const std::string& portName)
+{
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "/yarp-shmring-%d-%zx", static_cast<int>(::getpid()), std::hash<std::string>{}(portName));
+    return buf;
+}
+
+bool isSameHost(ConnectionState& proto)
+{
+    Contact remote = proto.getStreams().getRemoteAddress();
+    Contact local = proto.getStreams().getLocalAddress();
+    if (remote.getHost() != local.getHost()) {
+        yCError(SHMRING_CARRIER, "The ports are on different machines, shared memory not supported");
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+yarp::os::Carrier* ShmRingCarrier::create() const
+{
+    return new ShmRingCarrier();
+}
+
+std::string ShmRingCarrier::getName() const
+{
+    return name;
+}
+
+bool ShmRingCarrier::requireAck() const
+{
+    return false;
+}
+
+bool ShmRingCarrier::isConnectionless() const
+{
+    return false;
+}
+
+bool ShmRingCarrier::supportReply() const
+{
+    return false;
+}
+
+bool ShmRingCarrier::checkHeader(const Bytes& header)
+{
+    if (header.length() != headerSize) {
+        return false;
+    }
+    for (size_t i = 0; i < headerSize; i++) {
+        if (header.get()[i] != headerCode[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ShmRingCarrier::getHeader(Bytes& header) const
+{
+    for (size_t i = 0; i < headerSize && i < header.length(); i++) {
+        header.get()[i] = headerCode[i];
+    }
+}
+
+void ShmRingCarrier::setParameters(const Bytes& header)
+{
+    YARP_UNUSED(header);
+}
+
+bool ShmRingCarrier::configure(ConnectionState& proto)
+{
+    Property options;
+    options.fromString(proto.getSenderSpecifier());
+    return configureFromProperty(options);
+}
+
+bool ShmRingCarrier::configureFromProperty(Property& options)
+{
+    int slots = options.check("slots", Value(static_cast<int>(defaultSlotCount))).asInt32();
+    int size = options.check("slot_size", Value(static_cast<int>(defaultSlotSize))).asInt32();
+    if (slots <= 0 || size <= 0) {
+        yCError(SHMRING_CARRIER, "Invalid ring of %d slots of %d bytes", slots, size);
+        return false;
+    }
+    slotCount = static_cast<size_t>(slots);
+    slotSize = static_cast<size_t>(size);
+    return true;
+}
+
+bool ShmRingCarrier::respondToHeader(ConnectionState& proto)
+{
+    // I am the receiver
+    return becomeShmRing(proto, false);
+}
+
+bool ShmRingCarrier::expectReplyToHeader(ConnectionState& proto)
+{
+    // I am the sender
+    return becomeShmRing(proto, true);
+}
+
+bool ShmRingCarrier::becomeShmRing(ConnectionState& proto, bool sender)
+{
+    if (!isSameHost(proto)) {
+        return false;
+    }
+
+    std::shared_ptr<ShmRingSegment> segment;
+    int reader = -1;
+    NetInt32 numberSrc;
+    Bytes number(reinterpret_cast<char*>(&numberSrc), sizeof(NetInt32));
+
+    if (sender) {
+        // The sender creates the ring, reserves a reader for the
+        // connection, and tells the receiver where to find it.
+        segment = ShmRingSegment::create(segmentName(proto.getRoute().getFromName()), slotCount, slotSize);
+        if (!segment) {
+            return false;
+        }
+        reader = segment->addReader();
+        if (reader < 0) {
+            yCError(SHMRING_CARRIER, "Too many readers for %s", segment->getName().c_str());
+            return false;
+        }
+        const std::string& segName = segment->getName();
+        writeYarpInt(reader, proto);
+        NetType::netInt(static_cast<int>(segName.length()), number);
+        proto.os().write(number);
+        proto.os().write(Bytes(const_cast<char*>(segName.c_str()), segName.length()));
+        proto.os().flush();
+        if (readYarpInt(proto) != 0) {
+            yCError(SHMRING_CARRIER, "The receiver could not open %s", segName.c_str());
+            segment->removeReader(reader);
+            segment->removeWriter(reader);
+            return false;
+        }
+    } else {
+        reader = readYarpInt(proto);
+        int len = -1;
+        if (proto.is().readFull(number) == static_cast<yarp::conf::ssize_t>(number.length())) {
+            len = NetType::netInt(number);
+        }
+        if (len <= 0 || len > max_name_length) {
+            yCError(SHMRING_CARRIER, "Invalid ring name");
+            return false;
+        }
+        ManagedBytes buf(static_cast<size_t>(len));
+        if (proto.is().readFull(buf.bytes()) != len) {
+            yCError(SHMRING_CARRIER, "Invalid ring name");
+            return false;
+        }
+        segment = ShmRingSegment::open(std::string(buf.get(), static_cast<size_t>(len)));
+        bool ok = segment && segment->attachReader(reader);
+        writeYarpInt(ok ? 0 : -1, proto);
+        proto.os().flush();
+        if (!ok) {
+            return false;
+        }
+    }
+
+    Contact remote = proto.getStreams().getRemoteAddress();
+    Contact local = proto.getStreams().getLocalAddress();
+
+    proto.takeStreams(nullptr); // free up port from tcp
+
+    stream = new ShmRingStream(segment, reader, sender);
+    stream->setLocalAddress(local);
+    stream->setRemoteAddress(remote);
+    proto.takeStreams(stream);
+
+    yCDebug(SHMRING_CARRIER, "Connected on %s as %s %d", segment->getName().c_str(), (sender ? "sender" : "receiver"), reader);
+    return true;
+}
+
+bool ShmRingCarrier::write(ConnectionState& proto, SizedWriter& writer)
+{
+    YARP_UNUSED(proto);
+    if (stream == nullptr) {
+        return false;
+    }
+    return stream->writeMessage(writer);
+}
+
+bool ShmRingCarrier::expectIndex(ConnectionState& proto)
+{
+    if (stream == nullptr) {
+        return false;
+    }
+    yarp::conf::ssize_t len = stream->beginMessage();
+    if (len < 0) {
+        return false;
+    }
+    proto.setRemainingLength(static_cast<int>(len));
+    return true;
+}
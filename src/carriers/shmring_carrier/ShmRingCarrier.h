@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SHMRING_SHMRINGCARRIER_H
+#define YARP_SHMRING_SHMRINGCARRIER_H
+
+#include <yarp/os/AbstractCarrier.h>
+
+#include "ShmRingStream.h"
+
+/**
+ * Communicating between two ports on the same host via a POSIX shared
+ * memory ring.
+ *
+ * The connection is negotiated on the usual tcp socket, that is closed
+ * afterwards.  Messages are copied once, from the buffers of the sender to
+ * the slots of the ring, and read from there by the receiver.  All the
+ * shmring connections of an output port share the same ring.
+ *
+ * The size of the ring can be set by the first connection of a port, e.g.
+ * "shmring+slots.32+slot_size.65536".  Replies are not supported.
+ */
+class ShmRingCarrier :
+        public yarp::os::AbstractCarrier
+{
+public:
+    ShmRingCarrier() = default;
+    ShmRingCarrier(const ShmRingCarrier&) = delete;
+    ShmRingCarrier(ShmRingCarrier&&) = delete;
+    ShmRingCarrier& operator=(const ShmRingCarrier&) = delete;
+    ShmRingCarrier& operator=(ShmRingCarrier&&) = delete;
+
+    ~ShmRingCarrier() override = default;
+
+    yarp::os::Carrier* create() const override;
+
+    std::string getName() const override;
+
+    bool requireAck() const override;
+    bool isConnectionless() const override;
+    bool supportReply() const override;
+
+    bool checkHeader(const yarp::os::Bytes& header) override;
+    void getHeader(yarp::os::Bytes& header) const override;
+    void setParameters(const yarp::os::Bytes& header) override;
+
+    // The sender reads the size of the ring from the connection string
+    bool configure(yarp::os::ConnectionState& proto) override;
+    bool configureFromProperty(yarp::os::Property& options) override;
+
+    bool respondToHeader(yarp::os::ConnectionState& proto) override;
+    bool expectReplyToHeader(yarp::os::ConnectionState& proto) override;
+
+    bool write(yarp::os::ConnectionState& proto, yarp::os::SizedWriter& writer) override;
+    bool expectIndex(yarp::os::ConnectionState& proto) override;
+
+private:
+    static constexpr const char* name = "shmring";
+    static constexpr const char* headerCode = "SHM_RING";
+    static constexpr size_t headerSize = 8;
+
+    static constexpr size_t defaultSlotCount = 16;
+    static constexpr size_t defaultSlotSize = 1024 * 1024;
+
+    size_t slotCount {defaultSlotCount};
+    size_t slotSize {defaultSlotSize};
+    ShmRingStream* stream {nullptr};
+
+    bool becomeShmRing(yarp::os::ConnectionState& proto, bool sender);
+};
+
+#endif // YARP_SHMRING_SHMRINGCARRIER_H
@@ -0,0 +1,16 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SHMRING_SHMRINGLOGCOMPONENT_H
+#define YARP_SHMRING_SHMRINGLOGCOMPONENT_H
+
+#include <yarp/os/LogComponent.h>
+
+YARP_DECLARE_LOG_COMPONENT(SHMRING_CARRIER)
+
+#endif // YARP_SHMRING_SHMRINGLOGCOMPONENT_H
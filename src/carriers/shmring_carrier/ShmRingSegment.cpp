@@ -0,0 +1,838 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "ShmRingSegment.h"
+#include "ShmRingLogComponent.h"
+
+#include <yarp/os/LogStream.h>
+#include <yarp/os/MemoryLoan.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <map>
+#include <new>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+              "shmring requires lock-free atomics in shared memory");
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+              "futex words must be plain 32 bit integers");
+
+namespace {
+
+constexpr std::uint32_t ring_magic = 0x474e4952; // "RING"
+constexpr std::uint32_t ring_version = 1;
+constexpr size_t cache_line = 64;
+constexpr std::uint64_t no_seq = ~static_cast<std::uint64_t>(0);
+
+// How often a waiting side checks whether the other process is still alive
+constexpr long liveness_period_ns = 200 * 1000 * 1000;
+
+// Bits of RingReader::state, cleared by each side when it closes.  The
+// entry is free when the state is 0.
+constexpr std::uint32_t writer_open = 1;
+constexpr std::uint32_t reader_open = 2;
+
+struct alignas(cache_line) RingReader
+{
+    std::atomic<std::uint32_t> state;
+    std::atomic<std::int32_t> pid;    ///< the reader process, 0 until attached
+    std::atomic<std::uint64_t> cursor; ///< the next sequence to read
+};
+
+struct RingHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t slotCount;
+    std::uint32_t slotSize;
+    std::int32_t writerPid;
+
+    alignas(cache_line) std::atomic<std::uint32_t> published; ///< futex, bumped for each message
+    std::atomic<std::uint32_t> readersWaiting;
+
+    alignas(cache_line) std::atomic<std::uint32_t> released;  ///< futex, bumped when a reader moves on
+    std::atomic<std::uint32_t> writerWaiting;
+
+    RingReader readers[ShmRingSegment::maxReaders];
+};
+
+struct alignas(cache_line) RingSlot
+{
+    /**
+     * The sequence of the message starting in this slot.  Written last, the
+     * other fields are valid once the sequence is seen.
+     */
+    std::atomic<std::uint64_t> seq;
+
+    /**
+     * Low 32 bits: the readers the message is for.  High 32 bits: the
+     * readers that may get the message as well, if their connection writes
+     * the same bytes.  These readers wait until their bit is moved to the
+     * low half, or cleared.
+     */
+    std::atomic<std::uint64_t> targets;
+
+    std::uint64_t length; ///< the length of the message
+    std::uint64_t size;   ///< the bytes of the message in the ring
+    std::uint32_t slots;  ///< the number of slots of the message
+    std::uint32_t loaned; ///< is the message made of chunks
+};
+
+/**
+ * A message referring to loaned memory is a sequence of chunks, each one
+ * starting with a ChunkHeader.  The data of an inline chunk follow the
+ * header, a loaned chunk is followed by the name of the shared memory
+ * object containing its data.
+ */
+struct ChunkHeader
+{
+    std::uint64_t length;     ///< the length of the data
+    std::uint64_t offset;     ///< the position of the data in the object
+    std::uint32_t nameLength; ///< 0 for inline chunks
+    std::uint32_t reserved;
+};
+
+// Smaller blocks are copied in the ring even if they are loaned
+constexpr size_t loan_threshold = 4096;
+
+constexpr char loan_prefix[] = "/yarp-loan-";
+constexpr size_t max_loan_name = 255;
+
+// The loaned objects mapped by a reader at the same time
+constexpr size_t max_loans = 16;
+
+constexpr size_t roundUp(size_t n)
+{
+    return (n + cache_line - 1) / cache_line * cache_line;
+}
+
+constexpr size_t header_size = roundUp(sizeof(RingHeader));
+
+RingHeader* header(char* base)
+{
+    return reinterpret_cast<RingHeader*>(base);
+}
+
+RingSlot& slotOf(char* data)
+{
+    return *reinterpret_cast<RingSlot*>(data - sizeof(RingSlot));
+}
+
+long futex(std::atomic<std::uint32_t>* word, int op, std::uint32_t value, const struct timespec* timeout)
+{
+    // Not FUTEX_PRIVATE_FLAG, the word is shared with other processes
+    return syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(word), op, value, timeout, nullptr, 0);
+}
+
+// Wait until the word changes from its value, or for a while.
+// Returns false on timeout.
+bool futexWait(std::atomic<std::uint32_t>* word, std::uint32_t value)
+{
+    struct timespec timeout { 0, liveness_period_ns };
+    return !(futex(word, FUTEX_WAIT, value, &timeout) == -1 && errno == ETIMEDOUT);
+}
+
+void futexWake(std::atomic<std::uint32_t>* word)
+{
+    futex(word, FUTEX_WAKE, INT_MAX, nullptr);
+}
+
+bool isAlive(std::int32_t pid)
+{
+    return pid == 0 || ::kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+std::mutex registryMutex;
+std::map<std::string, std::weak_ptr<ShmRingSegment>> registry;
+
+} // namespace
+
+
+ShmRingSegment::ShmRingSegment(const std::string& name, bool owner) :
+        name(name),
+        owner(owner)
+{
+}
+
+ShmRingSegment::~ShmRingSegment()
+{
+    for (auto& loan : loans) {
+        ::munmap(loan.second.first, loan.second.second);
+    }
+    if (base != nullptr) {
+        ::munmap(base, size);
+    }
+    if (owner) {
+        // The name may already belong to a new segment of the same port
+        std::lock_guard<std::mutex> lock(registryMutex);
+        auto it = registry.find(name);
+        if (it != registry.end() && it->second.expired()) {
+            registry.erase(it);
+            ::shm_unlink(name.c_str());
+        }
+    }
+}
+
+bool ShmRingSegment::map(int fd, size_t size)
+{
+    void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        yCError(SHMRING_CARRIER, "mmap() error on %s: %d, %s", name.c_str(), errno, strerror(errno));
+        return false;
+    }
+    base = static_cast<char*>(addr);
+    this->size = size;
+    return true;
+}
+
+std::shared_ptr<ShmRingSegment> ShmRingSegment::create(const std::string& name, size_t slotCount, size_t slotSize)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = registry.find(name);
+    if (it != registry.end()) {
+        if (auto segment = it->second.lock()) {
+            if (segment->slotCount != slotCount || segment->slotSize != slotSize) {
+                yCDebug(SHMRING_CARRIER, "%s already exists, using %zu slots of %zu bytes", name.c_str(), segment->slotCount, segment->slotSize);
+            }
+            return segment;
+        }
+    }
+
+    if (slotCount == 0 || slotSize == 0 || slotSize > UINT32_MAX || slotCount > UINT32_MAX) {
+        yCError(SHMRING_CARRIER, "Invalid ring of %zu slots of %zu bytes", slotCount, slotSize);
+        return nullptr;
+    }
+
+    // A segment left behind by a crashed process with the same pid
+    ::shm_unlink(name.c_str());
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        yCError(SHMRING_CARRIER, "shm_open() error on %s: %d, %s", name.c_str(), errno, strerror(errno));
+        return nullptr;
+    }
+
+    // Not the owner until it is registered, the destructor must not take
+    // the registry lock.
+    std::shared_ptr<ShmRingSegment> segment(new ShmRingSegment(name, false));
+    segment->slotCount = slotCount;
+    segment->slotSize = slotSize;
+    segment->slotStride = sizeof(RingSlot) + roundUp(slotSize);
+    size_t size = header_size + slotCount * segment->slotStride;
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        yCError(SHMRING_CARRIER, "ftruncate() error on %s: %d, %s", name.c_str(), errno, strerror(errno));
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        return nullptr;
+    }
+    if (!segment->map(fd, size)) {
+        ::shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    // The memory is zeroed by ftruncate()
+    RingHeader* h = new (segment->base) RingHeader;
+    h->magic = ring_magic;
+    h->version = ring_version;
+    h->slotCount = static_cast<std::uint32_t>(slotCount);
+    h->slotSize = static_cast<std::uint32_t>(slotSize);
+    h->writerPid = static_cast<std::int32_t>(::getpid());
+    for (size_t i = 0; i < slotCount; i++) {
+        auto* slot = new (segment->base + header_size + i * segment->slotStride) RingSlot;
+        slot->seq.store(no_seq, std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    yCDebug(SHMRING_CARRIER, "Created %s, %zu slots of %zu bytes", name.c_str(), slotCount, slotSize);
+    segment->owner = true;
+    registry[name] = segment;
+    return segment;
+}
+
+std::shared_ptr<ShmRingSegment> ShmRingSegment::open(const std::string& name)
+{
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        yCError(SHMRING_CARRIER, "shm_open() error on %s: %d, %s", name.c_str(), errno, strerror(errno));
+        return nullptr;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < header_size) {
+        yCError(SHMRING_CARRIER, "%s is not a valid ring", name.c_str());
+        ::close(fd);
+        return nullptr;
+    }
+
+    std::shared_ptr<ShmRingSegment> segment(new ShmRingSegment(name, false));
+    if (!segment->map(fd, static_cast<size_t>(st.st_size))) {
+        return nullptr;
+    }
+    RingHeader* h = header(segment->base);
+    segment->slotCount = h->slotCount;
+    segment->slotSize = h->slotSize;
+    segment->slotStride = sizeof(RingSlot) + roundUp(segment->slotSize);
+    if (h->magic != ring_magic || h->version != ring_version || segment->slotCount == 0
+        || header_size + segment->slotCount * segment->slotStride != segment->size) {
+        yCError(SHMRING_CARRIER, "%s is not a valid ring", name.c_str());
+        return nullptr;
+    }
+    return segment;
+}
+
+char* ShmRingSegment::slotData(std::uint64_t seq) const
+{
+    return base + header_size + (seq % slotCount) * slotStride + sizeof(RingSlot);
+}
+
+
+int ShmRingSegment::addReader()
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    RingHeader* h = header(base);
+    for (size_t i = 0; i < maxReaders; i++) {
+        RingReader& r = h->readers[i];
+        std::uint32_t expected = 0;
+        // Set the cursor before the writers can see the reader
+        if (r.state.load(std::memory_order_acquire) == 0) {
+            r.pid.store(0, std::memory_order_relaxed);
+            r.cursor.store(head, std::memory_order_relaxed);
+            if (r.state.compare_exchange_strong(expected, writer_open | reader_open, std::memory_order_acq_rel)) {
+                resolvedFrom[i] = head;
+                return static_cast<int>(i);
+            }
+        }
+    }
+    return -1;
+}
+
+void ShmRingSegment::removeWriter(int reader)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    RingHeader* h = header(base);
+    h->readers[reader].state.fetch_and(~writer_open, std::memory_order_acq_rel);
+    // The reader may be waiting for a message that will never come
+    clearPending(static_cast<std::uint64_t>(1) << reader);
+}
+
+bool ShmRingSegment::hasReader(int reader) const
+{
+    return (header(base)->readers[reader].state.load(std::memory_order_acquire) & reader_open) != 0;
+}
+
+bool ShmRingSegment::attachReader(int reader)
+{
+    if (reader < 0 || static_cast<size_t>(reader) >= maxReaders) {
+        return false;
+    }
+    RingReader& r = header(base)->readers[reader];
+    if ((r.state.load(std::memory_order_acquire) & reader_open) == 0) {
+        return false;
+    }
+    r.pid.store(static_cast<std::int32_t>(::getpid()), std::memory_order_release);
+    return true;
+}
+
+void ShmRingSegment::removeReader(int reader)
+{
+    RingHeader* h = header(base);
+    h->readers[reader].state.fetch_and(~reader_open, std::memory_order_acq_rel);
+    // The writer may be waiting for this reader to release a slot
+    h->released.fetch_add(1, std::memory_order_seq_cst);
+    futexWake(&h->released);
+}
+
+void ShmRingSegment::wakeUp()
+{
+    RingHeader* h = header(base);
+    h->published.fetch_add(1, std::memory_order_seq_cst);
+    h->released.fetch_add(1, std::memory_order_seq_cst);
+    futexWake(&h->published);
+    futexWake(&h->released);
+}
+
+std::uint32_t ShmRingSegment::pendingReaders(int reader) const
+{
+    // The other connections of the port, that may write the same message
+    std::uint32_t readers = 0;
+    RingHeader* h = header(base);
+    for (size_t i = 0; i < maxReaders; i++) {
+        if (static_cast<int>(i) != reader && h->readers[i].state.load(std::memory_order_acquire) == (writer_open | reader_open)) {
+            readers |= static_cast<std::uint32_t>(1) << i;
+        }
+    }
+    return readers;
+}
+
+void ShmRingSegment::checkReaders(std::uint64_t seq)
+{
+    // Forget the readers that died without closing the connection, they
+    // would block the ring forever.
+    RingHeader* h = header(base);
+    for (size_t i = 0; i < maxReaders; i++) {
+        RingReader& r = h->readers[i];
+        if ((r.state.load(std::memory_order_acquire) & reader_open) != 0
+            && r.cursor.load(std::memory_order_acquire) + slotCount <= seq
+            && !isAlive(r.pid.load(std::memory_order_acquire))) {
+            yCWarning(SHMRING_CARRIER, "Reader %zu of %s is gone", i, name.c_str());
+            r.state.fetch_and(~reader_open, std::memory_order_acq_rel);
+        }
+    }
+}
+
+void ShmRingSegment::clearPending(std::uint64_t readers)
+{
+    for (size_t i = 0; i < slotCount; i++) {
+        slotOf(slotData(i)).targets.fetch_and(~(readers << 32), std::memory_order_acq_rel);
+    }
+    notifyReaders();
+}
+
+void ShmRingSegment::notifyReaders()
+{
+    RingHeader* h = header(base);
+    h->published.fetch_add(1, std::memory_order_seq_cst);
+    if (h->readersWaiting.load(std::memory_order_seq_cst) != 0) {
+        futexWake(&h->published);
+    }
+}
+
+bool ShmRingSegment::waitForSlot(std::uint64_t seq, const std::atomic<bool>& interrupted)
+{
+    if (seq < slotCount) {
+        return true;
+    }
+    RingHeader* h = header(base);
+    bool cleared = false;
+    while (true) {
+        std::uint32_t seen = h->released.load(std::memory_order_acquire);
+        bool free = true;
+        for (size_t i = 0; i < maxReaders && free; i++) {
+            const RingReader& r = h->readers[i];
+            if ((r.state.load(std::memory_order_acquire) & reader_open) != 0) {
+                free = (r.cursor.load(std::memory_order_acquire) + slotCount > seq);
+            }
+        }
+        if (free) {
+            return true;
+        }
+        if (interrupted.load()) {
+            return false;
+        }
+        if (!cleared) {
+            // The readers waiting for their connection to write a message
+            // may be the ones holding the slots, and their connections are
+            // waiting for this write to complete.  Those connections will
+            // write their own copy.
+            clearPending(~static_cast<std::uint64_t>(0));
+            cleared = true;
+            continue;
+        }
+        h->writerWaiting.fetch_add(1, std::memory_order_seq_cst);
+        bool woken = futexWait(&h->released, seen);
+        h->writerWaiting.fetch_sub(1, std::memory_order_seq_cst);
+        if (!woken) {
+            checkReaders(seq);
+        }
+    }
+}
+
+bool ShmRingSegment::waitConsumed(std::uint64_t seq, const std::atomic<bool>& interrupted)
+{
+    RingHeader* h = header(base);
+    while (true) {
+        std::uint32_t seen = h->released.load(std::memory_order_acquire);
+        bool consumed = true;
+        for (size_t i = 0; i < maxReaders && consumed; i++) {
+            const RingReader& r = h->readers[i];
+            if ((r.state.load(std::memory_order_acquire) & reader_open) != 0) {
+                consumed = (r.cursor.load(std::memory_order_acquire) > seq);
+            }
+        }
+        if (consumed) {
+            return true;
+        }
+        if (interrupted.load()) {
+            return false;
+        }
+        h->writerWaiting.fetch_add(1, std::memory_order_seq_cst);
+        bool woken = futexWait(&h->released, seen);
+        h->writerWaiting.fetch_sub(1, std::memory_order_seq_cst);
+        if (!woken) {
+            std::lock_guard<std::mutex> lock(writeMutex);
+            checkReaders(seq + slotCount);
+            // The connections of the readers still waiting for this message
+            // did not write it, they will write their own copy if needed.
+            RingSlot& slot = slotOf(slotData(seq));
+            if (slot.seq.load(std::memory_order_relaxed) == seq) {
+                slot.targets.fetch_and(0xffffffff, std::memory_order_acq_rel);
+                notifyReaders();
+            }
+        }
+    }
+}
+
+void ShmRingSegment::encode(const yarp::os::SizedWriter& writer, Message& message)
+{
+    std::string name;
+    size_t offset = 0;
+    for (size_t i = 0; i < writer.length(); i++) {
+        const char* data = writer.data(i);
+        size_t len = writer.length(i);
+        message.length += len;
+        if (len >= loan_threshold && yarp::os::MemoryLoan::find(data, len, name, offset)) {
+            message.loaned = true;
+        }
+    }
+
+    if (!message.loaned) {
+        for (size_t i = 0; i < writer.length(); i++) {
+            message.parts.emplace_back(writer.data(i), writer.length(i));
+        }
+        message.size = message.length;
+        return;
+    }
+
+    for (size_t i = 0; i < writer.length(); i++) {
+        const char* data = writer.data(i);
+        size_t len = writer.length(i);
+        ChunkHeader chunk {len, 0, 0, 0};
+        bool loaned = (len >= loan_threshold && yarp::os::MemoryLoan::find(data, len, name, offset));
+        if (loaned) {
+            chunk.offset = offset;
+            chunk.nameLength = static_cast<std::uint32_t>(name.size());
+        }
+        message.chunks.emplace_back(reinterpret_cast<const char*>(&chunk), sizeof(chunk));
+        if (loaned) {
+            message.chunks.back() += name;
+        }
+        message.parts.emplace_back(message.chunks.back().data(), message.chunks.back().size());
+        message.size += message.chunks.back().size();
+        if (!loaned) {
+            message.parts.emplace_back(data, len);
+            message.size += len;
+        }
+    }
+}
+
+bool ShmRingSegment::equals(const Message& message, std::uint64_t seq) const
+{
+    size_t part = 0;
+    size_t offset = 0;
+    for (const auto& p : message.parts) {
+        const char* data = p.first;
+        size_t len = p.second;
+        while (len > 0) {
+            size_t n = std::min(len, slotSize - offset);
+            if (std::memcmp(slotData(seq + part) + offset, data, n) != 0) {
+                return false;
+            }
+            data += n;
+            len -= n;
+            offset += n;
+            if (offset == slotSize) {
+                part++;
+                offset = 0;
+            }
+        }
+    }
+    return true;
+}
+
+void ShmRingSegment::copyIn(const Message& message, std::uint64_t seq)
+{
+    size_t part = 0;
+    size_t offset = 0;
+    for (const auto& p : message.parts) {
+        const char* data = p.first;
+        size_t len = p.second;
+        while (len > 0) {
+            size_t n = std::min(len, slotSize - offset);
+            std::memcpy(slotData(seq + part) + offset, data, n);
+            data += n;
+            len -= n;
+            offset += n;
+            if (offset == slotSize) {
+                part++;
+                offset = 0;
+            }
+        }
+    }
+}
+
+bool ShmRingSegment::share(int reader, const Message& message)
+{
+    if (!hasLast || lastLength != message.size) {
+        return false;
+    }
+    RingSlot& slot = slotOf(slotData(lastSeq));
+    std::uint64_t bit = static_cast<std::uint64_t>(1) << reader;
+    std::uint64_t targets = slot.targets.load(std::memory_order_acquire);
+    if ((targets & (bit << 32)) == 0 || slot.loaned != (message.loaned ? 1 : 0) || !equals(message, lastSeq)) {
+        return false;
+    }
+    // Readers never modify the targets, the other writers hold the lock
+    slot.targets.store((targets & ~(bit << 32)) | bit, std::memory_order_release);
+    return true;
+}
+
+void ShmRingSegment::resolve(int reader)
+{
+    // The messages written by the other connections since the last write
+    // of this one were not sent by this connection.
+    std::uint64_t bit = static_cast<std::uint64_t>(1) << reader;
+    for (std::uint64_t seq = resolvedFrom[reader]; seq < head;) {
+        RingSlot& slot = slotOf(slotData(seq));
+        if (slot.seq.load(std::memory_order_relaxed) != seq) {
+            // Overwritten, therefore already resolved
+            break;
+        }
+        slot.targets.fetch_and(~(bit << 32), std::memory_order_acq_rel);
+        seq += slot.slots;
+    }
+    resolvedFrom[reader] = head;
+}
+
+bool ShmRingSegment::write(int reader, const yarp::os::SizedWriter& writer, const std::atomic<bool>& interrupted)
+{
+    Message message;
+    encode(writer, message);
+
+    std::unique_lock<std::mutex> lock(writeMutex);
+
+    if (!hasReader(reader)) {
+        return false;
+    }
+
+    size_t slots = std::max<size_t>(1, (message.size + slotSize - 1) / slotSize);
+    if (slots > slotCount) {
+        yCError(SHMRING_CARRIER, "Message of %zu bytes does not fit in %zu slots of %zu bytes", message.size, slotCount, slotSize);
+        return false;
+    }
+
+    if (share(reader, message)) {
+        // The connection that wrote the message waits for the readers
+        resolve(reader);
+        notifyReaders();
+        return true;
+    }
+    resolve(reader);
+
+    std::uint64_t seq = head;
+    // Readers release whole messages in order, the last slot is free only
+    // when all the previous ones are.
+    if (!waitForSlot(seq + slots - 1, interrupted)) {
+        return false;
+    }
+
+    copyIn(message, seq);
+
+    // Only the first slot of a message is published, readers jump over
+    // the other ones.
+    RingSlot& slot = slotOf(slotData(seq));
+    slot.length = message.length;
+    slot.size = message.size;
+    slot.slots = static_cast<std::uint32_t>(slots);
+    slot.loaned = message.loaned ? 1 : 0;
+    slot.targets.store((static_cast<std::uint64_t>(pendingReaders(reader)) << 32) | (static_cast<std::uint64_t>(1) << reader), std::memory_order_relaxed);
+    slot.seq.store(seq, std::memory_order_release);
+
+    head = seq + slots;
+    resolvedFrom[reader] = head;
+    lastSeq = seq;
+    lastLength = message.size;
+    hasLast = true;
+
+    notifyReaders();
+
+    if (message.loaned) {
+        // The application may modify the loaned memory once the write is
+        // completed
+        lock.unlock();
+        return waitConsumed(seq, interrupted);
+    }
+    return true;
+}
+
+yarp::conf::ssize_t ShmRingSegment::beginRead(int reader, ReadState& state, const std::atomic<bool>& interrupted)
+{
+    RingHeader* h = header(base);
+    RingReader& r = h->readers[reader];
+    std::uint64_t bit = static_cast<std::uint64_t>(1) << reader;
+    std::uint64_t cursor = r.cursor.load(std::memory_order_relaxed);
+
+    while (true) {
+        if (interrupted.load()) {
+            return -1;
+        }
+        std::uint32_t seen = h->published.load(std::memory_order_acquire);
+        RingSlot& slot = slotOf(slotData(cursor));
+        if (slot.seq.load(std::memory_order_acquire) == cursor) {
+            size_t slots = slot.slots;
+            std::uint64_t targets = slot.targets.load(std::memory_order_acquire);
+            if ((targets & bit) != 0) {
+                state.seq = cursor;
+                state.slots = slots;
+                state.length = static_cast<size_t>(slot.length);
+                state.offset = 0;
+                state.position = 0;
+                state.loaned = (slot.loaned != 0);
+                state.chunkLeft = 0;
+                state.chunkData = nullptr;
+                state.active = true;
+                return static_cast<yarp::conf::ssize_t>(state.length);
+            }
+            if ((targets & (bit << 32)) == 0) {
+                cursor += slots;
+                advance(reader, cursor);
+                continue;
+            }
+            // Wait for the connection to write the same message, or
+            // something else
+        } else if ((r.state.load(std::memory_order_acquire) & writer_open) == 0) {
+            // All the messages were read, and no more can arrive
+            return -1;
+        }
+        h->readersWaiting.fetch_add(1, std::memory_order_seq_cst);
+        bool woken = futexWait(&h->published, seen);
+        h->readersWaiting.fetch_sub(1, std::memory_order_seq_cst);
+        if (!woken && !isAlive(h->writerPid)) {
+            yCWarning(SHMRING_CARRIER, "The writer of %s is gone", name.c_str());
+            return -1;
+        }
+    }
+}
+
+void ShmRingSegment::copyOut(const ReadState& state, char* data, size_t length) const
+{
+    size_t position = state.position;
+    while (length > 0) {
+        size_t part = position / slotSize;
+        size_t offset = position % slotSize;
+        size_t n = std::min(length, slotSize - offset);
+        std::memcpy(data, slotData(state.seq + part) + offset, n);
+        data += n;
+        length -= n;
+        position += n;
+    }
+}
+
+const char* ShmRingSegment::mapLoan(const std::string& loan, size_t offset, size_t length)
+{
+    auto it = loans.find(loan);
+    if (it == loans.end()) {
+        if (loan.compare(0, sizeof(loan_prefix) - 1, loan_prefix) != 0) {
+            yCError(SHMRING_CARRIER, "Invalid loaned memory %s in %s", loan.c_str(), name.c_str());
+            return nullptr;
+        }
+        int fd = ::shm_open(loan.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            yCError(SHMRING_CARRIER, "shm_open() error on %s: %d, %s", loan.c_str(), errno, strerror(errno));
+            return nullptr;
+        }
+        struct stat st;
+        void* addr = MAP_FAILED;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            yCError(SHMRING_CARRIER, "Cannot map %s: %d, %s", loan.c_str(), errno, strerror(errno));
+            return nullptr;
+        }
+        // The writer usually reuses the same few blocks, the others were
+        // released
+        if (loans.size() >= max_loans) {
+            ::munmap(loans.begin()->second.first, loans.begin()->second.second);
+            loans.erase(loans.begin());
+        }
+        it = loans.emplace(loan, std::make_pair(static_cast<char*>(addr), static_cast<size_t>(st.st_size))).first;
+    }
+    if (offset > it->second.second || length > it->second.second - offset) {
+        yCError(SHMRING_CARRIER, "Invalid block of %zu bytes in %s", length, loan.c_str());
+        return nullptr;
+    }
+    return it->second.first + offset;
+}
+
+size_t ShmRingSegment::read(ReadState& state, char* data, size_t length)
+{
+    size_t total = 0;
+    length = std::min(length, state.length - state.offset);
+    if (!state.loaned) {
+        copyOut(state, data, length);
+        state.position += length;
+        state.offset += length;
+        return length;
+    }
+
+    while (length > 0) {
+        if (state.chunkLeft == 0) {
+            ChunkHeader chunk;
+            copyOut(state, reinterpret_cast<char*>(&chunk), sizeof(chunk));
+            state.position += sizeof(chunk);
+            state.chunkLeft = static_cast<size_t>(chunk.length);
+            state.chunkData = nullptr;
+            if (chunk.nameLength > 0) {
+                if (chunk.nameLength <= max_loan_name) {
+                    std::string loan(chunk.nameLength, '\0');
+                    copyOut(state, &loan[0], loan.size());
+                    state.position += loan.size();
+                    state.chunkData = mapLoan(loan, static_cast<size_t>(chunk.offset), state.chunkLeft);
+                }
+                if (state.chunkData == nullptr) {
+                    // The rest of the message cannot be read
+                    state.offset = state.length;
+                    return total;
+                }
+            }
+        }
+        size_t n = std::min(length, state.chunkLeft);
+        if (state.chunkData != nullptr) {
+            std::memcpy(data, state.chunkData, n);
+            state.chunkData += n;
+        } else {
+            copyOut(state, data, n);
+            state.position += n;
+        }
+        data += n;
+        length -= n;
+        total += n;
+        state.offset += n;
+        state.chunkLeft -= n;
+    }
+    return total;
+}
+
+void ShmRingSegment::endRead(int reader, ReadState& state)
+{
+    if (state.active) {
+        state.active = false;
+        advance(reader, state.seq + state.slots);
+    }
+}
+
+void ShmRingSegment::advance(int reader, std::uint64_t cursor)
+{
+    RingHeader* h = header(base);
+    h->readers[reader].cursor.store(cursor, std::memory_order_release);
+    h->released.fetch_add(1, std::memory_order_seq_cst);
+    if (h->writerWaiting.load(std::memory_order_seq_cst) != 0) {
+        futexWake(&h->released);
+    }
+}
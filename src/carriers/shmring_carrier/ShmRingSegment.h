@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SHMRING_SHMRINGSEGMENT_H
+#define YARP_SHMRING_SHMRINGSEGMENT_H
+
+#include <yarp/conf/numeric.h>
+
+#include <yarp/os/SizedWriter.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * A POSIX shared memory segment containing a ring of fixed size slots.
+ *
+ * The segment is created by the process of an output port, and is shared by
+ * all the shmring connections of that port, i.e. by up to maxReaders
+ * readers.  Each reader has its own cursor in the ring, and a message stays
+ * in its slots until every reader went past it.  A message spans as many
+ * consecutive slots as needed.
+ *
+ * The connections of the port write into the ring one at a time, therefore
+ * the segment sees a single producer.  A message written by a connection is
+ * pending for the readers of the other connections of the port: when their
+ * connection writes the same bytes, the message is delivered to them as
+ * well instead of being copied again.  These readers wait until their
+ * connection writes something, and the pending messages are dropped if the
+ * ring is full.
+ *
+ * Blocks of the message allocated with yarp::os::MemoryLoan are not copied
+ * in the ring: the message contains their position, and the readers copy
+ * them directly from the memory of the writer process.  The writer waits
+ * until all the readers went past such a message, so that the application
+ * does not modify the blocks while they are read.
+ *
+ * Readers and writers never take a lock in shared memory: they wait on futex
+ * words when the ring is empty or full, and the other side issues a wake up
+ * only if someone is waiting.
+ */
+class ShmRingSegment
+{
+public:
+    static constexpr size_t maxReaders = 32;
+
+    /**
+     * The position of a reader in the message it is reading.
+     */
+    struct ReadState
+    {
+        std::uint64_t seq {0};    ///< the first slot of the message
+        size_t slots {0};         ///< the number of slots used by the message
+        size_t length {0};        ///< the length of the message
+        size_t offset {0};        ///< the bytes already read
+        size_t position {0};      ///< the bytes already read from the ring
+        bool loaned {false};      ///< does the message refer to loaned memory
+        size_t chunkLeft {0};     ///< the bytes left in the current chunk
+        const char* chunkData {nullptr}; ///< the loaned memory of the current chunk
+        bool active {false};      ///< is a message being read
+    };
+
+    ShmRingSegment(const ShmRingSegment&) = delete;
+    ShmRingSegment& operator=(const ShmRingSegment&) = delete;
+    ~ShmRingSegment();
+
+    /**
+     * Get the segment of an output port, creating it if it does not exist
+     * yet in this process.
+     */
+    static std::shared_ptr<ShmRingSegment> create(const std::string& name, size_t slotCount, size_t slotSize);
+
+    /**
+     * Map a segment created by another port.
+     */
+    static std::shared_ptr<ShmRingSegment> open(const std::string& name);
+
+    const std::string& getName() const { return name; }
+    size_t getSlotCount() const { return slotCount; }
+    size_t getSlotSize() const { return slotSize; }
+
+    /**
+     * Writer side: reserve a reader for a new connection.
+     * @return the reader index, or -1 if there are too many readers.
+     */
+    int addReader();
+
+    /**
+     * Writer side: the connection was closed, the reader gets the messages
+     * that are already in the ring, and then an error.
+     */
+    void removeWriter(int reader);
+
+    /**
+     * Writer side: check whether the reader of a connection is still open.
+     */
+    bool hasReader(int reader) const;
+
+    /**
+     * Writer side: write a message for a reader, waiting for free slots.
+     * @return false if the message is too big, if the reader is gone, or
+     * if the wait was interrupted.
+     */
+    bool write(int reader, const yarp::os::SizedWriter& writer, const std::atomic<bool>& interrupted);
+
+    /**
+     * Reader side: start reading as the reader reserved by the writer.
+     */
+    bool attachReader(int reader);
+
+    /**
+     * Reader side: the connection was closed, the writer stops waiting for
+     * this reader.
+     */
+    void removeReader(int reader);
+
+    /**
+     * Reader side: wait for the next message for the reader.
+     * @return the length of the message, or -1 if the connection was
+     * closed or the wait was interrupted.
+     */
+    yarp::conf::ssize_t beginRead(int reader, ReadState& state, const std::atomic<bool>& interrupted);
+
+    /**
+     * Reader side: copy the next bytes of the message being read.
+     * @return the number of bytes copied, 0 if the loaned memory of the
+     * message cannot be accessed.
+     */
+    size_t read(ReadState& state, char* data, size_t length);
+
+    /**
+     * Reader side: release the slots of the message being read.
+     */
+    void endRead(int reader, ReadState& state);
+
+    /**
+     * Wake up all the readers and writers waiting on the segment, so that
+     * they can check whether they were interrupted.
+     */
+    void wakeUp();
+
+private:
+    /**
+     * The bytes of a message, as they are written in the ring.
+     */
+    struct Message
+    {
+        std::vector<std::pair<const char*, size_t>> parts;
+        std::deque<std::string> chunks; ///< the chunk headers, when loaned
+        size_t length {0};              ///< the length of the message
+        size_t size {0};                ///< the bytes in the ring
+        bool loaned {false};            ///< does the message refer to loaned memory
+    };
+
+    ShmRingSegment(const std::string& name, bool owner);
+
+    bool map(int fd, size_t size);
+    char* slotData(std::uint64_t seq) const;
+    static void encode(const yarp::os::SizedWriter& writer, Message& message);
+    bool waitForSlot(std::uint64_t seq, const std::atomic<bool>& interrupted);
+    bool waitConsumed(std::uint64_t seq, const std::atomic<bool>& interrupted);
+    bool share(int reader, const Message& message);
+    void resolve(int reader);
+    void clearPending(std::uint64_t readers);
+    void notifyReaders();
+    std::uint32_t pendingReaders(int reader) const;
+    bool equals(const Message& message, std::uint64_t seq) const;
+    void copyIn(const Message& message, std::uint64_t seq);
+    void copyOut(const ReadState& state, char* data, size_t length) const;
+    const char* mapLoan(const std::string& name, size_t offset, size_t length);
+    void advance(int reader, std::uint64_t cursor);
+    void checkReaders(std::uint64_t seq);
+
+    std::string name;
+    bool owner;
+    char* base {nullptr};
+    size_t size {0};
+    size_t slotCount {0};
+    size_t slotSize {0};
+    size_t slotStride {0};
+
+    // Writer side, protected by writeMutex
+    std::mutex writeMutex;
+    std::uint64_t head {0};                 ///< the next sequence to write
+    std::uint64_t lastSeq {0};              ///< the first slot of the last message
+    size_t lastLength {0};                  ///< the length of the last message
+    bool hasLast {false};                   ///< is there a message in the ring
+    std::uint64_t resolvedFrom[maxReaders] {}; ///< the first message that may be pending for a reader
+
+    // Reader side, the loaned memory mapped so far
+    std::map<std::string, std::pair<char*, size_t>> loans;
+};
+
+#endif // YARP_SHMRING_SHMRINGSEGMENT_H
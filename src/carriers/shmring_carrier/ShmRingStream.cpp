@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "ShmRingStream.h"
+#include "ShmRingLogComponent.h"
+
+#include <yarp/os/Bytes.h>
+#include <yarp/os/LogStream.h>
+
+#include <utility>
+
+using namespace yarp::os;
+
+ShmRingStream::ShmRingStream(std::shared_ptr<ShmRingSegment> segment, int reader, bool sender) :
+        segment(std::move(segment)),
+        reader(reader),
+        sender(sender)
+{
+}
+
+ShmRingStream::~ShmRingStream()
+{
+    close();
+}
+
+InputStream& ShmRingStream::getInputStream()
+{
+    return *this;
+}
+
+OutputStream& ShmRingStream::getOutputStream()
+{
+    return *this;
+}
+
+const Contact& ShmRingStream::getLocalAddress() const
+{
+    return localAddress;
+}
+
+const Contact& ShmRingStream::getRemoteAddress() const
+{
+    return remoteAddress;
+}
+
+void ShmRingStream::setLocalAddress(const Contact& address)
+{
+    localAddress = address;
+}
+
+void ShmRingStream::setRemoteAddress(const Contact& address)
+{
+    remoteAddress = address;
+}
+
+void ShmRingStream::interrupt()
+{
+    yCDebug(SHMRING_CARRIER, "Interrupting %s", segment->getName().c_str());
+    interrupted = true;
+    happy = false;
+    segment->wakeUp();
+}
+
+void ShmRingStream::close()
+{
+    if (closed.exchange(true)) {
+        return;
+    }
+    interrupt();
+    if (sender) {
+        segment->removeWriter(reader);
+    } else {
+        // Once removed, the cursor of the reader is ignored, there is no
+        // need to release the message being read.
+        segment->removeReader(reader);
+    }
+}
+
+yarp::conf::ssize_t ShmRingStream::read(Bytes& b)
+{
+    if (sender || !state.active || !happy) {
+        return -1;
+    }
+    size_t len = segment->read(state, b.get(), b.length());
+    if (len == 0 && b.length() != 0) {
+        return -1;
+    }
+    return static_cast<yarp::conf::ssize_t>(len);
+}
+
+void ShmRingStream::write(const Bytes& b)
+{
+    // Messages are written as a whole by writeMessage(), replies are not
+    // supported.
+    YARP_UNUSED(b);
+}
+
+bool ShmRingStream::isOk() const
+{
+    return happy;
+}
+
+void ShmRingStream::reset()
+{
+}
+
+void ShmRingStream::beginPacket()
+{
+}
+
+void ShmRingStream::endPacket()
+{
+    if (!sender && !closed) {
+        segment->endRead(reader, state);
+    }
+}
+
+bool ShmRingStream::writeMessage(const SizedWriter& writer)
+{
+    if (!happy) {
+        return false;
+    }
+    if (!segment->write(reader, writer, interrupted)) {
+        // A message too big for the ring is dropped, the connection is
+        // kept.
+        if (interrupted || !segment->hasReader(reader)) {
+            happy = false;
+        }
+        return false;
+    }
+    return true;
+}
+
+yarp::conf::ssize_t ShmRingStream::beginMessage()
+{
+    if (!happy) {
+        return -1;
+    }
+    segment->endRead(reader, state);
+    yarp::conf::ssize_t len = segment->beginRead(reader, state, interrupted);
+    if (len < 0) {
+        happy = false;
+    }
+    return len;
+}
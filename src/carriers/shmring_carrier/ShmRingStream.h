@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SHMRING_SHMRINGSTREAM_H
+#define YARP_SHMRING_SHMRINGSTREAM_H
+
+#include <yarp/os/Contact.h>
+#include <yarp/os/InputStream.h>
+#include <yarp/os/OutputStream.h>
+#include <yarp/os/SizedWriter.h>
+#include <yarp/os/TwoWayStream.h>
+
+#include "ShmRingSegment.h"
+
+#include <atomic>
+#include <memory>
+
+/**
+ * One direction stream over a shared memory ring.
+ *
+ * The sender writes whole messages with writeMessage(), the receiver waits
+ * for a message with beginMessage(), reads it with read(), and releases it
+ * with endPacket().  The bytes are read directly from the slots of the ring.
+ */
+class ShmRingStream :
+        public yarp::os::TwoWayStream,
+        public yarp::os::InputStream,
+        public yarp::os::OutputStream
+{
+public:
+    ShmRingStream(std::shared_ptr<ShmRingSegment> segment, int reader, bool sender);
+    ShmRingStream(const ShmRingStream&) = delete;
+    ShmRingStream& operator=(const ShmRingStream&) = delete;
+
+    ~ShmRingStream() override;
+
+    InputStream& getInputStream() override;
+    OutputStream& getOutputStream() override;
+
+    const yarp::os::Contact& getLocalAddress() const override;
+    const yarp::os::Contact& getRemoteAddress() const override;
+    void setLocalAddress(const yarp::os::Contact& address);
+    void setRemoteAddress(const yarp::os::Contact& address);
+
+    void interrupt() override;
+    void close() override;
+
+    using yarp::os::InputStream::read;
+    yarp::conf::ssize_t read(yarp::os::Bytes& b) override;
+
+    using yarp::os::OutputStream::write;
+    void write(const yarp::os::Bytes& b) override;
+
+    bool isOk() const override;
+
+    void reset() override;
+
+    void beginPacket() override;
+    void endPacket() override;
+
+    /**
+     * Sender side: write a message in the ring.
+     */
+    bool writeMessage(const yarp::os::SizedWriter& writer);
+
+    /**
+     * Receiver side: wait for the next message.
+     * @return the length of the message, or -1 on error.
+     */
+    yarp::conf::ssize_t beginMessage();
+
+private:
+    std::shared_ptr<ShmRingSegment> segment;
+    int reader;
+    bool sender;
+    ShmRingSegment::ReadState state;
+    std::atomic<bool> interrupted {false};
+    std::atomic<bool> happy {true};
+    std::atomic<bool> closed {false};
+    yarp::os::Contact localAddress;
+    yarp::os::Contact remoteAddress;
+};
+
+#endif // YARP_SHMRING_SHMRINGSTREAM_H
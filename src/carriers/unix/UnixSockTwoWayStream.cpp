@@ -25,7 +25,8 @@
 using namespace yarp::os;
 
 UnixSockTwoWayStream::UnixSockTwoWayStream(const std::string& _socketPath) :
-        socketPath(_socketPath)
+        socketPath(_socketPath),
+        writer([this](const iovec* iov, int count) { return sendBlocks(iov, count); })
 {
 }
 
@@ -157,6 +158,7 @@ yarp::conf::ssize_t UnixSockTwoWayStream::read(Bytes& b)
     if (closed || !happy) {
         return -1;
     }
+    writer.flush();
     int result;
     result = ::read(openedAsReader ? sender_fd : reader_fd, b.get(), b.length());
     if (closed || result == 0) {
@@ -176,14 +178,56 @@ void UnixSockTwoWayStream::write(const Bytes& b)
         close();
         return;
     }
-    int writtenMem = ::write(openedAsReader ? sender_fd : reader_fd, b.get(), b.length());
+    writer.write(b);
+}
+
+void UnixSockTwoWayStream::writeBlocks(const Bytes* blocks, size_t count)
+{
+    if (reader_fd < 0) {
+        writer.clear();
+        close();
+        return;
+    }
+    writer.writeBlocks(blocks, count);
+}
+
+void UnixSockTwoWayStream::flush()
+{
+    writer.flush();
+}
+
+bool UnixSockTwoWayStream::sendBlocks(const iovec* iov, int count)
+{
+    int fd = openedAsReader ? sender_fd : reader_fd;
+    ssize_t writtenMem = ::writev(fd, iov, count);
+    if (writtenMem >= 0) {
+        // Complete the buffers that were only partially written
+        auto written = static_cast<size_t>(writtenMem);
+        for (int i = 0; i < count && writtenMem >= 0; i++) {
+            if (written >= iov[i].iov_len) {
+                written -= iov[i].iov_len;
+                continue;
+            }
+            const char* rest = static_cast<const char*>(iov[i].iov_base) + written;
+            size_t len = iov[i].iov_len - written;
+            written = 0;
+            while (len > 0 && writtenMem >= 0) {
+                writtenMem = ::write(fd, rest, len);
+                if (writtenMem > 0) {
+                    rest += writtenMem;
+                    len -= writtenMem;
+                }
+            }
+        }
+    }
     if (writtenMem < 0) {
         yCError(UNIXSOCK_CARRIER, "write() error: %d, %s", errno, strerror(errno));
         if (errno != ETIMEDOUT) {
             close();
         }
-        return;
+        return false;
     }
+    return true;
 }
 
 bool UnixSockTwoWayStream::isOk() const
@@ -197,8 +241,10 @@ void UnixSockTwoWayStream::reset()
 
 void UnixSockTwoWayStream::beginPacket()
 {
+    writer.beginPacket();
 }
 
 void UnixSockTwoWayStream::endPacket()
 {
+    writer.endPacket();
 }
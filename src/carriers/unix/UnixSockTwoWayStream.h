@@ -12,6 +12,7 @@
 #include <yarp/os/ManagedBytes.h>
 #include <yarp/os/Semaphore.h>
 #include <yarp/os/TwoWayStream.h>
+#include <yarp/os/impl/GatheredWriter.h>
 
 #include <mutex>
 
@@ -46,6 +47,8 @@ public:
 
     using yarp::os::OutputStream::write;
     void write(const yarp::os::Bytes& b) override;
+    void writeBlocks(const yarp::os::Bytes* blocks, size_t count) override;
+    void flush() override;
 
     bool isOk() const override;
 
@@ -69,6 +72,10 @@ private:
     int reader_fd{-1};
     int sender_fd{-1};
 
+    yarp::os::impl::GatheredWriter writer; ///< collect the small writes of a packet
+
+    bool sendBlocks(const iovec* iov, int count);
+
     static constexpr size_t maxAttempts = 5;
     static constexpr double delayBetweenAttempts = 0.1;
 };
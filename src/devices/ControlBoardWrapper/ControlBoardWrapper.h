@@ -53,7 +53,7 @@
 
 #define PROTOCOL_VERSION_MAJOR 1
 #define PROTOCOL_VERSION_MINOR 9
-#define PROTOCOL_VERSION_TWEAK 0
+#define PROTOCOL_VERSION_TWEAK 1
 
 /*
  * To optimize memory allocation, for group of joints we can have one mem reserver for rpc port
@@ -49,6 +49,29 @@ void RPCMessagesParser::handleProtocolVersionRequest(const yarp::os::Bottle& cmd
     *ok=true;
 }
 
+void RPCMessagesParser::handleBatchMsg(const yarp::os::Bottle& cmd,
+                                       yarp::os::Bottle& response, bool *rec, bool *ok)
+{
+    if (ControlBoardWrapper_p->verbose())
+        yCDebug(CONTROLBOARDWRAPPER, "Handling batch of %zu requests", cmd.size() - 1);
+
+    response.addVocab(VOCAB_BATCH);
+    for (size_t i = 1; i < cmd.size(); i++)
+    {
+        yarp::os::Bottle& reply = response.addList();
+        yarp::os::Bottle* request = cmd.get(i).asList();
+        if (request == nullptr || request->get(0).asVocab() == VOCAB_BATCH)
+        {
+            reply.addVocab(VOCAB_FAILED);
+            continue;
+        }
+        respond(*request, reply);
+    }
+
+    *rec=true;
+    *ok=true;
+}
+
 void RPCMessagesParser::handleImpedanceMsg(const yarp::os::Bottle& cmd,
                                            yarp::os::Bottle& response, bool *rec, bool *ok)
 {
@@ -1673,6 +1696,10 @@ bool RPCMessagesParser::respond(const yarp::os::Bottle& cmd, yarp::os::Bottle& r
                 // fallback for old interfaces with no specific name
                 switch (code)
                 {
+                    case VOCAB_BATCH:
+                        handleBatchMsg(cmd, response, &rec, &ok);
+                    break;
+
                     case VOCAB_CALIBRATE_JOINT:
                     {
                         rec=true;
@@ -112,6 +112,13 @@ public:
     void handleProtocolVersionRequest(const yarp::os::Bottle& cmd,
          yarp::os::Bottle& response, bool *rec, bool *ok);
 
+    /**
+     * Handle a [btch] (request1) (request2) ... message, replying with
+     * [btch] (reply1) (reply2) ...
+     */
+    void handleBatchMsg(const yarp::os::Bottle& cmd,
+         yarp::os::Bottle& response, bool *rec, bool *ok);
+
     void handleRemoteCalibratorMsg(const yarp::os::Bottle& cmd, yarp::os::Bottle& response, bool *rec, bool *ok);
 
     void handleRemoteVariablesMsg(const yarp::os::Bottle& cmd, yarp::os::Bottle& response, bool *rec, bool *ok);
@@ -41,7 +41,8 @@ namespace {
 
 constexpr int PROTOCOL_VERSION_MAJOR = 1;
 constexpr int PROTOCOL_VERSION_MINOR = 9;
-constexpr int PROTOCOL_VERSION_TWEAK = 0;
+constexpr int PROTOCOL_VERSION_TWEAK = 1;
+constexpr int PROTOCOL_VERSION_TWEAK_BATCH = 1; // first version accepting [btch] requests
 
 constexpr double DIAGNOSTIC_THREAD_PERIOD = 1.000;
 
@@ -330,6 +331,11 @@ bool RemoteControlBoard::open(Searchable& config)
         return false;
     }
 
+    rpcBatch = config.check("rpc_batch", Value(true)).asBool() &&
+               protocolVersion.major == PROTOCOL_VERSION_MAJOR &&
+               protocolVersion.minor == PROTOCOL_VERSION_MINOR &&
+               protocolVersion.tweak >= PROTOCOL_VERSION_TWEAK_BATCH;
+
     if (!isLive()) {
         if (remote!="") {
             yCError(REMOTECONTROLBOARD, "Problems with obtaining the number of controlled axes");
@@ -399,11 +405,85 @@ bool RemoteControlBoard::close()
 
 // BEGIN Helpers functions
 
+bool RemoteControlBoard::rpcWrite(const Bottle& cmd, Bottle& response) const
+{
+    if (!rpcBatch) {
+        return rpc_p.write(cmd, response);
+    }
+
+    RpcRequest request{&cmd, &response};
+    std::unique_lock<std::mutex> lock(rpcBatchMutex);
+    rpcBatchQueue.push_back(&request);
+    while (!request.done) {
+        if (rpcBatchSending) {
+            // Another thread is sending, this request will be sent with
+            // the next batch
+            rpcBatchDone.wait(lock);
+            continue;
+        }
+
+        // Send all the requests queued so far, including this one
+        std::vector<RpcRequest*> batch;
+        batch.swap(rpcBatchQueue);
+        rpcBatchSending = true;
+        lock.unlock();
+        rpcWriteBatch(batch);
+        lock.lock();
+        for (auto* r : batch) {
+            r->done = true;
+        }
+        rpcBatchSending = false;
+        rpcBatchDone.notify_all();
+    }
+    return request.ok;
+}
+
+bool RemoteControlBoard::rpcWriteBatch(const std::vector<RpcRequest*>& batch) const
+{
+    if (batch.size() == 1) {
+        batch[0]->ok = rpc_p.write(*batch[0]->cmd, *batch[0]->response);
+        return batch[0]->ok;
+    }
+
+    Bottle cmd, response;
+    cmd.addVocab(VOCAB_BATCH);
+    for (const auto* r : batch) {
+        cmd.addList() = *r->cmd;
+    }
+    if (!rpc_p.write(cmd, response)) {
+        for (auto* r : batch) {
+            r->ok = false;
+        }
+        return false;
+    }
+
+    // expected [btch] (reply1) (reply2) ... [ok]
+    // The server might have processed any of the requests already, so if
+    // the reply is not valid they are not sent again, the whole batch fails.
+    bool valid = (response.get(0).asVocab() == VOCAB_BATCH && response.size() == batch.size() + 2);
+    for (size_t i = 0; valid && i < batch.size(); i++) {
+        valid = response.get(i + 1).isList();
+    }
+    if (!valid) {
+        yCError(REMOTECONTROLBOARD, "Invalid reply to a batch of %zu requests: %s", batch.size(), response.toString().c_str());
+        for (auto* r : batch) {
+            r->ok = false;
+        }
+        return false;
+    }
+
+    for (size_t i = 0; i < batch.size(); i++) {
+        *batch[i]->response = *response.get(i + 1).asList();
+        batch[i]->ok = true;
+    }
+    return true;
+}
+
 bool RemoteControlBoard::send1V(int v)
 {
     Bottle cmd, response;
     cmd.addVocab(v);
-    bool ok=rpc_p.write(cmd, response);
+    bool ok=rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         return true;
     }
@@ -415,7 +495,7 @@ bool RemoteControlBoard::send2V(int v1, int v2)
     Bottle cmd, response;
     cmd.addVocab(v1);
     cmd.addVocab(v2);
-    bool ok=rpc_p.write(cmd, response);
+    bool ok=rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         return true;
     }
@@ -428,7 +508,7 @@ bool RemoteControlBoard::send2V1I(int v1, int v2, int axis)
     cmd.addVocab(v1);
     cmd.addVocab(v2);
     cmd.addInt32(axis);
-    bool ok=rpc_p.write(cmd, response);
+    bool ok=rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         return true;
     }
@@ -440,7 +520,7 @@ bool RemoteControlBoard::send1V1I(int v, int axis)
     Bottle cmd, response;
     cmd.addVocab(v);
     cmd.addInt32(axis);
-    bool ok=rpc_p.write(cmd, response);
+    bool ok=rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         return true;
     }
@@ -454,7 +534,7 @@ bool RemoteControlBoard::send3V1I(int v1, int v2, int v3, int j)
     cmd.addVocab(v2);
     cmd.addVocab(v3);
     cmd.addInt32(j);
-    bool ok=rpc_p.write(cmd, response);
+    bool ok=rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         return true;
     }
@@ -467,7 +547,7 @@ bool RemoteControlBoard::set1V(int code)
     cmd.addVocab(VOCAB_SET);
     cmd.addVocab(code);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -478,7 +558,7 @@ bool RemoteControlBoard::set1V2D(int code, double v)
     cmd.addVocab(code);
     cmd.addFloat64(v);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     return CHECK_FAIL(ok, response);
 }
@@ -490,7 +570,7 @@ bool RemoteControlBoard::set1V1I(int code, int v)
     cmd.addVocab(code);
     cmd.addInt32(v);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     return CHECK_FAIL(ok, response);
 }
@@ -502,7 +582,7 @@ bool RemoteControlBoard::get1V1D(int code, double& v) const
     cmd.addVocab(VOCAB_GET);
     cmd.addVocab(code);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     if (CHECK_FAIL(ok, response)) {
         // response should be [cmd] [name] value
@@ -522,7 +602,7 @@ bool RemoteControlBoard::get1V1I(int code, int& v) const
     cmd.addVocab(VOCAB_GET);
     cmd.addVocab(code);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     if (CHECK_FAIL(ok, response)) {
         // response should be [cmd] [name] value
@@ -542,7 +622,7 @@ bool RemoteControlBoard::set1V1I1D(int code, int j, double val)
     cmd.addVocab(code);
     cmd.addInt32(j);
     cmd.addFloat64(val);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -555,7 +635,7 @@ bool RemoteControlBoard::set1V1I2D(int code, int j, double val1, double val2)
     cmd.addFloat64(val1);
     cmd.addFloat64(val2);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -568,7 +648,7 @@ bool RemoteControlBoard::set1VDA(int v, const double *val)
     Bottle& l = cmd.addList();
     for (size_t i = 0; i < nj; i++)
         l.addFloat64(val[i]);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -582,7 +662,7 @@ bool RemoteControlBoard::set2V1DA(int v1, int v2, const double *val)
     Bottle& l = cmd.addList();
     for (size_t i = 0; i < nj; i++)
         l.addFloat64(val[i]);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -599,7 +679,7 @@ bool RemoteControlBoard::set2V2DA(int v1, int v2, const double *val1, const doub
     Bottle& l2 = cmd.addList();
     for (size_t i = 0; i < nj; i++)
         l2.addFloat64(val2[i]);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -617,7 +697,7 @@ bool RemoteControlBoard::set1V1I1IA1DA(int v, const int len, const int *val1, co
     Bottle& l2 = cmd.addList();
     for (i = 0; i < len; i++)
         l2.addFloat64(val2[i]);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -629,7 +709,7 @@ bool RemoteControlBoard::set2V1I1D(int v1, int v2, int axis, double val)
     cmd.addVocab(v2);
     cmd.addInt32(axis);
     cmd.addFloat64(val);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -643,7 +723,7 @@ bool RemoteControlBoard::setValWithPidType(int voc, PidControlTypeEnum type, int
     cmd.addVocab(type);
     cmd.addInt32(axis);
     cmd.addFloat64(val);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -658,7 +738,7 @@ bool RemoteControlBoard::setValWithPidType(int voc, PidControlTypeEnum type, con
     Bottle& l = cmd.addList();
     for (size_t i = 0; i < nj; i++)
         l.addFloat64(val_arr[i]);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -670,7 +750,7 @@ bool RemoteControlBoard::getValWithPidType(int voc, PidControlTypeEnum type, int
     cmd.addVocab(voc);
     cmd.addVocab(type);
     cmd.addInt32(j);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     if (CHECK_FAIL(ok, response))
     {
@@ -689,7 +769,7 @@ bool RemoteControlBoard::getValWithPidType(int voc, PidControlTypeEnum type, dou
     cmd.addVocab(VOCAB_PID);
     cmd.addVocab(voc);
     cmd.addVocab(type);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response))
     {
         Bottle* lp = response.get(2).asList();
@@ -712,7 +792,7 @@ bool RemoteControlBoard::set2V1I(int v1, int v2, int axis)
     cmd.addVocab(v1);
     cmd.addVocab(v2);
     cmd.addInt32(axis);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -722,7 +802,7 @@ bool RemoteControlBoard::get1V1I1D(int v, int j, double *val)
     cmd.addVocab(VOCAB_GET);
     cmd.addVocab(v);
     cmd.addInt32(j);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     if (CHECK_FAIL(ok, response)) {
         // ok
@@ -740,7 +820,7 @@ bool RemoteControlBoard::get1V1I1I(int v, int j, int *val)
     cmd.addVocab(VOCAB_GET);
     cmd.addVocab(v);
     cmd.addInt32(j);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         // ok
         *val = response.get(2).asInt32();
@@ -758,7 +838,7 @@ bool RemoteControlBoard::get2V1I1D(int v1, int v2, int j, double *val)
     cmd.addVocab(v1);
     cmd.addVocab(v2);
     cmd.addInt32(j);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     if (CHECK_FAIL(ok, response)) {
         // ok
@@ -777,7 +857,7 @@ bool RemoteControlBoard::get2V1I2D(int v1, int v2, int j, double *val1, double *
     cmd.addVocab(v1);
     cmd.addVocab(v2);
     cmd.addInt32(j);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         // ok
         *val1 = response.get(2).asFloat64();
@@ -796,7 +876,7 @@ bool RemoteControlBoard::get1V1I2D(int code, int axis, double *v1, double *v2)
     cmd.addVocab(code);
     cmd.addInt32(axis);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     if (CHECK_FAIL(ok, response)) {
         *v1 = response.get(2).asFloat64();
@@ -812,7 +892,7 @@ bool RemoteControlBoard::get1V1I1B(int v, int j, bool &val)
     cmd.addVocab(VOCAB_GET);
     cmd.addVocab(v);
     cmd.addInt32(j);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         val = (response.get(2).asInt32()!=0);
         getTimeStamp(response, lastStamp);
@@ -831,7 +911,7 @@ bool RemoteControlBoard::get1V1I1IA1B(int v,  const int len, const int *val1, bo
     for (int i = 0; i < len; i++)
         l1.addInt32(val1[i]);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     if (CHECK_FAIL(ok, response)) {
         retVal = (response.get(2).asInt32()!=0);
@@ -855,7 +935,7 @@ bool RemoteControlBoard::get2V1I1IA1DA(int v1, int v2, const int n_joints, const
     for (int i = 0; i < n_joints; i++)
         l1.addInt32(joints[i]);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     if (CHECK_FAIL(ok, response))
     {
@@ -889,7 +969,7 @@ bool RemoteControlBoard::get1V1B(int v, bool &val)
     Bottle cmd, response;
     cmd.addVocab(VOCAB_GET);
     cmd.addVocab(v);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         val = (response.get(2).asInt32()!=0);
         getTimeStamp(response, lastStamp);
@@ -904,7 +984,7 @@ bool RemoteControlBoard::get1VIA(int v, int *val)
     Bottle cmd, response;
     cmd.addVocab(VOCAB_GET);
     cmd.addVocab(v);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         Bottle* lp = response.get(2).asList();
         if (lp == nullptr)
@@ -927,7 +1007,7 @@ bool RemoteControlBoard::get1VDA(int v, double *val)
     Bottle cmd, response;
     cmd.addVocab(VOCAB_GET);
     cmd.addVocab(v);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         Bottle* lp = response.get(2).asList();
         if (lp == nullptr)
@@ -950,7 +1030,7 @@ bool RemoteControlBoard::get1V1DA(int v1, double *val)
     Bottle cmd, response;
     cmd.addVocab(VOCAB_GET);
     cmd.addVocab(v1);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     if (CHECK_FAIL(ok, response)) {
         Bottle* lp = response.get(2).asList();
@@ -974,7 +1054,7 @@ bool RemoteControlBoard::get2V1DA(int v1, int v2, double *val)
     cmd.addVocab(VOCAB_GET);
     cmd.addVocab(v1);
     cmd.addVocab(v2);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     if (CHECK_FAIL(ok, response)) {
         Bottle* lp = response.get(2).asList();
@@ -998,7 +1078,7 @@ bool RemoteControlBoard::get2V2DA(int v1, int v2, double *val1, double *val2)
     cmd.addVocab(VOCAB_GET);
     cmd.addVocab(v1);
     cmd.addVocab(v2);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         Bottle* lp1 = response.get(2).asList();
         if (lp1 == nullptr)
@@ -1031,7 +1111,7 @@ bool RemoteControlBoard::get1V1I1S(int code, int j, std::string &name)
     cmd.addVocab(VOCAB_GET);
     cmd.addVocab(code);
     cmd.addInt32(j);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     if (CHECK_FAIL(ok, response)) {
         name = response.get(2).asString();
@@ -1053,7 +1133,7 @@ bool RemoteControlBoard::get1V1I1IA1DA(int v, const int len, const int *val1, do
     for(int i = 0; i < len; i++)
         l1.addInt32(val1[i]);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     if (CHECK_FAIL(ok, response)) {
         Bottle* lp2 = response.get(2).asList();
@@ -1104,7 +1184,7 @@ bool RemoteControlBoard::setPid(const PidControlTypeEnum& pidtype, int j, const
     l.addFloat64(pid.stiction_up_val);
     l.addFloat64(pid.stiction_down_val);
     l.addFloat64(pid.kff);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -1131,7 +1211,7 @@ bool RemoteControlBoard::setPids(const PidControlTypeEnum& pidtype, const Pid *p
         m.addFloat64(pids[i].kff);
     }
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -1173,7 +1253,7 @@ bool RemoteControlBoard::getPid(const PidControlTypeEnum& pidtype, int j, Pid *p
     cmd.addVocab(VOCAB_PID);
     cmd.addVocab(pidtype);
     cmd.addInt32(j);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         Bottle* lp = response.get(2).asList();
         if (lp == nullptr)
@@ -1202,7 +1282,7 @@ bool RemoteControlBoard::getPids(const PidControlTypeEnum& pidtype, Pid *pids)
     cmd.addVocab(VOCAB_PID);
     cmd.addVocab(VOCAB_PIDS);
     cmd.addVocab(pidtype);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response))
     {
         Bottle* lp = response.get(2).asList();
@@ -1260,7 +1340,7 @@ bool RemoteControlBoard::resetPid(const PidControlTypeEnum& pidtype, int j)
     cmd.addVocab(VOCAB_RESET);
     cmd.addVocab(pidtype);
     cmd.addInt32(j);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -1273,7 +1353,7 @@ bool RemoteControlBoard::disablePid(const PidControlTypeEnum& pidtype, int j)
     cmd.addVocab(VOCAB_DISABLE);
     cmd.addVocab(pidtype);
     cmd.addInt32(j);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -1286,7 +1366,7 @@ bool RemoteControlBoard::enablePid(const PidControlTypeEnum& pidtype, int j)
     cmd.addVocab(VOCAB_ENABLE);
     cmd.addVocab(pidtype);
     cmd.addInt32(j);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -1298,7 +1378,7 @@ bool RemoteControlBoard::isPidEnabled(const PidControlTypeEnum& pidtype, int j,
     cmd.addVocab(VOCAB_ENABLE);
     cmd.addVocab(pidtype);
     cmd.addInt32(j);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response))
     {
         *enabled = response.get(2).asBool();
@@ -1438,7 +1518,7 @@ bool RemoteControlBoard::getRemoteVariable(std::string key, yarp::os::Bottle& va
     cmd.addVocab(VOCAB_REMOTE_VARIABILE_INTERFACE);
     cmd.addVocab(VOCAB_VARIABLE);
     cmd.addString(key);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response))
     {
         val = *(response.get(2).asList());
@@ -1456,7 +1536,7 @@ bool RemoteControlBoard::setRemoteVariable(std::string key, const yarp::os::Bott
     cmd.addString(key);
     cmd.append(val);
     //std::string s = cmd.toString();
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     return CHECK_FAIL(ok, response);
 }
@@ -1468,7 +1548,7 @@ bool RemoteControlBoard::getRemoteVariablesList(yarp::os::Bottle* listOfKeys)
     cmd.addVocab(VOCAB_GET);
     cmd.addVocab(VOCAB_REMOTE_VARIABILE_INTERFACE);
     cmd.addVocab(VOCAB_LIST_VARIABLES);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     //std::string s = response.toString();
     if (CHECK_FAIL(ok, response))
     {
@@ -1794,7 +1874,7 @@ bool RemoteControlBoard::stop(const int len, const int *val1)
     for (i = 0; i < len; i++)
         l1.addInt32(val1[i]);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -1983,7 +2063,7 @@ bool RemoteControlBoard::calibrateAxisWithParams(int j, unsigned int ui, double
     cmd.addFloat64(v2);
     cmd.addFloat64(v3);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     if (CHECK_FAIL(ok, response)) {
         return true;
@@ -2003,7 +2083,7 @@ bool RemoteControlBoard::setCalibrationParameters(int j, const CalibrationParame
     cmd.addFloat64(params.param3);
     cmd.addFloat64(params.param4);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     if (CHECK_FAIL(ok, response)) {
         return true;
@@ -2096,7 +2176,7 @@ bool RemoteControlBoard::setMotorTorqueParams(int j, const MotorTorqueParameters
     b.addFloat64(params.bemf_scale);
     b.addFloat64(params.ktau);
     b.addFloat64(params.ktau_scale);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -2107,7 +2187,7 @@ bool RemoteControlBoard::getMotorTorqueParams(int j, MotorTorqueParameters *para
     cmd.addVocab(VOCAB_TORQUE);
     cmd.addVocab(VOCAB_MOTOR_PARAMS);
     cmd.addInt32(j);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         Bottle* lp = response.get(2).asList();
         if (lp == nullptr)
@@ -2166,7 +2246,7 @@ bool RemoteControlBoard::getImpedance(int j, double *stiffness, double *damping)
     cmd.addVocab(VOCAB_IMPEDANCE);
     cmd.addVocab(VOCAB_IMP_PARAM);
     cmd.addInt32(j);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         Bottle* lp = response.get(2).asList();
         if (lp == nullptr)
@@ -2186,7 +2266,7 @@ bool RemoteControlBoard::getImpedanceOffset(int j, double *offset)
     cmd.addVocab(VOCAB_IMPEDANCE);
     cmd.addVocab(VOCAB_IMP_OFFSET);
     cmd.addInt32(j);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         Bottle* lp = response.get(2).asList();
         if (lp == nullptr)
@@ -2210,7 +2290,7 @@ bool RemoteControlBoard::setImpedance(int j, double stiffness, double damping)
     b.addFloat64(stiffness);
     b.addFloat64(damping);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -2225,7 +2305,7 @@ bool RemoteControlBoard::setImpedanceOffset(int j, double offset)
     Bottle& b = cmd.addList();
     b.addFloat64(offset);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -2236,7 +2316,7 @@ bool RemoteControlBoard::getCurrentImpedanceLimit(int j, double *min_stiff, doub
     cmd.addVocab(VOCAB_IMPEDANCE);
     cmd.addVocab(VOCAB_LIMITS);
     cmd.addInt32(j);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if (CHECK_FAIL(ok, response)) {
         Bottle* lp = response.get(2).asList();
         if (lp == nullptr)
@@ -2301,7 +2381,7 @@ bool RemoteControlBoard::setControlMode(const int j, const int mode)
     cmd.addInt32(j);
     cmd.addVocab(mode);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -2322,7 +2402,7 @@ bool RemoteControlBoard::setControlModes(const int n_joint, const int *joints, i
     for (i = 0; i < n_joint; i++)
         l2.addVocab(modes[i]);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -2338,7 +2418,7 @@ bool RemoteControlBoard::setControlModes(int *modes)
     for (size_t i = 0; i < nj; i++)
         l2.addVocab(modes[i]);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -2490,7 +2570,7 @@ bool RemoteControlBoard::setInteractionMode(int axis, yarp::dev::InteractionMode
     cmd.addInt32(axis);
     cmd.addVocab(mode);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -2513,7 +2593,7 @@ bool RemoteControlBoard::setInteractionModes(int n_joints, int *joints, yarp::de
     {
         l2.addVocab(modes[i]);
     }
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -2530,7 +2610,7 @@ bool RemoteControlBoard::setInteractionModes(yarp::dev::InteractionModeEnum* mod
     for (size_t i = 0; i < nj; i++)
         l1.addVocab(modes[i]);
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -2544,7 +2624,7 @@ bool RemoteControlBoard::isCalibratorDevicePresent(bool *isCalib)
     cmd.addVocab(VOCAB_GET);
     cmd.addVocab(VOCAB_REMOTE_CALIBRATOR_INTERFACE);
     cmd.addVocab(VOCAB_IS_CALIBRATOR_PRESENT);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     if(ok) {
         *isCalib = response.get(2).asInt32()!=0;
     } else {
@@ -2564,7 +2644,7 @@ bool RemoteControlBoard::calibrateWholePart()
     cmd.addVocab(VOCAB_SET);
     cmd.addVocab(VOCAB_REMOTE_CALIBRATOR_INTERFACE);
     cmd.addVocab(VOCAB_CALIBRATE_WHOLE_PART);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -2579,7 +2659,7 @@ bool RemoteControlBoard::homingWholePart()
     cmd.addVocab(VOCAB_SET);
     cmd.addVocab(VOCAB_REMOTE_CALIBRATOR_INTERFACE);
     cmd.addVocab(VOCAB_HOMING_WHOLE_PART);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     yCDebug(REMOTECONTROLBOARD) << "Sent homing whole part message";
     return CHECK_FAIL(ok, response);
 }
@@ -2595,7 +2675,7 @@ bool RemoteControlBoard::parkWholePart()
     cmd.addVocab(VOCAB_SET);
     cmd.addVocab(VOCAB_REMOTE_CALIBRATOR_INTERFACE);
     cmd.addVocab(VOCAB_PARK_WHOLE_PART);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -2605,7 +2685,7 @@ bool RemoteControlBoard::quitCalibrate()
     cmd.addVocab(VOCAB_SET);
     cmd.addVocab(VOCAB_REMOTE_CALIBRATOR_INTERFACE);
     cmd.addVocab(VOCAB_QUIT_CALIBRATE);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -2615,7 +2695,7 @@ bool RemoteControlBoard::quitPark()
     cmd.addVocab(VOCAB_SET);
     cmd.addVocab(VOCAB_REMOTE_CALIBRATOR_INTERFACE);
     cmd.addVocab(VOCAB_QUIT_PARK);
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
     return CHECK_FAIL(ok, response);
 }
 
@@ -2753,7 +2833,7 @@ bool RemoteControlBoard::getRefDutyCycle(int j, double *ref)
     cmd.addInt32(j);
     response.clear();
 
-    bool ok = rpc_p.write(cmd, response);
+    bool ok = rpcWrite(cmd, response);
 
     if (CHECK_FAIL(ok, response))
     {
@@ -37,6 +37,10 @@
 
 #include "stateExtendedReader.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
 struct ProtocolVersion
 {
     int major{0};
@@ -62,6 +66,7 @@ class DiagnosticThread;
 * | remote         |       -        | string  | -     |   -           | Yes          | Prefix of the port to which to connect.        |       |
 * | local          |       -        | string  | -     |   -           | Yes          | Port prefix of the port opened by this device. |       |
 * | writeStrict    |       -        | string  | -     | See note      | No           |                                                |       |
+* | rpc_batch      |       -        | bool    | -     | true          | No           | Send the rpc requests made concurrently by several threads in a single message | Only with a controlboardwrapper2 supporting it |
 *
 */
 class RemoteControlBoard :
@@ -114,6 +119,25 @@ protected:
 
     ProtocolVersion protocolVersion;
 
+    // Requests made by several threads at the same time are sent in a
+    // single [btch] message by the first of them, while the others wait
+    struct RpcRequest
+    {
+        const yarp::os::Bottle* cmd;
+        yarp::os::Bottle* response;
+        bool ok{false};
+        bool done{false};
+    };
+    bool rpcBatch{false};
+    mutable std::mutex rpcBatchMutex;
+    mutable std::condition_variable rpcBatchDone;
+    mutable std::vector<RpcRequest*> rpcBatchQueue;
+    mutable bool rpcBatchSending{false};
+
+    // Write on the rpc port, batching the concurrent requests if possible
+    bool rpcWrite(const yarp::os::Bottle& cmd, yarp::os::Bottle& response) const;
+    bool rpcWriteBatch(const std::vector<RpcRequest*>& batch) const;
+
     // Check for number of joints, if needed.
     // This is to allow for delayed connection to the remote control board.
     bool isLive();
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "FrameGraph.h"
+
+#include <yarp/math/Math.h>
+
+#include <algorithm>
+#include <mutex>
+
+using yarp::math::FrameTransform;
+
+FrameGraph::FrameGraph(std::vector<FrameTransform> transforms, const FrameGraph* previous, size_t history_size) :
+        m_transforms(std::move(transforms))
+{
+    if (previous != nullptr && previous->sameFrames(m_transforms))
+    {
+        m_topology = previous->m_topology;
+        m_histories = previous->m_histories;
+    }
+    else
+    {
+        buildTopology();
+
+        // Keep the history of the edges that still exist
+        const Topology& topology = *m_topology;
+        m_histories.resize(topology.names.size());
+        for (size_t i = 0; i < topology.names.size(); i++)
+        {
+            if (topology.edge[i] < 0)
+            {
+                continue;
+            }
+            if (previous != nullptr && previous->m_topology)
+            {
+                int old = previous->id(topology.names[i]);
+                if (old >= 0 && previous->parent(old) >= 0 &&
+                    previous->name(previous->parent(old)) == topology.names[topology.parent[i]])
+                {
+                    m_histories[i] = previous->m_histories[old];
+                }
+            }
+            if (!m_histories[i])
+            {
+                m_histories[i] = std::make_shared<FrameTransformHistory>(history_size);
+            }
+        }
+    }
+
+    const Topology& topology = *m_topology;
+    m_matrices.resize(topology.names.size());
+    for (size_t i = 0; i < topology.names.size(); i++)
+    {
+        if (topology.edge[i] >= 0)
+        {
+            const FrameTransform& t = m_transforms[topology.edge[i]];
+            m_matrices[i] = t.toMatrix();
+            m_histories[i]->add(t);
+        }
+    }
+}
+
+bool FrameGraph::sameFrames(const std::vector<FrameTransform>& transforms) const
+{
+    if (!m_topology || m_topology->frames.size() != transforms.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < transforms.size(); i++)
+    {
+        if (m_topology->frames[i].first != transforms[i].src_frame_id ||
+            m_topology->frames[i].second != transforms[i].dst_frame_id)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FrameGraph::buildTopology()
+{
+    auto topology = std::make_shared<Topology>();
+
+    auto intern = [&topology](const std::string& frame_id)
+    {
+        auto it = topology->ids.find(frame_id);
+        if (it != topology->ids.end())
+        {
+            return it->second;
+        }
+        int id = static_cast<int>(topology->names.size());
+        topology->ids.emplace(frame_id, id);
+        topology->names.push_back(frame_id);
+        topology->parent.push_back(-1);
+        topology->edge.push_back(-1);
+        return id;
+    };
+
+    // The parent of a frame is the source of the first transform having it
+    // as destination
+    topology->frames.reserve(m_transforms.size());
+    for (size_t i = 0; i < m_transforms.size(); i++)
+    {
+        const FrameTransform& t = m_transforms[i];
+        topology->frames.emplace_back(t.src_frame_id, t.dst_frame_id);
+        int src = intern(t.src_frame_id);
+        int dst = intern(t.dst_frame_id);
+        if (src != dst && topology->edge[dst] < 0)
+        {
+            topology->parent[dst] = src;
+            topology->edge[dst] = static_cast<int>(i);
+        }
+    }
+
+    // Compute the depth of each frame, and break the cycles if any
+    size_t n = topology->names.size();
+    topology->depth.assign(n, 0);
+    std::vector<char> state(n, 0); // 0 = not visited, 1 = visiting, 2 = done
+    std::vector<int> chain;
+    for (size_t i = 0; i < n; i++)
+    {
+        chain.clear();
+        int f = static_cast<int>(i);
+        while (f >= 0 && state[f] == 0)
+        {
+            state[f] = 1;
+            chain.push_back(f);
+            f = topology->parent[f];
+        }
+        if (f >= 0 && state[f] == 1)
+        {
+            topology->parent[chain.back()] = -1;
+            topology->edge[chain.back()] = -1;
+            f = -1;
+        }
+        int d = (f < 0) ? -1 : topology->depth[f];
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+        {
+            topology->depth[*it] = ++d;
+            state[*it] = 2;
+        }
+    }
+
+    m_topology = topology;
+}
+
+int FrameGraph::id(const std::string& frame_id) const
+{
+    if (!m_topology)
+    {
+        return -1;
+    }
+    auto it = m_topology->ids.find(frame_id);
+    return (it != m_topology->ids.end()) ? it->second : -1;
+}
+
+bool FrameGraph::hasTransform(const std::string& target_frame_id, const std::string& source_frame_id) const
+{
+    for (const auto& t : m_transforms)
+    {
+        if (t.dst_frame_id == target_frame_id && t.src_frame_id == source_frame_id)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+const FrameGraph::Path& FrameGraph::path(int target, int source) const
+{
+    const Topology& topology = *m_topology;
+    std::uint64_t key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(target)) << 32) | static_cast<std::uint32_t>(source);
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(topology.mutex);
+        auto it = topology.paths.find(key);
+        if (it != topology.paths.end())
+        {
+            return *it->second;
+        }
+    }
+
+    // Climb from the deepest frame up to the lowest common ancestor
+    std::unique_ptr<Path> p(new Path);
+    int a = target;
+    int b = source;
+    while (topology.depth[a] > topology.depth[b])
+    {
+        p->to_target.push_back(a);
+        a = topology.parent[a];
+    }
+    while (topology.depth[b] > topology.depth[a])
+    {
+        p->to_source.push_back(b);
+        b = topology.parent[b];
+    }
+    while (a != b && a >= 0 && b >= 0)
+    {
+        p->to_target.push_back(a);
+        p->to_source.push_back(b);
+        a = topology.parent[a];
+        b = topology.parent[b];
+    }
+    p->connected = (a == b && a >= 0);
+    p->ancestor = p->connected ? a : -1;
+    std::reverse(p->to_target.begin(), p->to_target.end());
+    std::reverse(p->to_source.begin(), p->to_source.end());
+
+    std::unique_lock<std::shared_timed_mutex> lock(topology.mutex);
+    auto it = topology.paths.emplace(key, std::move(p)).first;
+    return *it->second;
+}
+
+yarp::sig::Matrix FrameGraph::chain(const std::vector<int>& frames) const
+{
+    yarp::sig::Matrix m(4, 4);
+    m.eye();
+    for (int f : frames)
+    {
+        m = m * m_matrices[f];
+    }
+    return m;
+}
+
+yarp::sig::Matrix FrameGraph::transform(const Path& path) const
+{
+    if (path.to_source.empty())
+    {
+        return chain(path.to_target);
+    }
+    if (path.to_target.empty())
+    {
+        return yarp::math::SE3inv(chain(path.to_source));
+    }
+    return yarp::math::SE3inv(chain(path.to_source)) * chain(path.to_target);
+}
+
+bool FrameGraph::chain(const std::vector<int>& frames, double time, yarp::sig::Matrix& m) const
+{
+    m.resize(4, 4);
+    m.eye();
+    FrameTransform t;
+    for (int f : frames)
+    {
+        if (!m_histories[f]->get(time, t))
+        {
+            return false;
+        }
+        m = m * t.toMatrix();
+    }
+    return true;
+}
+
+bool FrameGraph::transform(const Path& path, double time, yarp::sig::Matrix& transform) const
+{
+    yarp::sig::Matrix to_target;
+    yarp::sig::Matrix to_source;
+    if (!chain(path.to_target, time, to_target) || !chain(path.to_source, time, to_source))
+    {
+        return false;
+    }
+    if (path.to_source.empty())
+    {
+        transform = to_target;
+    }
+    else
+    {
+        transform = yarp::math::SE3inv(to_source) * to_target;
+    }
+    return true;
+}
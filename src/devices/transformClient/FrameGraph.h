@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef YARP_DEV_FRAMEGRAPH_H
+#define YARP_DEV_FRAMEGRAPH_H
+
+#include <yarp/math/FrameTransform.h>
+#include <yarp/sig/Matrix.h>
+
+#include "FrameTransformHistory.h"
+
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * The frames and the transforms received by the transformClient at a given
+ * time.
+ *
+ * Frame ids are interned to integers, and each frame points to its parent,
+ * i.e. the source frame of the first transform having it as destination.
+ * The path between two frames goes through their lowest common ancestor,
+ * and is cached the first time it is asked.  A graph is never modified once
+ * built, so it can be read by any thread without locks (except for the path
+ * cache and the histories).  When new transforms arrive with the same
+ * frames and parents, the new graph shares the topology, and therefore the
+ * cached paths, of the previous one.
+ *
+ * Each edge also keeps the history of the transforms received, shared by
+ * all the graphs where the edge exists.
+ */
+class FrameGraph
+{
+public:
+    /**
+     * The path from a frame to another one: the frames from the common
+     * ancestor (excluded) down to each of them.
+     */
+    struct Path
+    {
+        bool connected {false};
+        int ancestor {-1};
+        std::vector<int> to_target;
+        std::vector<int> to_source;
+    };
+
+    FrameGraph() = default;
+
+    /**
+     * @param transforms the transforms received, as (src_frame_id,
+     *                   dst_frame_id) = (parent, child)
+     * @param previous the graph built before, if any, whose topology is
+     *                 reused when the frames did not change
+     * @param history_size the number of transforms kept for each edge
+     */
+    FrameGraph(std::vector<yarp::math::FrameTransform> transforms, const FrameGraph* previous, size_t history_size);
+
+    const std::vector<yarp::math::FrameTransform>& transforms() const { return m_transforms; }
+
+    /**
+     * @return the id of a frame, -1 if it does not exist
+     */
+    int id(const std::string& frame_id) const;
+
+    const std::string& name(int id) const { return m_topology->names[id]; }
+    int parent(int id) const { return m_topology->parent[id]; }
+    size_t frameCount() const { return m_topology ? m_topology->names.size() : 0; }
+
+    /**
+     * @return true if a transform from source_frame_id to target_frame_id
+     *         was received
+     */
+    bool hasTransform(const std::string& target_frame_id, const std::string& source_frame_id) const;
+
+    /**
+     * @return the path between two frames, computed once for each topology
+     */
+    const Path& path(int target, int source) const;
+
+    /**
+     * Compute the transform from source to target along a path.
+     */
+    yarp::sig::Matrix transform(const Path& path) const;
+
+    /**
+     * Compute the transform from source to target along a path, at a given
+     * time, interpolating the history of each edge.
+     *
+     * @return false if the time is too old for the history of an edge
+     */
+    bool transform(const Path& path, double time, yarp::sig::Matrix& transform) const;
+
+private:
+    struct Topology
+    {
+        std::unordered_map<std::string, int> ids;
+        std::vector<std::string> names;
+        std::vector<int> parent;                                ///< -1 for roots
+        std::vector<int> depth;
+        std::vector<int> edge;                                  ///< index of the transform from the parent
+        std::vector<std::pair<std::string, std::string>> frames; ///< (src, dst) of each transform
+
+        mutable std::shared_timed_mutex mutex;
+        mutable std::unordered_map<std::uint64_t, std::unique_ptr<Path>> paths;
+    };
+
+    bool sameFrames(const std::vector<yarp::math::FrameTransform>& transforms) const;
+    void buildTopology();
+    yarp::sig::Matrix chain(const std::vector<int>& frames) const;
+    bool chain(const std::vector<int>& frames, double time, yarp::sig::Matrix& m) const;
+
+    std::shared_ptr<const Topology> m_topology;
+    std::vector<yarp::math::FrameTransform> m_transforms;
+    std::vector<yarp::sig::Matrix> m_matrices; ///< the transform from the parent of each frame
+    std::vector<std::shared_ptr<FrameTransformHistory>> m_histories; ///< the history of the transform from the parent of each frame
+};
+
+#endif // YARP_DEV_FRAMEGRAPH_H
@@ -21,6 +21,7 @@
 #include <yarp/os/LogComponent.h>
 #include <yarp/os/LogStream.h>
 #include <yarp/math/Math.h>
+#include <algorithm>
 #include <mutex>
 
 /*! \file FrameTransformClient.cpp */
@@ -86,7 +87,7 @@ void Transforms_client_storage::onRead(yarp::os::Bottle &b)
     {
         m_state = IFrameTransform::TRANSFORM_OK;
 
-        m_transforms.clear();
+        std::vector<FrameTransform> transforms;
         int bsize= b.size();
         for (int i = 0; i < bsize; i++)
         {
@@ -105,9 +106,12 @@ void Transforms_client_storage::onRead(yarp::os::Bottle &b)
                 t.rotation.x() = bt->get(7).asFloat64();
                 t.rotation.y() = bt->get(8).asFloat64();
                 t.rotation.z() = bt->get(9).asFloat64();
-                m_transforms.push_back(t);
+                transforms.push_back(t);
             }
         }
+        // Publish a new graph, the readers keep using the previous one
+        // until they are done
+        std::atomic_store(&m_graph, std::shared_ptr<const FrameGraph>(std::make_shared<FrameGraph>(std::move(transforms), m_graph.get(), m_history_size)));
     }
     else
     {
@@ -158,17 +162,19 @@ void Transforms_client_storage::getEstFrequency(int &ite, double &av, double &mi
 void Transforms_client_storage::clear()
 {
     std::lock_guard<std::recursive_mutex> l(m_mutex);
-    m_transforms.clear();
+    std::atomic_store(&m_graph, std::make_shared<const FrameGraph>());
 }
 
-Transforms_client_storage::Transforms_client_storage(std::string local_streaming_name)
+Transforms_client_storage::Transforms_client_storage(std::string local_streaming_name, size_t history_size)
 {
     m_count = 0;
+    m_history_size = history_size;
     m_deltaT = 0;
     m_deltaTMax = 0;
     m_deltaTMin = 1e22;
     m_now = Time::now();
     m_prev = m_now;
+    m_graph = std::make_shared<const FrameGraph>();
 
     if (!this->open(local_streaming_name))
     {
@@ -183,18 +189,11 @@ Transforms_client_storage::~Transforms_client_storage()
     this->close();
 }
 
-size_t   Transforms_client_storage::size()
+std::shared_ptr<const FrameGraph> Transforms_client_storage::graph() const
 {
-    std::lock_guard<std::recursive_mutex> l(m_mutex);
-    return m_transforms.size();
+    return std::atomic_load(&m_graph);
 }
 
-yarp::math::FrameTransform& Transforms_client_storage::operator[]   (std::size_t idx)
-{
-    std::lock_guard<std::recursive_mutex> l(m_mutex);
-    return m_transforms[idx];
-};
-
 //------------------------------------------------------------------------------------------------------------------------------
 bool FrameTransformClient::read(yarp::os::ConnectionReader& connection)
 {
@@ -441,7 +440,19 @@ bool FrameTransformClient::open(yarp::os::Searchable &config)
         return false;
     }
 
-    m_transform_storage = new Transforms_client_storage(m_local_streaming_name);
+    size_t history_size = DEFAULT_HISTORY_SIZE;
+    if (config.check("history_size"))
+    {
+        int size = config.find("history_size").asInt32();
+        if (size < 1)
+        {
+            yCError(FRAMETRANSFORMCLIENT, "open(): Invalid history_size %d", size);
+            return false;
+        }
+        history_size = static_cast<size_t>(size);
+    }
+
+    m_transform_storage = new Transforms_client_storage(m_local_streaming_name, history_size);
     bool ok = Network::connect(m_remote_streaming_name.c_str(), m_local_streaming_name.c_str(), m_streaming_connection_type.c_str());
     if (!ok)
     {
@@ -475,69 +486,26 @@ bool FrameTransformClient::close()
 
 bool FrameTransformClient::allFramesAsString(std::string &all_frames)
 {
-    for (size_t i = 0; i < m_transform_storage->size(); i++)
+    auto graph = m_transform_storage->graph();
+    for (const auto& t : graph->transforms())
     {
-        all_frames += (*m_transform_storage)[i].toString() + " ";
+        all_frames += t.toString() + " ";
     }
     return true;
 }
 
-FrameTransformClient::ConnectionType FrameTransformClient::getConnectionType(const std::string &target_frame, const std::string &source_frame, std::string* commonAncestor = nullptr)
+bool FrameTransformClient::canTransform(const std::string &target_frame, const std::string &source_frame)
 {
-    if (target_frame == source_frame) {return IDENTITY;}
-
-    Transforms_client_storage& tfVec = *m_transform_storage;
-    size_t                     i, j;
-    std::vector<std::string>   tar2root_vec;
-    std::vector<std::string>   src2root_vec;
-    std::string                ancestor, child;
-    child = target_frame;
-    std::lock_guard<std::recursive_mutex> l(tfVec.m_mutex);
-    while(getParent(child, ancestor))
-    {
-        if(ancestor == source_frame)
-        {
-            return DIRECT;
-        }
-
-        tar2root_vec.push_back(ancestor);
-        child = ancestor;
-    }
-    child = source_frame;
-    while(getParent(child, ancestor))
-    {
-        if(ancestor == target_frame)
-        {
-            return INVERSE;
-        }
-
-        src2root_vec.push_back(ancestor);
-        child = ancestor;
-    }
+    if (target_frame == source_frame) {return true;}
 
-    for(i = 0; i < tar2root_vec.size(); i++)
+    auto graph = m_transform_storage->graph();
+    int target = graph->id(target_frame);
+    int source = graph->id(source_frame);
+    if (target < 0 || source < 0)
     {
-        std::string a;
-        a = tar2root_vec[i];
-        for(j = 0; j < src2root_vec.size(); j++)
-        {
-            if(a == src2root_vec[j])
-            {
-                if(commonAncestor)
-                {
-                    *commonAncestor = a;
-                }
-                return UNDIRECT;
-            }
-        }
+        return false;
     }
-
-    return DISCONNECTED;
-}
-
-bool FrameTransformClient::canTransform(const std::string &target_frame, const std::string &source_frame)
-{
-    return getConnectionType(target_frame, source_frame) != DISCONNECTED;
+    return graph->path(target, source).connected;
 }
 
 bool FrameTransformClient::clear()
@@ -567,34 +535,20 @@ bool FrameTransformClient::clear()
 
 bool FrameTransformClient::frameExists(const std::string &frame_id)
 {
-    for (size_t i = 0; i < m_transform_storage->size(); i++)
-    {
-        if (((*m_transform_storage)[i].src_frame_id) == frame_id) { return true; }
-        if (((*m_transform_storage)[i].dst_frame_id) == frame_id) { return true; }
-    }
-    return false;
+    return m_transform_storage->graph()->id(frame_id) >= 0;
 }
 
 bool FrameTransformClient::getAllFrameIds(std::vector< std::string > &ids)
 {
-    for (size_t i = 0; i < m_transform_storage->size(); i++)
+    auto graph = m_transform_storage->graph();
+    for (const auto& t : graph->transforms())
     {
-        bool found = false;
-        for (const auto& id : ids)
-        {
-            if (((*m_transform_storage)[i].src_frame_id) == id) { found = true; break; }
-        }
-        if (found == false) ids.push_back((*m_transform_storage)[i].src_frame_id);
+        if (std::find(ids.begin(), ids.end(), t.src_frame_id) == ids.end()) ids.push_back(t.src_frame_id);
     }
 
-    for (size_t i = 0; i < m_transform_storage->size(); i++)
+    for (const auto& t : graph->transforms())
     {
-        bool found = false;
-        for (const auto& id : ids)
-        {
-            if (((*m_transform_storage)[i].dst_frame_id) == id) { found = true; break; }
-        }
-        if (found == false) ids.push_back((*m_transform_storage)[i].dst_frame_id);
+        if (std::find(ids.begin(), ids.end(), t.dst_frame_id) == ids.end()) ids.push_back(t.dst_frame_id);
     }
 
     return true;
@@ -602,99 +556,72 @@ bool FrameTransformClient::getAllFrameIds(std::vector< std::string > &ids)
 
 bool FrameTransformClient::getParent(const std::string &frame_id, std::string &parent_frame_id)
 {
-    for (size_t i = 0; i < m_transform_storage->size(); i++)
+    auto graph = m_transform_storage->graph();
+    int id = graph->id(frame_id);
+    if (id < 0 || graph->parent(id) < 0)
     {
-        std::string par((*m_transform_storage)[i].dst_frame_id);
-        if (((*m_transform_storage)[i].dst_frame_id == frame_id))
-        {
-
-            parent_frame_id = (*m_transform_storage)[i].src_frame_id;
-            return true;
-        }
+        return false;
     }
-    return false;
+    parent_frame_id = graph->name(graph->parent(id));
+    return true;
 }
 
 bool FrameTransformClient::canExplicitTransform(const std::string& target_frame_id, const std::string& source_frame_id) const
 {
-    Transforms_client_storage& tfVec = *m_transform_storage;
-    size_t                     i, tfVec_size;
-    std::lock_guard<std::recursive_mutex>         l(tfVec.m_mutex);
-
-    tfVec_size = tfVec.size();
-    for (i = 0; i < tfVec_size; i++)
-    {
-        if (tfVec[i].dst_frame_id == target_frame_id && tfVec[i].src_frame_id == source_frame_id)
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_transform_storage->graph()->hasTransform(target_frame_id, source_frame_id);
 }
 
-bool FrameTransformClient::getChainedTransform(const std::string& target_frame_id, const std::string& source_frame_id, yarp::sig::Matrix& transform) const
+bool FrameTransformClient::getTransform(const std::string& target_frame_id, const std::string& source_frame_id, yarp::sig::Matrix& transform)
 {
-    Transforms_client_storage& tfVec = *m_transform_storage;
-    size_t                     i, tfVec_size;
-    std::lock_guard<std::recursive_mutex>         l(tfVec.m_mutex);
+    if (target_frame_id == source_frame_id)
+    {
+        yarp::sig::Matrix tmp(4, 4); tmp.eye();
+        transform = tmp;
+        return true;
+    }
 
-    tfVec_size = tfVec.size();
-    for (i = 0; i < tfVec_size; i++)
+    // The frames, the transforms and the path are all taken from the same
+    // graph, even if new transforms are received in the meantime
+    auto graph = m_transform_storage->graph();
+    int target = graph->id(target_frame_id);
+    int source = graph->id(source_frame_id);
+    if (target >= 0 && source >= 0)
     {
-        if (tfVec[i].dst_frame_id == target_frame_id)
+        const FrameGraph::Path& path = graph->path(target, source);
+        if (path.connected)
         {
-            if (tfVec[i].src_frame_id == source_frame_id)
-            {
-                transform = tfVec[i].toMatrix();
-                return true;
-            }
-            else
-            {
-                yarp::sig::Matrix m;
-                if (getChainedTransform(tfVec[i].src_frame_id, source_frame_id, m))
-                {
-                    transform = m * tfVec[i].toMatrix();
-                    return true;
-                }
-            }
+            transform = graph->transform(path);
+            return true;
         }
     }
+
+    yCError(FRAMETRANSFORMCLIENT) << "getTransform(): Frames " << source_frame_id << " and " << target_frame_id << " are not connected";
     return false;
 }
 
-bool FrameTransformClient::getTransform(const std::string& target_frame_id, const std::string& source_frame_id, yarp::sig::Matrix& transform)
+bool FrameTransformClient::getTransform(const std::string& target_frame_id, const std::string& source_frame_id, double time, yarp::sig::Matrix& transform)
 {
-    ConnectionType ct;
-    std::string    ancestor;
-    ct = getConnectionType(target_frame_id, source_frame_id, &ancestor);
-    if (ct == DIRECT)
+    if (target_frame_id == source_frame_id)
     {
-        return getChainedTransform(target_frame_id, source_frame_id, transform);
-    }
-    else if (ct == INVERSE)
-    {
-        yarp::sig::Matrix m(4, 4);
-        getChainedTransform(source_frame_id, target_frame_id, m);
-        transform = yarp::math::SE3inv(m);
+        yarp::sig::Matrix tmp(4, 4); tmp.eye();
+        transform = tmp;
         return true;
     }
-    else if(ct == UNDIRECT)
+
+    auto graph = m_transform_storage->graph();
+    int target = graph->id(target_frame_id);
+    int source = graph->id(source_frame_id);
+    if (target < 0 || source < 0 || !graph->path(target, source).connected)
     {
-        yarp::sig::Matrix root2tar(4, 4), root2src(4, 4);
-        getChainedTransform(source_frame_id, ancestor, root2src);
-        getChainedTransform(target_frame_id, ancestor, root2tar);
-        transform = yarp::math::SE3inv(root2src) * root2tar;
-        return true;
+        yCError(FRAMETRANSFORMCLIENT) << "getTransform(): Frames " << source_frame_id << " and " << target_frame_id << " are not connected";
+        return false;
     }
-    else if (ct == IDENTITY)
+    if (!graph->transform(graph->path(target, source), time, transform))
     {
-        yarp::sig::Matrix tmp(4, 4); tmp.eye();
-        transform = tmp;
-        return true;
+        yCError(FRAMETRANSFORMCLIENT) << "getTransform(): No transform between " << source_frame_id << " and " << target_frame_id << " at time " << time;
+        return false;
     }
-
-    yCError(FRAMETRANSFORMCLIENT) << "getTransform(): Frames " << source_frame_id << " and " << target_frame_id << " are not connected";
-    return false;
+    return true;
 }
 
 bool FrameTransformClient::setTransform(const std::string& target_frame_id, const std::string& source_frame_id, const yarp::sig::Matrix& transform)
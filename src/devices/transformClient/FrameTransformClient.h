@@ -33,12 +33,16 @@
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/math/FrameTransform.h>
 #include <yarp/os/PeriodicThread.h>
+#include <memory>
 #include <mutex>
 
+#include "FrameGraph.h"
+
 
 #define DEFAULT_THREAD_PERIOD 20 //ms
 const int TRANSFORM_TIMEOUT_MS = 100; //ms
 const int MAX_PORTS = 5;
+const size_t DEFAULT_HISTORY_SIZE = 100;
 
 
 class Transforms_client_storage :
@@ -54,17 +58,18 @@ private:
     double           m_now;
     int              m_state;
     int              m_count;
+    size_t           m_history_size;
 
-    std::vector <yarp::math::FrameTransform> m_transforms;
+    // Replaced, never modified, when new transforms are received
+    std::shared_ptr<const FrameGraph> m_graph;
 
 public:
     std::recursive_mutex  m_mutex;
-    size_t   size();
-    yarp::math::FrameTransform& operator[]   (std::size_t idx);
+    std::shared_ptr<const FrameGraph> graph() const;
     void clear();
 
 public:
-    Transforms_client_storage (std::string port_name);
+    Transforms_client_storage (std::string port_name, size_t history_size = DEFAULT_HISTORY_SIZE);
     ~Transforms_client_storage ( );
     bool     set_transform(yarp::math::FrameTransform t);
     bool     delete_transform(std::string t1, std::string t2);
@@ -91,12 +96,7 @@ class FrameTransformClient :
         public yarp::os::PeriodicThread
 {
 private:
-    enum ConnectionType {DISCONNECTED = 0, DIRECT, INVERSE, UNDIRECT, IDENTITY};
-
-    FrameTransformClient::ConnectionType getConnectionType(const std::string &target_frame, const std::string &source_frame, std::string* commonAncestor);
-
     bool canExplicitTransform(const std::string& target_frame_id, const std::string& source_frame_id) const;
-    bool getChainedTransform(const std::string &target_frame_id, const std::string &source_frame_id, yarp::sig::Matrix &transform) const;
 
 protected:
 
@@ -145,6 +145,7 @@ public:
      bool     getAllFrameIds(std::vector< std::string > &ids) override;
      bool     getParent(const std::string &frame_id, std::string &parent_frame_id) override;
      bool     getTransform(const std::string &target_frame_id, const std::string &source_frame_id, yarp::sig::Matrix &transform) override;
+     bool     getTransform(const std::string &target_frame_id, const std::string &source_frame_id, double time, yarp::sig::Matrix &transform) override;
      bool     setTransform(const std::string &target_frame_id, const std::string &source_frame_id, const yarp::sig::Matrix &transform) override;
      bool     setTransformStatic(const std::string &target_frame_id, const std::string &source_frame_id, const yarp::sig::Matrix &transform) override;
      bool     deleteTransform(const std::string &target_frame_id, const std::string &source_frame_id) override;
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "FrameTransformHistory.h"
+
+#include <mutex>
+
+using yarp::math::FrameTransform;
+using yarp::math::Quaternion;
+
+FrameTransformHistory::FrameTransformHistory(size_t capacity) :
+        m_samples(capacity > 0 ? capacity : 1)
+{
+}
+
+void FrameTransformHistory::add(const FrameTransform& t)
+{
+    std::unique_lock<std::shared_timed_mutex> lock(m_mutex);
+    if (m_count > 0 && t.timestamp <= at(m_count - 1).timestamp)
+    {
+        return;
+    }
+    if (m_count < m_samples.size())
+    {
+        m_samples[(m_first + m_count) % m_samples.size()] = t;
+        m_count++;
+    }
+    else
+    {
+        m_samples[m_first] = t;
+        m_first = (m_first + 1) % m_samples.size();
+    }
+}
+
+bool FrameTransformHistory::get(double time, FrameTransform& t) const
+{
+    std::shared_lock<std::shared_timed_mutex> lock(m_mutex);
+    if (m_count == 0)
+    {
+        return false;
+    }
+    const FrameTransform& latest = at(m_count - 1);
+    if (m_count == 1 || time >= latest.timestamp)
+    {
+        t = latest;
+        return true;
+    }
+    if (time < at(0).timestamp)
+    {
+        return false;
+    }
+
+    // The first sample not older than time
+    size_t lo = 0;
+    size_t hi = m_count - 1;
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+        if (at(mid).timestamp < time)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    const FrameTransform& t1 = at(lo);
+    if (lo == 0 || t1.timestamp == time)
+    {
+        t = t1;
+        return true;
+    }
+    const FrameTransform& t0 = at(lo - 1);
+
+    double r = (time - t0.timestamp) / (t1.timestamp - t0.timestamp);
+    t.src_frame_id = t1.src_frame_id;
+    t.dst_frame_id = t1.dst_frame_id;
+    t.timestamp = time;
+    t.translation.set(t0.translation.tX + r * (t1.translation.tX - t0.translation.tX),
+                      t0.translation.tY + r * (t1.translation.tY - t0.translation.tY),
+                      t0.translation.tZ + r * (t1.translation.tZ - t0.translation.tZ));
+    t.rotation = Quaternion::slerp(t0.rotation, t1.rotation, r);
+    return true;
+}
+
+size_t FrameTransformHistory::size() const
+{
+    std::shared_lock<std::shared_timed_mutex> lock(m_mutex);
+    return m_count;
+}
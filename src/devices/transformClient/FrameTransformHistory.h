@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef YARP_DEV_FRAMETRANSFORMHISTORY_H
+#define YARP_DEV_FRAMETRANSFORMHISTORY_H
+
+#include <yarp/math/FrameTransform.h>
+
+#include <shared_mutex>
+#include <vector>
+
+/**
+ * The last transforms received for an edge of the frame graph, ordered by
+ * timestamp, in a ring buffer of fixed capacity.
+ *
+ * The transform at a given time is interpolated between the two samples
+ * around it: linearly for the translation, and with a spherical linear
+ * interpolation for the rotation.
+ */
+class FrameTransformHistory
+{
+public:
+    explicit FrameTransformHistory(size_t capacity);
+
+    /**
+     * Add a sample, if newer than the latest one.  When the buffer is full,
+     * the oldest sample is dropped.
+     */
+    void add(const yarp::math::FrameTransform& t);
+
+    /**
+     * Get the transform at a given time.
+     *
+     * A time after the latest sample gives the latest sample, and so does
+     * any time if there is a single sample (e.g. a static transform).
+     *
+     * @return false if the time is before the oldest sample kept
+     */
+    bool get(double time, yarp::math::FrameTransform& t) const;
+
+    size_t size() const;
+
+private:
+    const yarp::math::FrameTransform& at(size_t i) const
+    {
+        return m_samples[(m_first + i) % m_samples.size()];
+    }
+
+    mutable std::shared_timed_mutex m_mutex;
+    std::vector<yarp::math::FrameTransform> m_samples;
+    size_t m_first {0};
+    size_t m_count {0};
+};
+
+#endif // YARP_DEV_FRAMETRANSFORMHISTORY_H
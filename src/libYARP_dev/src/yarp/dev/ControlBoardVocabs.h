@@ -39,4 +39,7 @@ constexpr yarp::conf::vocab32_t VOCAB_VELOCITY_MOVES = yarp::os::createVocab('v'
 // protocol version
 constexpr yarp::conf::vocab32_t VOCAB_PROTOCOL_VERSION = yarp::os::createVocab('p', 'r', 'o', 't');
 
+// several rpc requests in a single message
+constexpr yarp::conf::vocab32_t VOCAB_BATCH = yarp::os::createVocab('b', 't', 'c', 'h');
+
 #endif // YARP_DEV_CONTROLBOARDVOCABS_H
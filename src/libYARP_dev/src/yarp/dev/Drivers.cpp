@@ -21,6 +21,7 @@
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/ServiceInterfaces.h>
 
+#include <mutex>
 #include <vector>
 #include <sstream>
 #include <iterator>
@@ -36,6 +37,7 @@ YARP_LOG_COMPONENT(DRIVERS, "yarp.dev.Drivers")
 class Drivers::Private : public YarpPluginSelector {
 public:
     std::vector<DriverCreator *> delegates;
+    std::recursive_mutex mutex; // devices can be opened by several threads
 
     ~Private() override {
         for (auto& delegate : delegates) {
@@ -52,6 +54,7 @@ public:
     }
 
     std::string toString() {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
         std::string s;
         Property done;
         for (auto& delegate : delegates) {
@@ -134,6 +137,7 @@ public:
     }
 
     void add(DriverCreator *creator) {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
         if (creator!=nullptr) {
             delegates.push_back(creator);
         }
@@ -142,6 +146,7 @@ public:
     DriverCreator *load(const char *name);
 
     DriverCreator *find(const char *name) {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
         for (auto& delegate : delegates) {
             if (delegate == nullptr) {
                 continue;
@@ -155,6 +160,7 @@ public:
     }
 
     bool remove(const char *name) {
+        std::lock_guard<std::recursive_mutex> lock(mutex);
         for (auto& delegate : delegates) {
             if (delegate == nullptr) {
                 continue;
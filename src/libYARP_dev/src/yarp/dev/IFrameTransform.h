@@ -97,6 +97,25 @@ public:
     */
     virtual bool     getTransform (const std::string &target_frame_id, const std::string &source_frame_id, yarp::sig::Matrix &transform) = 0;
 
+    /**
+     Get the transform between two frames at a given time, interpolating the transforms received around it.
+    * @param target_frame_id the name of target reference frame
+    * @param source_frame_id the name of source reference frame
+    * @param time the time of the transform, as given by yarp::os::Time::now()
+    * @param transform the transformation matrix from source_frame_id to target_frame_id
+    * @return true/false (e.g. if the time is older than the transforms kept)
+    * @note The default implementation returns false, for the devices that
+    *       do not keep the transforms received.
+    */
+    virtual bool     getTransform (const std::string &target_frame_id, const std::string &source_frame_id, double time, yarp::sig::Matrix &transform)
+    {
+        YARP_UNUSED(target_frame_id);
+        YARP_UNUSED(source_frame_id);
+        YARP_UNUSED(time);
+        YARP_UNUSED(transform);
+        return false;
+    }
+
     /**
      Register a transform between two frames.
      * @param target_frame_id the name of target reference frame
@@ -34,30 +34,26 @@ void LogEntry::clear_logEntries()
 {
     entry_list.clear();
     logInfo.clear();
-    last_read_message=-1;
+    last_read_message=0;
 }
 
 void LogEntry::setLogEntryMaxSize(int size)
 {
-    entry_list_max_size = size;
-    entry_list.reserve(entry_list_max_size);
+    entry_list.setMaxSize(size > 0 ? size : 0);
     clear_logEntries();
 }
 
 void LogEntry::setLogEntryMaxSizeEnabled (bool enable)
 {
-    entry_list_max_size_enabled=enable;
+    entry_list.setMaxSizeEnabled(enable);
+    logInfo.logsize = entry_list.size();
 }
 
-bool LogEntry::append_logEntry(MessageEntry entry)
+bool LogEntry::append_logEntry(const MessageEntry& entry, impl::StringPool& pool)
 {
-    if (logInfo.logsize >= entry_list_max_size && entry_list_max_size_enabled)
-    {
-        //printf("WARNING: exceeded entry_list_max_size=%d\n",entry_list_max_size);
-        return false;
-    }
-    entry_list.push_back(entry);
-    logInfo.logsize++;
+    // When the list is full, the oldest messages are dropped
+    entry_list.append(entry, pool);
+    logInfo.logsize = entry_list.size();
     return true;
 }
 
@@ -158,19 +154,10 @@ void LoggerEngine::discover  (std::list<std::string>& ports)
         getline(iss, token, '/'); entry.logInfo.process_name = token;
         getline(iss, token, '/'); entry.logInfo.process_pid  = token;
 
-        std::list<LogEntry>::iterator it;
         this->log_updater->mutex.lock();
-        bool found = false;
-        for (it = this->log_updater->log_list.begin(); it != log_updater->log_list.end(); it++)
-        {
-            if (it->logInfo.port_complete==entry.logInfo.port_complete)
-            {
-                found=true; break;
-            }
-        }
-        if (found==false)
+        if (log_updater->find_entry(log_updater->by_port_complete, entry.logInfo.port_complete) == nullptr)
         {
-            log_updater->log_list.push_back(entry);
+            log_updater->add_entry(entry);
         }
         this->log_updater->mutex.unlock();
     }
@@ -201,6 +188,35 @@ std::string LoggerEngine::logger_thread::getPortName()
     return logger_portName;
 }
 
+LogEntry* LoggerEngine::logger_thread::add_entry(const LogEntry& entry)
+{
+    log_list.push_back(entry);
+    LogEntry* added = &log_list.back();
+    added->entry_list.setSpill(&spill, added->logInfo.port_complete);
+    // The queries by prefix, process and pid return the first entry found
+    by_port_complete.emplace(added->logInfo.port_complete, added);
+    by_port_prefix.emplace(added->logInfo.port_prefix, added);
+    by_process.emplace(added->logInfo.process_name, added);
+    by_pid.emplace(added->logInfo.process_pid, added);
+    return added;
+}
+
+LogEntry* LoggerEngine::logger_thread::find_entry(const std::unordered_map<std::string, LogEntry*>& index, const std::string& key)
+{
+    auto it = index.find(key);
+    return (it != index.end()) ? it->second : nullptr;
+}
+
+void LoggerEngine::logger_thread::clear_entries()
+{
+    by_port_complete.clear();
+    by_port_prefix.clear();
+    by_process.clear();
+    by_pid.clear();
+    log_list.clear();
+    string_pool.clear();
+}
+
 LoggerEngine::logger_thread::logger_thread (std::string _portname, double _period,  int _log_list_max_size) : PeriodicThread(_period, ShouldUseSystemClock::Yes)
 {
         logger_portName              = _portname;
@@ -249,7 +265,7 @@ void LoggerEngine::logger_thread::run()
                 return;
             }
 
-            if (b->size()!=2)
+            if (b->size()<2)
             {
                 fprintf (stderr, "ERROR: unknown log format!\n");
                 unknown_format_received++;
@@ -270,227 +286,225 @@ void LoggerEngine::logger_thread::run()
                 continue;
             }
 
-            MessageEntry body;
-
-            char ttstr [20];
-            static int count=0;
-            sprintf(ttstr,"%d",count++);
-            body.yarprun_timestamp = string(ttstr);
-            body.local_timestamp   = machine_current_time_s;
-
-            std::string s;
-
-            if (b->get(1).isString())
+            // The log forwarder can send several messages in the same
+            // bottle: [port] message1 message2 ...
+            for (size_t i = 1; i < b->size(); i++)
             {
-                s = b->get(1).asString();
-            }
-            else
-            {
-                fprintf(stderr, "ERROR: unknown log format!\n");
-                unknown_format_received++;
-                continue;
+                if (!b->get(i).isString())
+                {
+                    fprintf(stderr, "ERROR: unknown log format!\n");
+                    unknown_format_received++;
+                    continue;
+                }
+                process_message(header, b->get(i).asString(), machine_current_time, machine_current_time_s);
             }
+        }
+    }
 
-            yarp::os::Property p(s.c_str());
-
-            if (p.check("level")) {
-                body.text = p.find("message").toString();
-
-                auto level = p.find("level").toString();
-                if (level == "TRACE") {
-                    body.level = LOGLEVEL_TRACE;
-                } else if (level == "DEBUG") {
-                    body.level = LOGLEVEL_DEBUG;
-                } else if (level == "INFO") {
-                    body.level = LOGLEVEL_INFO;
-                } else if (level == "WARNING") {
-                    body.level = LOGLEVEL_WARNING;
-                } else if (level == "ERROR") {
-                    body.level = LOGLEVEL_ERROR;
-                } else if (level == "FATAL") {
-                    body.level = LOGLEVEL_FATAL;
-                } else {
-                    body.level = LOGLEVEL_UNDEFINED;
-                }
+}
 
-                if (p.check("filename")) {
-                    body.filename = p.find("filename").asString();
-                } else {
-                    body.filename.clear();
-                }
+void LoggerEngine::logger_thread::process_message(const std::string& header, const std::string& s, std::time_t machine_current_time, const std::string& machine_current_time_s)
+{
+    MessageEntry body;
+
+    char ttstr [20];
+    static int count=0;
+    sprintf(ttstr,"%d",count++);
+    body.yarprun_timestamp = string(ttstr);
+    body.local_timestamp   = machine_current_time_s;
+
+    yarp::os::Property p(s.c_str());
+
+    if (p.check("level")) {
+        body.text = p.find("message").toString();
+
+        auto level = p.find("level").toString();
+        if (level == "TRACE") {
+            body.level = LOGLEVEL_TRACE;
+        } else if (level == "DEBUG") {
+            body.level = LOGLEVEL_DEBUG;
+        } else if (level == "INFO") {
+            body.level = LOGLEVEL_INFO;
+        } else if (level == "WARNING") {
+            body.level = LOGLEVEL_WARNING;
+        } else if (level == "ERROR") {
+            body.level = LOGLEVEL_ERROR;
+        } else if (level == "FATAL") {
+            body.level = LOGLEVEL_FATAL;
+        } else {
+            body.level = LOGLEVEL_UNDEFINED;
+        }
 
-                if (p.check("line")) {
-                    body.line = static_cast<uint32_t>(p.find("line").asInt32());
-                } else {
-                    body.line = 0;
-                }
+        if (p.check("filename")) {
+            body.filename = p.find("filename").asString();
+        } else {
+            body.filename.clear();
+        }
 
-                if (p.check("function")) {
-                    body.function = p.find("function").asString();
-                } else {
-                    body.function.clear();
-                }
+        if (p.check("line")) {
+            body.line = static_cast<uint32_t>(p.find("line").asInt32());
+        } else {
+            body.line = 0;
+        }
 
-                if (p.check("hostname")) {
-                    body.hostname = p.find("hostname").asString();
-                } else {
-                    body.hostname.clear();
-                }
+        if (p.check("function")) {
+            body.function = p.find("function").asString();
+        } else {
+            body.function.clear();
+        }
 
-                if (p.check("pid")) {
-                    body.pid = p.find("pid").asInt32();
-                } else {
-                    body.pid = 0;
-                }
+        if (p.check("hostname")) {
+            body.hostname = p.find("hostname").asString();
+        } else {
+            body.hostname.clear();
+        }
 
-                if (p.check("cmd")) {
-                    body.cmd = p.find("cmd").asString();
-                } else {
-                    body.cmd.clear();
-                }
+        if (p.check("pid")) {
+            body.pid = p.find("pid").asInt32();
+        } else {
+            body.pid = 0;
+        }
 
-                if (p.check("args")) {
-                    body.args = p.find("args").asString();
-                } else {
-                    body.args.clear();
-                }
+        if (p.check("cmd")) {
+            body.cmd = p.find("cmd").asString();
+        } else {
+            body.cmd.clear();
+        }
 
-                if (p.check("thread_id")) {
-                    body.thread_id = p.find("thread_id").asInt64();
-                } else {
-                    body.thread_id = 0;
-                }
+        if (p.check("args")) {
+            body.args = p.find("args").asString();
+        } else {
+            body.args.clear();
+        }
 
-                if (p.check("component")) {
-                    body.component = p.find("component").asString();
-                } else {
-                    body.component.clear();
-                }
+        if (p.check("thread_id")) {
+            body.thread_id = p.find("thread_id").asInt64();
+        } else {
+            body.thread_id = 0;
+        }
 
-                if (p.check("systemtime")) {
-                    body.systemtime = p.find("systemtime").asFloat64();
-                } else {
-                    body.systemtime = 0.0;
-                }
+        if (p.check("component")) {
+            body.component = p.find("component").asString();
+        } else {
+            body.component.clear();
+        }
 
-                if (p.check("networktime")) {
-                    body.networktime = p.find("networktime").asFloat64();
-                } else {
-                    body.networktime = body.systemtime;
-                    body.yarprun_timestamp.clear();
-                }
+        if (p.check("systemtime")) {
+            body.systemtime = p.find("systemtime").asFloat64();
+        } else {
+            body.systemtime = 0.0;
+        }
 
-                if (p.check("externaltime")) {
-                    body.externaltime = p.find("externaltime").asFloat64();
-                } else {
-                    body.externaltime = 0.0;
-                }
+        if (p.check("networktime")) {
+            body.networktime = p.find("networktime").asFloat64();
+        } else {
+            body.networktime = body.systemtime;
+            body.yarprun_timestamp.clear();
+        }
 
-                if (p.check("backtrace")) {
-                    body.backtrace = p.find("backtrace").asString();
-                } else {
-                    body.backtrace.clear();
-                }
-            } else {
-                // This is plain output forwarded by yarprun
-                // Perhaps at some point yarprun could be formatting it properly
-                // But for now we just try to extract the level information
-                body.text = s;
-                body.level = LOGLEVEL_UNDEFINED;
-
-                size_t str = s.find('[',0);
-                size_t end = s.find(']',0);
-                if (str==std::string::npos || end==std::string::npos )
-                {
-                    body.level = LOGLEVEL_UNDEFINED;
-                }
-                else if (str==0)
-                {
-                    std::string level = s.substr(str,end+1);
-                    body.level = LOGLEVEL_UNDEFINED;
-                    if      (level.find("TRACE")!=std::string::npos)   body.level = LOGLEVEL_TRACE;
-                    else if (level.find("DEBUG")!=std::string::npos)   body.level = LOGLEVEL_DEBUG;
-                    else if (level.find("INFO")!=std::string::npos)    body.level = LOGLEVEL_INFO;
-                    else if (level.find("WARNING")!=std::string::npos) body.level = LOGLEVEL_WARNING;
-                    else if (level.find("ERROR")!=std::string::npos)   body.level = LOGLEVEL_ERROR;
-                    else if (level.find("FATAL")!=std::string::npos)   body.level = LOGLEVEL_FATAL;
-                    body.text = s.substr(end+1);
-                }
-                else
-                {
-                    body.level = LOGLEVEL_UNDEFINED;
-                }
-            }
+        if (p.check("externaltime")) {
+            body.externaltime = p.find("externaltime").asFloat64();
+        } else {
+            body.externaltime = 0.0;
+        }
+
+        if (p.check("backtrace")) {
+            body.backtrace = p.find("backtrace").asString();
+        } else {
+            body.backtrace.clear();
+        }
+    } else {
+        // This is plain output forwarded by yarprun
+        // Perhaps at some point yarprun could be formatting it properly
+        // But for now we just try to extract the level information
+        body.text = s;
+        body.level = LOGLEVEL_UNDEFINED;
+
+        size_t str = s.find('[',0);
+        size_t end = s.find(']',0);
+        if (str==std::string::npos || end==std::string::npos )
+        {
+            body.level = LOGLEVEL_UNDEFINED;
+        }
+        else if (str==0)
+        {
+            std::string level = s.substr(str,end+1);
+            body.level = LOGLEVEL_UNDEFINED;
+            if      (level.find("TRACE")!=std::string::npos)   body.level = LOGLEVEL_TRACE;
+            else if (level.find("DEBUG")!=std::string::npos)   body.level = LOGLEVEL_DEBUG;
+            else if (level.find("INFO")!=std::string::npos)    body.level = LOGLEVEL_INFO;
+            else if (level.find("WARNING")!=std::string::npos) body.level = LOGLEVEL_WARNING;
+            else if (level.find("ERROR")!=std::string::npos)   body.level = LOGLEVEL_ERROR;
+            else if (level.find("FATAL")!=std::string::npos)   body.level = LOGLEVEL_FATAL;
+            body.text = s.substr(end+1);
+        }
+        else
+        {
+            body.level = LOGLEVEL_UNDEFINED;
+        }
+    }
 
-            if (body.level == LOGLEVEL_UNDEFINED && listen_to_LOGLEVEL_UNDEFINED == false) {continue;}
-            if (body.level == LOGLEVEL_TRACE     && listen_to_LOGLEVEL_TRACE     == false) {continue;}
-            if (body.level == LOGLEVEL_DEBUG     && listen_to_LOGLEVEL_DEBUG     == false) {continue;}
-            if (body.level == LOGLEVEL_INFO      && listen_to_LOGLEVEL_INFO      == false) {continue;}
-            if (body.level == LOGLEVEL_WARNING   && listen_to_LOGLEVEL_WARNING   == false) {continue;}
-            if (body.level == LOGLEVEL_ERROR     && listen_to_LOGLEVEL_ERROR     == false) {continue;}
-            if (body.level == LOGLEVEL_FATAL     && listen_to_LOGLEVEL_FATAL     == false) {continue;}
-
-            this->mutex.lock();
-            LogEntry entry;
-            entry.logInfo.port_complete = header;
-            entry.logInfo.port_complete.erase(0,1);
-            entry.logInfo.port_complete.erase(entry.logInfo.port_complete.size()-1);
-            std::istringstream iss(header);
-            std::string token;
-            getline(iss, token, '/');
-            getline(iss, token, '/'); entry.logInfo.port_system  = token;
-            getline(iss, token, '/'); entry.logInfo.port_prefix  = "/"+ token;
-            getline(iss, token, '/'); entry.logInfo.process_name = token;
-            getline(iss, token, '/'); entry.logInfo.process_pid  = token.erase(token.size()-1);
-            if (entry.logInfo.port_system == "log" && listen_to_YARP_MESSAGES==false)    continue;
-            if (entry.logInfo.port_system == "yarprunlog" && listen_to_YARPRUN_MESSAGES==false) continue;
-
-            std::list<LogEntry>::iterator it;
-            for (it = log_list.begin(); it != log_list.end(); it++)
+    if (body.level == LOGLEVEL_UNDEFINED && listen_to_LOGLEVEL_UNDEFINED == false) {return;}
+    if (body.level == LOGLEVEL_TRACE     && listen_to_LOGLEVEL_TRACE     == false) {return;}
+    if (body.level == LOGLEVEL_DEBUG     && listen_to_LOGLEVEL_DEBUG     == false) {return;}
+    if (body.level == LOGLEVEL_INFO      && listen_to_LOGLEVEL_INFO      == false) {return;}
+    if (body.level == LOGLEVEL_WARNING   && listen_to_LOGLEVEL_WARNING   == false) {return;}
+    if (body.level == LOGLEVEL_ERROR     && listen_to_LOGLEVEL_ERROR     == false) {return;}
+    if (body.level == LOGLEVEL_FATAL     && listen_to_LOGLEVEL_FATAL     == false) {return;}
+
+    this->mutex.lock();
+    LogEntry entry;
+    entry.logInfo.port_complete = header;
+    entry.logInfo.port_complete.erase(0,1);
+    entry.logInfo.port_complete.erase(entry.logInfo.port_complete.size()-1);
+    std::istringstream iss(header);
+    std::string token;
+    getline(iss, token, '/');
+    getline(iss, token, '/'); entry.logInfo.port_system  = token;
+    getline(iss, token, '/'); entry.logInfo.port_prefix  = "/"+ token;
+    getline(iss, token, '/'); entry.logInfo.process_name = token;
+    getline(iss, token, '/'); entry.logInfo.process_pid  = token.erase(token.size()-1);
+    if (entry.logInfo.port_system == "log" && listen_to_YARP_MESSAGES==false)    {this->mutex.unlock(); return;}
+    if (entry.logInfo.port_system == "yarprunlog" && listen_to_YARPRUN_MESSAGES==false) {this->mutex.unlock(); return;}
+
+    LogEntry* it = find_entry(by_port_complete, entry.logInfo.port_complete);
+    if (it != nullptr)
+    {
+        if (it->logging_enabled)
+        {
+            it->logInfo.setNewError(body.level);
+            it->logInfo.last_update=machine_current_time;
+            it->append_logEntry(body, string_pool);
+        }
+        else
+        {
+            //just skipping this message
+        }
+    }
+    else
+    {
+        if (log_list.size() < log_list_max_size || log_list_max_size_enabled==false )
+        {
+            yarp::os::Contact contact = yarp::os::Network::queryName(entry.logInfo.port_complete);
+            if (contact.isValid())
             {
-                if (it->logInfo.port_complete==entry.logInfo.port_complete)
-                {
-                    if (it->logging_enabled)
-                    {
-                        it->logInfo.setNewError(body.level);
-                        it->logInfo.last_update=machine_current_time;
-                        it->append_logEntry(body);
-                    }
-                    else
-                    {
-                        //just skipping this message
-                    }
-                    break;
-                }
+                entry.logInfo.setNewError(body.level);
+                entry.logInfo.ip_address = contact.getHost();
             }
-            if (it == log_list.end())
+            else
             {
-                if (log_list.size() < log_list_max_size || log_list_max_size_enabled==false )
-                {
-                    yarp::os::Contact contact = yarp::os::Network::queryName(entry.logInfo.port_complete);
-                    if (contact.isValid())
-                    {
-                        entry.logInfo.setNewError(body.level);
-                        entry.logInfo.ip_address = contact.getHost();
-                    }
-                    else
-                    {
-                        printf("ERROR: invalid contact: %s\n", entry.logInfo.port_complete.c_str());
-                    };
-                    entry.append_logEntry(body);
-                    entry.logInfo.last_update=machine_current_time;
-                    log_list.push_back(entry);
-                }
-                //else
-                //{
-                //    printf("WARNING: exceeded log_list_max_size=%d\n",log_list_max_size);
-                //}
-            }
-
-            this->mutex.unlock();
+                printf("ERROR: invalid contact: %s\n", entry.logInfo.port_complete.c_str());
+            };
+            entry.logInfo.last_update=machine_current_time;
+            add_entry(entry)->append_logEntry(body, string_pool);
         }
+        //else
+        //{
+        //    printf("WARNING: exceeded log_list_max_size=%d\n",log_list_max_size);
+        //}
     }
 
+    this->mutex.unlock();
 }
 
 //public methods
@@ -597,39 +611,29 @@ void LoggerEngine::get_messages (std::list<MessageEntry>& messages)
     std::list<LogEntry>::iterator it;
     for (it = log_updater->log_list.begin(); it != log_updater->log_list.end(); it++)
     {
-        messages.insert(messages.end(), it->entry_list.begin(), it->entry_list.end());
+        std::uint64_t cursor = 0;
+        it->entry_list.get(cursor, messages);
     }
     log_updater->mutex.unlock();
 }
 
+// Copies the messages of the entry not read yet, or all the messages
+static void read_new_messages(LogEntry* entry, std::list<MessageEntry>& messages, bool from_beginning)
+{
+    if (entry == nullptr) return;
+    if (from_beginning==true)
+    {
+        entry->last_read_message = 0;
+    }
+    entry->entry_list.get(entry->last_read_message, messages);
+}
+
 void LoggerEngine::get_messages_by_port_prefix    (std::string  port,  std::list<MessageEntry>& messages,  bool from_beginning)
 {
     if (log_updater == nullptr) return;
 
     log_updater->mutex.lock();
-    std::list<LogEntry>::iterator it;
-    for (it = log_updater->log_list.begin(); it != log_updater->log_list.end(); it++)
-    {
-        if (it->logInfo.port_prefix == port)
-        {
-            //messages = (it->entry_list);
-            if (it->last_read_message==-1)
-            {
-                from_beginning=true;
-            }
-            if (from_beginning==true)
-            {
-                it->last_read_message = 0;
-            }
-            int i=it->last_read_message;
-            for (; i<(int)it->entry_list.size(); i++)
-            {
-                messages.push_back(it->entry_list[i]);
-            }
-            it->last_read_message=i;
-            break;
-        }
-    }
+    read_new_messages(log_updater->find_entry(log_updater->by_port_prefix, port), messages, from_beginning);
     log_updater->mutex.unlock();
 }
 
@@ -638,14 +642,10 @@ void LoggerEngine::clear_messages_by_port_complete    (std::string  port)
     if (log_updater == nullptr) return;
 
     log_updater->mutex.lock();
-    std::list<LogEntry>::iterator it;
-    for (it = log_updater->log_list.begin(); it != log_updater->log_list.end(); it++)
+    LogEntry* entry = log_updater->find_entry(log_updater->by_port_complete, port);
+    if (entry != nullptr)
     {
-        if (it->logInfo.port_complete == port)
-           {
-               it->clear_logEntries();
-               break;
-           }
+        entry->clear_logEntries();
     }
     log_updater->mutex.unlock();
 }
@@ -655,30 +655,7 @@ void LoggerEngine::get_messages_by_port_complete    (std::string  port,  std::li
     if (log_updater == nullptr) return;
 
     log_updater->mutex.lock();
-    std::list<LogEntry>::iterator it;
-    for (it = log_updater->log_list.begin(); it != log_updater->log_list.end(); it++)
-    {
-        if (it->logInfo.port_complete == port)
-        {
-            //messages = (it->entry_list);
-            if (it->last_read_message==-1)
-            {
-                from_beginning=true;
-            }
-            if (from_beginning==true)
-            {
-                it->last_read_message = 0;
-            }
-            int i=it->last_read_message;
-            int size = (int)it->entry_list.size();
-            for (; i<size; i++)
-            {
-                messages.push_back(it->entry_list[i]);
-            }
-            it->last_read_message=i;
-            break;
-        }
-    }
+    read_new_messages(log_updater->find_entry(log_updater->by_port_complete, port), messages, from_beginning);
     log_updater->mutex.unlock();
 }
 
@@ -687,29 +664,7 @@ void LoggerEngine::get_messages_by_process (std::string  process,  std::list<Mes
     if (log_updater == nullptr) return;
 
     log_updater->mutex.lock();
-    std::list<LogEntry>::iterator it;
-    for (it = log_updater->log_list.begin(); it != log_updater->log_list.end(); it++)
-    {
-        if (it->logInfo.process_name == process)
-        {
-            //messages = (it->entry_list);
-            if (it->last_read_message==-1)
-            {
-                from_beginning=true;
-            }
-            if (from_beginning==true)
-            {
-                it->last_read_message = 0;
-            }
-            int i=it->last_read_message;
-            for (; i<(int)it->entry_list.size(); i++)
-            {
-                messages.push_back(it->entry_list[i]);
-            }
-            it->last_read_message=i;
-            break;
-        }
-    }
+    read_new_messages(log_updater->find_entry(log_updater->by_process, process), messages, from_beginning);
     log_updater->mutex.unlock();
 }
 
@@ -718,33 +673,33 @@ void LoggerEngine::get_messages_by_pid     (std::string pid, std::list<MessageEn
     if (log_updater == nullptr) return;
 
     log_updater->mutex.lock();
-    std::list<LogEntry>::iterator it;
-    for (it = log_updater->log_list.begin(); it != log_updater->log_list.end(); it++)
-    {
-        if (it->logInfo.process_pid == pid)
-        {
-            //messages = (it->entry_list);
-            if (it->last_read_message==-1)
-            {
-                from_beginning=true;
-            }
-            if (from_beginning==true)
-            {
-                it->last_read_message = 0;
-            }
-            int i=it->last_read_message;
-            for (; i<(int)it->entry_list.size(); i++)
-            {
-                messages.push_back(it->entry_list[i]);
-            }
-            it->last_read_message=i;
-            break;
-        }
-    }
+    read_new_messages(log_updater->find_entry(log_updater->by_pid, pid), messages, from_beginning);
     log_updater->mutex.unlock();
 }
 
-const std::list<MessageEntry> filter_by_level (int level, const std::list<MessageEntry>& messages)
+bool LoggerEngine::get_messages_since (std::string port, std::uint64_t& cursor, std::list<MessageEntry>& messages)
+{
+    if (log_updater == nullptr) return false;
+
+    std::lock_guard<std::mutex> lock(log_updater->mutex);
+    LogEntry* entry = log_updater->find_entry(log_updater->by_port_complete, port);
+    if (entry == nullptr) return false;
+    entry->entry_list.get(cursor, messages);
+    return true;
+}
+
+bool LoggerEngine::get_messages_by_level_since (std::string port, int level, std::uint64_t& cursor, std::list<MessageEntry>& messages)
+{
+    if (log_updater == nullptr) return false;
+
+    std::lock_guard<std::mutex> lock(log_updater->mutex);
+    LogEntry* entry = log_updater->find_entry(log_updater->by_port_complete, port);
+    if (entry == nullptr) return false;
+    entry->entry_list.getByLevel(level, cursor, messages);
+    return true;
+}
+
+std::list<MessageEntry> LoggerEngine::filter_by_level (int level, const std::list<MessageEntry>& messages)
 {
     std::list<MessageEntry> ret;
     std::list<MessageEntry>::const_iterator it;
@@ -819,21 +774,21 @@ bool LoggerEngine::export_log_to_text_file   (std::string  filename, std::string
     if (filename.size() == 0) return false;
 
     log_updater->mutex.lock();
-    std::list<LogEntry>::iterator it;
-    for (it = log_updater->log_list.begin(); it != log_updater->log_list.end(); it++)
+    LogEntry* it = log_updater->find_entry(log_updater->by_port_complete, portname);
+    if (it != nullptr)
     {
-        if (it->logInfo.port_complete == portname)
+        ofstream file1;
+        file1.open(filename.c_str());
+        if (file1.is_open() == false) {log_updater->mutex.unlock(); return false;}
+        std::list<MessageEntry> messages;
+        std::uint64_t cursor = 0;
+        it->entry_list.get(cursor, messages);
+        std::list<MessageEntry>::iterator it1;
+        for (it1 = messages.begin(); it1 != messages.end(); it1++)
         {
-            ofstream file1;
-            file1.open(filename.c_str());
-            if (file1.is_open() == false) {log_updater->mutex.unlock(); return false;}
-            std::vector<MessageEntry>::iterator it1;
-            for (it1 = it->entry_list.begin(); it1 != it->entry_list.end(); it1++)
-            {
-                file1 << it1->yarprun_timestamp << " " << it1->local_timestamp << " " << it1->level.toString() << " " << it1->text << " " << std::endl;
-            }
-            file1.close();
+            file1 << it1->yarprun_timestamp << " " << it1->local_timestamp << " " << it1->level.toString() << " " << it1->text << " " << std::endl;
         }
+        file1.close();
     }
     log_updater->mutex.unlock();
     return true;
@@ -873,9 +828,12 @@ bool LoggerEngine::save_all_logs_to_file   (std::string  filename)
         file1 << it->logInfo.get_number_of_errors() << std::endl;
         file1 << it->logInfo.get_number_of_fatals() << std::endl;
         file1 << it->logInfo.logsize << std::endl;
-        file1 << it->entry_list.size() << std::endl;
-        std::vector<MessageEntry>::iterator it1;
-        for (it1 = it->entry_list.begin(); it1 != it->entry_list.end(); it1++)
+        std::list<MessageEntry> messages;
+        std::uint64_t cursor = 0;
+        it->entry_list.get(cursor, messages);
+        file1 << messages.size() << std::endl;
+        std::list<MessageEntry>::iterator it1;
+        for (it1 = messages.begin(); it1 != messages.end(); it1++)
         {
             file1 << it1->yarprun_timestamp << std::endl;
             file1 << it1->local_timestamp << std::endl;
@@ -936,10 +894,12 @@ bool LoggerEngine::load_all_logs_from_file   (std::string  filename)
     {
         int size_log_list;
         file1 >> size_log_list;
-        log_updater->log_list.clear();
+        log_updater->clear_entries();
         for (int i=0; i< size_log_list; i++)
         {
             LogEntry l_tmp;
+            // Keep all the messages of the file
+            l_tmp.setLogEntryMaxSizeEnabled(false);
             int      dummy;
             file1 >> l_tmp.logInfo.ip_address;
             file1 >> l_tmp.logInfo.port_complete;
@@ -982,9 +942,9 @@ bool LoggerEngine::load_all_logs_from_file   (std::string  filename)
                 file1.seekg(end_p+end_string_size);
                 m_tmp.text=buff;
                 delete [] buff;
-                l_tmp.entry_list.push_back(m_tmp);
+                l_tmp.append_logEntry(m_tmp, log_updater->string_pool);
             }
-            log_updater->log_list.push_back(l_tmp);
+            log_updater->add_entry(l_tmp);
         }
     }
     file1.close();
@@ -1041,7 +1001,7 @@ bool LoggerEngine::clear()
 {
     if (log_updater == nullptr) return false;
     log_updater->mutex.lock();
-    log_updater->log_list.clear();
+    log_updater->clear_entries();
     log_updater->mutex.unlock();
     return true;
 }
@@ -1051,14 +1011,10 @@ void LoggerEngine::set_log_enable_by_port_complete (std::string  port, bool enab
     if (log_updater == nullptr) return;
 
     log_updater->mutex.lock();
-    std::list<LogEntry>::iterator it;
-    for (it = log_updater->log_list.begin(); it != log_updater->log_list.end(); it++)
+    LogEntry* entry = log_updater->find_entry(log_updater->by_port_complete, port);
+    if (entry != nullptr)
     {
-        if (it->logInfo.port_complete == port)
-           {
-               it->logging_enabled=enable;
-               break;
-           }
+        entry->logging_enabled=enable;
     }
     log_updater->mutex.unlock();
 }
@@ -1069,15 +1025,37 @@ bool  LoggerEngine::get_log_enable_by_port_complete (std::string  port)
 
     bool enabled=false;
     log_updater->mutex.lock();
-    std::list<LogEntry>::iterator it;
-    for (it = log_updater->log_list.begin(); it != log_updater->log_list.end(); it++)
+    LogEntry* entry = log_updater->find_entry(log_updater->by_port_complete, port);
+    if (entry != nullptr)
     {
-        if (it->logInfo.port_complete == port)
-           {
-               enabled=it->logging_enabled;
-               break;
-           }
+        enabled=entry->logging_enabled;
     }
     log_updater->mutex.unlock();
     return enabled;
 }
+
+bool LoggerEngine::set_spill_file (std::string filename)
+{
+    if (log_updater == nullptr) return false;
+
+    std::lock_guard<std::mutex> lock(log_updater->mutex);
+    if (filename.empty())
+    {
+        log_updater->spill.close();
+        return true;
+    }
+    if (log_updater->spill.open(filename) == false)
+    {
+        fprintf(stderr, "ERROR: unable to open the spill file %s\n", filename.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::string LoggerEngine::get_spill_file ()
+{
+    if (log_updater == nullptr) return std::string();
+
+    std::lock_guard<std::mutex> lock(log_updater->mutex);
+    return log_updater->spill.getFilename();
+}
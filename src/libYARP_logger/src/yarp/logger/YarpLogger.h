@@ -19,10 +19,14 @@
 #include <yarp/os/Thread.h>
 #include <yarp/os/PeriodicThread.h>
 
+#include <yarp/logger/impl/MessageStore.h>
+
+#include <cstdint>
 #include <list>
 #include <mutex>
 #include <vector>
 #include <string>
+#include <unordered_map>
 #include <ctime>
 
 namespace yarp
@@ -175,29 +179,23 @@ class yarp::yarpLogger::LogEntryInfo
 
 class yarp::yarpLogger::LogEntry
 {
-    private:
-    unsigned int                  entry_list_max_size;
-    bool                          entry_list_max_size_enabled;
-
     public:
     bool                          logging_enabled;
-    std::vector<MessageEntry>     entry_list;
-    int                           last_read_message;
+    yarp::yarpLogger::impl::MessageStore entry_list;
+    std::uint64_t                 last_read_message;
     void                          clear_logEntries();
-    bool                          append_logEntry(MessageEntry entry);
+    bool                          append_logEntry(const MessageEntry& entry, yarp::yarpLogger::impl::StringPool& pool);
 
     public:
     LogEntry(int _entry_list_max_size=10000) :
-        entry_list_max_size(_entry_list_max_size),
-        entry_list_max_size_enabled(true),
         logging_enabled(true),
-        last_read_message(-1)
+        entry_list(_entry_list_max_size),
+        last_read_message(0)
     {
-        entry_list.reserve(entry_list_max_size);
     }
 
-    int  getLogEntryMaxSize        ()          {return entry_list_max_size;}
-    bool getLogEntryMaxSizeEnabled ()          {return entry_list_max_size_enabled;}
+    int  getLogEntryMaxSize        ()          {return static_cast<int>(entry_list.getMaxSize());}
+    bool getLogEntryMaxSizeEnabled ()          {return entry_list.getMaxSizeEnabled();}
     void setLogEntryMaxSize        (int  size);
     void setLogEntryMaxSizeEnabled (bool enable);
 
@@ -217,6 +215,12 @@ class yarp::yarpLogger::LoggerEngine
         unsigned int         log_list_max_size;
         bool                 log_list_max_size_enabled;
         std::list<LogEntry>  log_list;
+        yarp::yarpLogger::impl::StringPool   string_pool;
+        yarp::yarpLogger::impl::MessageSpill spill;
+        std::unordered_map<std::string, LogEntry*> by_port_complete;
+        std::unordered_map<std::string, LogEntry*> by_port_prefix;
+        std::unordered_map<std::string, LogEntry*> by_process;
+        std::unordered_map<std::string, LogEntry*> by_pid;
         yarp::os::BufferedPort<yarp::os::Bottle> logger_port;
         std::string          logger_portName;
         int                  unknown_format_received;
@@ -224,6 +228,10 @@ class yarp::yarpLogger::LoggerEngine
         public:
         std::string getPortName();
         void        run() override;
+        void        process_message(const std::string& header, const std::string& s, std::time_t machine_current_time, const std::string& machine_current_time_s);
+        LogEntry*   add_entry(const LogEntry& entry);
+        LogEntry*   find_entry(const std::unordered_map<std::string, LogEntry*>& index, const std::string& key);
+        void        clear_entries();
         void        threadRelease() override;
         bool        listen_to_LOGLEVEL_UNDEFINED;
         bool        listen_to_LOGLEVEL_TRACE;
@@ -266,6 +274,8 @@ class yarp::yarpLogger::LoggerEngine
     void get_messages_by_port_complete   (std::string  port,    std::list<MessageEntry>& messages, bool from_beginning = false);
     void get_messages_by_process         (std::string  process, std::list<MessageEntry>& messages, bool from_beginning = false);
     void get_messages_by_pid             (std::string  pid,     std::list<MessageEntry>& messages, bool from_beginning = false);
+    bool get_messages_since              (std::string  port,    std::uint64_t& cursor, std::list<MessageEntry>& messages);
+    bool get_messages_by_level_since     (std::string  port,    int level, std::uint64_t& cursor, std::list<MessageEntry>& messages);
     void clear_messages_by_port_complete (std::string  port);
     void set_log_enable_by_port_complete (std::string  port, bool enable);
     bool get_log_enable_by_port_complete (std::string  port);
@@ -282,6 +292,9 @@ class yarp::yarpLogger::LoggerEngine
     void get_log_lines_max_size          (bool& enabled, int& current_size);
     void get_log_list_max_size           (bool& enabled, int& current_size);
 
+    bool set_spill_file                  (std::string  filename);
+    std::string get_spill_file           ();
+
     std::list<MessageEntry> filter_by_level (int level, const std::list<MessageEntry>& messages);
 };
 
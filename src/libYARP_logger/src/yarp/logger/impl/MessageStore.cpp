@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/logger/impl/MessageStore.h>
+
+#include <yarp/logger/YarpLogger.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+#if defined(YARP_HAS_ZLIB)
+#  include <zlib.h>
+#endif
+
+using yarp::yarpLogger::MessageEntry;
+using yarp::yarpLogger::impl::MessageSpill;
+using yarp::yarpLogger::impl::MessageStore;
+using yarp::yarpLogger::impl::StringPool;
+
+namespace {
+// The largest number of messages in a segment, i.e. the number of messages
+// dropped at once when the store is full
+constexpr size_t max_segment_size = 1024;
+} // namespace
+
+
+const std::string* StringPool::intern(const std::string& s)
+{
+    return &(*strings.insert(s).first);
+}
+
+
+MessageSpill::MessageSpill() = default;
+
+MessageSpill::~MessageSpill()
+{
+    close();
+}
+
+bool MessageSpill::open(const std::string& filename)
+{
+    close();
+#if defined(YARP_HAS_ZLIB)
+    // Each run appends a new gzip member, that zcat reads as a single file
+    file = gzopen(filename.c_str(), "ab");
+#else
+    file = fopen(filename.c_str(), "a");
+#endif
+    if (file == nullptr) {
+        return false;
+    }
+    this->filename = filename;
+    return true;
+}
+
+void MessageSpill::close()
+{
+    if (file == nullptr) {
+        return;
+    }
+#if defined(YARP_HAS_ZLIB)
+    gzclose(static_cast<gzFile>(file));
+#else
+    fclose(static_cast<FILE*>(file));
+#endif
+    file = nullptr;
+    filename.clear();
+}
+
+bool MessageSpill::isOpen() const
+{
+    return file != nullptr;
+}
+
+void MessageSpill::write(const std::string& source, const MessageEntry& entry)
+{
+    if (file == nullptr) {
+        return;
+    }
+    // The same line written by LoggerEngine::export_log_to_text_file(),
+    // prefixed by the port of the source
+    std::ostringstream line;
+    line << source << " " << entry.yarprun_timestamp << " " << entry.local_timestamp << " " << entry.level.toString() << " " << entry.text << " \n";
+    const std::string s = line.str();
+#if defined(YARP_HAS_ZLIB)
+    gzwrite(static_cast<gzFile>(file), s.data(), static_cast<unsigned int>(s.size()));
+#else
+    fwrite(s.data(), 1, s.size(), static_cast<FILE*>(file));
+#endif
+}
+
+
+MessageStore::MessageStore(size_t max_size, bool max_size_enabled) :
+        max_size(max_size),
+        max_size_enabled(max_size_enabled)
+{
+}
+
+void MessageStore::setMaxSize(size_t max_size)
+{
+    this->max_size = max_size;
+    while (max_size_enabled && count > max_size && !segments.empty()) {
+        dropOldest();
+    }
+}
+
+void MessageStore::setMaxSizeEnabled(bool enabled)
+{
+    max_size_enabled = enabled;
+    setMaxSize(max_size);
+}
+
+void MessageStore::setSpill(MessageSpill* spill, const std::string& source)
+{
+    this->spill = spill;
+    this->source = source;
+}
+
+size_t MessageStore::segmentSize() const
+{
+    // Drop about 1/8 of the messages at once, so that a full store still
+    // has most of the history
+    if (!max_size_enabled) {
+        return max_segment_size;
+    }
+    return std::max<size_t>(1, std::min(max_segment_size, max_size / 8));
+}
+
+void MessageStore::append(const MessageEntry& entry, StringPool& pool)
+{
+    if (max_size_enabled && max_size == 0) {
+        return;
+    }
+
+    size_t segment_size = segmentSize();
+    if (segments.empty() || segments.back().messages.size() >= segment_size) {
+        segments.emplace_back();
+        segments.back().first = next;
+        segments.back().messages.reserve(segment_size);
+    }
+    Segment& segment = segments.back();
+
+    int level = static_cast<int>(static_cast<LogLevelEnum>(entry.level));
+    if (level < 0 || level >= levels) {
+        level = LOGLEVEL_UNDEFINED;
+    }
+
+    segment.by_level[level].push_back(static_cast<std::uint32_t>(segment.messages.size()));
+    segment.messages.push_back({level,
+                                entry.text,
+                                pool.intern(entry.filename),
+                                entry.line,
+                                pool.intern(entry.function),
+                                pool.intern(entry.hostname),
+                                pool.intern(entry.cmd),
+                                pool.intern(entry.args),
+                                entry.pid,
+                                entry.thread_id,
+                                pool.intern(entry.component),
+                                entry.systemtime,
+                                entry.networktime,
+                                entry.externaltime,
+                                entry.backtrace,
+                                entry.yarprun_timestamp,
+                                entry.local_timestamp});
+    count++;
+    next++;
+
+    while (max_size_enabled && count > max_size) {
+        dropOldest();
+    }
+}
+
+void MessageStore::dropOldest()
+{
+    Segment& segment = segments.front();
+    if (spill != nullptr && spill->isOpen()) {
+        MessageEntry entry;
+        for (const auto& stored : segment.messages) {
+            toEntry(stored, entry);
+            spill->write(source, entry);
+        }
+    }
+    count -= segment.messages.size();
+    segments.pop_front();
+}
+
+void MessageStore::clear()
+{
+    segments.clear();
+    count = 0;
+    next = 0;
+}
+
+std::uint64_t MessageStore::begin() const
+{
+    return segments.empty() ? next : segments.front().first;
+}
+
+void MessageStore::toEntry(const StoredMessage& stored, MessageEntry& entry)
+{
+    entry.level.setLevel(stored.level);
+    entry.text = stored.text;
+    entry.filename = *stored.filename;
+    entry.line = stored.line;
+    entry.function = *stored.function;
+    entry.hostname = *stored.hostname;
+    entry.cmd = *stored.cmd;
+    entry.args = *stored.args;
+    entry.pid = stored.pid;
+    entry.thread_id = stored.thread_id;
+    entry.component = *stored.component;
+    entry.systemtime = stored.systemtime;
+    entry.networktime = stored.networktime;
+    entry.externaltime = stored.externaltime;
+    entry.backtrace = stored.backtrace;
+    entry.yarprun_timestamp = stored.yarprun_timestamp;
+    entry.local_timestamp = stored.local_timestamp;
+}
+
+void MessageStore::get(std::uint64_t& cursor, std::list<MessageEntry>& messages) const
+{
+    // Skip the segments already read
+    auto it = std::upper_bound(segments.begin(), segments.end(), cursor, [](std::uint64_t c, const Segment& s) { return c < s.first; });
+    if (it != segments.begin()) {
+        --it;
+    }
+    for (; it != segments.end(); ++it) {
+        size_t i = (cursor > it->first) ? static_cast<size_t>(cursor - it->first) : 0;
+        for (; i < it->messages.size(); i++) {
+            messages.emplace_back();
+            toEntry(it->messages[i], messages.back());
+        }
+    }
+    cursor = next;
+}
+
+void MessageStore::getByLevel(int level, std::uint64_t& cursor, std::list<MessageEntry>& messages) const
+{
+    if (level < 0 || level >= levels) {
+        cursor = next;
+        return;
+    }
+    auto it = std::upper_bound(segments.begin(), segments.end(), cursor, [](std::uint64_t c, const Segment& s) { return c < s.first; });
+    if (it != segments.begin()) {
+        --it;
+    }
+    for (; it != segments.end(); ++it) {
+        const auto& index = it->by_level[level];
+        std::uint32_t from = (cursor > it->first) ? static_cast<std::uint32_t>(cursor - it->first) : 0;
+        for (auto i = std::lower_bound(index.begin(), index.end(), from); i != index.end(); ++i) {
+            messages.emplace_back();
+            toEntry(it->messages[*i], messages.back());
+        }
+    }
+    cursor = next;
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_LOGGER_IMPL_MESSAGESTORE_H
+#define YARP_LOGGER_IMPL_MESSAGESTORE_H
+
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace yarp {
+namespace yarpLogger {
+
+struct MessageEntry;
+
+namespace impl {
+
+/**
+ * Keeps a single copy of the strings repeated by many messages (file and
+ * function names, host names, components...).
+ *
+ * The pointers returned by intern() are valid until clear() is called.
+ * The strings are not released when the messages that use them are dropped
+ * by the stores, so the pool grows with the number of distinct strings
+ * received, until LoggerEngine clears all the logs.
+ */
+class StringPool
+{
+public:
+    const std::string* intern(const std::string& s);
+    size_t size() const { return strings.size(); }
+    void clear() { strings.clear(); }
+
+private:
+    std::unordered_set<std::string> strings;
+};
+
+/**
+ * Writes the messages dropped by the stores to a file, compressed with
+ * gzip when YARP is built with zlib.
+ */
+class MessageSpill
+{
+public:
+    MessageSpill();
+    ~MessageSpill();
+    MessageSpill(const MessageSpill&) = delete;
+    MessageSpill& operator=(const MessageSpill&) = delete;
+
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const;
+    const std::string& getFilename() const { return filename; }
+
+    void write(const std::string& source, const MessageEntry& entry);
+
+private:
+    std::string filename;
+    void* file {nullptr};
+};
+
+/**
+ * The messages received from a single source.
+ *
+ * The messages are stored in segments of consecutive messages.  When the
+ * maximum size is exceeded, the oldest segment is dropped (and written to
+ * the spill file if any), so the memory used does not grow.
+ *
+ * Each message is numbered, starting from 0 when the store is created or
+ * cleared, so that a reader can keep a cursor and ask only for the messages
+ * received since its last call.  Each segment also keeps the positions of
+ * its messages for each level.
+ */
+class MessageStore
+{
+public:
+    explicit MessageStore(size_t max_size = 10000, bool max_size_enabled = true);
+
+    void   setMaxSize(size_t max_size);
+    size_t getMaxSize() const { return max_size; }
+    void   setMaxSizeEnabled(bool enabled);
+    bool   getMaxSizeEnabled() const { return max_size_enabled; }
+
+    /**
+     * Write the dropped messages to a spill file, nullptr to discard them.
+     */
+    void setSpill(MessageSpill* spill, const std::string& source);
+
+    void append(const MessageEntry& entry, StringPool& pool);
+    void clear();
+
+    /**
+     * @return the number of the oldest message still stored
+     */
+    std::uint64_t begin() const;
+
+    /**
+     * @return the number that the next message will have
+     */
+    std::uint64_t end() const { return next; }
+
+    size_t size() const { return count; }
+
+    /**
+     * Copy the messages numbered from cursor onwards, and move the cursor
+     * after the last one.  Messages already dropped are skipped.
+     */
+    void get(std::uint64_t& cursor, std::list<MessageEntry>& messages) const;
+
+    /**
+     * As get(), but only the messages of the given level.
+     */
+    void getByLevel(int level, std::uint64_t& cursor, std::list<MessageEntry>& messages) const;
+
+    static constexpr int levels = 7;
+
+private:
+    struct StoredMessage
+    {
+        int                 level;
+        std::string         text;
+        const std::string*  filename;
+        unsigned int        line;
+        const std::string*  function;
+        const std::string*  hostname;
+        const std::string*  cmd;
+        const std::string*  args;
+        int                 pid;
+        long                thread_id;
+        const std::string*  component;
+        double              systemtime;
+        double              networktime;
+        double              externaltime;
+        std::string         backtrace;
+        std::string         yarprun_timestamp;
+        std::string         local_timestamp;
+    };
+
+    struct Segment
+    {
+        std::uint64_t                       first;      ///< number of the first message
+        std::vector<StoredMessage>          messages;
+        std::vector<std::uint32_t>          by_level[levels];
+    };
+
+    static void toEntry(const StoredMessage& stored, MessageEntry& entry);
+    size_t segmentSize() const;
+    void dropOldest();
+
+    std::deque<Segment> segments;
+    size_t          max_size;
+    bool            max_size_enabled;
+    size_t          count {0};
+    std::uint64_t   next {0};
+    MessageSpill*   spill {nullptr};
+    std::string     source;
+};
+
+} // namespace impl
+} // namespace yarpLogger
+} // namespace yarp
+
+#endif // YARP_LOGGER_IMPL_MESSAGESTORE_H
@@ -330,3 +330,40 @@ Quaternion Quaternion::inverse() const
     //                     w                  x                 y                  z
     return Quaternion(internal_data[0], -internal_data[1], -internal_data[2], -internal_data[3]);
 }
+
+Quaternion Quaternion::slerp(const Quaternion& q0, const Quaternion& q1, double t)
+{
+    const double* a = q0.data();
+    const double* b = q1.data();
+    double cosTheta = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+
+    // q and -q are the same rotation, take the shortest arc
+    double sign = 1.0;
+    if (cosTheta < 0)
+    {
+        cosTheta = -cosTheta;
+        sign = -1.0;
+    }
+
+    double k0;
+    double k1;
+    if (cosTheta > 0.9995)
+    {
+        // Almost the same rotation, interpolate linearly
+        k0 = 1.0 - t;
+        k1 = t;
+    }
+    else
+    {
+        double theta = acos(cosTheta);
+        double sinTheta = sin(theta);
+        k0 = sin((1.0 - t) * theta) / sinTheta;
+        k1 = sin(t * theta) / sinTheta;
+    }
+    k1 *= sign;
+
+    //                x                      y                      z                      w
+    Quaternion q(k0 * a[1] + k1 * b[1], k0 * a[2] + k1 * b[2], k0 * a[3] + k1 * b[3], k0 * a[0] + k1 * b[0]);
+    q.normalize();
+    return q;
+}
@@ -63,6 +63,16 @@ public:
     */
     double arg();
 
+    /**
+    * Spherical linear interpolation between two unit quaternions, along
+    * the shortest arc.
+    * @param q0 the quaternion returned for t = 0
+    * @param q1 the quaternion returned for t = 1
+    * @param t the interpolation parameter, between 0 and 1
+    * @return the normalized interpolated quaternion
+    */
+    static Quaternion slerp(const Quaternion& q0, const Quaternion& q1, double t);
+
     /**
     * Computes the quaternion from an axis-angle representation
     * @param v a 4D vector, where the first three elements represent the axis, while the fourth element represents the angle (in radians)
@@ -0,0 +1,757 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/BottleView.h>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/ConnectionReader.h>
+#include <yarp/os/ConnectionWriter.h>
+#include <yarp/os/NetFloat32.h>
+#include <yarp/os/NetFloat64.h>
+#include <yarp/os/NetInt16.h>
+#include <yarp/os/NetInt32.h>
+#include <yarp/os/NetInt64.h>
+#include <yarp/os/NetInt8.h>
+#include <yarp/os/Value.h>
+#include <yarp/os/Vocab.h>
+#include <yarp/os/impl/LogComponent.h>
+#include <yarp/os/impl/Storable.h>
+
+#include <cinttypes>
+#include <cstring>
+#include <memory>
+
+using yarp::os::BottleView;
+using yarp::os::ConnectionReader;
+using yarp::os::ConnectionWriter;
+
+namespace {
+YARP_OS_LOG_COMPONENT(BOTTLEVIEW, "yarp.os.BottleView")
+
+// Deeper nesting is considered an error, to protect the stack
+constexpr int max_depth = 256;
+
+template <typename T, typename NetT>
+inline T load(const char* p)
+{
+    NetT x;
+    std::memcpy(&x, p, sizeof(NetT));
+    return static_cast<T>(x);
+}
+
+inline std::int32_t loadInt32(const char* p)
+{
+    return load<std::int32_t, yarp::os::NetInt32>(p);
+}
+
+inline size_t fixedSize(std::int32_t code)
+{
+    switch (code) {
+    case BOTTLE_TAG_INT8:
+        return 1;
+    case BOTTLE_TAG_INT16:
+        return 2;
+    case BOTTLE_TAG_INT32:
+    case BOTTLE_TAG_VOCAB:
+    case BOTTLE_TAG_FLOAT32:
+        return 4;
+    case BOTTLE_TAG_INT64:
+    case BOTTLE_TAG_FLOAT64:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+inline bool isBlobCode(std::int32_t code)
+{
+    return code == BOTTLE_TAG_STRING || code == BOTTLE_TAG_BLOB;
+}
+
+inline bool isDictCode(std::int32_t code)
+{
+    return (code & BOTTLE_TAG_DICT) != 0;
+}
+
+inline bool isListCode(std::int32_t code)
+{
+    return (code & GROUP_MASK) != 0;
+}
+
+
+/*
+ * Skip items whose representation was already validated.
+ */
+const char* skipList(const char* p, std::int32_t subCode);
+const char* skipBottle(const char* p);
+
+const char* skipItem(const char* p, std::int32_t code)
+{
+    size_t fixed = fixedSize(code);
+    if (fixed != 0) {
+        return p + fixed;
+    }
+    if (isBlobCode(code)) {
+        return p + sizeof(std::int32_t) + loadInt32(p);
+    }
+    if (isDictCode(code)) {
+        return skipBottle(p);
+    }
+    return skipList(p, code & UNIT_MASK);
+}
+
+const char* skipList(const char* p, std::int32_t subCode)
+{
+    std::int32_t len = loadInt32(p);
+    p += sizeof(std::int32_t);
+    size_t fixed = fixedSize(subCode);
+    if (fixed != 0) {
+        return p + fixed * len;
+    }
+    for (std::int32_t i = 0; i < len; i++) {
+        std::int32_t code = subCode;
+        if (code == 0) {
+            code = loadInt32(p);
+            p += sizeof(std::int32_t);
+        }
+        p = skipItem(p, code);
+    }
+    return p;
+}
+
+const char* skipBottle(const char* p)
+{
+    return skipList(p + sizeof(std::int32_t), loadInt32(p) & UNIT_MASK);
+}
+
+
+/*
+ * Validate a binary representation, taking the bytes from a source.
+ *
+ * A source provides take(n), that returns a pointer to the next n bytes,
+ * valid until the next call, or nullptr if they are not available, and
+ * position(), that returns the number of bytes taken so far.
+ */
+
+// Bytes already in memory
+class MemorySource
+{
+public:
+    MemorySource(const char* buf, size_t len) :
+            base(buf),
+            cursor(buf),
+            end(buf + len)
+    {
+    }
+
+    const char* take(size_t n)
+    {
+        if (static_cast<size_t>(end - cursor) < n) {
+            return nullptr;
+        }
+        const char* result = cursor;
+        cursor += n;
+        return result;
+    }
+
+    size_t position() const
+    {
+        return static_cast<size_t>(cursor - base);
+    }
+
+private:
+    const char* base;
+    const char* cursor;
+    const char* end;
+};
+
+// Bytes read from a connection, and appended to a buffer
+class ReaderSource
+{
+public:
+    ReaderSource(ConnectionReader& reader, std::vector<char>& buffer) :
+            reader(reader),
+            buffer(buffer)
+    {
+    }
+
+    const char* take(size_t n)
+    {
+        // Do not trust lengths longer than the message
+        size_t available = reader.getSize();
+        if (available != 0 && n > available) {
+            return nullptr;
+        }
+        size_t pos = buffer.size();
+        buffer.resize(pos + n);
+        if (!reader.expectBlock(buffer.data() + pos, n) || reader.isError()) {
+            return nullptr;
+        }
+        return buffer.data() + pos;
+    }
+
+    size_t position() const
+    {
+        return buffer.size();
+    }
+
+private:
+    ConnectionReader& reader;
+    std::vector<char>& buffer;
+};
+
+template <typename Source>
+bool parseList(Source& src, std::int32_t subCode, std::vector<size_t>* offsets, int depth);
+
+template <typename Source>
+bool parseBottle(Source& src, std::vector<size_t>* offsets, int depth)
+{
+    const char* p = src.take(sizeof(std::int32_t));
+    if (p == nullptr) {
+        return false;
+    }
+    return parseList(src, loadInt32(p) & UNIT_MASK, offsets, depth);
+}
+
+template <typename Source>
+bool parseItem(Source& src, std::int32_t code, int depth)
+{
+    size_t fixed = fixedSize(code);
+    if (fixed != 0) {
+        return src.take(fixed) != nullptr;
+    }
+    if (isBlobCode(code)) {
+        const char* p = src.take(sizeof(std::int32_t));
+        if (p == nullptr) {
+            return false;
+        }
+        std::int32_t len = loadInt32(p);
+        if (len < 0) {
+            return false;
+        }
+        return len == 0 || src.take(static_cast<size_t>(len)) != nullptr;
+    }
+    if (isListCode(code)) {
+        if (depth >= max_depth) {
+            yCError(BOTTLEVIEW, "Lists nested more than %d levels", max_depth);
+            return false;
+        }
+        if (isDictCode(code)) {
+            return parseBottle(src, nullptr, depth + 1);
+        }
+        return parseList(src, code & UNIT_MASK, nullptr, depth + 1);
+    }
+    yCError(BOTTLEVIEW, "Unrecognized object code %" PRId32, code);
+    return false;
+}
+
+template <typename Source>
+bool parseList(Source& src, std::int32_t subCode, std::vector<size_t>* offsets, int depth)
+{
+    const char* p = src.take(sizeof(std::int32_t));
+    if (p == nullptr) {
+        return false;
+    }
+    std::int32_t len = loadInt32(p);
+    if (len < 0) {
+        return false;
+    }
+    if (offsets != nullptr) {
+        offsets->clear();
+    }
+    size_t fixed = fixedSize(subCode);
+    if (fixed != 0) {
+        // Items of a fixed size can be located without an index
+        return len == 0 || src.take(fixed * static_cast<size_t>(len)) != nullptr;
+    }
+    for (std::int32_t i = 0; i < len; i++) {
+        if (offsets != nullptr) {
+            offsets->push_back(src.position());
+        }
+        std::int32_t code = subCode;
+        if (code == 0) {
+            p = src.take(sizeof(std::int32_t));
+            if (p == nullptr) {
+                return false;
+            }
+            code = loadInt32(p);
+        }
+        if (!parseItem(src, code, depth)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+
+////////////////////////////////////////////////////////////////////////////
+// BottleView::Element
+
+BottleView::Element::Element() :
+        code(0),
+        data(nullptr)
+{
+}
+
+BottleView::Element::Element(std::int32_t code, const char* data) :
+        code(code),
+        data(data)
+{
+}
+
+bool BottleView::Element::isNull() const
+{
+    return code == 0;
+}
+
+bool BottleView::Element::isInt8() const
+{
+    return code == BOTTLE_TAG_INT8;
+}
+
+bool BottleView::Element::isInt16() const
+{
+    return code == BOTTLE_TAG_INT16;
+}
+
+bool BottleView::Element::isInt32() const
+{
+    return code == BOTTLE_TAG_INT32;
+}
+
+bool BottleView::Element::isInt64() const
+{
+    return code == BOTTLE_TAG_INT64;
+}
+
+bool BottleView::Element::isFloat32() const
+{
+    return code == BOTTLE_TAG_FLOAT32;
+}
+
+bool BottleView::Element::isFloat64() const
+{
+    return code == BOTTLE_TAG_FLOAT64;
+}
+
+bool BottleView::Element::isVocab() const
+{
+    return code == BOTTLE_TAG_VOCAB;
+}
+
+bool BottleView::Element::isString() const
+{
+    return code == BOTTLE_TAG_STRING;
+}
+
+bool BottleView::Element::isBlob() const
+{
+    return code == BOTTLE_TAG_BLOB;
+}
+
+bool BottleView::Element::isList() const
+{
+    return isListCode(code) && !isDictCode(code);
+}
+
+bool BottleView::Element::isDict() const
+{
+    return isListCode(code) && isDictCode(code);
+}
+
+namespace {
+template <typename T>
+T asNumber(std::int32_t code, const char* data)
+{
+    switch (code) {
+    case BOTTLE_TAG_INT8:
+        return static_cast<T>(load<std::int8_t, yarp::os::NetInt8>(data));
+    case BOTTLE_TAG_INT16:
+        return static_cast<T>(load<std::int16_t, yarp::os::NetInt16>(data));
+    case BOTTLE_TAG_INT32:
+    case BOTTLE_TAG_VOCAB:
+        return static_cast<T>(load<std::int32_t, yarp::os::NetInt32>(data));
+    case BOTTLE_TAG_INT64:
+        return static_cast<T>(load<std::int64_t, yarp::os::NetInt64>(data));
+    case BOTTLE_TAG_FLOAT32:
+        return static_cast<T>(load<yarp::conf::float32_t, yarp::os::NetFloat32>(data));
+    case BOTTLE_TAG_FLOAT64:
+        return static_cast<T>(load<yarp::conf::float64_t, yarp::os::NetFloat64>(data));
+    default:
+        return T(0);
+    }
+}
+} // namespace
+
+std::int8_t BottleView::Element::asInt8() const
+{
+    return asNumber<std::int8_t>(code, data);
+}
+
+std::int16_t BottleView::Element::asInt16() const
+{
+    return asNumber<std::int16_t>(code, data);
+}
+
+std::int32_t BottleView::Element::asInt32() const
+{
+    return asNumber<std::int32_t>(code, data);
+}
+
+std::int64_t BottleView::Element::asInt64() const
+{
+    return asNumber<std::int64_t>(code, data);
+}
+
+yarp::conf::float32_t BottleView::Element::asFloat32() const
+{
+    return asNumber<yarp::conf::float32_t>(code, data);
+}
+
+yarp::conf::float64_t BottleView::Element::asFloat64() const
+{
+    return asNumber<yarp::conf::float64_t>(code, data);
+}
+
+bool BottleView::Element::asBool() const
+{
+    return asNumber<yarp::conf::float64_t>(code, data) != 0;
+}
+
+std::int32_t BottleView::Element::asVocab() const
+{
+    if (code == BOTTLE_TAG_VOCAB || code == BOTTLE_TAG_INT32) {
+        return loadInt32(data);
+    }
+    if (code == BOTTLE_TAG_STRING) {
+        return yarp::os::Vocab::encode(asString());
+    }
+    return 0;
+}
+
+std::string BottleView::Element::asString() const
+{
+    if (code != BOTTLE_TAG_STRING) {
+        return {};
+    }
+    return std::string(asBlob(), asBlobLength());
+}
+
+const char* BottleView::Element::asBlob() const
+{
+    if (!isBlobCode(code)) {
+        return nullptr;
+    }
+    return data + sizeof(std::int32_t);
+}
+
+size_t BottleView::Element::asBlobLength() const
+{
+    if (!isBlobCode(code)) {
+        return 0;
+    }
+    return static_cast<size_t>(loadInt32(data));
+}
+
+BottleView BottleView::Element::asList() const
+{
+    if (!isListCode(code)) {
+        return BottleView();
+    }
+    return BottleView(data, isDictCode(code), code & UNIT_MASK);
+}
+
+std::int32_t BottleView::Element::getCode() const
+{
+    return code;
+}
+
+std::string BottleView::Element::toString() const
+{
+    std::unique_ptr<yarp::os::Value> value;
+    switch (code) {
+    case BOTTLE_TAG_INT8:
+        value.reset(yarp::os::Value::makeInt8(asInt8()));
+        break;
+    case BOTTLE_TAG_INT16:
+        value.reset(yarp::os::Value::makeInt16(asInt16()));
+        break;
+    case BOTTLE_TAG_INT32:
+        value.reset(yarp::os::Value::makeInt32(asInt32()));
+        break;
+    case BOTTLE_TAG_INT64:
+        value.reset(yarp::os::Value::makeInt64(asInt64()));
+        break;
+    case BOTTLE_TAG_FLOAT32:
+        value.reset(yarp::os::Value::makeFloat32(asFloat32()));
+        break;
+    case BOTTLE_TAG_FLOAT64:
+        value.reset(yarp::os::Value::makeFloat64(asFloat64()));
+        break;
+    case BOTTLE_TAG_VOCAB:
+        value.reset(yarp::os::Value::makeVocab(asVocab()));
+        break;
+    case BOTTLE_TAG_STRING:
+        return asString();
+    case BOTTLE_TAG_BLOB:
+        value.reset(yarp::os::Value::makeBlob(const_cast<char*>(asBlob()), static_cast<int>(asBlobLength())));
+        break;
+    default:
+        if (isListCode(code)) {
+            return asList().toString();
+        }
+        return {};
+    }
+    return value->toString();
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+// BottleView
+
+BottleView::BottleView() :
+        begin(nullptr),
+        data(nullptr),
+        subCode(0),
+        count(0),
+        hasCode(false),
+        valid(false),
+        owned(false)
+{
+}
+
+BottleView::BottleView(const char* begin, bool hasCode, std::int32_t subCode) :
+        begin(begin),
+        data(nullptr),
+        subCode(subCode),
+        count(0),
+        hasCode(hasCode),
+        valid(true),
+        owned(false)
+{
+    const char* p = begin;
+    if (hasCode) {
+        this->subCode = loadInt32(p) & UNIT_MASK;
+        p += sizeof(std::int32_t);
+    }
+    count = static_cast<size_t>(loadInt32(p));
+    data = p + sizeof(std::int32_t);
+}
+
+BottleView::BottleView(const BottleView& rhs) :
+        BottleView()
+{
+    *this = rhs;
+}
+
+BottleView& BottleView::operator=(const BottleView& rhs)
+{
+    if (&rhs == this) {
+        return *this;
+    }
+    subCode = rhs.subCode;
+    count = rhs.count;
+    hasCode = rhs.hasCode;
+    valid = rhs.valid;
+    owned = rhs.owned;
+    offsets = rhs.offsets;
+    if (rhs.owned) {
+        buffer = rhs.buffer;
+        begin = buffer.data();
+        data = begin + (rhs.data - rhs.begin);
+    } else {
+        buffer.clear();
+        begin = rhs.begin;
+        data = rhs.data;
+    }
+    return *this;
+}
+
+BottleView::~BottleView() = default;
+
+void BottleView::clear()
+{
+    begin = nullptr;
+    data = nullptr;
+    subCode = 0;
+    count = 0;
+    hasCode = false;
+    valid = false;
+    owned = false;
+    buffer.clear();
+    offsets.clear();
+}
+
+void BottleView::setTopLevel(const char* buf, bool owned)
+{
+    begin = buf;
+    hasCode = true;
+    subCode = loadInt32(begin) & UNIT_MASK;
+    count = static_cast<size_t>(loadInt32(begin + sizeof(std::int32_t)));
+    data = begin + 2 * sizeof(std::int32_t);
+    valid = true;
+    this->owned = owned;
+}
+
+bool BottleView::fromBinary(const char* buf, size_t len)
+{
+    clear();
+    MemorySource src(buf, len);
+    if (!parseBottle(src, &offsets, 0)) {
+        clear();
+        return false;
+    }
+    setTopLevel(buf, false);
+    return true;
+}
+
+bool BottleView::isValid() const
+{
+    return valid;
+}
+
+size_t BottleView::size() const
+{
+    return count;
+}
+
+const char* BottleView::locate(size_t index) const
+{
+    if (index >= count) {
+        return nullptr;
+    }
+    size_t fixed = fixedSize(subCode);
+    if (fixed != 0) {
+        return data + index * fixed;
+    }
+    if (offsets.size() == count) {
+        return begin + offsets[index];
+    }
+    // Nested lists have no index, scan them
+    const char* p = data;
+    for (size_t i = 0; i < index; i++) {
+        std::int32_t code = subCode;
+        if (code == 0) {
+            code = loadInt32(p);
+            p += sizeof(std::int32_t);
+        }
+        p = skipItem(p, code);
+    }
+    return p;
+}
+
+BottleView::Element BottleView::get(size_t index) const
+{
+    const char* p = locate(index);
+    if (p == nullptr) {
+        return Element();
+    }
+    std::int32_t code = subCode;
+    if (code == 0) {
+        code = loadInt32(p);
+        p += sizeof(std::int32_t);
+    }
+    return Element(code, p);
+}
+
+namespace {
+bool matches(const BottleView::Element& element, const std::string& key)
+{
+    if (element.isString()) {
+        return element.asBlobLength() == key.length() && std::memcmp(element.asBlob(), key.data(), key.length()) == 0;
+    }
+    return element.toString() == key;
+}
+} // namespace
+
+BottleView::Element BottleView::find(const std::string& key) const
+{
+    const char* p = data;
+    for (size_t i = 0; i < count; i++) {
+        std::int32_t code = subCode;
+        if (code == 0) {
+            code = loadInt32(p);
+            p += sizeof(std::int32_t);
+        }
+        Element element(code, p);
+        if (element.isList()) {
+            BottleView nested = element.asList();
+            if (matches(nested.get(0), key)) {
+                return nested.get(1);
+            }
+        } else if (matches(element, key)) {
+            return get(i + 1);
+        }
+        p = skipItem(p, code);
+    }
+    return Element();
+}
+
+bool BottleView::check(const std::string& key) const
+{
+    return !find(key).isNull();
+}
+
+std::string BottleView::toString() const
+{
+    yarp::os::Bottle bot;
+    bot.read(*this);
+    return bot.toString();
+}
+
+bool BottleView::read(ConnectionReader& reader)
+{
+    clear();
+    if (reader.isTextMode()) {
+        yarp::os::Bottle bot;
+        if (!bot.read(reader)) {
+            return false;
+        }
+        size_t len = 0;
+        const char* bin = bot.toBinary(&len);
+        buffer.assign(bin, bin + len);
+        MemorySource src(buffer.data(), buffer.size());
+        if (!parseBottle(src, &offsets, 0)) {
+            clear();
+            return false;
+        }
+    } else {
+        ReaderSource src(reader, buffer);
+        if (!parseBottle(src, &offsets, 0)) {
+            clear();
+            return false;
+        }
+    }
+    setTopLevel(buffer.data(), true);
+    return true;
+}
+
+bool BottleView::write(ConnectionWriter& writer) const
+{
+    if (writer.isTextMode()) {
+        writer.appendText(toString());
+        return !writer.isError();
+    }
+    if (!valid) {
+        // an empty bottle
+        writer.appendInt32(BOTTLE_TAG_LIST);
+        writer.appendInt32(0);
+        return !writer.isError();
+    }
+    const char* end = nullptr;
+    if (hasCode) {
+        end = skipBottle(begin);
+    } else {
+        writer.appendInt32(BOTTLE_TAG_LIST + subCode);
+        end = skipList(begin, subCode);
+    }
+    writer.appendBlock(begin, static_cast<size_t>(end - begin));
+    return !writer.isError();
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_BOTTLEVIEW_H
+#define YARP_OS_BOTTLEVIEW_H
+
+#include <yarp/conf/numeric.h>
+
+#include <yarp/os/Portable.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace yarp {
+namespace os {
+
+/**
+ * \ingroup key_class
+ *
+ * A read-only view of a Bottle in its binary (network) representation.
+ *
+ * Reading a Bottle creates an object for each one of its items.  A
+ * BottleView instead keeps the bytes as they were received, and decodes
+ * the items only when they are accessed.  When a BottleView is reused to
+ * read messages of similar size, no memory is allocated.
+ *
+ * A BottleView can be read from a port like a Bottle, e.g. using
+ * BufferedPort<BottleView> or TypedReaderCallback<BottleView>, and can be
+ * written back unchanged.  It cannot be modified.
+ *
+ * The data are validated when the view is created, accessing an item
+ * that does not exist or has a different type returns an invalid Element
+ * or a default value (0, empty string or empty list), as for Bottle.
+ *
+ * Lists returned by Element::asList() are views over the same memory,
+ * and must not be used after the BottleView that owns the data is
+ * destroyed or reads another message.
+ */
+class YARP_os_API BottleView : public Portable
+{
+public:
+    /**
+     * A single item of a BottleView.
+     */
+    class YARP_os_API Element
+    {
+    public:
+        /**
+         * Construct an invalid element.
+         */
+        Element();
+
+        bool isNull() const;
+        bool isInt8() const;
+        bool isInt16() const;
+        bool isInt32() const;
+        bool isInt64() const;
+        bool isFloat32() const;
+        bool isFloat64() const;
+        bool isVocab() const;
+        bool isString() const;
+        bool isBlob() const;
+        bool isList() const;
+        bool isDict() const;
+
+        /**
+         * Numbers and vocabularies are converted to the requested type,
+         * any other item returns 0.
+         */
+        std::int8_t asInt8() const;
+        std::int16_t asInt16() const;
+        std::int32_t asInt32() const;
+        std::int64_t asInt64() const;
+        yarp::conf::float32_t asFloat32() const;
+        yarp::conf::float64_t asFloat64() const;
+        bool asBool() const;
+
+        /**
+         * @return the vocabulary, or 0 if the item is not a vocabulary.
+         */
+        std::int32_t asVocab() const;
+
+        /**
+         * @return a copy of the string, or an empty string if the item is
+         * not a string.
+         */
+        std::string asString() const;
+
+        /**
+         * @return a pointer to the bytes of a string or a blob, without
+         * copying them, or nullptr.
+         */
+        const char* asBlob() const;
+
+        /**
+         * @return the number of bytes of a string or a blob.
+         */
+        size_t asBlobLength() const;
+
+        /**
+         * @return a view of a list or a dictionary, or an empty view.
+         */
+        BottleView asList() const;
+
+        /**
+         * @return the type code of the item (one of the BOTTLE_TAG_*
+         * values), or 0 if the element is invalid.
+         */
+        std::int32_t getCode() const;
+
+        /**
+         * @return a textual representation of the item, as for Value.
+         */
+        std::string toString() const;
+
+    private:
+        friend class BottleView;
+        Element(std::int32_t code, const char* data);
+
+        std::int32_t code;
+        const char* data;
+    };
+
+    /**
+     * Construct an empty view.
+     */
+    BottleView();
+
+    /**
+     * Copy constructor.  If the view owns its data, the data are copied.
+     */
+    BottleView(const BottleView& rhs);
+
+    /**
+     * Copy assignment.  If the view owns its data, the data are copied.
+     */
+    BottleView& operator=(const BottleView& rhs);
+
+    ~BottleView() override;
+
+    /**
+     * Make a view of the binary representation of a Bottle (as returned
+     * by Bottle::toBinary()), without copying it.  The data must stay
+     * valid as long as the view is used.
+     *
+     * @param buf the binary representation
+     * @param len the size of the binary representation
+     * @return true if the data is a valid Bottle
+     */
+    bool fromBinary(const char* buf, size_t len);
+
+    /**
+     * @return true if the view contains a valid Bottle.
+     */
+    bool isValid() const;
+
+    /**
+     * @return the number of items.
+     */
+    size_t size() const;
+
+    /**
+     * @return the item at the given position, or an invalid element.
+     */
+    Element get(size_t index) const;
+
+    /**
+     * Look for a key, as Bottle::find() does.  The key can be an item of
+     * the list followed by its value, or the first item of a nested list
+     * followed by the value.
+     *
+     * @return the value associated to the key, or an invalid element.
+     */
+    Element find(const std::string& key) const;
+
+    /**
+     * @return true if the key can be found.
+     */
+    bool check(const std::string& key) const;
+
+    /**
+     * @return a textual representation, as for Bottle::toString().
+     */
+    std::string toString() const;
+
+    // documented in PortReader
+    bool read(ConnectionReader& reader) override;
+
+    // documented in PortWriter
+    bool write(ConnectionWriter& writer) const override;
+
+private:
+    BottleView(const char* begin, bool hasCode, std::int32_t subCode);
+
+    void clear();
+    void setTopLevel(const char* buf, bool owned);
+    const char* locate(size_t index) const;
+
+    const char* begin;     ///< the binary representation
+    const char* data;      ///< the first item
+    std::int32_t subCode;  ///< the type of all the items, or 0 if they are tagged
+    size_t count;          ///< the number of items
+    bool hasCode;          ///< does the binary representation start with the type code
+    bool valid;            ///< is the binary representation valid
+    bool owned;            ///< is the binary representation stored in buffer
+    YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<char>) buffer;     ///< the data received by read()
+    YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<size_t>) offsets;  ///< the position of the items, from begin
+};
+
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_BOTTLEVIEW_H
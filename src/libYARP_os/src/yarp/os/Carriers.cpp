@@ -9,12 +9,14 @@
 
 #include <yarp/os/Carriers.h>
 
+#include <yarp/os/Network.h>
 #include <yarp/os/YarpPlugin.h>
 #include <yarp/os/impl/FakeFace.h>
 #include <yarp/os/impl/HttpCarrier.h>
 #include <yarp/os/impl/LocalCarrier.h>
 #include <yarp/os/impl/LogComponent.h>
 #include <yarp/os/impl/McastCarrier.h>
+#include <yarp/os/impl/NameCache.h>
 #include <yarp/os/impl/NameserCarrier.h>
 #include <yarp/os/impl/Protocol.h>
 #include <yarp/os/impl/TcpCarrier.h>
@@ -299,6 +301,18 @@ OutputProtocol* Carriers::connect(const Contact& address)
 
     OutputProtocol* proto = face->write(address);
     delete face;
+
+    if (proto == nullptr && NameCache::getInstance().invalidate(address.getRegName())) {
+        // The address may come from a stale entry of the name cache: if
+        // the port moved, try once more with its current address.
+        Contact current = NetworkBase::queryName(address.getRegName());
+        if (current.isValid() && (current.getHost() != address.getHost() || current.getPort() != address.getPort())) {
+            yCDebug(CARRIERS, "%s moved from %s to %s", address.getRegName().c_str(), address.toURI().c_str(), current.toURI().c_str());
+            Contact retry = address;
+            retry.setSocket(address.getCarrier(), current.getHost(), current.getPort());
+            return connect(retry);
+        }
+    }
     return proto;
 }
 
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/MemoryLoan.h>
+
+#include <yarp/os/impl/LogComponent.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <new>
+
+#if !defined(_WIN32)
+#    include <csignal>
+#    include <dirent.h>
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+using yarp::os::MemoryLoan;
+
+namespace {
+YARP_OS_LOG_COMPONENT(MEMORYLOAN, "yarp.os.MemoryLoan")
+
+struct LoanBlock
+{
+    size_t size;
+    std::string name;  ///< the shared memory object, empty for heap blocks
+    char* allocated;   ///< the heap allocation, before alignment
+};
+
+std::mutex loanMutex;
+std::map<const char*, LoanBlock> loans;
+std::atomic<unsigned int> loanCounter {0};
+
+#if !defined(_WIN32)
+std::once_flag reclaimOnce;
+
+bool isAlive(pid_t pid)
+{
+    return ::kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+// The objects are unlinked by release(), therefore a process that crashed,
+// or did not release its blocks, leaves them behind.  They are reclaimed
+// before the first allocation of every process, including the ones of a
+// previous process with the same pid.
+void reclaimStale()
+{
+#    if defined(__linux__)
+    DIR* dir = ::opendir("/dev/shm");
+    if (dir == nullptr) {
+        return;
+    }
+    const std::string prefix = "yarp-loan-";
+    const pid_t self = ::getpid();
+    while (struct dirent* entry = ::readdir(dir)) {
+        const std::string file = entry->d_name;
+        if (file.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        char* end = nullptr;
+        long pid = std::strtol(file.c_str() + prefix.size(), &end, 10);
+        if (end == file.c_str() + prefix.size() || *end != '-' || pid <= 0) {
+            continue;
+        }
+        if (static_cast<pid_t>(pid) != self && isAlive(static_cast<pid_t>(pid))) {
+            continue;
+        }
+        const std::string name = "/" + file;
+        if (::shm_unlink(name.c_str()) == 0) {
+            yCDebug(MEMORYLOAN, "Reclaimed the stale object %s", name.c_str());
+        }
+    }
+    ::closedir(dir);
+#    endif
+}
+
+char* allocateShared(size_t size, std::string& name)
+{
+    std::call_once(reclaimOnce, reclaimStale);
+    name = "/yarp-loan-" + std::to_string(::getpid()) + "-" + std::to_string(loanCounter++);
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        yCDebug(MEMORYLOAN, "shm_open() error on %s: %d, %s", name.c_str(), errno, strerror(errno));
+        return nullptr;
+    }
+    void* addr = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        yCDebug(MEMORYLOAN, "Cannot map %s: %d, %s", name.c_str(), errno, strerror(errno));
+        ::shm_unlink(name.c_str());
+        return nullptr;
+    }
+    // mmap() returns page aligned memory
+    return static_cast<char*>(addr);
+}
+#endif
+
+} // namespace
+
+
+char* MemoryLoan::allocate(size_t size)
+{
+    if (size == 0) {
+        size = 1;
+    }
+
+    LoanBlock block {size, {}, nullptr};
+    char* data = nullptr;
+#if !defined(_WIN32)
+    data = allocateShared(size, block.name);
+#endif
+    if (data == nullptr) {
+        block.name.clear();
+        block.allocated = new (std::nothrow) char[size + alignment];
+        if (block.allocated == nullptr) {
+            yCError(MEMORYLOAN, "Cannot allocate %zu bytes", size);
+            return nullptr;
+        }
+        auto addr = reinterpret_cast<std::uintptr_t>(block.allocated);
+        data = block.allocated + (alignment - addr % alignment) % alignment;
+    }
+
+    std::lock_guard<std::mutex> lock(loanMutex);
+    loans.emplace(data, std::move(block));
+    return data;
+}
+
+void MemoryLoan::release(char* data)
+{
+    if (data == nullptr) {
+        return;
+    }
+
+    LoanBlock block;
+    {
+        std::lock_guard<std::mutex> lock(loanMutex);
+        auto it = loans.find(data);
+        if (it == loans.end()) {
+            yCError(MEMORYLOAN, "Releasing memory that was not allocated by MemoryLoan");
+            return;
+        }
+        block = std::move(it->second);
+        loans.erase(it);
+    }
+
+    if (block.allocated != nullptr) {
+        delete[] block.allocated;
+        return;
+    }
+#if !defined(_WIN32)
+    // The readers that already mapped the object keep it alive
+    ::munmap(data, block.size);
+    ::shm_unlink(block.name.c_str());
+#endif
+}
+
+bool MemoryLoan::find(const char* data, size_t length, std::string& name, size_t& offset)
+{
+    std::lock_guard<std::mutex> lock(loanMutex);
+    auto it = loans.upper_bound(data);
+    if (it == loans.begin()) {
+        return false;
+    }
+    --it;
+    const LoanBlock& block = it->second;
+    offset = static_cast<size_t>(data - it->first);
+    if (block.name.empty() || offset > block.size || length > block.size - offset) {
+        return false;
+    }
+    name = block.name;
+    return true;
+}
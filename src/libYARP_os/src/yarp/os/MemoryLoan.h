@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_MEMORYLOAN_H
+#define YARP_OS_MEMORYLOAN_H
+
+#include <yarp/os/api.h>
+
+#include <cstddef>
+#include <string>
+
+namespace yarp {
+namespace os {
+
+/**
+ * \ingroup key_class
+ *
+ * Memory lent by the transport layer to the application.
+ *
+ * Data written through a port are usually copied by the carrier, into the
+ * kernel or into a shared memory segment.  When large blocks (e.g. the
+ * pixels of an image) are allocated with MemoryLoan instead, carriers that
+ * connect processes on the same machine can publish them by reference, and
+ * the data are copied only once, by the reader.
+ *
+ * On POSIX systems each block is a separate shared memory object, that
+ * other processes can map using the name returned by find().  Elsewhere,
+ * or if the shared memory cannot be created, the block is plain heap
+ * memory and is always copied.  In both cases blocks are aligned to
+ * MemoryLoan::alignment bytes.
+ *
+ * A carrier publishing a block by reference does not complete the write
+ * until all the readers copied the data, therefore the block can be
+ * modified once the write is completed, e.g. when a BufferedPort returns
+ * the object again from prepare().
+ *
+ * \sa yarp::sig::Image::setLoaned()
+ */
+class YARP_os_API MemoryLoan
+{
+public:
+    /**
+     * The alignment of the blocks.
+     */
+    static constexpr size_t alignment = 64;
+
+    /**
+     * Allocate a block.
+     *
+     * @param size the size of the block
+     * @return the block, or nullptr if it cannot be allocated
+     */
+    static char* allocate(size_t size);
+
+    /**
+     * Free a block returned by allocate().
+     *
+     * @param data the block
+     */
+    static void release(char* data);
+
+    /**
+     * Find the shared memory object containing some data.
+     *
+     * @param data the data
+     * @param length the size of the data
+     * @param[out] name the name of the shared memory object, to be used
+     *             with shm_open()
+     * @param[out] offset the position of the data in the object
+     * @return true if the data are entirely contained in a block that can
+     *         be shared with other processes
+     */
+    static bool find(const char* data, size_t length, std::string& name, size_t& offset);
+};
+
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_MEMORYLOAN_H
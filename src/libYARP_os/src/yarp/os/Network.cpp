@@ -26,6 +26,7 @@
 #include <yarp/os/impl/BufferedConnectionWriter.h>
 #include <yarp/os/impl/LogComponent.h>
 #include <yarp/os/impl/LogForwarder.h>
+#include <yarp/os/impl/NameCache.h>
 #include <yarp/os/impl/NameConfig.h>
 #include <yarp/os/impl/PlatformSignal.h>
 #include <yarp/os/impl/PlatformStdio.h>
@@ -947,6 +948,9 @@ void NetworkBase::finiMinimum()
         // LogForwarded was not used.
         yarp::os::impl::LogForwarder::shutdown();
 
+        // Same for the port listening to the events of the name server
+        yarp::os::impl::NameCache::shutdown();
+
         Time::useSystemClock();
         yarp::os::impl::Time::removeClock();
 
@@ -1087,7 +1091,7 @@ bool NetworkBase::setConnectionQos(const std::string& src, const std::string& de
     yarp::os::Bottle reply;
 
     // ignore if everything left as default
-    if (srcStyle.getPacketPriorityAsTOS() != -1 || srcStyle.getThreadPolicy() != -1) {
+    if (srcStyle.getPacketPriorityAsTOS() != -1 || srcStyle.getThreadPolicy() != -1 || srcStyle.isLatestOnly() || srcStyle.getMaxRate() > 0) {
         // set the source Qos
         cmd.addString("prop");
         cmd.addString("set");
@@ -1101,6 +1105,11 @@ bool NetworkBase::setConnectionQos(const std::string& src, const std::string& de
         qos.addString("qos");
         Property& qos_prop = qos.addDict();
         qos_prop.put("tos", srcStyle.getPacketPriorityAsTOS());
+        if (srcStyle.isLatestOnly() || srcStyle.getMaxRate() > 0) {
+            // the policy for slow receivers only applies to the sender
+            qos_prop.put("latest", srcStyle.isLatestOnly());
+            qos_prop.put("rate", srcStyle.getMaxRate());
+        }
         Contact srcCon = Contact::fromString(src);
         bool ret = write(srcCon, cmd, reply, true, true, 2.0);
         if (!ret) {
@@ -1185,6 +1194,12 @@ static bool getPortQos(const std::string& port, const std::string& unit, QosStyl
     Bottle& qos = reply.findGroup("qos");
     Bottle* qos_prop = qos.find("qos").asList();
     style.setPacketPrioritybyTOS(qos_prop->find("tos").asInt32());
+    if (qos_prop->check("latest")) {
+        style.setLatestOnly(qos_prop->find("latest").asBool());
+    }
+    if (qos_prop->check("rate")) {
+        style.setMaxRate(qos_prop->find("rate").asFloat64());
+    }
 
     return true;
 }
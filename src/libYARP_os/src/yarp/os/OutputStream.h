@@ -12,6 +12,8 @@
 
 #include <yarp/os/api.h>
 
+#include <cstddef>
+
 namespace yarp {
 namespace os {
 
@@ -54,6 +56,18 @@ public:
      */
     virtual void write(const yarp::os::Bytes& b) = 0;
 
+    /**
+     * Write a sequence of blocks of bytes to the stream, as if they were
+     * a single block.  Streams that can hand several buffers to the
+     * operating system at once (e.g. with writev() or sendmsg()) override
+     * this to write all the blocks with a single system call.  By
+     * default, this calls write(const Bytes& b) for each block.
+     *
+     * @param blocks the blocks to write
+     * @param count the number of blocks
+     */
+    virtual void writeBlocks(const yarp::os::Bytes* blocks, size_t count);
+
     /**
      * Terminate the stream.
      */
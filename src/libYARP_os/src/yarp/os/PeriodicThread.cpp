@@ -10,9 +10,11 @@
 #include <yarp/os/PeriodicThread.h>
 
 #include <yarp/os/SystemClock.h>
+#include <yarp/os/impl/PeriodicThreadExecutor.h>
 #include <yarp/os/impl/PlatformTime.h>
 #include <yarp/os/impl/ThreadImpl.h>
 
+#include <atomic>
 #include <cmath>
 #include <mutex>
 
@@ -20,13 +22,22 @@ using namespace yarp::os::impl;
 using namespace yarp::os;
 
 
-class yarp::os::PeriodicThread::Private : public ThreadImpl
+class yarp::os::PeriodicThread::Private :
+        public ThreadImpl,
+        public PeriodicThreadExecutor::Task
 {
 private:
-    double adaptedPeriod;
+    // Read by the executor workers, and set by setPeriod() from any thread
+    std::atomic<double> adaptedPeriod;
     PeriodicThread* owner;
     mutable std::mutex mutex;
 
+    // Run by the PeriodicThreadExecutor instead of its own thread
+    bool scheduled;
+    std::atomic<bool> scheduledClosing;
+    std::atomic<bool> scheduledRunning;
+    const bool systemClock;
+
     double elapsed;
     double sleepPeriod;
 
@@ -62,6 +73,10 @@ public:
     Private(PeriodicThread* owner, double p, ShouldUseSystemClock useSystemClock) :
             adaptedPeriod(p),
             owner(owner),
+            scheduled(false),
+            scheduledClosing(false),
+            scheduledRunning(false),
+            systemClock(useSystemClock == ShouldUseSystemClock::Yes),
             elapsed(0),
             sleepPeriod(adaptedPeriod),
             suspended(false),
@@ -79,6 +94,13 @@ public:
     {
     }
 
+    ~Private() override
+    {
+        if (scheduled) {
+            stop();
+        }
+    }
+
     void resetStat()
     {
         scheduleReset = true;
@@ -153,7 +175,8 @@ public:
     }
 
 
-    void step()
+    // Run one iteration, and return the time it took
+    double runOnce()
     {
         lock();
         currentRun = nowFunc();
@@ -198,11 +221,92 @@ public:
         sumUsedSq += elapsed * elapsed;
         unlock();
 
+        return elapsed;
+    }
+
+    void step()
+    {
+        double elapsed = runOnce();
+
         sleepPeriod = adaptedPeriod - elapsed; // everything is in [seconds] except period, for it is used in the interface as [ms]
 
         delayFunc(sleepPeriod);
     }
 
+    bool start() override
+    {
+        // The executor keeps the deadlines on the system clock
+        scheduled = PeriodicThreadExecutor::isEnabled() && (systemClock || yarp::os::Time::isSystemClock());
+        if (!scheduled) {
+            return ThreadImpl::start();
+        }
+
+        // Same sequence as ThreadImpl::start(), threadInit() is called by
+        // the calling thread.
+        beforeStart();
+        bool success = threadInit();
+        afterStart(success);
+        if (!success) {
+            return false;
+        }
+        scheduledClosing = false;
+        scheduledRunning = true;
+        PeriodicThreadExecutor::getInstance().add(this);
+        return true;
+    }
+
+    void stop()
+    {
+        if (!scheduled) {
+            close();
+            return;
+        }
+        scheduledClosing = true;
+        if (PeriodicThreadExecutor::isRunningTask(this)) {
+            // Called by run(), threadRelease() is called when it returns
+            return;
+        }
+        if (PeriodicThreadExecutor::getInstance().remove(this)) {
+            finishTask();
+        }
+    }
+
+    void askToStop()
+    {
+        if (!scheduled) {
+            askToClose();
+            return;
+        }
+        scheduledClosing = true;
+    }
+
+    bool isRunning()
+    {
+        if (!scheduled) {
+            return ThreadImpl::isRunning();
+        }
+        return scheduledRunning;
+    }
+
+    bool runTask() override
+    {
+        if (!scheduledClosing) {
+            runOnce();
+        }
+        return !scheduledClosing;
+    }
+
+    double getTaskPeriod() const override
+    {
+        return adaptedPeriod;
+    }
+
+    void finishTask() override
+    {
+        threadRelease();
+        scheduledRunning = false;
+    }
+
     void run() override
     {
         while (!isClosing()) {
@@ -295,12 +399,12 @@ bool PeriodicThread::isSuspended() const
 
 void PeriodicThread::stop()
 {
-    mPriv->close();
+    mPriv->stop();
 }
 
 void PeriodicThread::askToStop()
 {
-    mPriv->askToClose();
+    mPriv->askToStop();
 }
 
 void PeriodicThread::step()
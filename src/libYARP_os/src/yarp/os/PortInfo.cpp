@@ -14,6 +14,8 @@ yarp::os::PortInfo::PortInfo() :
         tag(PORTINFO_NULL),
         incoming(false),
         created(true),
-        message("no information")
+        message("no information"),
+        dropped(0),
+        conflated(0)
 {
 }
@@ -14,6 +14,7 @@
 
 #include <yarp/os/Vocab.h>
 
+#include <cstddef>
 #include <string>
 
 
@@ -70,6 +71,14 @@ public:
 
     /// A human-readable description of contents.
     YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::string) message;
+
+    /// Number of messages not sent on an outgoing connection because of
+    /// its maximum rate, or because it was busy.
+    std::size_t dropped;
+
+    /// Number of messages replaced by a newer one before being sent on an
+    /// outgoing connection that keeps only the latest message.
+    std::size_t conflated;
 };
 
 } // namespace os
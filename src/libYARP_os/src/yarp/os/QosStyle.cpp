@@ -16,7 +16,9 @@
 yarp::os::QosStyle::QosStyle() :
         threadPriority(-1),
         threadPolicy(-1),
-        packetPriority(-1)
+        packetPriority(-1),
+        latestOnly(false),
+        maxRate(0.0)
 {
 }
 
@@ -143,6 +143,36 @@ public:
     }
 
 
+    /**
+     * @brief sets whether only the latest message should be kept when the
+     * receiver is slow.
+     *
+     * The messages written while the connection is still sending a previous
+     * one replace the one waiting to be sent, and are counted as conflated.
+     * The writer never waits for the receiver.
+     *
+     * @param latestOnly true to keep only the latest message
+     */
+    void setLatestOnly(bool latestOnly)
+    {
+        this->latestOnly = latestOnly;
+    }
+
+
+    /**
+     * @brief sets the maximum rate of the messages sent on the connection.
+     *
+     * The messages written faster than this rate are not sent, and are
+     * counted as dropped (or conflated, if setLatestOnly() is set).
+     *
+     * @param maxRate the maximum rate in Hz, 0 for no limit
+     */
+    void setMaxRate(double maxRate)
+    {
+        this->maxRate = maxRate;
+    }
+
+
     /**
      * @brief returns the packet TOS value
      * @return the TOS
@@ -187,6 +217,26 @@ public:
     }
 
 
+    /**
+     * @brief returns whether only the latest message is kept
+     * @return true if only the latest message is kept
+     */
+    bool isLatestOnly() const
+    {
+        return latestOnly;
+    }
+
+
+    /**
+     * @brief returns the maximum rate of the messages sent
+     * @return the rate in Hz, 0 if there is no limit
+     */
+    double getMaxRate() const
+    {
+        return maxRate;
+    }
+
+
     /**
      * @brief returns the IPV4/6 DSCP value given as DSCP code
      * @param vocab a DSCP code (e.g., CS0)
@@ -207,6 +257,8 @@ private:
     int threadPriority;
     int threadPolicy;
     int packetPriority;
+    bool latestOnly;
+    double maxRate;
 };
 
 } // namespace os
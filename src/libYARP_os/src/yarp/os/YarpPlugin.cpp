@@ -14,6 +14,7 @@
 #include <yarp/os/SystemClock.h>
 #include <yarp/os/impl/LogComponent.h>
 #include <yarp/os/impl/NameClient.h>
+#include <yarp/os/impl/PluginIndex.h>
 
 #include <cstdio>
 #include <cstdlib>
@@ -214,66 +215,23 @@ void YarpPluginSelector::scan()
     // This method needs to be accessed by one thread only
     std::lock_guard<std::mutex> guard(mutex);
 
-    // If it was scanned in the last 5 seconds, there is no need to scan again
-    bool need_scan = true;
-    if (config.check("last_update_time")) {
-        if (SystemClock::nowSystem() - config.find("last_update_time").asFloat64() < 5) {
-            need_scan = false;
-        }
-    }
-    if (!need_scan) {
+    // If the plugin configuration files did not change since the last scan,
+    // there is no need to select the plugins again.  A new selector always
+    // checks that the files did not change.
+    auto index = yarp::os::impl::PluginIndex::get(index_generation == 0);
+    if (index->generation == index_generation) {
         return;
     }
 
-    yCDebug(YARPPLUGINSETTINGS, "Scanning. I'm scanning. I hope you like scanning too.");
-
-    // Search plugins directories
-    ResourceFinder& rf = ResourceFinder::getResourceFinderSingleton();
-    if (!rf.isConfigured()) {
-        rf.configure(0, nullptr);
-    }
-    Bottle plugin_paths = rf.findPaths("plugins");
-    if (plugin_paths.size() == 0) {
-        plugin_paths = rf.findPaths("share/yarp/plugins");
-    }
-
-    // Search .ini files in plugins directories
-    config.clear();
-    if (plugin_paths.size() > 0) {
-        for (size_t i = 0; i < plugin_paths.size(); i++) {
-            std::string target = plugin_paths.get(i).asString();
-            yCDebug(YARPPLUGINSETTINGS, "Loading configuration files related to plugins from %s.",
-                       target.c_str());
-            config.fromConfigDir(target, "inifile", false);
-        }
-    } else {
-        yCDebug(YARPPLUGINSETTINGS, "Plugin directory not found");
-    }
-
-    // Read the .ini files and populate the lists
+    // Populate the lists
     plugins.clear();
-    search_path.clear();
-    Bottle inilst = config.findGroup("inifile").tail();
-    for (size_t i = 0; i < inilst.size(); i++) {
-        std::string inifile = inilst.get(i).asString();
-        Bottle inigroup = config.findGroup(inifile);
-        Bottle lst = inigroup.findGroup("plugin").tail();
-        for (size_t i = 0; i < lst.size(); i++) {
-            std::string plugin_name = lst.get(i).asString();
-            Bottle group = inigroup.findGroup(plugin_name);
-            group.add(Value::makeValue(std::string("(inifile \"") + inifile + "\")"));
-            if (select(group)) {
-                plugins.addList() = group;
-            }
-        }
-        lst = inigroup.findGroup("search").tail();
-        for (size_t i = 0; i < lst.size(); i++) {
-            std::string search_name = lst.get(i).asString();
-            Bottle group = inigroup.findGroup(search_name);
-            search_path.addList() = group;
+    for (size_t i = 0; i < index->plugins.size(); i++) {
+        Bottle* group = index->plugins.get(i).asList();
+        if (group != nullptr && select(*group)) {
+            plugins.addList() = *group;
         }
     }
+    search_path = index->search_path;
 
-    // Update last_update_time
-    config.put("last_update_time", SystemClock::nowSystem());
+    index_generation = index->generation;
 }
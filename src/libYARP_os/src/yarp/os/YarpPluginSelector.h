@@ -31,7 +31,7 @@ class YARP_os_API YarpPluginSelector
 private:
     Bottle plugins;
     Bottle search_path;
-    Property config;
+    std::size_t index_generation {0};
     mutable std::mutex mutex;
 
 public:
@@ -55,6 +55,9 @@ public:
     /**
      * Find plugin configuration files, and run [plugin] sections
      * through the select method.
+     *
+     * The configuration files are read once for all the selectors of the
+     * process, and are read again only if they change.
      */
     void scan();
 
@@ -70,6 +70,7 @@ void BufferedConnectionWriter::restart()
     reader = nullptr;
     ref = nullptr;
     convertTextModePending = false;
+    shouldDrop = false;
     target = &lst;
     target_used = &lst_used;
     stopPool();
@@ -359,14 +360,16 @@ bool BufferedConnectionWriter::write(ConnectionWriter& connection) const
 void BufferedConnectionWriter::write(OutputStream& os)
 {
     stopWrite();
+    // Hand all the buffers to the stream at once, so that it can send
+    // them with a single system call.
+    blocks.clear();
     for (size_t i = 0; i < header_used; i++) {
-        yarp::os::ManagedBytes& b = *(header[i]);
-        os.write(b.usedBytes());
+        blocks.push_back(header[i]->usedBytes());
     }
     for (size_t i = 0; i < lst_used; i++) {
-        yarp::os::ManagedBytes& b = *(lst[i]);
-        os.write(b.usedBytes());
+        blocks.push_back(lst[i]->usedBytes());
     }
+    os.writeBlocks(blocks.data(), blocks.size());
     os.flush();
 }
 
@@ -10,6 +10,7 @@
 #ifndef YARP_OS_IMPL_BUFFEREDCONNECTIONWRITER_H
 #define YARP_OS_IMPL_BUFFEREDCONNECTIONWRITER_H
 
+#include <yarp/os/Bytes.h>
 #include <yarp/os/ConnectionWriter.h>
 #include <yarp/os/SizedWriter.h>
 
@@ -82,6 +83,8 @@ public:
      * of the new object matches that of what came before, the buffers
      * will be reused without any new memory allocation being necessary.
      * If the structure differs, memory allocation may be needed.
+     * A drop requested with requestDrop() for the previous object is
+     * cleared.
      */
     void restart();
 
@@ -253,6 +256,7 @@ private:
     YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<yarp::os::ManagedBytes*>) lst;     ///< buffers in payload
     YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<yarp::os::ManagedBytes*>) header;  ///< buffers in header
     YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<yarp::os::ManagedBytes*>*) target; ///< points to header or payload
+    YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<yarp::os::Bytes>) blocks;          ///< buffers in use, passed to OutputStream::writeBlocks
     yarp::os::ManagedBytes* pool; ///< the pool buffer (in lst or header)
     size_t poolIndex;             ///< current offset into pool buffer
     size_t poolCount;             ///< number of pool buffers allocated
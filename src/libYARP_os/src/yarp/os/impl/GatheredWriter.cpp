@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/GatheredWriter.h>
+
+#include <utility>
+
+using yarp::os::Bytes;
+using yarp::os::impl::GatheredWriter;
+
+constexpr size_t GatheredWriter::maxGatheredWrite;
+constexpr size_t GatheredWriter::maxPending;
+constexpr int GatheredWriter::maxBlocks;
+
+GatheredWriter::GatheredWriter(Sender sender) :
+        sender(std::move(sender))
+{
+}
+
+void GatheredWriter::beginPacket()
+{
+    gathering = true;
+}
+
+void GatheredWriter::endPacket()
+{
+    gathering = false;
+    flush();
+}
+
+void GatheredWriter::write(const Bytes& b)
+{
+    if (gathering && b.length() <= maxGatheredWrite) {
+        if (pending.size() + b.length() > maxPending) {
+            flush();
+        }
+        pending.insert(pending.end(), b.get(), b.get() + b.length());
+        return;
+    }
+    writeBlocks(&b, 1);
+}
+
+void GatheredWriter::writeBlocks(const Bytes* blocks, size_t count)
+{
+    iovec iov[maxBlocks];
+    int n = 0;
+    if (!pending.empty()) {
+        iov[n].iov_base = pending.data();
+        iov[n].iov_len = pending.size();
+        n++;
+    }
+    bool ok = true;
+    for (size_t i = 0; i < count && ok; i++) {
+        if (blocks[i].length() == 0) {
+            continue;
+        }
+        iov[n].iov_base = const_cast<char*>(blocks[i].get());
+        iov[n].iov_len = blocks[i].length();
+        n++;
+        if (n == maxBlocks) {
+            ok = sender(iov, n);
+            n = 0;
+        }
+    }
+    if (ok && n > 0) {
+        sender(iov, n);
+    }
+    pending.clear();
+}
+
+void GatheredWriter::flush()
+{
+    if (pending.empty()) {
+        return;
+    }
+    writeBlocks(nullptr, 0);
+}
+
+void GatheredWriter::clear()
+{
+    pending.clear();
+}
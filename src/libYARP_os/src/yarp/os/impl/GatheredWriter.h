@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_IMPL_GATHEREDWRITER_H
+#define YARP_OS_IMPL_GATHEREDWRITER_H
+
+#include <yarp/os/api.h>
+#include <yarp/os/Bytes.h>
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#ifdef YARP_HAS_ACE
+#    include <ace/os_include/sys/os_uio.h>
+// In one the ACE headers there is a definition of "main" for WIN32
+#    ifdef main
+#        undef main
+#    endif
+#else
+#    include <sys/uio.h>
+#endif
+
+namespace yarp {
+namespace os {
+namespace impl {
+
+/**
+ * Collect the writes of a packet on a stream, so that they are sent with a
+ * few gathered system calls.
+ *
+ * Between beginPacket() and endPacket() small writes are copied into a
+ * pending buffer, while larger ones are sent immediately together with the
+ * pending data.  The stream provides the function that sends a list of
+ * buffers, e.g. with writev().
+ */
+class YARP_os_impl_API GatheredWriter
+{
+public:
+    static constexpr size_t maxGatheredWrite = 1024; ///< writes up to this size are copied
+    static constexpr size_t maxPending = 65536;      ///< size of the pending data sent anyway
+    static constexpr int maxBlocks = 64;             ///< buffers sent with a single call
+
+    /**
+     * Send some buffers, and return false on errors.
+     */
+    using Sender = std::function<bool(const iovec* iov, int count)>;
+
+    explicit GatheredWriter(Sender sender);
+
+    /**
+     * Start collecting the small writes.
+     */
+    void beginPacket();
+
+    /**
+     * Stop collecting the small writes, and send the pending data.
+     */
+    void endPacket();
+
+    /**
+     * Write a block, or copy it if it is small and a packet is being
+     * collected.
+     */
+    void write(const yarp::os::Bytes& b);
+
+    /**
+     * Send the pending data followed by some blocks.
+     */
+    void writeBlocks(const yarp::os::Bytes* blocks, size_t count);
+
+    /**
+     * Send the pending data, if any.
+     */
+    void flush();
+
+    /**
+     * Drop the pending data, e.g. when the stream is closed.
+     */
+    void clear();
+
+private:
+    Sender sender;
+    bool gathering {false};    ///< small writes are being collected, until the end of the packet
+    std::vector<char> pending; ///< small writes not sent yet
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_IMPL_GATHEREDWRITER_H
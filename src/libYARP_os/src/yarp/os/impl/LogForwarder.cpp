@@ -8,16 +8,70 @@
 
 #include <yarp/os/impl/LogForwarder.h>
 
+#include <yarp/conf/environment.h>
+
 #include <yarp/os/Log.h>
 #include <yarp/os/NetType.h>
 #include <yarp/os/Network.h>
 #include <yarp/os/Os.h>
 #include <yarp/os/SystemInfo.h>
 #include <yarp/os/Time.h>
+#include <yarp/os/impl/LogComponent.h>
 #include <yarp/os/impl/PlatformLimits.h>
 
+#include <chrono>
+#include <cstdlib>
 #include <sstream>
 
+namespace {
+YARP_OS_LOG_COMPONENT(LOGFORWARDER, "yarp.os.impl.LogForwarder")
+
+constexpr size_t default_buffer_size = 1024;
+
+// Maximum number of messages written in the same Bottle
+constexpr size_t max_batch_size = 128;
+
+// The thread writes as soon as this many messages are queued, otherwise
+// it waits at most flush_period
+constexpr size_t wake_size = 32;
+constexpr std::chrono::milliseconds flush_period(10);
+
+size_t getBufferSize()
+{
+    std::string size = yarp::conf::environment::getEnvironment("YARP_FORWARD_LOG_BUFFER_SIZE");
+    if (!size.empty()) {
+        int n = std::atoi(size.c_str());
+        if (n > 0) {
+            return static_cast<size_t>(n);
+        }
+        yCWarning(LOGFORWARDER, "Invalid YARP_FORWARD_LOG_BUFFER_SIZE \"%s\", using %zu", size.c_str(), default_buffer_size);
+    }
+    return default_buffer_size;
+}
+
+yarp::os::impl::LogRing::OverflowPolicy getOverflowPolicy()
+{
+    std::string policy = yarp::conf::environment::getEnvironment("YARP_FORWARD_LOG_OVERFLOW");
+    if (policy == "drop_newest") {
+        return yarp::os::impl::LogRing::OverflowPolicy::DropNewest;
+    }
+    if (!policy.empty() && policy != "drop_oldest") {
+        yCWarning(LOGFORWARDER, "Invalid YARP_FORWARD_LOG_OVERFLOW \"%s\", using drop_oldest", policy.c_str());
+    }
+    return yarp::os::impl::LogRing::OverflowPolicy::DropOldest;
+}
+
+std::string timestamps()
+{
+    std::ostringstream ost;
+    auto systemtime = yarp::os::SystemClock::nowSystem();
+    auto networktime = (!yarp::os::NetworkBase::isNetworkInitialized() ? 0.0 : (yarp::os::Time::isSystemClock() ? systemtime : yarp::os::Time::now()));
+    ost << " (systemtime " << yarp::os::NetType::toString(systemtime)  << ")";
+    ost << " (networktime " << yarp::os::NetType::toString(networktime)  << ")";
+    return ost.str();
+}
+} // namespace
+
 bool yarp::os::impl::LogForwarder::started{false};
 
 yarp::os::impl::LogForwarder& yarp::os::impl::LogForwarder::getInstance()
@@ -26,9 +80,13 @@ yarp::os::impl::LogForwarder& yarp::os::impl::LogForwarder::getInstance()
     return instance;
 }
 
-yarp::os::impl::LogForwarder::~LogForwarder() = default;
+yarp::os::impl::LogForwarder::~LogForwarder()
+{
+    stop();
+}
 
-yarp::os::impl::LogForwarder::LogForwarder()
+yarp::os::impl::LogForwarder::LogForwarder() :
+        ring(getBufferSize(), getOverflowPolicy())
 {
     char hostname[HOST_NAME_MAX];
     yarp::os::gethostname(hostname, HOST_NAME_MAX);
@@ -40,37 +98,85 @@ yarp::os::impl::LogForwarder::LogForwarder()
     if (!outputPort.open(logPortName)) {
         printf("LogForwarder error while opening port %s\n", logPortName.c_str());
     }
-    outputPort.enableBackgroundWrite(true);
+    // The messages are written by the thread, that can wait for the port
     outputPort.addOutput("/yarplogger", "fast_tcp");
+    header = "[" + outputPort.getName() + "]";
+
+    thread = std::thread(&LogForwarder::run, this);
 
     started = true;
 }
 
 void yarp::os::impl::LogForwarder::forward(const std::string& message)
 {
-    mutex.lock();
-    static Bottle b;
-    b.clear();
-    std::string port = "[" + outputPort.getName() + "]";
-    b.addString(port);
-    b.addString(message);
-    outputPort.write(b);
-    mutex.unlock();
+    ring.push(std::string(message));
+    if (ring.size() >= wake_size) {
+        // A wake up missed while the thread is not waiting yet only
+        // delays the messages by flush_period.
+        cv.notify_one();
+    }
+}
+
+size_t yarp::os::impl::LogForwarder::getDropped() const
+{
+    return dropped.load();
 }
 
-void yarp::os::impl::LogForwarder::shutdown()
+void yarp::os::impl::LogForwarder::run()
 {
-    if (started) {
-        std::ostringstream ost;
-        auto systemtime = yarp::os::SystemClock::nowSystem();
-        auto networktime = (!yarp::os::NetworkBase::isNetworkInitialized() ? 0.0 : (yarp::os::Time::isSystemClock() ? systemtime : yarp::os::Time::now()));
+    while (true) {
+        bool done = stopping.load();
+        flush();
+        if (done) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait_for(lock, flush_period, [this]() { return stopping.load() || ring.size() >= wake_size; });
+    }
+}
+
+void yarp::os::impl::LogForwarder::flush()
+{
+    std::string message;
+    Bottle b;
+    while (true) {
+        b.clear();
+        b.addString(header);
+        size_t lost = ring.takeDropped();
+        if (lost != 0) {
+            dropped += lost;
+            b.addString("(level WARNING) (message \"" + std::to_string(lost) + " log messages were dropped\")" + timestamps());
+        }
+        while (b.size() <= max_batch_size && ring.pop(message)) {
+            b.addString(message);
+        }
+        if (b.size() == 1) {
+            return;
+        }
+        outputPort.write(b);
+        if (b.size() <= max_batch_size) {
+            return;
+        }
+    }
+}
 
-        ost << "(level INFO)";
-        ost << " (systemtime " << yarp::os::NetType::toString(systemtime)  << ")";
-        ost << " (networktime " << yarp::os::NetType::toString(networktime)  << ")";
+void yarp::os::impl::LogForwarder::stop()
+{
+    if (!thread.joinable()) {
+        return;
+    }
+    stopping = true;
+    cv.notify_one();
+    thread.join();
+}
 
+void yarp::os::impl::LogForwarder::shutdown()
+{
+    if (started) {
         yarp::os::impl::LogForwarder& fw = getInstance();
-        fw.forward(ost.str());
+        fw.forward("(level INFO)" + timestamps());
+        // The thread writes the queued messages before stopping
+        fw.stop();
         while (fw.outputPort.isWriting()) {
             yarp::os::SystemClock::delaySystem(0.2);
         }
@@ -12,14 +12,31 @@
 #include <yarp/os/api.h>
 
 #include <yarp/os/Port.h>
+#include <yarp/os/impl/LogRing.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <string>
+#include <thread>
 
 namespace yarp {
 namespace os {
 namespace impl {
 
+/**
+ * Forwards the log messages to the yarplogger.
+ *
+ * forward() only queues the message in a LogRing, and never waits for the
+ * port.  A background thread writes the queued messages, many in the same
+ * Bottle, as [port] message1 message2 ...
+ *
+ * The size of the queue is set by the YARP_FORWARD_LOG_BUFFER_SIZE
+ * environment variable (default 1024).  When it is full, the oldest message
+ * is dropped, or the newest one if YARP_FORWARD_LOG_OVERFLOW is set to
+ * "drop_newest", and a warning with the number of dropped messages is
+ * forwarded with the next batch.
+ */
 class YARP_os_impl_API LogForwarder
 {
 public:
@@ -29,13 +46,28 @@ public:
     void forward(const std::string& message);
     static void shutdown();
 
+    /**
+     * @return the number of messages dropped because the queue was full
+     */
+    size_t getDropped() const;
+
 private:
     LogForwarder();
     LogForwarder(LogForwarder const&) = delete;
     LogForwarder& operator=(LogForwarder const&) = delete;
 
-    std::mutex mutex;
+    void run();
+    void flush();
+    void stop();
+
+    LogRing ring;
+    std::thread thread;
+    std::mutex mutex;                   ///< only used to wait for messages
+    std::condition_variable cv;
+    std::atomic<bool> stopping {false};
+    std::atomic<size_t> dropped {0};
     yarp::os::Port outputPort;
+    std::string header;
     static bool started;
 };
 
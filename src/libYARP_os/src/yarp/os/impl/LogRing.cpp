@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/LogRing.h>
+
+using yarp::os::impl::LogRing;
+
+namespace {
+// How many times push() drops the oldest message to make room for a new
+// one.  A thread popping a slot keeps it busy until it has taken the
+// message, and other threads may fill the room just made, so the new
+// message is dropped instead after these attempts.
+constexpr int max_push_attempts = 8;
+
+size_t roundUp(size_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    return size;
+}
+} // namespace
+
+LogRing::LogRing(size_t capacity, OverflowPolicy policy) :
+        slots(nullptr),
+        mask(roundUp(capacity) - 1),
+        policy(policy)
+{
+    slots = new Slot[mask + 1];
+    for (size_t i = 0; i <= mask; i++) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+LogRing::~LogRing()
+{
+    delete[] slots;
+}
+
+bool LogRing::tryPush(std::string& message)
+{
+    size_t pos = pushPos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[pos & mask];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            // The slot is free, take the position
+            if (pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The slot still holds the message pushed one lap before
+            return false;
+        } else {
+            pos = pushPos.load(std::memory_order_relaxed);
+        }
+    }
+    slot->message.swap(message);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogRing::push(std::string&& message)
+{
+    bool ok = true;
+    int attempts = 0;
+    while (!tryPush(message)) {
+        ok = false;
+        if (policy == OverflowPolicy::DropNewest || ++attempts > max_push_attempts) {
+            dropped++;
+            return false;
+        }
+        std::string oldest;
+        if (pop(oldest)) {
+            dropped++;
+        }
+    }
+    return ok;
+}
+
+bool LogRing::pop(std::string& message)
+{
+    size_t pos = popPos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[pos & mask];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+        if (diff == 0) {
+            // The slot holds a message, take the position
+            if (popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Nothing was pushed here yet
+            return false;
+        } else {
+            pos = popPos.load(std::memory_order_relaxed);
+        }
+    }
+    message.clear();
+    message.swap(slot->message);
+    // Free the slot for the push one lap later
+    slot->sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+}
+
+size_t LogRing::size() const
+{
+    size_t push = pushPos.load(std::memory_order_relaxed);
+    size_t pop = popPos.load(std::memory_order_relaxed);
+    return (push > pop) ? push - pop : 0;
+}
+
+size_t LogRing::capacity() const
+{
+    return mask + 1;
+}
+
+size_t LogRing::takeDropped()
+{
+    return dropped.exchange(0);
+}
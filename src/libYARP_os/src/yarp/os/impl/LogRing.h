@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_IMPL_LOGRING_H
+#define YARP_OS_IMPL_LOGRING_H
+
+#include <yarp/os/api.h>
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+namespace yarp {
+namespace os {
+namespace impl {
+
+/**
+ * A bounded lock-free queue of log messages.
+ *
+ * Any number of threads can push() and pop() concurrently, without taking
+ * a lock.  Each slot carries a sequence number telling whether it can be
+ * written or read at a given position, so a thread only retries when
+ * another thread took the same position first.
+ *
+ * When the queue is full, push() either discards the oldest message
+ * (DropOldest) or the new one (DropNewest), and counts it as dropped.
+ * With DropOldest, if there is still no room after dropping a few messages
+ * (the slots are being popped, or refilled by other threads), the new
+ * message is dropped too, so that push() never spins.
+ */
+class YARP_os_impl_API LogRing
+{
+public:
+    enum class OverflowPolicy
+    {
+        DropOldest,
+        DropNewest
+    };
+
+    /**
+     * @param capacity the maximum number of messages, rounded up to a
+     *                 power of 2
+     */
+    explicit LogRing(size_t capacity, OverflowPolicy policy = OverflowPolicy::DropOldest);
+    ~LogRing();
+    LogRing(const LogRing&) = delete;
+    LogRing& operator=(const LogRing&) = delete;
+
+    /**
+     * Queue a message, never blocks.
+     *
+     * @return false if a message was dropped
+     */
+    bool push(std::string&& message);
+
+    /**
+     * Take the oldest message.
+     *
+     * @return false if the queue is empty
+     */
+    bool pop(std::string& message);
+
+    /**
+     * @return the number of messages queued, only an estimate while other
+     *         threads are pushing or popping
+     */
+    size_t size() const;
+
+    size_t capacity() const;
+
+    /**
+     * @return the number of messages dropped since the last call
+     */
+    size_t takeDropped();
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        std::string message;
+    };
+
+    bool tryPush(std::string& message);
+
+    Slot* slots;
+    size_t mask;
+    OverflowPolicy policy;
+    std::atomic<size_t> pushPos {0};
+    std::atomic<size_t> popPos {0};
+    std::atomic<size_t> dropped {0};
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_IMPL_LOGRING_H
@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/NameCache.h>
+
+#include <yarp/conf/environment.h>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/ContactStyle.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Port.h>
+#include <yarp/os/PortReader.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/os/Vocab.h>
+#include <yarp/os/impl/LogComponent.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace yarp::os;
+using namespace yarp::os::impl;
+
+namespace {
+YARP_OS_LOG_COMPONENT(NAMECACHE, "yarp.os.impl.NameCache")
+
+constexpr double defaultTimeout = 1.0;
+constexpr double defaultNegativeTimeout = 0.1;
+
+// Expired entries are dropped when the cache grows beyond this size
+constexpr size_t pruneSize = 4096;
+
+/*
+  Reads the events announced by the name server
+*/
+class NameEventReader : public PortReader
+{
+private:
+    NameCache& cache;
+
+public:
+    NameEventReader(NameCache& cache) :
+            cache(cache)
+    {
+    }
+
+    bool read(ConnectionReader& connection) override
+    {
+        Bottle event;
+        if (!event.read(connection)) {
+            return false;
+        }
+        cache.onEvent(event);
+        return true;
+    }
+};
+
+} // namespace
+
+
+NameCache::NameCache() :
+        timeout(defaultTimeout),
+        negativeTimeout(defaultNegativeTimeout)
+{
+    bool found = false;
+    std::string ttl = yarp::conf::environment::getEnvironment("YARP_NAME_CACHE_TTL", &found);
+    if (found && !ttl.empty()) {
+        double t = std::atof(ttl.c_str());
+        setTimeout(t, std::min(t, defaultNegativeTimeout));
+    }
+}
+
+NameCache::~NameCache()
+{
+    stopListening();
+}
+
+NameCache& NameCache::getInstance()
+{
+    static NameCache instance;
+    return instance;
+}
+
+void NameCache::setTimeout(double timeout, double negativeTimeout)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->timeout = timeout;
+    this->negativeTimeout = negativeTimeout;
+    if (timeout <= 0) {
+        entries.clear();
+    }
+}
+
+double NameCache::getTimeout() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return timeout;
+}
+
+bool NameCache::lookup(const std::string& server, const std::string& name, Contact& contact)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (timeout <= 0) {
+            return false;
+        }
+        auto it = entries.find(name);
+        if (it != entries.end() && it->second.server == server) {
+            if (it->second.expiry >= SystemClock::nowSystem()) {
+                hits++;
+                contact = it->second.contact;
+                return true;
+            }
+            entries.erase(it);
+        }
+        misses++;
+    }
+
+    if (!listenChecked.exchange(true)) {
+        if (yarp::conf::environment::getEnvironment("YARP_NAME_CACHE_LISTEN") == "1") {
+            listen();
+        }
+    }
+    return false;
+}
+
+void NameCache::store(const std::string& server, const std::string& name, const Contact& contact)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    double ttl = contact.isValid() ? timeout : negativeTimeout;
+    if (timeout <= 0 || ttl <= 0 || name.empty()) {
+        return;
+    }
+    double now = SystemClock::nowSystem();
+    if (entries.size() >= pruneSize) {
+        prune(now);
+    }
+    Entry& entry = entries[name];
+    entry.server = server;
+    entry.contact = contact;
+    entry.expiry = now + ttl;
+}
+
+bool NameCache::invalidate(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (entries.erase(name) == 0) {
+        return false;
+    }
+    invalidations++;
+    return true;
+}
+
+void NameCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+}
+
+void NameCache::onEvent(const Bottle& event)
+{
+    int32_t code = event.get(0).asVocab();
+    if (code == yarp::os::createVocab('a', 'd', 'd') || code == yarp::os::createVocab('d', 'e', 'l')) {
+        yCDebug(NAMECACHE, "Name server event %s", event.toString().c_str());
+        invalidate(event.get(1).asString());
+    }
+}
+
+bool NameCache::listen()
+{
+    std::lock_guard<std::mutex> lock(listenMutex);
+    if (eventPort != nullptr) {
+        return true;
+    }
+
+    eventReader = new NameEventReader(*this);
+    eventPort = new Port;
+    eventPort->setInputMode(true);
+    eventPort->setOutputMode(false);
+    eventPort->setReader(*eventReader);
+    // An anonymous port, it is not registered
+    bool ok = eventPort->open("");
+    if (ok) {
+        ContactStyle style;
+        style.quiet = true;
+        ok = NetworkBase::connect(NetworkBase::getNameServerName(), eventPort->getName(), style);
+    }
+    if (!ok) {
+        yCWarning(NAMECACHE, "Cannot listen to the events of the name server");
+        eventPort->close();
+        delete eventPort;
+        eventPort = nullptr;
+        delete eventReader;
+        eventReader = nullptr;
+        return false;
+    }
+    yCDebug(NAMECACHE, "Listening to the events of the name server on %s", eventPort->getName().c_str());
+    return true;
+}
+
+void NameCache::shutdown()
+{
+    NameCache& cache = getInstance();
+    cache.stopListening();
+    cache.clear();
+    cache.listenChecked = false;
+}
+
+void NameCache::stopListening()
+{
+    std::lock_guard<std::mutex> lock(listenMutex);
+    if (eventPort != nullptr) {
+        eventPort->interrupt();
+        eventPort->close();
+        delete eventPort;
+        eventPort = nullptr;
+    }
+    delete eventReader;
+    eventReader = nullptr;
+}
+
+size_t NameCache::getHits() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+size_t NameCache::getMisses() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+size_t NameCache::getInvalidations() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return invalidations;
+}
+
+size_t NameCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+void NameCache::prune(double now)
+{
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.expiry < now) {
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    // Still too many live names, start over
+    if (entries.size() >= pruneSize) {
+        entries.clear();
+    }
+}
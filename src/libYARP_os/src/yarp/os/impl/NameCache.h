@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_IMPL_NAMECACHE_H
+#define YARP_OS_IMPL_NAMECACHE_H
+
+#include <yarp/os/api.h>
+
+#include <yarp/os/Contact.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace yarp {
+namespace os {
+
+class Bottle;
+class Port;
+class PortReader;
+
+namespace impl {
+
+/**
+ * Process-wide cache of the addresses returned by the name servers.
+ *
+ * Each entry expires after a timeout (1 second by default, or the value
+ * of the YARP_NAME_CACHE_TTL environment variable, 0 disables the cache).
+ * Names that are not registered are remembered too, as an invalid
+ * Contact, with a shorter timeout so that a new port is noticed quickly.
+ *
+ * An entry is dropped when the port is registered or unregistered by this
+ * process, when a connection to its address fails, or when the name
+ * server announces the change, if listen() was called.
+ */
+class YARP_os_impl_API NameCache
+{
+public:
+    NameCache();
+    ~NameCache();
+    NameCache(const NameCache&) = delete;
+    NameCache& operator=(const NameCache&) = delete;
+
+    static NameCache& getInstance();
+
+    /**
+     * Set how long the entries are valid.
+     *
+     * @param timeout time to live of an address, in seconds (<= 0 to
+     *                disable the cache)
+     * @param negativeTimeout time to live of an unregistered name
+     */
+    void setTimeout(double timeout, double negativeTimeout);
+
+    double getTimeout() const;
+
+    /**
+     * Look up a name.
+     *
+     * @param server the name server that would answer the query
+     * @param name the name of the port
+     * @param[out] contact the cached address, invalid if the name is not
+     *                     registered
+     * @return true if the name was found and is not expired
+     */
+    bool lookup(const std::string& server, const std::string& name, Contact& contact);
+
+    /**
+     * Store the address of a name, or an invalid Contact if the name is
+     * not registered.
+     */
+    void store(const std::string& server, const std::string& name, const Contact& contact);
+
+    /**
+     * Forget a name.
+     *
+     * @return true if the name was in the cache
+     */
+    bool invalidate(const std::string& name);
+
+    void clear();
+
+    /**
+     * Handle an event announced by the name server, (add /port) or
+     * (del /port).
+     */
+    void onEvent(const yarp::os::Bottle& event);
+
+    /**
+     * Listen to the events announced by the current name server, with an
+     * anonymous port.
+     *
+     * This is done at the first lookup when the YARP_NAME_CACHE_LISTEN
+     * environment variable is set to 1.  Every port registration is sent
+     * to every listener, so it is not enabled by default.
+     *
+     * @return true on success
+     */
+    bool listen();
+
+    /**
+     * Close the port listening to the name server, if any.
+     */
+    static void shutdown();
+
+    size_t getHits() const;
+    size_t getMisses() const;
+    size_t getInvalidations() const;
+    size_t size() const;
+
+private:
+    struct Entry
+    {
+        std::string server;
+        Contact contact;
+        double expiry;
+    };
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    double timeout;
+    double negativeTimeout;
+    size_t hits {0};
+    size_t misses {0};
+    size_t invalidations {0};
+
+    std::mutex listenMutex;
+    std::atomic<bool> listenChecked {false};
+    yarp::os::Port* eventPort {nullptr};
+    yarp::os::PortReader* eventReader {nullptr};
+
+    void prune(double now);
+    void stopListening();
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_IMPL_NAMECACHE_H
@@ -19,6 +19,7 @@
 #include <yarp/os/Os.h>
 #include <yarp/os/impl/FallbackNameClient.h>
 #include <yarp/os/impl/LogComponent.h>
+#include <yarp/os/impl/NameCache.h>
 #include <yarp/os/impl/NameConfig.h>
 #include <yarp/os/impl/NameServer.h>
 #include <yarp/os/impl/TcpFace.h>
@@ -102,6 +103,16 @@ public:
         argc = at;
     }
 };
+
+// A register or unregister command changes the address of a port
+void invalidateOnChange(const Bottle& cmd)
+{
+    size_t at = (cmd.get(0).asString() == "NAME_SERVER") ? 1 : 0;
+    std::string act = cmd.get(at).asString();
+    if (act == "register" || act == "unregister") {
+        NameCache::getInstance().invalidate(cmd.get(at + 1).asString());
+    }
+}
 } // namespace
 
 
@@ -160,7 +171,19 @@ Contact NameClient::queryName(const std::string& name)
 
     std::string q("NAME_SERVER query ");
     q += name;
-    return probe(q);
+    if (!useCache()) {
+        return probe(q);
+    }
+
+    NameCache& cache = NameCache::getInstance();
+    std::string scope = getCacheScope();
+    Contact c;
+    if (cache.lookup(scope, name, c)) {
+        return c;
+    }
+    c = probe(q);
+    cache.store(scope, name, c);
+    return c;
 }
 
 Contact NameClient::registerName(const std::string& name)
@@ -220,6 +243,9 @@ Contact NameClient::registerName(const std::string& name, const Contact& suggest
     Contact address = extractAddress(reply);
     if (address.isValid()) {
         std::string reg = address.getRegName();
+        if (useCache()) {
+            NameCache::getInstance().store(getCacheScope(), reg, address);
+        }
 
 
         std::string cmdOffers = "set /port offers ";
@@ -258,7 +284,11 @@ Contact NameClient::unregisterName(const std::string& name)
 {
     std::string q("NAME_SERVER unregister ");
     q += name;
-    return probe(q);
+    Contact c = probe(q);
+    if (useCache()) {
+        NameCache::getInstance().store(getCacheScope(), name, Contact());
+    }
+    return c;
 }
 
 Contact NameClient::probe(const std::string& cmd)
@@ -301,6 +331,10 @@ std::string NameClient::send(const std::string& cmd, bool multi, const ContactSt
     yCTrace(NAMECLIENT, "*** OLD YARP command %s", cmd.c_str());
     setup();
 
+    if (cmd.find("register") != std::string::npos) {
+        invalidateOnChange(Bottle(cmd));
+    }
+
     if (NetworkBase::getQueryBypass() != nullptr) {
         ContactStyle style;
         Bottle bcmd(cmd);
@@ -404,6 +438,7 @@ std::string NameClient::send(const std::string& cmd, bool multi, const ContactSt
 bool NameClient::send(Bottle& cmd, Bottle& reply)
 {
     setup();
+    invalidateOnChange(cmd);
     if (NetworkBase::getQueryBypass() != nullptr) {
         ContactStyle style;
         NetworkBase::writeToNameServer(cmd, reply, style);
@@ -516,3 +551,15 @@ void NameClient::setup()
     }
     mutex.unlock();
 }
+
+bool NameClient::useCache()
+{
+    // A name server in this process is fast enough
+    return !isFakeMode() && NetworkBase::getQueryBypass() == nullptr;
+}
+
+std::string NameClient::getCacheScope()
+{
+    // The same name can be registered on different name servers
+    return getAddress().toURI();
+}
@@ -62,6 +62,10 @@ public:
 
     /**
      * Look up the address of a named port.
+     *
+     * The answers of the name server are kept for a short time in the
+     * NameCache.
+     *
      * @param name the name of the port
      * @return the address associated with the port
      */
@@ -213,6 +217,8 @@ private:
 
     NameServer& getServer();
     void setup();
+    bool useCache();
+    std::string getCacheScope();
 };
 
 } // namespace impl
@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/PeriodicThreadExecutor.h>
+
+#include <yarp/conf/environment.h>
+
+#include <yarp/os/Thread.h>
+#include <yarp/os/impl/LogComponent.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+using yarp::os::impl::PeriodicThreadExecutor;
+
+namespace {
+YARP_OS_LOG_COMPONENT(PERIODICTHREADEXECUTOR, "yarp.os.impl.PeriodicThreadExecutor")
+
+constexpr size_t default_pool_size = 4;
+
+size_t getPoolSize()
+{
+    std::string size = yarp::conf::environment::getEnvironment("YARP_PERIODIC_EXECUTOR_SIZE");
+    if (!size.empty()) {
+        int n = std::atoi(size.c_str());
+        if (n > 0) {
+            return static_cast<size_t>(n);
+        }
+        yCWarning(PERIODICTHREADEXECUTOR, "Invalid YARP_PERIODIC_EXECUTOR_SIZE \"%s\", using %zu workers", size.c_str(), default_pool_size);
+    }
+    return default_pool_size;
+}
+
+// -1 until the environment is read
+std::atomic<int> enabled {-1};
+
+// The task run by the current worker
+thread_local const PeriodicThreadExecutor::Task* current = nullptr;
+
+// Order of the heap, the earliest deadline on top
+struct Later
+{
+    template <typename Entry>
+    bool operator()(const Entry& a, const Entry& b) const
+    {
+        if (a.deadline != b.deadline) {
+            return a.deadline > b.deadline;
+        }
+        return a.sequence > b.sequence;
+    }
+};
+} // namespace
+
+
+namespace yarp {
+namespace os {
+namespace impl {
+
+class PeriodicThreadExecutorWorker : public yarp::os::Thread
+{
+public:
+    PeriodicThreadExecutor& pool;
+
+    explicit PeriodicThreadExecutorWorker(PeriodicThreadExecutor& pool) :
+            pool(pool)
+    {
+    }
+
+    void run() override
+    {
+        while (pool.process()) {
+            // forever
+        }
+    }
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+using yarp::os::impl::PeriodicThreadExecutorWorker;
+
+
+PeriodicThreadExecutor::Task::~Task() = default;
+
+PeriodicThreadExecutor& PeriodicThreadExecutor::getInstance()
+{
+    static PeriodicThreadExecutor instance;
+    return instance;
+}
+
+PeriodicThreadExecutor::PeriodicThreadExecutor() = default;
+
+PeriodicThreadExecutor::~PeriodicThreadExecutor()
+{
+    // Threads still running at exit may have left the workers running.
+    std::lock_guard<std::mutex> lifecycleLock(lifecycleMutex);
+    stopWorkers();
+}
+
+bool PeriodicThreadExecutor::isEnabled()
+{
+    int e = enabled.load();
+    if (e < 0) {
+        e = (yarp::conf::environment::getEnvironment("YARP_PERIODIC_EXECUTOR") == "1") ? 1 : 0;
+        enabled.store(e);
+    }
+    return e != 0;
+}
+
+void PeriodicThreadExecutor::setEnabled(bool enable)
+{
+    enabled.store(enable ? 1 : 0);
+}
+
+void PeriodicThreadExecutor::startWorkers()
+{
+    std::lock_guard<std::mutex> lifecycleLock(lifecycleMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (active) {
+            return;
+        }
+        active = true;
+    }
+
+    size_t size = getPoolSize();
+    yCDebug(PERIODICTHREADEXECUTOR, "starting %zu workers", size);
+    for (size_t i = 0; i < size; i++) {
+        auto* worker = new PeriodicThreadExecutorWorker(*this);
+        if (!worker->start()) {
+            yCError(PERIODICTHREADEXECUTOR, "cannot start worker thread");
+            delete worker;
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        workers.push_back(worker);
+    }
+}
+
+void PeriodicThreadExecutor::stopWorkers()
+{
+    std::vector<PeriodicThreadExecutorWorker*> stopping;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        active = false;
+        stopping.swap(workers);
+        queue.clear();
+        tasks.clear();
+    }
+    cv.notify_all();
+
+    yCDebug(PERIODICTHREADEXECUTOR, "stopping %zu workers", stopping.size());
+    for (auto* worker : stopping) {
+        worker->stop();
+        delete worker;
+    }
+}
+
+void PeriodicThreadExecutor::push(Clock::time_point deadline, Task* task)
+{
+    queue.push_back({deadline, sequence++, task});
+    std::push_heap(queue.begin(), queue.end(), Later());
+    if (queue.front().task == task) {
+        // The worker waiting for the earliest deadline must wait less
+        cv.notify_all();
+    }
+}
+
+void PeriodicThreadExecutor::add(Task* task)
+{
+    startWorkers();
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.insert(task);
+    push(Clock::now(), task);
+}
+
+bool PeriodicThreadExecutor::remove(Task* task)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    bool found = (tasks.erase(task) != 0);
+    auto it = std::find_if(queue.begin(), queue.end(), [&](const Entry& e) { return e.task == task; });
+    if (it != queue.end()) {
+        queue.erase(it);
+        std::make_heap(queue.begin(), queue.end(), Later());
+        cv.notify_all();
+    }
+    if (!isRunningTask(task)) {
+        cvDone.wait(lock, [&] { return std::find(busy.begin(), busy.end(), task) == busy.end(); });
+    }
+    return found;
+}
+
+bool PeriodicThreadExecutor::isRunningTask(const Task* task)
+{
+    return current == task;
+}
+
+size_t PeriodicThreadExecutor::getWorkerCount()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return workers.size();
+}
+
+size_t PeriodicThreadExecutor::getTaskCount()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return tasks.size();
+}
+
+bool PeriodicThreadExecutor::process()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (active) {
+        if (!queue.empty() && queue.front().deadline <= Clock::now()) {
+            break;
+        }
+        if (waiting) {
+            // Another worker is watching the clock
+            cv.wait(lock);
+            continue;
+        }
+        waiting = true;
+        if (queue.empty()) {
+            cv.wait(lock);
+        } else {
+            // Absolute deadline, on the monotonic clock
+            cv.wait_until(lock, queue.front().deadline);
+        }
+        waiting = false;
+    }
+    if (!active) {
+        return false;
+    }
+
+    std::pop_heap(queue.begin(), queue.end(), Later());
+    Entry entry = queue.back();
+    queue.pop_back();
+    busy.push_back(entry.task);
+    lock.unlock();
+    // Let another worker wait for the next deadline
+    cv.notify_one();
+
+    current = entry.task;
+    bool again = entry.task->runTask();
+    current = nullptr;
+
+    lock.lock();
+    if (tasks.count(entry.task) != 0) {
+        if (again) {
+            // The next deadline does not depend on when this one was
+            // served, unless a whole period was missed.
+            auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(entry.task->getTaskPeriod()));
+            auto next = entry.deadline + std::max(period, Clock::duration::zero());
+            auto now = Clock::now();
+            push((next < now) ? now : next, entry.task);
+        } else {
+            tasks.erase(entry.task);
+            lock.unlock();
+            current = entry.task;
+            entry.task->finishTask();
+            current = nullptr;
+            lock.lock();
+        }
+    }
+    // The same task may be scheduled again and picked by another worker,
+    // therefore remove a single entry.
+    busy.erase(std::find(busy.begin(), busy.end(), entry.task));
+    lock.unlock();
+    cvDone.notify_all();
+    return true;
+}
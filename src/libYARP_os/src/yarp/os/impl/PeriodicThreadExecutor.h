@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_IMPL_PERIODICTHREADEXECUTOR_H
+#define YARP_OS_IMPL_PERIODICTHREADEXECUTOR_H
+
+#include <yarp/os/api.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace yarp {
+namespace os {
+namespace impl {
+
+class PeriodicThreadExecutorWorker;
+
+/**
+ * A pool of worker threads shared by the PeriodicThreads of the process.
+ *
+ * Instead of sleeping in its own thread, each PeriodicThread is queued by
+ * its next deadline, and run by the first free worker when the deadline
+ * expires.  The next deadline is the previous one plus the period, so the
+ * time spent running and the wake up latency do not accumulate.
+ *
+ * This is enabled by setting the YARP_PERIODIC_EXECUTOR environment
+ * variable to 1, or by calling setEnabled().  The number of workers is set
+ * by YARP_PERIODIC_EXECUTOR_SIZE (default 4).  Only the threads using the
+ * system clock are run by the pool.
+ *
+ * The threads share the workers, so a run() that blocks keeps a worker
+ * busy, and delays every other thread of the pool once all the workers
+ * are blocked.  Do not enable the pool if the threads of the process may
+ * block in run().
+ */
+class YARP_os_impl_API PeriodicThreadExecutor
+{
+public:
+    /**
+     * A periodic task run by the pool.
+     */
+    class Task
+    {
+    public:
+        virtual ~Task();
+
+        /**
+         * Run one iteration.
+         *
+         * @return false if the task should not be scheduled anymore, then
+         *         finishTask() is called
+         */
+        virtual bool runTask() = 0;
+
+        /**
+         * @return the time between two iterations, in seconds
+         */
+        virtual double getTaskPeriod() const = 0;
+
+        /**
+         * Called by the worker that ran the last iteration.
+         */
+        virtual void finishTask() = 0;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @return the pool shared by all the periodic threads of the process.
+     */
+    static PeriodicThreadExecutor& getInstance();
+
+    PeriodicThreadExecutor(const PeriodicThreadExecutor&) = delete;
+    PeriodicThreadExecutor& operator=(const PeriodicThreadExecutor&) = delete;
+
+    /**
+     * @return true if the periodic threads started from now on should be
+     *         run by the pool.
+     */
+    static bool isEnabled();
+
+    static void setEnabled(bool enabled);
+
+    /**
+     * Schedule a task, the first iteration runs immediately.  The workers
+     * are started with the first task.
+     */
+    void add(Task* task);
+
+    /**
+     * Stop scheduling a task, and wait for any worker that is currently
+     * running it, unless called by that worker.
+     *
+     * @return true if the task was scheduled, false if it had already
+     *         finished (or it is finishing in another thread).
+     */
+    bool remove(Task* task);
+
+    /**
+     * @return true if the calling thread is a worker running the task.
+     */
+    static bool isRunningTask(const Task* task);
+
+    /**
+     * @return the number of worker threads currently running.
+     */
+    size_t getWorkerCount();
+
+    /**
+     * @return the number of tasks currently scheduled.
+     */
+    size_t getTaskCount();
+
+private:
+    friend class PeriodicThreadExecutorWorker;
+
+    struct Entry
+    {
+        Clock::time_point deadline;
+        std::uint64_t sequence; ///< FIFO order for equal deadlines
+        Task* task;
+    };
+
+    PeriodicThreadExecutor();
+    ~PeriodicThreadExecutor();
+
+    /**
+     * Wait for the earliest deadline, and run its task.
+     *
+     * @return false if the workers should stop
+     */
+    bool process();
+
+    void push(Clock::time_point deadline, Task* task);
+    void startWorkers();
+    void stopWorkers();
+
+    std::mutex lifecycleMutex;          ///< serialize starting and stopping the workers
+    std::mutex mutex;                   ///< protect the queue
+    std::condition_variable cv;         ///< signal when the earliest deadline changes
+    std::condition_variable cvDone;     ///< signal when a worker finishes a task
+    std::vector<Entry> queue;           ///< heap of the scheduled tasks, earliest first
+    std::unordered_set<Task*> tasks;    ///< the scheduled tasks
+    std::vector<Task*> busy;            ///< the tasks being run by a worker
+    std::vector<PeriodicThreadExecutorWorker*> workers;
+    std::uint64_t sequence {0};
+    bool waiting {false};               ///< a worker is waiting for the earliest deadline
+    bool active {false};
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_IMPL_PERIODICTHREADEXECUTOR_H
@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/PluginIndex.h>
+
+#include <yarp/conf/environment.h>
+
+#include <yarp/os/Os.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/ResourceFinder.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/os/impl/LogComponent.h>
+#include <yarp/os/impl/PlatformDirent.h>
+#include <yarp/os/impl/PlatformSysStat.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+using yarp::os::impl::PluginIndex;
+
+namespace {
+YARP_OS_LOG_COMPONENT(PLUGININDEX, "yarp.os.impl.PluginIndex")
+
+constexpr double check_period = 5.0;
+constexpr int cache_version = 1;
+
+struct State
+{
+    std::mutex mutex;
+    std::shared_ptr<const PluginIndex::Snapshot> snapshot;
+    std::string key;
+    double last_check {-1.0};
+    std::size_t generation {0};
+};
+
+State& getState()
+{
+    static State state;
+    return state;
+}
+
+bool cacheEnabled()
+{
+    std::string enabled = yarp::conf::environment::getEnvironment("YARP_PLUGIN_INDEX_CACHE");
+    return enabled != "0";
+}
+
+std::string cacheFile(bool mayCreate)
+{
+    std::string home = mayCreate ? yarp::os::ResourceFinder::getDataHome() : yarp::os::ResourceFinder::getDataHomeNoCreate();
+    if (home.empty()) {
+        return {};
+    }
+    std::string dir = home + "/cache";
+    if (mayCreate) {
+        yarp::os::mkdir_p(dir.c_str());
+    }
+    return dir + "/plugin_index.txt";
+}
+
+Bottle findPluginPaths()
+{
+    yarp::os::ResourceFinder& rf = yarp::os::ResourceFinder::getResourceFinderSingleton();
+    if (!rf.isConfigured()) {
+        rf.configure(0, nullptr);
+    }
+    Bottle plugin_paths = rf.findPaths("plugins");
+    if (plugin_paths.size() == 0) {
+        plugin_paths = rf.findPaths("share/yarp/plugins");
+    }
+    return plugin_paths;
+}
+
+// The list of (path (name mtime size) ...) for the .ini files of each path
+std::string computeKey(const Bottle& plugin_paths)
+{
+    Bottle key;
+    key.addInt32(cache_version);
+    for (size_t i = 0; i < plugin_paths.size(); i++) {
+        std::string dirname = plugin_paths.get(i).asString();
+        Bottle& dir = key.addList();
+        dir.addString(dirname);
+
+        yarp::os::impl::dirent** namelist;
+        int n = yarp::os::impl::scandir(dirname.c_str(), &namelist, nullptr, yarp::os::impl::alphasort);
+        if (n < 0) {
+            continue;
+        }
+        for (int j = 0; j < n; j++) {
+            std::string name = namelist[j]->d_name;
+            free(namelist[j]);
+            if (name.length() < 4 || name.substr(name.length() - 4) != ".ini") {
+                continue;
+            }
+            yarp::os::impl::YARP_stat st;
+            std::string fname = dirname + "/" + name;
+            if (yarp::os::impl::stat(fname.c_str(), &st) != 0) {
+                continue;
+            }
+            Bottle& file = dir.addList();
+            file.addString(name);
+            file.addInt64(static_cast<std::int64_t>(st.st_mtime));
+            file.addInt64(static_cast<std::int64_t>(st.st_size));
+        }
+        free(namelist);
+    }
+    return key.toString();
+}
+
+// Parse the .ini files, as YarpPluginSelector::scan() used to do
+void parse(const Bottle& plugin_paths, Bottle& plugins, Bottle& search_path)
+{
+    yarp::os::Property config;
+    if (plugin_paths.size() > 0) {
+        for (size_t i = 0; i < plugin_paths.size(); i++) {
+            std::string target = plugin_paths.get(i).asString();
+            yCDebug(PLUGININDEX, "Loading configuration files related to plugins from %s.", target.c_str());
+            config.fromConfigDir(target, "inifile", false);
+        }
+    } else {
+        yCDebug(PLUGININDEX, "Plugin directory not found");
+    }
+
+    Bottle inilst = config.findGroup("inifile").tail();
+    for (size_t i = 0; i < inilst.size(); i++) {
+        std::string inifile = inilst.get(i).asString();
+        Bottle inigroup = config.findGroup(inifile);
+        Bottle lst = inigroup.findGroup("plugin").tail();
+        for (size_t j = 0; j < lst.size(); j++) {
+            std::string plugin_name = lst.get(j).asString();
+            Bottle group = inigroup.findGroup(plugin_name);
+            group.add(Value::makeValue(std::string("(inifile \"") + inifile + "\")"));
+            plugins.addList() = group;
+        }
+        lst = inigroup.findGroup("search").tail();
+        for (size_t j = 0; j < lst.size(); j++) {
+            std::string search_name = lst.get(j).asString();
+            search_path.addList() = inigroup.findGroup(search_name);
+        }
+    }
+}
+
+bool readCache(const std::string& key, Bottle& plugins, Bottle& search_path)
+{
+    std::string fname = cacheFile(false);
+    if (fname.empty()) {
+        return false;
+    }
+    FILE* fin = fopen(fname.c_str(), "r");
+    if (fin == nullptr) {
+        return false;
+    }
+    std::string txt;
+    char buf[25600];
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), fin)) > 0) {
+        txt.append(buf, len);
+    }
+    fclose(fin);
+
+    Bottle cache(txt);
+    if (cache.find("key").asString() != key) {
+        yCDebug(PLUGININDEX, "Plugin index %s is out of date", fname.c_str());
+        return false;
+    }
+    Bottle* p = cache.find("plugins").asList();
+    Bottle* s = cache.find("search").asList();
+    if (p == nullptr || s == nullptr) {
+        return false;
+    }
+    plugins = *p;
+    search_path = *s;
+    yCDebug(PLUGININDEX, "Plugin index read from %s", fname.c_str());
+    return true;
+}
+
+void writeCache(const std::string& key, const Bottle& plugins, const Bottle& search_path)
+{
+    std::string fname = cacheFile(true);
+    if (fname.empty()) {
+        return;
+    }
+
+    Bottle cache;
+    Bottle& k = cache.addList();
+    k.addString("key");
+    k.addString(key);
+    Bottle& p = cache.addList();
+    p.addString("plugins");
+    p.addList() = plugins;
+    Bottle& s = cache.addList();
+    s.addString("search");
+    s.addList() = search_path;
+    std::string txt = cache.toString();
+
+    // Write a temporary file and rename it, so that other processes never
+    // read a partial index
+    std::string tmp = fname + "." + std::to_string(yarp::os::getpid());
+    FILE* fout = fopen(tmp.c_str(), "w");
+    if (fout == nullptr) {
+        yCDebug(PLUGININDEX, "Cannot write plugin index %s", tmp.c_str());
+        return;
+    }
+    bool ok = fwrite(txt.c_str(), 1, txt.length(), fout) == txt.length();
+    ok = (fclose(fout) == 0) && ok;
+    if (!ok || std::rename(tmp.c_str(), fname.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        yCDebug(PLUGININDEX, "Cannot write plugin index %s", fname.c_str());
+    }
+}
+
+} // namespace
+
+
+std::shared_ptr<const PluginIndex::Snapshot> PluginIndex::get(bool check)
+{
+    State& state = getState();
+    std::lock_guard<std::mutex> guard(state.mutex);
+
+    // If it was checked in the last 5 seconds, there is no need to check again
+    double now = yarp::os::SystemClock::nowSystem();
+    if (!check && state.snapshot && now - state.last_check < check_period) {
+        return state.snapshot;
+    }
+
+    Bottle plugin_paths = findPluginPaths();
+    std::string key = computeKey(plugin_paths);
+    state.last_check = yarp::os::SystemClock::nowSystem();
+    if (state.snapshot && key == state.key) {
+        return state.snapshot;
+    }
+
+    auto snapshot = std::make_shared<Snapshot>();
+    bool cache = cacheEnabled();
+    if (!cache || !readCache(key, snapshot->plugins, snapshot->search_path)) {
+        yCDebug(PLUGININDEX, "Scanning. I'm scanning. I hope you like scanning too.");
+        parse(plugin_paths, snapshot->plugins, snapshot->search_path);
+        if (cache) {
+            writeCache(key, snapshot->plugins, snapshot->search_path);
+        }
+    }
+    snapshot->generation = ++state.generation;
+
+    state.key = key;
+    state.snapshot = snapshot;
+    return state.snapshot;
+}
+
+void PluginIndex::reset()
+{
+    State& state = getState();
+    std::lock_guard<std::mutex> guard(state.mutex);
+    state.snapshot.reset();
+    state.key.clear();
+    state.last_check = -1.0;
+}
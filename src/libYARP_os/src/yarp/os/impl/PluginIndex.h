@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_IMPL_PLUGININDEX_H
+#define YARP_OS_IMPL_PLUGININDEX_H
+
+#include <yarp/os/api.h>
+#include <yarp/os/Bottle.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace yarp {
+namespace os {
+namespace impl {
+
+/**
+ * The [plugin] and [search] sections of the .ini files found in the plugin
+ * directories, shared by all the YarpPluginSelectors of the process.
+ *
+ * The index is keyed by the name, modification time and size of the .ini
+ * files.  It is checked again at most every 5 seconds (unless asked), and
+ * the files are parsed only when the key changes.  The index is also saved
+ * in the YARP data home (cache/plugin_index.txt), so that a new process
+ * with the same plugins does not need to parse the files again.  Set the
+ * YARP_PLUGIN_INDEX_CACHE environment variable to 0 to disable the file.
+ */
+class YARP_os_impl_API PluginIndex
+{
+public:
+    /**
+     * An immutable view of the index.
+     */
+    struct Snapshot
+    {
+        std::size_t generation {0};   ///< changes each time the index changes
+        yarp::os::Bottle plugins;     ///< [plugin] sections, with the .ini file they come from
+        yarp::os::Bottle search_path; ///< [search] sections
+    };
+
+    /**
+     * @param check check the plugin directories even if they were checked
+     *              in the last 5 seconds
+     * @return the current index, updated if needed
+     */
+    static std::shared_ptr<const Snapshot> get(bool check = false);
+
+    /**
+     * Forget the index kept in memory, so that the next get() checks the
+     * plugin directories again.
+     */
+    static void reset();
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_IMPL_PLUGININDEX_H
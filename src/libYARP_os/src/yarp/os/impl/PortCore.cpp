@@ -26,6 +26,7 @@
 #include <yarp/os/impl/LogComponent.h>
 #include <yarp/os/impl/PlatformUnistd.h>
 #include <yarp/os/impl/PortCoreInputUnit.h>
+#include <yarp/os/impl/PortCoreOutputPool.h>
 #include <yarp/os/impl/PortCoreOutputUnit.h>
 #include <yarp/os/impl/StreamConnectionReader.h>
 
@@ -87,6 +88,11 @@ PortCore::PortCore() :
         m_dataOutputCount(0),
         m_flags(PORTCORE_IS_INPUT | PORTCORE_IS_OUTPUT),
         m_logNeeded(false),
+        m_sharedPayload(yarp::conf::environment::getEnvironment("YARP_SHARED_PAYLOAD") == "1"),
+        m_outputPool(yarp::conf::environment::getEnvironment("YARP_OUTPUT_POOL") == "1"),
+        m_payloadSerializations(0),
+        m_payloadReuses(0),
+        m_payloadSavedBytes(0),
         m_timeout(-1),
         m_counter(1),
         m_prop(nullptr),
@@ -745,8 +751,9 @@ void PortCore::addOutput(OutputProtocol* op)
     yCAssert(PORTCORE, op != nullptr);
     m_stateSemaphore.wait();
     if (!m_finished) {
-        PortCoreUnit* unit = new PortCoreOutputUnit(*this, getNextIndex(), op);
+        auto* unit = new PortCoreOutputUnit(*this, getNextIndex(), op);
         yCAssert(PORTCORE, unit != nullptr);
+        unit->setOutputPool(m_outputPool);
         unit->start();
         m_units.push_back(unit);
     }
@@ -1166,6 +1173,14 @@ void PortCore::describe(PortReport& reporter)
             Route route = unit->getRoute();
             std::string msg = "There is an output connection from " + route.getFromName() + " to " + route.getToName() + " using " + route.getCarrierName();
             PortInfo info;
+            auto* outUnit = dynamic_cast<PortCoreOutputUnit*>(unit);
+            if (outUnit != nullptr) {
+                info.dropped = outUnit->getDroppedCount();
+                info.conflated = outUnit->getConflatedCount();
+                if (info.dropped != 0 || info.conflated != 0) {
+                    msg += " (" + std::to_string(info.dropped) + " dropped, " + std::to_string(info.conflated) + " conflated)";
+                }
+            }
             info.message = msg;
             info.tag = yarp::os::PortInfo::PORTINFO_CONNECTION;
             info.incoming = false;
@@ -1330,13 +1345,13 @@ bool PortCore::sendHelper(const PortWriter& writer,
     int logCount = 0;
     std::string envelopeString = m_envelope;
 
-    // Pass a message to all output units for sending on.  We could
-    // be doing more here to cache the serialization of the message
-    // and reuse it across output connections.  However, one key
-    // optimization is present: external blocks written by
-    // yarp::os::ConnectionWriter::appendExternalBlock are never
-    // copied.  So for example the core image array in a yarp::sig::Image
-    // is untouched by the port communications code.
+    // Pass a message to all output units for sending on.  If shared
+    // payloads are enabled, the message is serialized only once for
+    // each text/bare mode, and the output units reference the
+    // serialized data stored in the packet.  In any case, external
+    // blocks written by yarp::os::ConnectionWriter::appendExternalBlock
+    // are never copied.  So for example the core image array in a
+    // yarp::sig::Image is untouched by the port communications code.
 
     yCTrace(PORTCORE, "------- send in real");
 
@@ -1361,11 +1376,37 @@ bool PortCore::sendHelper(const PortWriter& writer,
     yCTrace(PORTCORE, "------- send in");
     // Prepare a "packet" for tracking a single message which
     // may travel by multiple outputs.
-    m_packetMutex.lock();
     PortCorePacket* packet = m_packets.getFreePacket();
     yCAssert(PORTCORE, packet != nullptr);
     packet->setContent(&writer, false, callback);
-    m_packetMutex.unlock();
+
+    // Serialize the message once for each text/bare mode needed, before
+    // the packet is passed to any unit.  From then on the units may read
+    // the payloads from their own threads, and a ready payload is never
+    // modified.  Busy units drop the message, so nothing is prepared for
+    // them.
+    if (m_sharedPayload) {
+        for (auto* unit : m_units) {
+            if ((unit == nullptr) || !unit->isOutput() || unit->isFinished() || unit->isBusy()) {
+                continue;
+            }
+            bool log = (!unit->getMode().empty());
+            bool ok = (mode == PORTCORE_SEND_NORMAL) ? (!log) : (log);
+            bool textMode = false;
+            bool bareMode = false;
+            if (!ok || !unit->canSharePayload(textMode, bareMode)) {
+                continue;
+            }
+            PortCoreSharedPayload& payload = packet->getPayload(textMode, bareMode);
+            if (payload.isReady()) {
+                m_payloadReuses++;
+                m_payloadSavedBytes += payload.dataSize();
+            } else {
+                payload.prepare(writer);
+                m_payloadSerializations++;
+            }
+        }
+    }
 
     // Scan connections, placing message everywhere we can.
     for (auto* unit : m_units) {
@@ -1381,9 +1422,7 @@ bool PortCore::sendHelper(const PortWriter& writer,
             }
             bool waiter = m_waitAfterSend || (mode == PORTCORE_SEND_LOG);
             yCTrace(PORTCORE, "------- -- inc");
-            m_packetMutex.lock();
             packet->inc(); // One more connection carrying message.
-            m_packetMutex.unlock();
             yCTrace(PORTCORE, "------- -- pre-send");
             bool gotReplyOne = false;
             // Send the message off on this connection.
@@ -1399,10 +1438,8 @@ bool PortCore::sendHelper(const PortWriter& writer,
             yCTrace(PORTCORE, "------- -- send");
             if (out != nullptr) {
                 // We got back a report of a message already sent.
-                m_packetMutex.lock();
-                (static_cast<PortCorePacket*>(out))->dec(); // Message on one fewer connections.
-                m_packets.checkPacket(static_cast<PortCorePacket*>(out));
-                m_packetMutex.unlock();
+                // Message on one fewer connections.
+                m_packets.releasePacket(static_cast<PortCorePacket*>(out));
             }
             if (waiter) {
                 if (unit->isFinished()) {
@@ -1413,15 +1450,11 @@ bool PortCore::sendHelper(const PortWriter& writer,
         }
     }
     yCTrace(PORTCORE, "------- pack check");
-    m_packetMutex.lock();
 
     // We no longer concern ourselves with the message.
     // It may or may not be traveling on some connections.
     // But that is not our problem anymore.
-    packet->dec();
-
-    m_packets.checkPacket(packet);
-    m_packetMutex.unlock();
+    m_packets.releasePacket(packet);
     yCTrace(PORTCORE, "------- packed");
     yCTrace(PORTCORE, "------- send out");
     if (mode == PORTCORE_SEND_LOG) {
@@ -1440,6 +1473,18 @@ bool PortCore::sendHelper(const PortWriter& writer,
 }
 
 
+void PortCore::getSharedPayloadStats(size_t& serializations,
+                                     size_t& reuses,
+                                     size_t& savedBytes)
+{
+    m_stateSemaphore.wait();
+    serializations = m_payloadSerializations;
+    reuses = m_payloadReuses;
+    savedBytes = m_payloadSavedBytes;
+    m_stateSemaphore.post();
+}
+
+
 bool PortCore::isWriting()
 {
     bool writing = false;
@@ -1484,12 +1529,9 @@ int PortCore::getOutputCount()
 void PortCore::notifyCompletion(void* tracker)
 {
     yCTrace(PORTCORE, "starting notifyCompletion");
-    m_packetMutex.lock();
     if (tracker != nullptr) {
-        (static_cast<PortCorePacket*>(tracker))->dec();
-        m_packets.checkPacket(static_cast<PortCorePacket*>(tracker));
+        m_packets.releasePacket(static_cast<PortCorePacket*>(tracker));
     }
-    m_packetMutex.unlock();
     yCTrace(PORTCORE, "stopping notifyCompletion");
 }
 
@@ -2271,6 +2313,24 @@ bool PortCore::adminBlock(ConnectionReader& reader,
                         port_prop.put("is_output", is_output);
                         port_prop.put("is_rpc", is_rpc);
                         port_prop.put("type", getType().getName());
+
+                        size_t serializations = 0;
+                        size_t reuses = 0;
+                        size_t savedBytes = 0;
+                        getSharedPayloadStats(serializations, reuses, savedBytes);
+                        Bottle& payload = result.addList();
+                        payload.addString("payload");
+                        Property& payload_prop = payload.addDict();
+                        payload_prop.put("shared", isSharedPayload());
+                        payload_prop.put("serializations", Value::makeInt64(static_cast<std::int64_t>(serializations)));
+                        payload_prop.put("reuses", Value::makeInt64(static_cast<std::int64_t>(reuses)));
+                        payload_prop.put("saved_bytes", Value::makeInt64(static_cast<std::int64_t>(savedBytes)));
+
+                        Bottle& pool = result.addList();
+                        pool.addString("output_pool");
+                        Property& pool_prop = pool.addDict();
+                        pool_prop.put("enabled", isOutputPool());
+                        pool_prop.put("workers", static_cast<int>(PortCoreOutputPool::getInstance().getWorkerCount()));
                     } else {
                         for (auto* unit : m_units) {
                             if ((unit != nullptr) && !unit->isFinished()) {
@@ -2292,6 +2352,13 @@ bool PortCore::adminBlock(ConnectionReader& reader,
                                     qos.addString("qos");
                                     Property& qos_prop = qos.addDict();
                                     qos_prop.put("tos", tos);
+                                    auto* outUnit = dynamic_cast<PortCoreOutputUnit*>(unit);
+                                    if (outUnit != nullptr) {
+                                        qos_prop.put("latest", outUnit->isLatestOnly());
+                                        qos_prop.put("rate", outUnit->getMaxRate());
+                                        qos_prop.put("dropped", Value::makeInt64(static_cast<std::int64_t>(outUnit->getDroppedCount())));
+                                        qos_prop.put("conflated", Value::makeInt64(static_cast<std::int64_t>(outUnit->getConflatedCount())));
+                                    }
                                 }
                             } // end isFinished()
                         }     // end for loop
@@ -2386,6 +2453,7 @@ bool PortCore::adminBlock(ConnectionReader& reader,
             // e.g., "prop set /portname (qos ((priority HIGH)))"
             // e.g., "prop set /portname (qos ((dscp AF12)))"
             // e.g., "prop set /portname (qos ((tos 12)))"
+            // e.g., "prop set /portname (qos ((latest 1) (rate 30)))"
             if (!qos.isNull()) {
                 if ((!key.empty()) && (key[0] == '/')) {
                     bOk = false;
@@ -2447,6 +2515,16 @@ bool PortCore::adminBlock(ConnectionReader& reader,
                                     if (tos >= 0) {
                                         bOk = setTypeOfService(unit, tos);
                                     }
+                                    // Set the policy for slow receivers, outputs only
+                                    if (qos_prop->check("latest") || qos_prop->check("rate")) {
+                                        auto* outUnit = dynamic_cast<PortCoreOutputUnit*>(unit);
+                                        if (outUnit != nullptr) {
+                                            bool latest = qos_prop->check("latest") ? qos_prop->find("latest").asBool() : outUnit->isLatestOnly();
+                                            double rate = qos_prop->check("rate") ? qos_prop->find("rate").asFloat64() : outUnit->getMaxRate();
+                                            outUnit->setOutputQos(latest, rate);
+                                            bOk = (tos >= 0) ? bOk : true;
+                                        }
+                                    }
                                 } else {
                                     bOk = false;
                                 }
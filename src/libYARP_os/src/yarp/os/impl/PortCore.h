@@ -363,6 +363,59 @@ public:
         this->m_waitAfterSend = waitAfterSend;
     }
 
+    /**
+     * Should each message be serialized only once, and the serialized data
+     * shared by all the output connections using the same text/bare mode?
+     * By default this is enabled if the YARP_SHARED_PAYLOAD environment
+     * variable is set to 1.
+     */
+    void setSharedPayload(bool sharedPayload)
+    {
+        this->m_sharedPayload = sharedPayload;
+    }
+
+    /**
+     * @return true if messages are serialized once for all the output
+     * connections.
+     */
+    bool isSharedPayload() const
+    {
+        return m_sharedPayload;
+    }
+
+    /**
+     * Should background writes on the output connections be performed by
+     * the shared pool of worker threads (see PortCoreOutputPool) instead
+     * of one thread per connection?  Only affects connections created
+     * after the call.  By default this is enabled if the YARP_OUTPUT_POOL
+     * environment variable is set to 1.
+     */
+    void setOutputPool(bool outputPool)
+    {
+        this->m_outputPool = outputPool;
+    }
+
+    /**
+     * @return true if background writes use the shared pool of threads.
+     */
+    bool isOutputPool() const
+    {
+        return m_outputPool;
+    }
+
+    /**
+     * Get the counters for the shared serialization of messages.
+     *
+     * @param[out] serializations how many times a message was serialized
+     * into a shared payload
+     * @param[out] reuses how many times a connection used a payload
+     * that was already serialized, skipping the serialization
+     * @param[out] savedBytes the total size of the serializations skipped
+     */
+    void getSharedPayloadStats(size_t& serializations,
+                               size_t& reuses,
+                               size_t& savedBytes);
+
     /**
      * Callback for data.
      */
@@ -514,7 +567,7 @@ private:
     // main internal PortCore state and operations
     std::vector<PortCoreUnit *> m_units;  ///< list of connections
     yarp::os::Semaphore m_stateSemaphore;       ///< control access to essential port state
-    std::mutex m_packetMutex;      ///< control access to message cache
+    std::mutex m_packetMutex;      ///< control access to the connection counts
     yarp::os::Semaphore m_connectionChangeSemaphore; ///< signal changes in connections
     Face *m_face;  ///< network server
     std::string m_name; ///< name of port
@@ -543,6 +596,11 @@ private:
     unsigned int m_flags;      ///< binary flags encoding restrictions on port
     bool m_logNeeded; ///< port needs to monitor message content
     PortCorePackets m_packets; ///< a pool for tracking messages currently being sent
+    bool m_sharedPayload; ///< should messages be serialized once for all connections?
+    bool m_outputPool; ///< should background writes use the shared pool of threads?
+    size_t m_payloadSerializations; ///< how many shared payloads have been serialized
+    size_t m_payloadReuses; ///< how many sends used an already serialized payload
+    size_t m_payloadSavedBytes; ///< how many bytes were not serialized again
     std::string m_envelope;///< user-defined wrapping data
     float m_timeout;  ///< a timeout to apply to all network operations
     int m_counter;    ///< port-unique ids for connections
@@ -482,6 +482,9 @@ void PortCoreInputUnit::setCarrierParams(const yarp::os::Property& params)
 void PortCoreInputUnit::getCarrierParams(yarp::os::Property& params)
 {
     if (ip != nullptr) {
+        // The parameters of the carrier itself (e.g. connection statistics),
+        // then the ones of the receiver modifier, if any.
+        ip->getConnection().getCarrierParams(params);
         ip->getReceiver().getCarrierParams(params);
     }
 }
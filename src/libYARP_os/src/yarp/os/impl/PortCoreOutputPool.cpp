@@ -0,0 +1,370 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/PortCoreOutputPool.h>
+
+#include <yarp/conf/environment.h>
+
+#include <yarp/os/SystemClock.h>
+#include <yarp/os/Thread.h>
+#include <yarp/os/impl/LogComponent.h>
+#include <yarp/os/impl/PortCoreOutputUnit.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+using yarp::os::impl::PortCoreOutputPool;
+using yarp::os::impl::PortCoreOutputUnit;
+using yarp::os::SystemClock;
+
+namespace {
+YARP_OS_LOG_COMPONENT(PORTCOREOUTPUTPOOL, "yarp.os.impl.PortCoreOutputPool")
+
+constexpr size_t default_pool_size = 4;
+constexpr double stall_time = 0.1;
+
+size_t getPoolSize()
+{
+    std::string size = yarp::conf::environment::getEnvironment("YARP_OUTPUT_POOL_SIZE");
+    if (!size.empty()) {
+        int n = std::atoi(size.c_str());
+        if (n > 0) {
+            return static_cast<size_t>(n);
+        }
+        yCWarning(PORTCOREOUTPUTPOOL, "Invalid YARP_OUTPUT_POOL_SIZE \"%s\", using %zu workers", size.c_str(), default_pool_size);
+    }
+    return default_pool_size;
+}
+} // namespace
+
+
+namespace yarp {
+namespace os {
+namespace impl {
+
+class PortCoreOutputPoolWorker : public yarp::os::Thread
+{
+public:
+    PortCoreOutputPool& pool;
+    double since {0.0}; ///< when the current unit was taken, 0 when idle
+
+    explicit PortCoreOutputPoolWorker(PortCoreOutputPool& pool) :
+            pool(pool)
+    {
+    }
+
+    void run() override
+    {
+        while (pool.process(*this)) {
+            // forever
+        }
+    }
+};
+
+class PortCoreOutputPoolMonitor : public yarp::os::Thread
+{
+public:
+    PortCoreOutputPool& pool;
+
+    explicit PortCoreOutputPoolMonitor(PortCoreOutputPool& pool) :
+            pool(pool)
+    {
+    }
+
+    void run() override
+    {
+        while (pool.monitor()) {
+            // forever
+        }
+    }
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+using yarp::os::impl::PortCoreOutputPoolMonitor;
+using yarp::os::impl::PortCoreOutputPoolWorker;
+
+
+PortCoreOutputPool& PortCoreOutputPool::getInstance()
+{
+    static PortCoreOutputPool instance;
+    return instance;
+}
+
+PortCoreOutputPool::PortCoreOutputPool() :
+        monitorThread(nullptr),
+        size(0),
+        users(0),
+        active(false)
+{
+}
+
+PortCoreOutputPool::~PortCoreOutputPool()
+{
+    // Ports still open at exit may have left the workers running.
+    std::lock_guard<std::mutex> lifecycleLock(lifecycleMutex);
+    stopWorkers();
+}
+
+void PortCoreOutputPool::acquire()
+{
+    std::lock_guard<std::mutex> lifecycleLock(lifecycleMutex);
+    users++;
+    if (users > 1) {
+        return;
+    }
+
+    size = getPoolSize();
+    yCDebug(PORTCOREOUTPUTPOOL, "starting %zu workers", size);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        active = true;
+    }
+    for (size_t i = 0; i < size; i++) {
+        startWorker();
+    }
+    monitorThread = new PortCoreOutputPoolMonitor(*this);
+    if (!monitorThread->start()) {
+        yCError(PORTCOREOUTPUTPOOL, "cannot start monitor thread");
+        delete monitorThread;
+        monitorThread = nullptr;
+    }
+}
+
+void PortCoreOutputPool::release()
+{
+    std::lock_guard<std::mutex> lifecycleLock(lifecycleMutex);
+    yCAssert(PORTCOREOUTPUTPOOL, users > 0);
+    users--;
+    if (users == 0) {
+        stopWorkers();
+    }
+}
+
+bool PortCoreOutputPool::startWorker()
+{
+    auto* worker = new PortCoreOutputPoolWorker(*this);
+    if (!worker->start()) {
+        yCError(PORTCOREOUTPUTPOOL, "cannot start worker thread");
+        delete worker;
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!active) {
+        // The pool was stopped in the meantime
+        lock.unlock();
+        cv.notify_all();
+        worker->stop();
+        delete worker;
+        return false;
+    }
+    workers.push_back(worker);
+    return true;
+}
+
+void PortCoreOutputPool::stopWorkers()
+{
+    std::vector<PortCoreOutputPoolWorker*> stopping;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        active = false;
+        queue.clear();
+        timers.clear();
+    }
+    cv.notify_all();
+    cvMonitor.notify_all();
+
+    // Stop the monitor first, since it may start new workers
+    if (monitorThread != nullptr) {
+        monitorThread->stop();
+        delete monitorThread;
+        monitorThread = nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping.swap(workers);
+        stopping.insert(stopping.end(), retired.begin(), retired.end());
+        retired.clear();
+    }
+    cv.notify_all();
+
+    yCDebug(PORTCOREOUTPUTPOOL, "stopping %zu workers", stopping.size());
+    for (auto* worker : stopping) {
+        worker->stop();
+        delete worker;
+    }
+}
+
+void PortCoreOutputPool::schedule(PortCoreOutputUnit* unit, double delay)
+{
+    if (delay > 0) {
+        bool earliest = true;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            double when = SystemClock::nowSystem() + delay;
+            for (auto& timer : timers) {
+                if (timer.second == unit) {
+                    // Keep a single timer for each unit, the earliest one
+                    timer.first = std::min(timer.first, when);
+                    return;
+                }
+                earliest = earliest && when < timer.first;
+            }
+            timers.emplace_back(when, unit);
+        }
+        if (earliest) {
+            cvMonitor.notify_one();
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (std::find(queue.begin(), queue.end(), unit) != queue.end()) {
+            return;
+        }
+        queue.push_back(unit);
+    }
+    cv.notify_one();
+}
+
+void PortCoreOutputPool::remove(PortCoreOutputUnit* unit)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    queue.erase(std::remove(queue.begin(), queue.end(), unit), queue.end());
+    timers.erase(std::remove_if(timers.begin(), timers.end(), [&](const std::pair<double, PortCoreOutputUnit*>& timer) { return timer.second == unit; }), timers.end());
+    cvDone.wait(lock, [&] { return std::find(busy.begin(), busy.end(), unit) == busy.end(); });
+}
+
+size_t PortCoreOutputPool::getWorkerCount()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return workers.size();
+}
+
+size_t PortCoreOutputPool::getStalledCount()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return countStalled(SystemClock::nowSystem(), nullptr);
+}
+
+size_t PortCoreOutputPool::countStalled(double now, const PortCoreOutputPoolWorker* except)
+{
+    size_t stalled = 0;
+    for (const auto* worker : workers) {
+        if (worker != except && worker->since > 0 && now - worker->since > stall_time) {
+            stalled++;
+        }
+    }
+    return stalled;
+}
+
+bool PortCoreOutputPool::process(PortCoreOutputPoolWorker& worker)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // Take the first unit that is not being sent by another worker
+    auto next = queue.end();
+    cv.wait(lock, [&] {
+        next = std::find_if(queue.begin(), queue.end(), [&](PortCoreOutputUnit* unit) {
+            return std::find(busy.begin(), busy.end(), unit) == busy.end();
+        });
+        return next != queue.end() || !active;
+    });
+    if (!active) {
+        return false;
+    }
+    PortCoreOutputUnit* unit = *next;
+    queue.erase(next);
+    busy.push_back(unit);
+    worker.since = SystemClock::nowSystem();
+    lock.unlock();
+
+    unit->sendPending();
+
+    lock.lock();
+    busy.erase(std::find(busy.begin(), busy.end(), unit));
+    worker.since = 0.0;
+
+    // Exit if this worker was replaced while stalled, or if it replaced
+    // a worker that is not stalled anymore.
+    bool exit = active && workers.size() > size + countStalled(SystemClock::nowSystem(), &worker);
+    if (exit) {
+        workers.erase(std::find(workers.begin(), workers.end(), &worker));
+        retired.push_back(&worker);
+        yCDebug(PORTCOREOUTPUTPOOL, "worker exiting, %zu left", workers.size());
+    }
+    lock.unlock();
+    cvDone.notify_all();
+    // The unit may have been queued again while it was busy
+    cv.notify_one();
+    return !exit;
+}
+
+bool PortCoreOutputPool::monitor()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!active) {
+        return false;
+    }
+
+    double now = SystemClock::nowSystem();
+    bool queued = false;
+    double next = now + stall_time;
+    for (auto it = timers.begin(); it != timers.end();) {
+        if (it->first <= now) {
+            if (std::find(queue.begin(), queue.end(), it->second) == queue.end()) {
+                queue.push_back(it->second);
+                queued = true;
+            }
+            it = timers.erase(it);
+        } else {
+            next = std::min(next, it->first);
+            ++it;
+        }
+    }
+    if (queued) {
+        cv.notify_all();
+    }
+
+    // Replace the stalled workers if the queue is waiting and no worker is
+    // idle
+    size_t missing = 0;
+    if (!queue.empty()) {
+        bool idle = std::any_of(workers.begin(), workers.end(), [](const PortCoreOutputPoolWorker* worker) { return worker->since == 0.0; });
+        size_t target = size + countStalled(now, nullptr);
+        if (!idle && workers.size() < target) {
+            missing = target - workers.size();
+        }
+    }
+
+    std::vector<PortCoreOutputPoolWorker*> exited;
+    exited.swap(retired);
+    lock.unlock();
+
+    for (auto* worker : exited) {
+        worker->stop();
+        delete worker;
+    }
+    if (missing > 0) {
+        yCDebug(PORTCOREOUTPUTPOOL, "starting %zu workers in place of the stalled ones", missing);
+        for (size_t i = 0; i < missing; i++) {
+            startWorker();
+        }
+    }
+
+    lock.lock();
+    if (active) {
+        cvMonitor.wait_for(lock, std::chrono::duration<double>(std::max(0.0, next - SystemClock::nowSystem())));
+    }
+    return active;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_IMPL_PORTCOREOUTPUTPOOL_H
+#define YARP_OS_IMPL_PORTCOREOUTPUTPOOL_H
+
+#include <yarp/os/api.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace yarp {
+namespace os {
+namespace impl {
+
+class PortCoreOutputUnit;
+class PortCoreOutputPoolWorker;
+class PortCoreOutputPoolMonitor;
+
+/**
+ * A pool of threads, shared by all the ports of the process, that performs
+ * the background writes of the output connections.
+ *
+ * Without the pool, each output connection that is written in background
+ * starts a thread of its own, that sleeps until a message is available.
+ * With the pool, the connection is queued when a message is available, and
+ * the first idle worker sends it.  The number of threads is therefore
+ * bounded by the size of the pool instead of growing with the number of
+ * connections.
+ *
+ * A worker blocks for as long as the receiver takes to accept the message.
+ * When the queue is not empty and every worker has been busy on the same
+ * connection for more than 0.1 seconds, the stalled workers are left to
+ * their connections and new workers are started in their place, so that a
+ * few slow receivers cannot delay the writes of every other port.  A worker
+ * exits when it finishes and the pool has more workers than its size plus
+ * the ones still stalled.
+ *
+ * The workers are started when the first connection attaches to the pool
+ * with acquire(), and stopped when the last one detaches with release().
+ * The number of workers is read from the YARP_OUTPUT_POOL_SIZE environment
+ * variable, and defaults to 4.
+ */
+class YARP_os_impl_API PortCoreOutputPool
+{
+public:
+    /**
+     * @return the pool shared by all the ports of the process.
+     */
+    static PortCoreOutputPool& getInstance();
+
+    PortCoreOutputPool(const PortCoreOutputPool&) = delete;
+    PortCoreOutputPool& operator=(const PortCoreOutputPool&) = delete;
+
+    /**
+     * Register a user of the pool, starting the workers if needed.
+     */
+    void acquire();
+
+    /**
+     * Unregister a user of the pool, stopping the workers if it was the
+     * last one.
+     */
+    void release();
+
+    /**
+     * Queue a connection that has a message ready to be sent.  A worker
+     * will call PortCoreOutputUnit::sendPending() on it.  A connection is
+     * queued at most once, and it is never sent by two workers at the same
+     * time.
+     *
+     * @param unit the connection
+     * @param delay the time to wait, in seconds, before queueing the
+     *              connection
+     */
+    void schedule(PortCoreOutputUnit* unit, double delay = 0.0);
+
+    /**
+     * Remove a connection from the queue and the timers, and wait for any
+     * worker that is currently sending on it.  After this call the pool
+     * does not reference the connection anymore.
+     *
+     * @param unit the connection
+     */
+    void remove(PortCoreOutputUnit* unit);
+
+    /**
+     * @return the number of worker threads currently running.
+     */
+    size_t getWorkerCount();
+
+    /**
+     * @return the number of workers that have been sending on the same
+     *         connection for more than the stall time.
+     */
+    size_t getStalledCount();
+
+private:
+    friend class PortCoreOutputPoolWorker;
+    friend class PortCoreOutputPoolMonitor;
+
+    PortCoreOutputPool();
+    ~PortCoreOutputPool();
+
+    /**
+     * Wait for a connection to be queued, and send its message.
+     *
+     * @param worker the worker calling
+     * @return false if the worker should stop
+     */
+    bool process(PortCoreOutputPoolWorker& worker);
+
+    /**
+     * Queue the timers that are due, and replace the stalled workers.
+     * Called by the monitor thread.
+     *
+     * @return false if the monitor should stop
+     */
+    bool monitor();
+
+    bool startWorker();
+    void stopWorkers();
+    size_t countStalled(double now, const PortCoreOutputPoolWorker* except);
+
+    std::mutex lifecycleMutex;              ///< serialize acquire() and release()
+    std::mutex mutex;                       ///< protect the queue
+    std::condition_variable cv;             ///< signal when a unit is queued
+    std::condition_variable cvDone;         ///< signal when a worker finishes a unit
+    std::condition_variable cvMonitor;      ///< signal when a timer is added
+    std::deque<PortCoreOutputUnit*> queue;  ///< units waiting for a worker
+    std::vector<PortCoreOutputUnit*> busy;  ///< units being sent by a worker
+    std::vector<std::pair<double, PortCoreOutputUnit*>> timers; ///< units waiting for their time
+    std::vector<PortCoreOutputPoolWorker*> workers;
+    std::vector<PortCoreOutputPoolWorker*> retired; ///< workers that exited, to be joined
+    PortCoreOutputPoolMonitor* monitorThread;
+    size_t size;
+    size_t users;
+    bool active;
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_IMPL_PORTCOREOUTPUTPOOL_H
@@ -13,10 +13,15 @@
 #include <yarp/os/PortInfo.h>
 #include <yarp/os/PortReport.h>
 #include <yarp/os/Portable.h>
+#include <yarp/os/SystemClock.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/impl/BufferedConnectionWriter.h>
 #include <yarp/os/impl/LogComponent.h>
 #include <yarp/os/impl/PortCommand.h>
+#include <yarp/os/impl/PortCoreOutputPool.h>
+#include <yarp/os/impl/PortCorePacket.h>
+
+#include <cstdlib>
 
 namespace {
 YARP_OS_LOG_COMPONENT(PORTCOREOUTPUTUNIT, "yarp.os.impl.PortCoreOutputUnit")
@@ -33,13 +38,25 @@ PortCoreOutputUnit::PortCoreOutputUnit(PortCore& owner, int index, OutputProtoco
         running(false),
         threaded(false),
         sending(false),
+        outputPool(false),
+        pooled(false),
         phase(1),
         activate(0),
         trackerMutex(),
         cachedWriter(nullptr),
         cachedReader(nullptr),
         cachedCallback(nullptr),
-        cachedTracker(nullptr)
+        cachedTracker(nullptr),
+        cachedPayload(nullptr),
+        qosLatest(false),
+        qosPeriod(0.0),
+        qosPending(false),
+        qosLastSend(0.0),
+        qosDropped(0),
+        qosConflated(0),
+        qosScheduled(false),
+        qosNextTracker(nullptr),
+        qosNextPayload(nullptr)
 {
     yCAssert(PORTCOREOUTPUTUNIT, op != nullptr);
 }
@@ -91,27 +108,125 @@ void PortCoreOutputUnit::run()
             yCDebug(PORTCOREOUTPUTUNIT, "waiting");
             activate.wait();
             yCDebug(PORTCOREOUTPUTUNIT, "woken");
-            if (!closing) {
-                if (sending) {
-                    yCDebug(PORTCOREOUTPUTUNIT, "write something in background");
-                    sendHelper();
-                    yCDebug(PORTCOREOUTPUTUNIT, "wrote something in background");
-                    trackerMutex.lock();
-                    if (cachedTracker != nullptr) {
-                        void* t = cachedTracker;
-                        cachedTracker = nullptr;
-                        sending = false;
-                        getOwner().notifyCompletion(t);
-                    } else {
-                        sending = false;
-                    }
-                    trackerMutex.unlock();
-                }
-            }
+            sendPending();
+            sendLatest();
             yCDebug(PORTCOREOUTPUTUNIT, "wrote something in background");
         }
         yCDebug(PORTCOREOUTPUTUNIT, "thread closing");
+        trackerMutex.lock();
         sending = false;
+        trackerMutex.unlock();
+    }
+}
+
+
+void PortCoreOutputUnit::sendPending()
+{
+    if (closing) {
+        return;
+    }
+    trackerMutex.lock();
+    bool pending = sending;
+    trackerMutex.unlock();
+    if (pending) {
+        yCDebug(PORTCOREOUTPUTUNIT, "write something in background");
+        sendHelper();
+        yCDebug(PORTCOREOUTPUTUNIT, "wrote something in background");
+        trackerMutex.lock();
+        void* t = cachedTracker;
+        cachedTracker = nullptr;
+        cachedPayload = nullptr;
+        sending = false;
+        if (t != nullptr) {
+            getOwner().notifyCompletion(t);
+        }
+        trackerMutex.unlock();
+    }
+    if (pooled) {
+        sendLatest();
+    }
+}
+
+
+void PortCoreOutputUnit::sendLatest()
+{
+    while (!closing) {
+        std::unique_lock<std::mutex> lock(qosMutex);
+        if (!qosPending) {
+            qosScheduled = false;
+            return;
+        }
+        double now = SystemClock::nowSystem();
+        double wait = 0.0;
+        if (qosPeriod > 0 && now < qosLastSend + qosPeriod) {
+            wait = qosLastSend + qosPeriod - now;
+        } else {
+            trackerMutex.lock();
+            if (sending) {
+                // A message with a reply is being sent, try again later
+                wait = 0.001;
+            } else {
+                sending = true;
+                cachedTracker = qosNextTracker;
+                cachedReader = nullptr;
+                cachedPayload = qosNextPayload;
+                cachedEnvelope = qosNextEnvelope;
+                if (qosNextTracker != nullptr) {
+                    cachedWriter = static_cast<PortCorePacket*>(qosNextTracker)->getContent();
+                } else {
+                    std::swap(qosNextCopy, qosCurrentCopy);
+                    cachedWriter = qosCurrentCopy.get();
+                }
+            }
+            trackerMutex.unlock();
+        }
+        if (wait > 0) {
+            if (pooled) {
+                // The pool calls us again when the time comes, the
+                // message sent is the one waiting then.
+                PortCoreOutputPool::getInstance().schedule(this, wait);
+                return;
+            }
+            lock.unlock();
+            // Woken early by new messages and when closing, the message
+            // sent is the one waiting when the time comes.
+            activate.waitWithTimeout(wait);
+            continue;
+        }
+
+        qosNextTracker = nullptr;
+        qosNextPayload = nullptr;
+        qosPending = false;
+        qosLastSend = now;
+        lock.unlock();
+
+        sendHelper();
+
+        trackerMutex.lock();
+        void* t = cachedTracker;
+        cachedTracker = nullptr;
+        cachedPayload = nullptr;
+        sending = false;
+        trackerMutex.unlock();
+        if (t != nullptr) {
+            getOwner().notifyCompletion(t);
+        }
+    }
+}
+
+
+void PortCoreOutputUnit::releaseQos()
+{
+    void* t = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(qosMutex);
+        t = qosNextTracker;
+        qosNextTracker = nullptr;
+        qosNextPayload = nullptr;
+        qosPending = false;
+    }
+    if (t != nullptr) {
+        getOwner().notifyCompletion(t);
     }
 }
 
@@ -121,6 +236,16 @@ void PortCoreOutputUnit::runSingleThreaded()
     if (op != nullptr) {
         Route route = op->getRoute();
         setMode();
+
+        // e.g. "tcp+qos.latest+rate.30"
+        Name name(route.getCarrierName() + std::string("://test"));
+        bool hasLatest = false;
+        bool hasRate = false;
+        std::string latest = name.getCarrierModifier("qos", &hasLatest);
+        std::string rate = name.getCarrierModifier("rate", &hasRate);
+        if ((hasLatest && latest == "latest") || hasRate) {
+            setOutputQos(hasLatest && latest == "latest", hasRate ? std::atof(rate.c_str()) : 0.0);
+        }
         getOwner().reportUnit(this, true);
 
         std::string msg = std::string("Sending output from ") + route.getFromName() + " to " + route.getToName() + " using " + route.getCarrierName();
@@ -212,7 +337,27 @@ void PortCoreOutputUnit::closeBasic()
 
 void PortCoreOutputUnit::closeMain()
 {
+    // Detach from the shared pool even if a failed write already finished
+    // the connection.
+    if (pooled) {
+        if (!finished && op != nullptr) {
+            op->interrupt();
+        }
+
+        // After this, no worker is sending on this connection
+        closing = true;
+        PortCoreOutputPool::getInstance().remove(this);
+        PortCoreOutputPool::getInstance().release();
+        pooled = false;
+        trackerMutex.lock();
+        sending = false;
+        trackerMutex.unlock();
+    }
+
     if (finished) {
+        if (!running) {
+            releaseQos();
+        }
         return;
     }
 
@@ -233,6 +378,8 @@ void PortCoreOutputUnit::closeMain()
 
     yCDebug(PORTCOREOUTPUTUNIT, "internal join");
 
+    releaseQos();
+
     closeBasic();
     running = false;
     closing = false;
@@ -285,7 +432,9 @@ bool PortCoreOutputUnit::sendHelper()
             buf.setReference(p);
         } else {
             yCAssert(PORTCOREOUTPUTUNIT, cachedWriter != nullptr);
-            bool ok = cachedWriter->write(buf);
+            // If the message was already serialized by the port, just
+            // reference the shared buffers.
+            bool ok = (cachedPayload != nullptr) ? cachedPayload->write(buf) : cachedWriter->write(buf);
             if (!ok) {
                 done = true;
             }
@@ -360,8 +509,23 @@ void* PortCoreOutputUnit::send(const yarp::os::PortWriter& writer,
         }
     }
 
+    // Messages waiting for a reply are sent as usual, the others are
+    // copied and left to our thread.
+    if (reader == nullptr && hasOutputQos()) {
+        return sendWithQos(writer, tracker, envelopeString, waitAfter);
+    }
+
     if (!waitBefore || !waitAfter) {
-        if (!running) {
+        if (outputPool) {
+            if (!pooled) {
+                // the workers of the shared pool will do the background
+                // writes, no need for a thread of our own
+                getRoute();
+                PortCoreOutputPool::getInstance().acquire();
+                pooled = true;
+                yCDebug(PORTCOREOUTPUTUNIT, "using the shared pool for output");
+            }
+        } else if (!running) {
             // we must have a thread if we're going to be skipping waits
             threaded = true;
             yCDebug(PORTCOREOUTPUTUNIT, "starting a thread for output");
@@ -373,26 +537,55 @@ void* PortCoreOutputUnit::send(const yarp::os::PortWriter& writer,
     if ((!waitBefore) && waitAfter) {
         yCError(PORTCOREOUTPUTUNIT, "chosen port wait combination not yet implemented");
     }
-    if (!sending) {
+
+    // The tracker is the packet owning the serialized message, if the
+    // port prepared one for this connection.
+    const PortCoreSharedPayload* payload = nullptr;
+    bool textMode = false;
+    bool bareMode = false;
+    if (tracker != nullptr && canSharePayload(textMode, bareMode)) {
+        payload = static_cast<PortCorePacket*>(tracker)->findPayload(textMode, bareMode);
+    }
+
+    // A worker of the pool, or the thread sending the messages of the
+    // output policy, may be using the connection.
+    trackerMutex.lock();
+    bool busy = sending;
+    if (!busy) {
+        sending = true;
         cachedWriter = &writer;
         cachedReader = reader;
         cachedCallback = callback;
         cachedEnvelope = envelopeString;
+        cachedPayload = payload;
+    }
+    trackerMutex.unlock();
 
-        sending = true;
+    if (!busy) {
         if (waitAfter) {
             replied = sendHelper();
+            trackerMutex.lock();
+            cachedPayload = nullptr;
             sending = false;
+            trackerMutex.unlock();
         } else {
             trackerMutex.lock();
             void* nextTracker = tracker;
             tracker = cachedTracker;
             cachedTracker = nextTracker;
-            activate.post();
+            if (pooled) {
+                PortCoreOutputPool::getInstance().schedule(this);
+            } else {
+                activate.post();
+            }
             trackerMutex.unlock();
         }
     } else {
         yCDebug(PORTCOREOUTPUTUNIT, "skipping connection tagged as sending something");
+        if (hasOutputQos()) {
+            std::lock_guard<std::mutex> lock(qosMutex);
+            qosDropped++;
+        }
     }
 
     if (waitAfter) {
@@ -406,6 +599,161 @@ void* PortCoreOutputUnit::send(const yarp::os::PortWriter& writer,
 }
 
 
+void* PortCoreOutputUnit::sendWithQos(const yarp::os::PortWriter& writer,
+                                      void* tracker,
+                                      const std::string& envelopeString,
+                                      bool waitAfter)
+{
+    if (outputPool) {
+        if (!pooled) {
+            getRoute();
+            PortCoreOutputPool::getInstance().acquire();
+            pooled = true;
+            yCDebug(PORTCOREOUTPUTUNIT, "using the shared pool for output");
+        }
+    } else if (!running) {
+        // The thread waits for the next slot allowed by the maximum rate
+        threaded = true;
+        yCDebug(PORTCOREOUTPUTUNIT, "starting a thread for output");
+        start();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(qosMutex);
+        if (!qosLatest) {
+            if (qosPending || (qosPeriod > 0 && SystemClock::nowSystem() < qosLastSend + qosPeriod)) {
+                qosDropped++;
+                return tracker;
+            }
+        }
+    }
+
+    // Serialize the message in the packet, unless the port already did.
+    // This runs in the thread sending the message, and the other
+    // connections only read the payloads that were ready when they got
+    // the packet, so one that is not ready yet is used by nobody else.
+    if (tracker == nullptr) {
+        return tracker;
+    }
+    bool textMode = false;
+    bool bareMode = false;
+    canSharePayload(textMode, bareMode);
+    PortCoreSharedPayload& payload = static_cast<PortCorePacket*>(tracker)->getPayload(textMode, bareMode);
+    if (!payload.isReady()) {
+        payload.prepare(writer);
+    }
+    if (!payload.isOk()) {
+        return tracker;
+    }
+
+    void* replaced = nullptr;
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(qosMutex);
+        if (qosPending) {
+            if (!qosLatest) {
+                qosDropped++;
+                return tracker;
+            }
+            qosConflated++;
+            replaced = qosNextTracker;
+        }
+        if (waitAfter) {
+            // The writer may change or destroy its object as soon as the
+            // port returns, so the message must be copied.
+            if (!qosNextCopy) {
+                qosNextCopy.reset(new BufferedConnectionWriter(textMode, bareMode));
+                qosCurrentCopy.reset(new BufferedConnectionWriter(textMode, bareMode));
+            }
+            qosNextCopy->restart();
+            payload.copy(*qosNextCopy);
+            qosNextCopy->stopWrite();
+            qosNextTracker = nullptr;
+            qosNextPayload = nullptr;
+        } else {
+            // Keep the packet, and the object of the writer, until the
+            // message is sent.
+            qosNextTracker = tracker;
+            qosNextPayload = &payload;
+            tracker = nullptr;
+        }
+        qosNextEnvelope = envelopeString;
+        qosPending = true;
+        if (pooled) {
+            schedule = !qosScheduled;
+            qosScheduled = true;
+        } else {
+            activate.post();
+        }
+    }
+    if (schedule) {
+        PortCoreOutputPool::getInstance().schedule(this);
+    }
+    if (replaced != nullptr) {
+        getOwner().notifyCompletion(replaced);
+    }
+    return tracker;
+}
+
+void PortCoreOutputUnit::setOutputQos(bool latestOnly, double maxRate)
+{
+    std::lock_guard<std::mutex> lock(qosMutex);
+    qosLatest = latestOnly;
+    qosPeriod = (maxRate > 0) ? 1.0 / maxRate : 0.0;
+    yCDebug(PORTCOREOUTPUTUNIT, "output policy: latest %d, max rate %g Hz", static_cast<int>(qosLatest), maxRate);
+}
+
+bool PortCoreOutputUnit::isLatestOnly()
+{
+    std::lock_guard<std::mutex> lock(qosMutex);
+    return qosLatest;
+}
+
+double PortCoreOutputUnit::getMaxRate()
+{
+    std::lock_guard<std::mutex> lock(qosMutex);
+    return (qosPeriod > 0) ? 1.0 / qosPeriod : 0.0;
+}
+
+size_t PortCoreOutputUnit::getDroppedCount()
+{
+    std::lock_guard<std::mutex> lock(qosMutex);
+    return qosDropped;
+}
+
+size_t PortCoreOutputUnit::getConflatedCount()
+{
+    std::lock_guard<std::mutex> lock(qosMutex);
+    return qosConflated;
+}
+
+bool PortCoreOutputUnit::hasOutputQos()
+{
+    bool textMode = false;
+    bool bareMode = false;
+    if (!canSharePayload(textMode, bareMode)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(qosMutex);
+    return qosLatest || qosPeriod > 0;
+}
+
+
+bool PortCoreOutputUnit::canSharePayload(bool& textMode, bool& bareMode)
+{
+    if (op == nullptr || finished) {
+        return false;
+    }
+    // The local carrier passes the object itself, and modifiers may
+    // change the message for this connection only.
+    if (op->getConnection().isLocal() || op->getSender().modifiesOutgoingData()) {
+        return false;
+    }
+    textMode = op->getConnection().isTextMode();
+    bareMode = op->getConnection().isBareMode();
+    return true;
+}
+
 void* PortCoreOutputUnit::takeTracker()
 {
     void* tracker = nullptr;
@@ -420,6 +768,9 @@ void* PortCoreOutputUnit::takeTracker()
 
 bool PortCoreOutputUnit::isBusy()
 {
+    // A message waiting for the output policy is not reported: the writer
+    // never waits for it.
+    std::lock_guard<std::mutex> lock(trackerMutex);
     return sending;
 }
 
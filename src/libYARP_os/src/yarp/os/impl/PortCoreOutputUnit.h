@@ -13,14 +13,18 @@
 #include <yarp/os/OutputProtocol.h>
 #include <yarp/os/Semaphore.h>
 #include <yarp/os/impl/PortCore.h>
+#include <yarp/os/impl/PortCoreSharedPayload.h>
 #include <yarp/os/impl/PortCoreUnit.h>
 
+#include <memory>
 #include <mutex>
 
 namespace yarp {
 namespace os {
 namespace impl {
 
+class BufferedConnectionWriter;
+
 /**
  * Manager for a single output from a port.  Associated
  * with a PortCore object.
@@ -60,6 +64,68 @@ public:
      */
     virtual void runSingleThreaded();
 
+    /**
+     * Send the message queued for background writing, if any, and notify
+     * the port when it is done.  Called by the background thread, or by a
+     * worker of the PortCoreOutputPool.
+     */
+    void sendPending();
+
+    /**
+     * Should background writes be performed by the workers of the shared
+     * PortCoreOutputPool instead of a thread owned by this connection?
+     * Must be called before the first background write.
+     */
+    void setOutputPool(bool outputPool)
+    {
+        this->outputPool = outputPool;
+    }
+
+    /**
+     * Set the policy for the messages written while the connection is
+     * still sending a previous one, or faster than a maximum rate.
+     *
+     * With a policy set, messages are sent in background (by a thread
+     * owned by this connection, or by the shared pool), so the writer
+     * never waits for the receiver.  If the port writes in background, the
+     * connection keeps the message serialized by the port until it is
+     * sent, otherwise it keeps a copy, since the writer may reuse its
+     * object as soon as the port returns.
+     * At most one message waits to be sent: with latestOnly, a newer
+     * message replaces it (conflated), otherwise the newer message is
+     * not sent (dropped).
+     *
+     * The policy is also read from the carrier modifiers of the
+     * connection, e.g. "tcp+qos.latest+rate.30".
+     *
+     * @param latestOnly keep only the latest message
+     * @param maxRate the maximum rate of the messages sent in Hz, 0 for
+     *                no limit
+     */
+    void setOutputQos(bool latestOnly, double maxRate);
+
+    /**
+     * @return true if only the latest message is kept
+     */
+    bool isLatestOnly();
+
+    /**
+     * @return the maximum rate of the messages sent in Hz, 0 for no limit
+     */
+    double getMaxRate();
+
+    /**
+     * @return the number of messages not sent because of the policy set
+     *         by setOutputQos()
+     */
+    size_t getDroppedCount();
+
+    /**
+     * @return the number of messages replaced by a newer one before being
+     *         sent
+     */
+    size_t getConflatedCount();
+
     // documented in PortCoreUnit
     bool isOutput() override
     {
@@ -91,6 +157,9 @@ public:
                bool waitBefore,
                bool* gotReply) override;
 
+    // documented in PortCoreUnit
+    bool canSharePayload(bool& textMode, bool& bareMode) override;
+
     // documented in PortCoreUnit
     void* takeTracker() override;
 
@@ -113,6 +182,8 @@ private:
     bool running;       ///< is a thread running
     bool threaded;      ///< do we need a thread for background writing
     bool sending;       ///< are we sending something right now
+    bool outputPool;    ///< should background writes use the shared pool
+    bool pooled;        ///< are we attached to the shared pool
     yarp::os::Semaphore phase;        ///< let main thread kick sending thread
     yarp::os::Semaphore activate;     ///< signal when we have a new tracker
     std::mutex trackerMutex; ///< protect the tracker during outside access
@@ -121,13 +192,58 @@ private:
     const yarp::os::PortWriter* cachedCallback; ///< where to sent commencement and
                                           ///< completion events
     void *cachedTracker;        ///< memory tracker for current message
+    const PortCoreSharedPayload* cachedPayload; ///< the message, if already serialized
     std::string cachedEnvelope;      ///< some text to pass along with the message
+    std::mutex qosMutex;        ///< protect the state of the QoS policy
+    bool qosLatest;             ///< keep only the latest message
+    double qosPeriod;           ///< minimum time between two messages, 0 for none
+    bool qosPending;            ///< is a message waiting in qosNext
+    double qosLastSend;         ///< when the last message was sent
+    size_t qosDropped;          ///< messages not sent
+    size_t qosConflated;        ///< messages replaced by a newer one
+    bool qosScheduled;          ///< is the shared pool going to look at qosNext
+    void* qosNextTracker;       ///< the packet of the message waiting to be sent
+    const PortCoreSharedPayload* qosNextPayload; ///< the message waiting to be sent, owned by the packet
+    std::unique_ptr<BufferedConnectionWriter> qosNextCopy;    ///< a copy of the message waiting to be sent, if not referenced
+    std::unique_ptr<BufferedConnectionWriter> qosCurrentCopy; ///< a copy of the message being sent
+    std::string qosNextEnvelope; ///< the envelope of the message waiting to be sent
 
     /**
      * The core logic for sending a message.
      */
     bool sendHelper();
 
+    /**
+     * @return true if a policy was set by setOutputQos() and the
+     *         connection can copy the messages
+     */
+    bool hasOutputQos();
+
+    /**
+     * Queue a message for background sending, and return immediately.
+     *
+     * @param waitAfter true if the writer may reuse its object as soon as
+     *                  the port returns
+     * @return the tracker if it is not needed anymore, nullptr if it
+     *         was kept until the message is sent or replaced
+     */
+    void* sendWithQos(const yarp::os::PortWriter& writer,
+                      void* tracker,
+                      const std::string& envelopeString,
+                      bool waitAfter);
+
+    /**
+     * Send the message queued by sendWithQos(), if any, when the maximum
+     * rate allows it.  The background thread waits for that time, a
+     * worker of the shared pool schedules the connection again instead.
+     */
+    void sendLatest();
+
+    /**
+     * Give back the packet of the message waiting to be sent, if any.
+     */
+    void releaseQos();
+
     /**
      * Try to close the connection, but not very hard.
      */
@@ -12,6 +12,11 @@
 
 #include <yarp/os/NetType.h>
 #include <yarp/os/PortWriter.h>
+#include <yarp/os/impl/PortCoreSharedPayload.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
 
 namespace yarp {
 namespace os {
@@ -28,10 +33,13 @@ public:
     PortCorePacket* next_;                ///< this packet will be in a list of active packets
     const yarp::os::PortWriter* content;  ///< the object being sent
     const yarp::os::PortWriter* callback; ///< where to send event notifications
-    int ct;                               ///< number of uses of the messagae
+    std::atomic<int> ct;                  ///< number of uses of the messagae
     bool owned;                           ///< should we memory-manage the content object
     bool ownedCallback;                   ///< should we memory-manage the callback object
     bool completed;                       ///< has a notification of completion been sent
+    std::unique_ptr<PortCoreSharedPayload> payloads[4]; ///< the message serialized once for each text/bare mode, allocated when first needed
+    std::uint32_t slot;                   ///< position in the PortCorePackets slab
+    std::atomic<std::uint32_t> nextFree;  ///< next packet in the free list (slot + 1, 0 for none)
 
     /**
      * Constructor.
@@ -44,7 +52,9 @@ public:
             ct(0),
             owned(false),
             ownedCallback(false),
-            completed(false)
+            completed(false),
+            slot(0),
+            nextFree(0)
     {
         reset();
     }
@@ -63,7 +73,7 @@ public:
      */
     int getCount()
     {
-        return ct;
+        return ct.load(std::memory_order_acquire);
     }
 
     /**
@@ -71,15 +81,17 @@ public:
      */
     void inc()
     {
-        ct++;
+        ct.fetch_add(1, std::memory_order_relaxed);
     }
 
     /**
      * Decrement the usage count for this messagae.
+     *
+     * @return the number of users left
      */
-    void dec()
+    int dec()
     {
-        ct--;
+        return ct.fetch_sub(1, std::memory_order_acq_rel) - 1;
     }
 
     /**
@@ -98,6 +110,37 @@ public:
         return (callback != nullptr) ? callback : content;
     }
 
+    /**
+     * Get the shared serialization of the message for connections using
+     * the given text/bare mode, allocating it if needed.  The payload is
+     * not prepared until PortCoreSharedPayload::prepare() is called.
+     * This must be called only by the thread sending the message.
+     *
+     * @param textMode the text mode of the connection
+     * @param bareMode the bare mode of the connection
+     * @return the payload for the given mode.
+     */
+    PortCoreSharedPayload& getPayload(bool textMode, bool bareMode)
+    {
+        auto& payload = payloads[(textMode ? 1 : 0) + (bareMode ? 2 : 0)];
+        if (!payload) {
+            payload.reset(new PortCoreSharedPayload(textMode, bareMode));
+        }
+        return *payload;
+    }
+
+    /**
+     * @param textMode the text mode of the connection
+     * @param bareMode the bare mode of the connection
+     * @return the payload for the given mode if it is ready, nullptr
+     *         otherwise.
+     */
+    const PortCoreSharedPayload* findPayload(bool textMode, bool bareMode) const
+    {
+        const auto& payload = payloads[(textMode ? 1 : 0) + (bareMode ? 2 : 0)];
+        return (payload && payload->isReady()) ? payload.get() : nullptr;
+    }
+
     /**
      * Configure the object being sent and where to send notifications.
      *
@@ -113,7 +156,7 @@ public:
     {
         content = writable;
         this->callback = callback;
-        ct = 1;
+        ct.store(1, std::memory_order_release);
         this->owned = owned;
         this->ownedCallback = ownedCallback;
         completed = false;
@@ -132,10 +175,16 @@ public:
         }
         content = nullptr;
         callback = nullptr;
-        ct = 0;
+        ct.store(0, std::memory_order_release);
         owned = false;
         ownedCallback = false;
         completed = false;
+        // The payloads are kept, to reuse their buffers
+        for (auto& payload : payloads) {
+            if (payload) {
+                payload->reset();
+            }
+        }
     }
 
     /**
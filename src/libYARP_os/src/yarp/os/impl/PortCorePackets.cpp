@@ -11,48 +11,161 @@
 
 #include <yarp/os/impl/LogComponent.h>
 
+#include <new>
+
 using yarp::os::impl::PortCorePacket;
 using yarp::os::impl::PortCorePackets;
 
 namespace {
 YARP_OS_LOG_COMPONENT(PORTCOREPACKETS, "yarp.os.impl.PortCorePackets")
+
+constexpr std::uint64_t slot_mask = 0xffffffff;
+
+std::uint64_t makeHead(std::uint64_t tag, std::uint32_t next)
+{
+    return (tag << 32) | next;
+}
 } // namespace
 
+constexpr size_t PortCorePackets::chunkSize;
+constexpr size_t PortCorePackets::maxChunks;
+constexpr std::uint32_t PortCorePackets::overflowSlot;
+constexpr size_t PortCorePackets::cacheLineSize;
+
+PortCorePackets::PortCorePackets() :
+        freeHead(0),
+        activeCount(0),
+        chunkCount(0)
+{
+    for (size_t i = 0; i < maxChunks; i++) {
+        chunks[i].store(nullptr, std::memory_order_relaxed);
+        chunkMemory[i] = nullptr;
+    }
+}
+
 PortCorePackets::~PortCorePackets()
 {
-    while (!inactive.empty()) {
-        delete inactive.back();
-        inactive.pop_back();
+    size_t count = chunkCount.load();
+    for (size_t i = 0; i < count; i++) {
+        PacketSlot* chunk = chunks[i].load();
+        for (size_t j = 0; j < chunkSize; j++) {
+            chunk[j].~PacketSlot();
+        }
+        delete[] chunkMemory[i];
     }
-    while (!active.empty()) {
-        delete active.back();
-        active.pop_back();
+    for (auto* packet : overflow) {
+        delete packet;
     }
 }
 
 size_t PortCorePackets::getCount()
 {
-    return active.size();
+    return activeCount.load();
 }
 
-PortCorePacket* PortCorePackets::getFreePacket()
+size_t PortCorePackets::getCapacity()
+{
+    return chunkCount.load() * chunkSize;
+}
+
+size_t PortCorePackets::getOverflowCount()
+{
+    std::lock_guard<std::mutex> lock(chunkMutex);
+    return overflow.size();
+}
+
+PortCorePacket* PortCorePackets::getPacket(std::uint32_t slot)
+{
+    return &chunks[slot / chunkSize].load(std::memory_order_acquire)[slot % chunkSize].packet;
+}
+
+PortCorePacket* PortCorePackets::popFree()
+{
+    // The tag in the upper half of the head changes at each update, so
+    // a packet popped and pushed again by another thread in the meantime
+    // makes the exchange fail (ABA problem).
+    std::uint64_t head = freeHead.load(std::memory_order_acquire);
+    while ((head & slot_mask) != 0) {
+        PortCorePacket* packet = getPacket(static_cast<std::uint32_t>((head & slot_mask) - 1));
+        std::uint32_t next = packet->nextFree.load(std::memory_order_relaxed);
+        if (freeHead.compare_exchange_weak(head,
+                                           makeHead((head >> 32) + 1, next),
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+            return packet;
+        }
+    }
+    return nullptr;
+}
+
+void PortCorePackets::pushFree(PortCorePacket* packet)
+{
+    std::uint64_t head = freeHead.load(std::memory_order_relaxed);
+    do {
+        packet->nextFree.store(static_cast<std::uint32_t>(head & slot_mask), std::memory_order_relaxed);
+    } while (!freeHead.compare_exchange_weak(head,
+                                             makeHead((head >> 32) + 1, packet->slot + 1),
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_relaxed));
+}
+
+PortCorePacket* PortCorePackets::allocateChunk()
+{
+    std::lock_guard<std::mutex> lock(chunkMutex);
+
+    // Another thread may have filled the free list while we were waiting
+    PortCorePacket* packet = popFree();
+    if (packet != nullptr) {
+        return packet;
+    }
+
+    size_t index = chunkCount.load();
+    if (index >= maxChunks) {
+        return allocateOverflow();
+    }
+
+    // operator new does not honor alignments larger than the fundamental
+    // one before C++17, therefore the chunk is aligned by hand
+    char* memory = new char[chunkSize * sizeof(PacketSlot) + cacheLineSize];
+    auto addr = reinterpret_cast<std::uintptr_t>(memory);
+    char* aligned = memory + (cacheLineSize - addr % cacheLineSize) % cacheLineSize;
+    auto* chunk = reinterpret_cast<PacketSlot*>(aligned);
+    for (size_t i = 0; i < chunkSize; i++) {
+        new (&chunk[i]) PacketSlot();
+        chunk[i].packet.slot = static_cast<std::uint32_t>(index * chunkSize + i);
+    }
+    chunkMemory[index] = memory;
+    chunks[index].store(chunk, std::memory_order_release);
+    chunkCount.store(index + 1);
+
+    // Keep the first packet, and make the others available
+    for (size_t i = chunkSize - 1; i > 0; i--) {
+        pushFree(&chunk[i].packet);
+    }
+    return &chunk[0].packet;
+}
+
+PortCorePacket* PortCorePackets::allocateOverflow()
 {
-    if (inactive.empty()) {
-        PortCorePacket* obj = nullptr;
-        obj = new PortCorePacket();
-        yCAssert(PORTCOREPACKETS, obj != nullptr);
-        inactive.push_back(obj);
+    // Called with chunkMutex locked
+    if (overflow.empty()) {
+        yCWarning(PORTCOREPACKETS, "*** There are more than %zu messages being sent by a single port.\n", maxChunks * chunkSize);
+        yCWarning(PORTCOREPACKETS, "*** This typically occurs when connections never complete their writes.\n");
+        yCWarning(PORTCOREPACKETS, "*** The following messages are allocated one by one until they are sent.\n");
     }
-    PortCorePacket* next = inactive.front();
+    auto* packet = new PortCorePacket();
+    packet->slot = overflowSlot;
+    overflow.insert(packet);
+    return packet;
+}
+
+PortCorePacket* PortCorePackets::getFreePacket()
+{
+    PortCorePacket* next = popFree();
     if (next == nullptr) {
-        yCError(PORTCOREPACKETS, "*** YARP consistency check failed.\n");
-        yCError(PORTCOREPACKETS, "*** There has been a low-level failure in \"PortCorePackets\".\n");
-        yCError(PORTCOREPACKETS, "*** This typically occurs when ports are accessed in a non-threadsafe way.\n");
-        yCError(PORTCOREPACKETS, "*** For help: https://github.com/robotology/yarp/issues/new\n");
+        next = allocateChunk();
     }
-    yCAssert(PORTCOREPACKETS, next != nullptr);
-    inactive.remove(next);
-    active.push_back(next);
+    activeCount++;
     return next;
 }
 
@@ -63,8 +176,14 @@ void PortCorePackets::freePacket(PortCorePacket* packet, bool clear)
             packet->reset();
         }
         packet->completed = true;
-        active.remove(packet);
-        inactive.push_back(packet);
+        activeCount--;
+        if (packet->slot == overflowSlot) {
+            std::lock_guard<std::mutex> lock(chunkMutex);
+            overflow.erase(packet);
+            delete packet;
+            return;
+        }
+        pushFree(packet);
     }
 }
 
@@ -72,6 +191,7 @@ bool PortCorePackets::completePacket(PortCorePacket* packet)
 {
     if (packet != nullptr) {
         if (packet->getCount() <= 0) {
+            std::lock_guard<std::mutex> lock(completionMutex);
             packet->complete();
             return true;
         }
@@ -83,7 +203,27 @@ bool PortCorePackets::checkPacket(PortCorePacket* packet)
 {
     if (packet != nullptr) {
         if (packet->getCount() <= 0) {
-            packet->complete();
+            {
+                std::lock_guard<std::mutex> lock(completionMutex);
+                packet->complete();
+            }
+            freePacket(packet);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PortCorePackets::releasePacket(PortCorePacket* packet)
+{
+    if (packet != nullptr) {
+        if (packet->dec() <= 0) {
+            {
+                // Completion callbacks of the same port were always
+                // serialized, keep them so.
+                std::lock_guard<std::mutex> lock(completionMutex);
+                packet->complete();
+            }
             freePacket(packet);
             return true;
         }
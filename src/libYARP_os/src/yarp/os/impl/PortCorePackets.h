@@ -12,9 +12,10 @@
 
 #include <yarp/os/impl/PortCorePacket.h>
 
-#include <yarp/os/Log.h>
-
-#include <list>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
 
 namespace yarp {
 namespace os {
@@ -26,20 +27,46 @@ namespace impl {
  * This tracks uses of the messages for memory management purposes.
  * We call messages "packets" for no particular reason.
  *
+ * Packets are allocated in chunks, that are kept until the collection is
+ * destroyed, and unused packets are kept in a lock-free free list.  Each
+ * packet in a chunk starts on its own cache line, so that the reference
+ * counts of packets released by different threads are not falsely shared.
+ * Getting a packet, counting its users and releasing it take no lock, so
+ * they can be called from any thread, except when a new chunk is needed.
+ * When all the chunks are used, packets are allocated one by one and
+ * deleted when released.
+ *
  */
-class PortCorePackets
+class YARP_os_impl_API PortCorePackets
 {
-private:
-    std::list<PortCorePacket*> inactive; // unused packets we may reuse
-    std::list<PortCorePacket*> active;   // a list of packets being sent
 public:
+    static constexpr size_t chunkSize = 64;  ///< packets allocated at a time
+    static constexpr size_t maxChunks = 256; ///< chunks available, i.e. 16384 packets are recycled
+    static constexpr std::uint32_t overflowSlot = 0xffffffff; ///< slot of the packets allocated one by one
+    static constexpr size_t cacheLineSize = 64;                ///< alignment of the packets in the chunks
+
+    PortCorePackets();
     virtual ~PortCorePackets();
 
+    PortCorePackets(const PortCorePackets&) = delete;
+    PortCorePackets& operator=(const PortCorePackets&) = delete;
+
     /**
      * @return the number of packets currently being sent.
      */
     size_t getCount();
 
+    /**
+     * @return the number of packets allocated so far in chunks.
+     */
+    size_t getCapacity();
+
+    /**
+     * @return the number of packets allocated one by one, because all the
+     * chunks are used.
+     */
+    size_t getOverflowCount();
+
     /**
      * Get a packet that we can prepare for sending.  If a previously sent
      * packet that is not being used is available, we take that.  Otherwise
@@ -50,7 +77,7 @@ public:
     PortCorePacket* getFreePacket();
 
     /**
-     * Force the given packet into an inactive state.  See checkPacket() for
+     * Force the given packet into an inactive state.  See releasePacket() for
      * a less drastic way to nudge a packet onwards in its lifecycle.
      * @param packet the packet to work on
      * @param clear whether to reset the contents of the packet
@@ -68,10 +95,43 @@ public:
     /**
      * Move a packet to the inactive state if it has finished being
      * sent on all connections.
+     * This is not safe if other threads are releasing the same packet,
+     * use releasePacket() instead.
      * @param packet the packet to work on
      * @return true if the packet was made inactive
      */
     bool checkPacket(PortCorePacket* packet);
+
+    /**
+     * Decrement the usage count of a packet, and move it to the inactive
+     * state if it has finished being sent on all connections.
+     * Only the caller that releases the last use completes the packet,
+     * therefore this is safe to call from any thread.
+     * @param packet the packet to work on
+     * @return true if the packet was made inactive
+     */
+    bool releasePacket(PortCorePacket* packet);
+
+private:
+    struct alignas(cacheLineSize) PacketSlot
+    {
+        PortCorePacket packet;
+    };
+
+    PortCorePacket* getPacket(std::uint32_t slot);
+    PortCorePacket* popFree();
+    void pushFree(PortCorePacket* packet);
+    PortCorePacket* allocateChunk();
+    PortCorePacket* allocateOverflow();
+
+    std::atomic<std::uint64_t> freeHead;          ///< tag << 32 | (slot + 1) of the first free packet
+    std::atomic<size_t> activeCount;              ///< packets being sent
+    std::atomic<size_t> chunkCount;               ///< chunks allocated
+    std::atomic<PacketSlot*> chunks[maxChunks];   ///< the slab
+    char* chunkMemory[maxChunks];                 ///< the allocations of the chunks, before alignment
+    std::mutex chunkMutex;                        ///< serialize the allocation of chunks
+    std::unordered_set<PortCorePacket*> overflow; ///< packets allocated one by one, guarded by chunkMutex
+    std::mutex completionMutex;                   ///< serialize the completion notifications
 };
 
 
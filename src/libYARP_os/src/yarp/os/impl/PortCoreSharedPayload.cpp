@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/PortCoreSharedPayload.h>
+
+#include <yarp/os/Bytes.h>
+
+using yarp::os::impl::BufferedConnectionWriter;
+using yarp::os::impl::PortCoreSharedPayload;
+
+
+PortCoreSharedPayload::PortCoreSharedPayload(bool textMode, bool bareMode) :
+        content(textMode, bareMode),
+        ready(false),
+        ok(false),
+        drop(false)
+{
+}
+
+bool PortCoreSharedPayload::prepare(const yarp::os::PortWriter& writer)
+{
+    if (ready) {
+        return ok;
+    }
+    content.restart();
+    ok = writer.write(content);
+    // Apply any pending text mode conversion now, so that the buffers will
+    // not change while they are referenced by the connections.
+    content.stopWrite();
+    drop = content.dropRequested();
+    ready = true;
+    return ok;
+}
+
+void PortCoreSharedPayload::reset()
+{
+    ready = false;
+    ok = false;
+    drop = false;
+}
+
+size_t PortCoreSharedPayload::dataSize() const
+{
+    return content.dataSize();
+}
+
+bool PortCoreSharedPayload::write(BufferedConnectionWriter& buf) const
+{
+    for (size_t i = 0; i < content.length(); i++) {
+        buf.appendBlock(yarp::os::Bytes(const_cast<char*>(content.data(i)), content.length(i)));
+    }
+    if (drop) {
+        buf.requestDrop();
+    }
+    return ok;
+}
+
+bool PortCoreSharedPayload::copy(BufferedConnectionWriter& buf) const
+{
+    for (size_t i = 0; i < content.length(); i++) {
+        buf.appendBlockCopy(yarp::os::Bytes(const_cast<char*>(content.data(i)), content.length(i)));
+    }
+    if (drop) {
+        buf.requestDrop();
+    }
+    return ok;
+}
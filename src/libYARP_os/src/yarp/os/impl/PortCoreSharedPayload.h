@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_IMPL_PORTCORESHAREDPAYLOAD_H
+#define YARP_OS_IMPL_PORTCORESHAREDPAYLOAD_H
+
+#include <yarp/os/PortWriter.h>
+#include <yarp/os/impl/BufferedConnectionWriter.h>
+
+namespace yarp {
+namespace os {
+namespace impl {
+
+/**
+ * The serialized form of a message, shared by all the output connections
+ * of a port that use the same text/bare mode.
+ *
+ * The message is serialized once with prepare().  From then on the
+ * payload is immutable until reset() is called, and any number of
+ * connections (possibly running in their own threads) can reference its
+ * buffers with write() without copying them or running the serialization
+ * again.
+ *
+ * A payload is owned by a PortCorePacket, and it lives as long as the
+ * reference count of its packet is positive.  Buffers are kept across
+ * reset(), so a port that sends messages with the same structure does not
+ * allocate memory for the payload after the first message.
+ */
+class YARP_os_impl_API PortCoreSharedPayload
+{
+public:
+    /**
+     * Constructor.
+     *
+     * @param textMode the text mode used for serializing the message
+     * @param bareMode the bare mode used for serializing the message
+     */
+    PortCoreSharedPayload(bool textMode = false, bool bareMode = false);
+
+    PortCoreSharedPayload(const PortCoreSharedPayload&) = delete;
+    PortCoreSharedPayload& operator=(const PortCoreSharedPayload&) = delete;
+
+    /**
+     * Serialize a message.  Does nothing if the payload is already
+     * prepared.
+     *
+     * @param writer the message
+     * @return true if the message was serialized successfully
+     */
+    bool prepare(const yarp::os::PortWriter& writer);
+
+    /**
+     * Forget the current message, keeping any allocated buffer.
+     */
+    void reset();
+
+    /**
+     * @return true if a message was serialized with prepare() since the
+     * last reset().
+     */
+    bool isReady() const
+    {
+        return ready;
+    }
+
+    /**
+     * @return true if the serialization was successful.
+     */
+    bool isOk() const
+    {
+        return ok;
+    }
+
+    /**
+     * @return the size, in bytes, of the serialized message.
+     */
+    size_t dataSize() const;
+
+    /**
+     * Add the serialized message to the payload of a writer, by reference.
+     * If the serialization asked for the connection to be dropped, the
+     * request is forwarded to the writer.
+     *
+     * @param buf the writer used by a single connection
+     * @return true if the serialization was successful
+     */
+    bool write(BufferedConnectionWriter& buf) const;
+
+    /**
+     * Add a copy of the serialized message, including the external blocks,
+     * to the payload of a writer.
+     *
+     * @param buf the writer that will own the copy
+     * @return true if the serialization was successful
+     */
+    bool copy(BufferedConnectionWriter& buf) const;
+
+private:
+    BufferedConnectionWriter content; ///< the serialized message
+    bool ready;                       ///< has the message been serialized
+    bool ok;                          ///< was the serialization successful
+    bool drop;                        ///< did the serialization request a drop
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_IMPL_PORTCORESHAREDPAYLOAD_H
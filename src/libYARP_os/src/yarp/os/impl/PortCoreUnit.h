@@ -147,6 +147,22 @@ public:
         return tracker;
     }
 
+    /**
+     * Check whether the messages sent on this connection can be serialized
+     * once and shared with other connections of the port.
+     *
+     * @param[out] textMode the text mode used for serializing the message
+     * @param[out] bareMode the bare mode used for serializing the message
+     *
+     * @return true if a shared serialization can be used
+     */
+    virtual bool canSharePayload(bool& textMode, bool& bareMode)
+    {
+        YARP_UNUSED(textMode);
+        YARP_UNUSED(bareMode);
+        return false;
+    }
+
     /**
      * Reacquire a tracker previously passed via send(). This method
      * may need to wait a send operation to complete before the tracker
@@ -153,3 +153,21 @@ int SocketTwoWayStream::getTypeOfService()
     stream.get_option(IPPROTO_IP, IP_TOS, (int*)&tos, &optlen);
     return tos;
 }
+
+bool SocketTwoWayStream::sendBlocks(const iovec* iov, int count)
+{
+    if (!isOk()) {
+        return false;
+    }
+    yarp::conf::ssize_t result;
+    if (haveWriteTimeout) {
+        result = stream.sendv_n(iov, count, &writeTimeout);
+    } else {
+        result = stream.sendv_n(iov, count);
+    }
+    if (result < 0) {
+        happy = false;
+        yCDebug(SOCKETTWOWAYSTREAM, "bad socket write");
+    }
+    return happy;
+}
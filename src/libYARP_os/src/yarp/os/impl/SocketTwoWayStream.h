@@ -15,20 +15,11 @@
 #include <yarp/os/Bytes.h>
 #include <yarp/os/LogComponent.h>
 #include <yarp/os/TwoWayStream.h>
+#include <yarp/os/impl/GatheredWriter.h>
 #include <yarp/os/impl/PlatformTime.h>
 #include <yarp/os/impl/TcpAcceptor.h>
 #include <yarp/os/impl/TcpStream.h>
 
-#ifdef YARP_HAS_ACE // For TCP_CORK definition
-#    include <ace/os_include/netinet/os_tcp.h>
-// In one the ACE headers there is a definition of "main" for WIN32
-#    ifdef main
-#        undef main
-#    endif
-#else
-#    include <netinet/tcp.h>
-#endif
-
 YARP_DECLARE_LOG_COMPONENT(SOCKETTWOWAYSTREAM)
 
 namespace yarp {
@@ -47,7 +38,8 @@ public:
     SocketTwoWayStream() :
             haveWriteTimeout(false),
             haveReadTimeout(false),
-            happy(false)
+            happy(false),
+            writer([this](const iovec* iov, int count) { return sendBlocks(iov, count); })
     {
     }
 
@@ -106,6 +98,7 @@ public:
         if (!isOk()) {
             return -1;
         }
+        writer.flush();
         yarp::conf::ssize_t result;
         if (haveReadTimeout) {
             result = stream.recv_n(b.get(), b.length(), &readTimeout);
@@ -127,6 +120,7 @@ public:
         if (!isOk()) {
             return -1;
         }
+        writer.flush();
         yarp::conf::ssize_t result;
         if (haveReadTimeout) {
             result = stream.recv(b.get(), b.length(), &readTimeout);
@@ -149,33 +143,21 @@ public:
         if (!isOk()) {
             return;
         }
-        yarp::conf::ssize_t result;
-        if (haveWriteTimeout) {
-            result = stream.send_n(b.get(), b.length(), &writeTimeout);
-        } else {
-            result = stream.send_n(b.get(), b.length());
-        }
-        if (result < 0) {
-            happy = false;
-            yCDebug(SOCKETTWOWAYSTREAM, "bad socket write");
+        writer.write(b);
+    }
+
+    void writeBlocks(const Bytes* blocks, size_t count) override
+    {
+        if (!isOk()) {
+            writer.clear();
+            return;
         }
+        writer.writeBlocks(blocks, count);
     }
 
     void flush() override
     {
-#ifdef TCP_CORK
-        int status = 0;
-        int sizeInt = sizeof(int);
-        stream.get_option(IPPROTO_TCP, TCP_CORK, &status, &sizeInt);
-        if (status == 1) {
-            // Remove CORK
-            int zero = 0;
-            stream.set_option(IPPROTO_TCP, TCP_CORK, &zero, sizeof(int));
-            // Set CORK
-            int one = 1;
-            stream.set_option(IPPROTO_TCP, TCP_CORK, &one, sizeof(int));
-        }
-#endif
+        writer.flush();
     }
 
     bool isOk() const override
@@ -189,20 +171,12 @@ public:
 
     void beginPacket() override
     {
-#ifdef TCP_CORK
-        // Set CORK
-        int one = 1;
-        stream.set_option(IPPROTO_TCP, TCP_CORK, &one, sizeof(int));
-#endif
+        writer.beginPacket();
     }
 
     void endPacket() override
     {
-#ifdef TCP_CORK
-        // Remove CORK
-        int zero = 0;
-        stream.set_option(IPPROTO_TCP, TCP_CORK, &zero, sizeof(int));
-#endif
+        writer.endPacket();
     }
 
     bool setWriteTimeout(double timeout) override
@@ -238,7 +212,9 @@ private:
     YARP_timeval readTimeout;
     Contact localAddress, remoteAddress;
     bool happy;
+    GatheredWriter writer; ///< collect the small writes of a packet
     void updateAddresses();
+    bool sendBlocks(const iovec* iov, int count);
 };
 
 } // namespace impl
@@ -10,6 +10,7 @@
 
 #include <yarp/os/impl/Storable.h>
 
+#include <yarp/conf/environment.h>
 #include <yarp/conf/numeric.h>
 
 #include <yarp/os/Bottle.h>
@@ -22,6 +23,7 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <new>
 
 using yarp::os::Bottle;
 using yarp::os::ConnectionReader;
@@ -62,8 +64,150 @@ const int StoreDict::code = BOTTLE_TAG_LIST | BOTTLE_TAG_DICT;
 ////////////////////////////////////////////////////////////////////////////
 // Storable
 
+namespace {
+
+/*
+ * Per-thread cache of the blocks used by Storables.
+ *
+ * Blocks are grouped by size, rounded up to a multiple of 16 bytes, and
+ * freed blocks are kept in a singly linked list for each size.  Items are
+ * usually created and deleted by the same thread, therefore no lock is
+ * needed.  A block deleted by a thread other than the one that allocated it
+ * simply moves to the cache of the deleting thread.
+ */
+class StorableCache
+{
+public:
+    static constexpr size_t granularity = 16;
+    static constexpr size_t maxSize = 256;
+    static constexpr size_t classes = maxSize / granularity;
+    static constexpr size_t maxCached = 4096; ///< blocks kept for each size
+
+    static size_t sizeClass(size_t size)
+    {
+        return (size + granularity - 1) / granularity - 1;
+    }
+
+    ~StorableCache()
+    {
+        for (auto& head : heads) {
+            while (head != nullptr) {
+                Block* next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+        }
+    }
+
+    void* allocate(size_t cls)
+    {
+        Block* block = heads[cls];
+        if (block == nullptr) {
+            return ::operator new((cls + 1) * granularity);
+        }
+        heads[cls] = block->next;
+        counts[cls]--;
+        return block;
+    }
+
+    void deallocate(void* ptr, size_t cls)
+    {
+        if (counts[cls] >= maxCached) {
+            ::operator delete(ptr);
+            return;
+        }
+        auto* block = static_cast<Block*>(ptr);
+        block->next = heads[cls];
+        heads[cls] = block;
+        counts[cls]++;
+    }
+
+private:
+    struct Block
+    {
+        Block* next;
+    };
+
+    Block* heads[classes] {};
+    size_t counts[classes] {};
+};
+
+constexpr size_t StorableCache::granularity;
+constexpr size_t StorableCache::maxSize;
+constexpr size_t StorableCache::classes;
+constexpr size_t StorableCache::maxCached;
+
+// The cache of the thread, created on first use.  Plain pointers are used
+// because access to thread_local objects with a destructor is slower.
+thread_local StorableCache* storable_cache = nullptr;
+// Set once the cache of the thread is destroyed, Storables deleted later
+// by other thread_local destructors go straight to the heap.
+thread_local bool storable_cache_destroyed = false;
+
+class StorableCacheHolder
+{
+public:
+    StorableCache cache;
+
+    StorableCacheHolder()
+    {
+        storable_cache = &cache;
+    }
+
+    ~StorableCacheHolder()
+    {
+        storable_cache = nullptr;
+        storable_cache_destroyed = true;
+    }
+};
+
+const bool storable_cache_enabled = (yarp::conf::environment::getEnvironment("YARP_BOTTLE_POOL") != "0");
+
+StorableCache* getStorableCache(size_t size)
+{
+    if (size > StorableCache::maxSize) {
+        return nullptr;
+    }
+    StorableCache* cache = storable_cache;
+    if (cache == nullptr && storable_cache_enabled && !storable_cache_destroyed) {
+        thread_local StorableCacheHolder holder;
+        cache = &holder.cache;
+    }
+    return cache;
+}
+
+} // namespace
+
+
 Storable::~Storable() = default;
 
+void* Storable::operator new(std::size_t size)
+{
+    StorableCache* cache = getStorableCache(size);
+    if (cache == nullptr) {
+        // Blocks may end up in the cache of another thread, allocate all
+        // the bytes of the size class.
+        if (size <= StorableCache::maxSize) {
+            size = (StorableCache::sizeClass(size) + 1) * StorableCache::granularity;
+        }
+        return ::operator new(size);
+    }
+    return cache->allocate(StorableCache::sizeClass(size));
+}
+
+void Storable::operator delete(void* ptr, std::size_t size)
+{
+    if (ptr == nullptr) {
+        return;
+    }
+    StorableCache* cache = getStorableCache(size);
+    if (cache == nullptr) {
+        ::operator delete(ptr);
+        return;
+    }
+    cache->deallocate(ptr, StorableCache::sizeClass(size));
+}
+
 Storable* Storable::createByCode(std::int32_t id)
 {
     Storable* storable = nullptr;
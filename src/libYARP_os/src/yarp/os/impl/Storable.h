@@ -17,6 +17,8 @@
 #include <yarp/os/Value.h>
 #include <yarp/os/Vocab.h>
 
+#include <cstddef>
+
 
 #define UNIT_MASK         \
     (BOTTLE_TAG_INT8    | \
@@ -51,6 +53,20 @@ public:
      */
     virtual ~Storable();
 
+    /**
+     * Allocate a Storable.  Small items are taken from a per-thread cache
+     * of blocks, refilled when items are deleted, so that building and
+     * reading a Bottle with the same structure as a previous one does not
+     * need the heap.  Setting the YARP_BOTTLE_POOL environment variable to
+     * 0 disables the cache.
+     */
+    static void* operator new(std::size_t size);
+
+    /**
+     * Release a Storable allocated with operator new.
+     */
+    static void operator delete(void* ptr, std::size_t size);
+
     /**
      * Factory method.
      */
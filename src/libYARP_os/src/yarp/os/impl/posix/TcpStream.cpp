@@ -13,6 +13,8 @@
 
 // General files
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <climits>
 #include <cstdio>
 
 #include <yarp/os/impl/TcpStream.h>
@@ -38,6 +40,51 @@ int TcpStream::open() {
     return 0;
 }
 
+ssize_t TcpStream::sendv_n(const iovec *iov, int iovcnt)
+{
+#ifdef IOV_MAX
+    const int maxCount = IOV_MAX;
+#else
+    const int maxCount = 16;
+#endif
+    ssize_t total = 0;
+    while (iovcnt > 0) {
+        int count = (iovcnt < maxCount) ? iovcnt : maxCount;
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = const_cast<iovec*>(iov);
+        msg.msg_iovlen = count;
+        ssize_t sent = ::sendmsg(sd, &msg, 0);
+        if (sent < 0) {
+            return -1;
+        }
+        total += sent;
+        for (int i = 0; i < count; i++) {
+            size_t len = iov[i].iov_len;
+            if (static_cast<size_t>(sent) >= len) {
+                sent -= len;
+                continue;
+            }
+            // The kernel took only part of the buffers, send the rest
+            const char* rest = static_cast<const char*>(iov[i].iov_base) + sent;
+            len -= sent;
+            sent = 0;
+            while (len > 0) {
+                ssize_t result = ::send(sd, rest, len, 0);
+                if (result <= 0) {
+                    return -1;
+                }
+                rest += result;
+                len -= result;
+                total += result;
+            }
+        }
+        iov += count;
+        iovcnt -= count;
+    }
+    return total;
+}
+
 int TcpStream::get_local_addr (sockaddr & sa) {
 
     int len = sizeof(sa);
@@ -13,6 +13,7 @@
 // General files
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
@@ -76,6 +77,20 @@ public:
         return ::send(sd, buf, n, 0);
     }
 
+    /**
+     * Send several buffers, with a single sendmsg() call when possible.
+     * Buffers that are only partially sent are completed with send().
+     *
+     * @return the number of bytes sent, or -1 on error
+     */
+    ssize_t sendv_n (const iovec *iov, int iovcnt);
+
+    inline ssize_t sendv_n (const iovec *iov, int iovcnt, struct timeval *tv)
+    {
+        setsockopt(sd, SOL_SOCKET, SO_SNDTIMEO, (char *)tv, sizeof (*tv));
+        return sendv_n(iov, iovcnt);
+    }
+
     // No idea what this should do...
     void flush() { }
 
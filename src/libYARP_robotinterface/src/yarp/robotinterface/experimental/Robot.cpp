@@ -13,13 +13,21 @@
 #include <yarp/robotinterface/experimental/Param.h>
 
 #include <yarp/os/LogStream.h>
+#include <yarp/os/SystemClock.h>
 
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/PolyDriverList.h>
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 
 
@@ -47,7 +55,8 @@ public:
     Private(Robot* /*parent*/) :
             build(0),
             currentPhase(ActionPhaseUnknown),
-            currentLevel(0)
+            currentLevel(0),
+            openThreads(0)
     {
     }
 
@@ -72,6 +81,15 @@ public:
     // open all the devices and return true if all the open calls were successful
     bool openDevices();
 
+    // open all the devices on openThreads threads, each device after the
+    // devices it depends on, and return true if all the open calls were
+    // successful
+    bool openDevicesParallel();
+
+    // return the indices of the devices that the device at the given index
+    // references in its attach and calibrate actions
+    std::vector<size_t> getDependencies(size_t index) const;
+
     // close all the devices and return true if all the close calls were successful
     bool closeDevices();
 
@@ -111,6 +129,7 @@ public:
     yarp::dev::PolyDriverList externalDevices;
     yarp::robotinterface::experimental::ActionPhase currentPhase;
     unsigned int currentLevel;
+    unsigned int openThreads;
 }; // class yarp::robotinterface::experimental::Robot::Private
 
 bool yarp::robotinterface::experimental::Robot::Private::hasDevice(const std::string& name) const
@@ -195,6 +214,10 @@ bool yarp::robotinterface::experimental::Robot::Private::checkForNamingConflicts
 
 bool yarp::robotinterface::experimental::Robot::Private::openDevices()
 {
+    if (openThreads > 1 && devices.size() > 1) {
+        return openDevicesParallel();
+    }
+
     bool ret = true;
     for (auto& device : devices) {
         // yDebug() << device;
@@ -213,6 +236,215 @@ bool yarp::robotinterface::experimental::Robot::Private::openDevices()
     return ret;
 }
 
+std::vector<size_t> yarp::robotinterface::experimental::Robot::Private::getDependencies(size_t index) const
+{
+    std::vector<size_t> dependencies;
+    auto addDependency = [&](const std::string& deviceName) {
+        for (size_t i = 0; i < devices.size(); ++i) {
+            if (i != index && devices[i].name() == deviceName) {
+                dependencies.push_back(i);
+            }
+        }
+    };
+
+    for (const auto& action : devices[index].actions()) {
+        const ParamList& params = action.params();
+        if (action.type() == ActionTypeCalibrate) {
+            if (yarp::robotinterface::experimental::hasParam(params, "target")) {
+                addDependency(yarp::robotinterface::experimental::findParam(params, "target"));
+            }
+        } else if (action.type() == ActionTypeAttach) {
+            if (yarp::robotinterface::experimental::hasParam(params, "all")) {
+                // Attached to every other device: wait for all the devices that
+                // are not attached to all the others as well
+                for (size_t i = 0; i < devices.size(); ++i) {
+                    if (i == index) {
+                        continue;
+                    }
+                    bool all = false;
+                    for (const auto& otherAction : devices[i].actions()) {
+                        if (otherAction.type() == ActionTypeAttach && yarp::robotinterface::experimental::hasParam(otherAction.params(), "all")) {
+                            all = true;
+                        }
+                    }
+                    if (!all) {
+                        dependencies.push_back(i);
+                    }
+                }
+            } else if (yarp::robotinterface::experimental::hasParam(params, "network")) {
+                if (yarp::robotinterface::experimental::hasParam(params, "device")) {
+                    addDependency(yarp::robotinterface::experimental::findParam(params, "device"));
+                }
+            } else if (yarp::robotinterface::experimental::hasParam(params, "networks")) {
+                yarp::os::Value v;
+                v.fromString(yarp::robotinterface::experimental::findParam(params, "networks").c_str());
+                yarp::os::Bottle* targetNetworks = v.asList();
+                for (size_t i = 0; targetNetworks != nullptr && i < targetNetworks->size(); ++i) {
+                    std::string targetNetwork = targetNetworks->get(i).toString();
+                    if (yarp::robotinterface::experimental::hasParam(params, targetNetwork)) {
+                        addDependency(yarp::robotinterface::experimental::findParam(params, targetNetwork));
+                    }
+                }
+            }
+        }
+    }
+
+    std::sort(dependencies.begin(), dependencies.end());
+    dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+    return dependencies;
+}
+
+bool yarp::robotinterface::experimental::Robot::Private::openDevicesParallel()
+{
+    const size_t count = devices.size();
+
+    // Build the dependency graph
+    std::vector<std::vector<size_t>> dependencies(count);
+    std::vector<std::vector<size_t>> dependents(count);
+    std::vector<size_t> missing(count);
+    for (size_t i = 0; i < count; ++i) {
+        dependencies[i] = getDependencies(i);
+        missing[i] = dependencies[i].size();
+        for (size_t d : dependencies[i]) {
+            dependents[d].push_back(i);
+        }
+    }
+
+    // Check that there are no cycles
+    {
+        std::vector<size_t> left = missing;
+        std::deque<size_t> ready;
+        for (size_t i = 0; i < count; ++i) {
+            if (left[i] == 0) {
+                ready.push_back(i);
+            }
+        }
+        size_t sorted = 0;
+        while (!ready.empty()) {
+            size_t i = ready.front();
+            ready.pop_front();
+            ++sorted;
+            for (size_t d : dependents[i]) {
+                if (--left[d] == 0) {
+                    ready.push_back(d);
+                }
+            }
+        }
+        if (sorted != count) {
+            yWarning() << "The devices have circular dependencies. Opening them sequentially.";
+            unsigned int threads = openThreads;
+            openThreads = 0;
+            bool ret = openDevices();
+            openThreads = threads;
+            return ret;
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<size_t> ready;
+    size_t done = 0;
+    bool ret = true;
+    std::vector<double> start(count, 0.0);
+    std::vector<double> end(count, 0.0);
+    std::vector<bool> opened(count, false);
+    const double t0 = yarp::os::SystemClock::nowSystem();
+
+    for (size_t i = 0; i < count; ++i) {
+        if (missing[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            cond.wait(lock, [&]() { return !ready.empty() || done == count; });
+            if (ready.empty()) {
+                return;
+            }
+            size_t i = ready.front();
+            ready.pop_front();
+
+            lock.unlock();
+            double t = yarp::os::SystemClock::nowSystem() - t0;
+            bool ok = devices[i].open();
+            double e = yarp::os::SystemClock::nowSystem() - t0;
+            lock.lock();
+
+            start[i] = t;
+            end[i] = e;
+            opened[i] = ok;
+            if (!ok) {
+                yWarning() << "Cannot open device" << devices[i].name();
+                ret = false;
+            }
+            // The dependents are opened anyway, as in the sequential case,
+            // and will fail in the attach actions
+            for (size_t d : dependents[i]) {
+                if (--missing[d] == 0) {
+                    ready.push_back(d);
+                }
+            }
+            ++done;
+            cond.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    size_t threadCount = std::min(static_cast<size_t>(openThreads), count);
+    yInfo() << "Opening" << count << "devices on" << threadCount << "threads";
+    threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Startup timeline
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return start[a] < start[b]; });
+    yInfo() << "Device opening timeline:";
+    for (size_t i : order) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(3) << start[i] << " s -> " << end[i] << " s (" << end[i] - start[i] << " s)";
+        if (opened[i]) {
+            yInfo() << " " << devices[i].name() << ":" << oss.str();
+        } else {
+            yWarning() << " " << devices[i].name() << ":" << oss.str() << "(failed)";
+        }
+    }
+
+    // The critical path goes back from the last device opened, through the
+    // dependency that finished last
+    size_t last = *std::max_element(order.begin(), order.end(), [&](size_t a, size_t b) { return end[a] < end[b]; });
+    std::vector<size_t> critical {last};
+    while (!dependencies[critical.back()].empty()) {
+        const auto& deps = dependencies[critical.back()];
+        critical.push_back(*std::max_element(deps.begin(), deps.end(), [&](size_t a, size_t b) { return end[a] < end[b]; }));
+    }
+    std::ostringstream path;
+    for (auto it = critical.rbegin(); it != critical.rend(); ++it) {
+        path << (it == critical.rbegin() ? "" : " -> ") << devices[*it].name() << " (" << std::fixed << std::setprecision(3) << end[*it] - start[*it] << " s)";
+    }
+    yInfo() << "Critical path:" << path.str();
+    {
+        std::ostringstream total;
+        total << std::fixed << std::setprecision(3) << end[last] << " s";
+        yInfo() << "All devices processed in" << total.str();
+    }
+
+    if (!ret) {
+        yWarning() << "There was some problem opening one or more devices. Please check the log and your configuration";
+    }
+
+    return ret;
+}
+
 bool yarp::robotinterface::experimental::Robot::Private::closeDevices()
 {
     bool ret = true;
@@ -514,6 +746,11 @@ void yarp::robotinterface::experimental::Robot::setAllowDeprecatedDevices(bool a
     }
 }
 
+void yarp::robotinterface::experimental::Robot::setParallelOpen(unsigned int threads)
+{
+    mPriv->openThreads = threads;
+}
+
 yarp::robotinterface::experimental::ParamList& yarp::robotinterface::experimental::Robot::params()
 {
     return mPriv->params;
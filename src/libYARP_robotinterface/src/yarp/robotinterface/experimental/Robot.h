@@ -34,6 +34,16 @@ public:
     void setVerbose(bool verbose);
     void setAllowDeprecatedDevices(bool allowDeprecatedDevices);
 
+    /**
+     * Open the devices on the given number of threads in the startup phase.
+     *
+     * Each device is opened after the devices that it references in its
+     * attach and calibrate actions, and a timeline with the critical path is
+     * printed at the end.  With 0 or 1 threads (the default), the devices are
+     * opened sequentially in the order of the configuration file.
+     */
+    void setParallelOpen(unsigned int threads);
+
     ParamList& params();
     DeviceList& devices();
     Device& device(const std::string& name);
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SERVERSQL_IMPL_SQLITESTATEMENTCACHE_H
+#define YARP_SERVERSQL_IMPL_SQLITESTATEMENTCACHE_H
+
+#include <sqlite3.h>
+
+#include <string>
+#include <unordered_map>
+
+
+namespace yarp {
+namespace serversql {
+namespace impl {
+
+/**
+ * Prepared statements of a Sqlite database, compiled once and reused.
+ *
+ * Queries are expected to use parameters ("?") instead of literal
+ * values, so that a handful of statements serves every lookup.  A
+ * statement returned by prepare() must be released with sqlite3_reset()
+ * once its rows have been read, and never finalized by the caller.
+ */
+class SqliteStatementCache
+{
+public:
+    SqliteStatementCache() = default;
+    SqliteStatementCache(const SqliteStatementCache&) = delete;
+    SqliteStatementCache& operator=(const SqliteStatementCache&) = delete;
+
+    ~SqliteStatementCache()
+    {
+        clear();
+    }
+
+    /**
+     * Set the database, finalizing the statements of the previous one.
+     */
+    void setDatabase(sqlite3* db);
+
+    /**
+     * Get the statement for a query, with no parameter bound.
+     * @return the statement, or nullptr if the query is not valid.
+     */
+    sqlite3_stmt* prepare(const std::string& sql);
+
+    /**
+     * Finalize all statements.  Must be called before closing the database.
+     */
+    void clear();
+
+    /**
+     * Bind a string parameter of a statement, nullptr is bound as NULL.
+     * The string must stay valid until the statement is reset.
+     */
+    static void bindText(sqlite3_stmt* statement, int index, const char* text);
+
+private:
+    sqlite3* db {nullptr};
+    std::unordered_map<std::string, sqlite3_stmt*> statements;
+};
+
+} // namespace impl
+} // namespace serversql
+} // namespace yarp
+
+
+#endif // YARP_SERVERSQL_IMPL_SQLITESTATEMENTCACHE_H
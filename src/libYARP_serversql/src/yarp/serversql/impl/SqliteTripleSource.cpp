@@ -14,53 +14,86 @@
 #include <cstdlib>
 #include <cstdio>
 
+using yarp::serversql::impl::SqliteStatementCache;
 using yarp::serversql::impl::SqliteTripleSource;
 using yarp::serversql::impl::Triple;
 using yarp::serversql::impl::TripleContext;
 
 namespace {
 YARP_SERVERSQL_LOG_COMPONENT(SQLITETRIPLESOURCE, "yarp.serversql.impl.SqliteTripleSource")
+
+// Separator of the fields of the cache keys
+constexpr char sep = '\x1f';
+
+// The cache is flushed when it grows past this number of results, lookups
+// of names that do not exist are cached too.
+constexpr size_t maxCacheSize = 100000;
+
+std::string token(bool has, const std::string& str)
+{
+    if (!has) {
+        return "!";
+    }
+    if (str == "*") {
+        return "*";
+    }
+    return "=" + str;
+}
+
+bool isExact(const Triple& t)
+{
+    return !(t.hasNs && t.ns == "*") &&
+           !(t.hasName && t.name == "*") &&
+           !(t.hasValue && t.value == "*");
+}
+
+int ridOf(TripleContext *context)
+{
+    return (context != nullptr) ? context->rid : -1;
+}
+
 } // namespace
 
 SqliteTripleSource::SqliteTripleSource(sqlite3 *db) : db(db)
 {
+    statements.setDatabase(db);
 }
 
-std::string SqliteTripleSource::condition(Triple& t, TripleContext *context)
+SqliteTripleSource::~SqliteTripleSource()
 {
-    int rid = (context != nullptr) ? context->rid : -1;
+    // The statements must be finalized before the database is closed
+    statements.clear();
+}
+
+std::string SqliteTripleSource::condition(Triple& t, TripleContext *context, std::vector<const char*>& args)
+{
+    int rid = ridOf(context);
     std::string cond = "";
     if (rid==-1) {
         cond = "rid IS NULL";
     } else {
-        cond = "rid = " + expressContext(context);
+        cond = "rid = ?";
     }
     if (t.hasNs) {
         if (t.ns!="*") {
-            char *query = nullptr;
-            query = sqlite3_mprintf(" AND ns = %Q",t.getNs());
-            cond = cond + query;
-            sqlite3_free(query);
+            cond += " AND ns = ?";
+            args.push_back(t.getNs());
         }
     } else {
         cond += " AND ns IS NULL";
     }
     if (t.hasName) {
         if (t.name!="*") {
-            char *query = nullptr;
-            query = sqlite3_mprintf(" AND name = %Q",t.getName());
-            cond = cond + query;
-            sqlite3_free(query);
+            cond += " AND name = ?";
+            args.push_back(t.getName());
         }
     } else {
         cond += " AND name IS NULL";
     }
     if (t.hasValue) {
         if (t.value!="*") {
-            char *query = nullptr;
-            query = sqlite3_mprintf(" AND value = %Q",t.getValue());
-            cond = cond + query;
-            sqlite3_free(query);
+            cond += " AND value = ?";
+            args.push_back(t.getValue());
         }
     } else {
         cond += " AND value IS NULL";
@@ -68,67 +101,166 @@ std::string SqliteTripleSource::condition(Triple& t, TripleContext *context)
     return cond;
 }
 
+sqlite3_stmt* SqliteTripleSource::prepare(const std::string& sql)
+{
+    yCDebug(SQLITETRIPLESOURCE, "Query: %s", sql.c_str());
+    sqlite3_stmt* statement = statements.prepare(sql);
+    if (statement == nullptr) {
+        yCWarning(SQLITETRIPLESOURCE, "Error in query");
+    }
+    return statement;
+}
+
+void SqliteTripleSource::bind(sqlite3_stmt* statement, int first, TripleContext *context, const std::vector<const char*>& args)
+{
+    int index = first;
+    int rid = ridOf(context);
+    if (rid != -1) {
+        sqlite3_bind_int(statement, index++, rid);
+    }
+    for (const char* arg : args) {
+        SqliteStatementCache::bindText(statement, index++, arg);
+    }
+}
+
+bool SqliteTripleSource::exec(sqlite3_stmt* statement)
+{
+    int result = sqlite3_step(statement);
+    if (result != SQLITE_DONE) {
+        yCError(SQLITETRIPLESOURCE, "Error: %s", sqlite3_errmsg(db));
+        yCError(SQLITETRIPLESOURCE, "(Query was): %s", sqlite3_sql(statement));
+    }
+    sqlite3_reset(statement);
+    return result == SQLITE_DONE;
+}
+
+std::string SqliteTripleSource::cacheKey(Triple& t, TripleContext *context, char op)
+{
+    // Ordered by rid, name and value, so that invalidate() can drop all
+    // the results that depend on a triple with a few range erasures.
+    return std::to_string(ridOf(context)) + sep +
+           token(t.hasName, t.name) + sep +
+           token(t.hasValue, t.value) + sep +
+           token(t.hasNs, t.ns) + sep +
+           op;
+}
+
+void SqliteTripleSource::cacheStore(const std::string& key, const CachedResult& result)
+{
+    if (cache.size() >= maxCacheSize) {
+        yCDebug(SQLITETRIPLESOURCE, "Flushing the cache");
+        cache.clear();
+    }
+    cache[key] = result;
+}
+
+void SqliteTripleSource::invalidatePrefix(const std::string& prefix)
+{
+    auto it = cache.lower_bound(prefix);
+    while (it != cache.end() && it->first.compare(0, prefix.length(), prefix) == 0) {
+        it = cache.erase(it);
+    }
+}
+
+void SqliteTripleSource::invalidate(Triple& t, TripleContext *context, bool anyValue)
+{
+    // Drop the results of the lookups that could match the triple
+    // written, i.e. with the same name and value, or with wildcards.
+    const std::string ridPrefix = std::to_string(ridOf(context)) + sep;
+    if (t.hasName && t.name == "*") {
+        invalidatePrefix(ridPrefix);
+        return;
+    }
+    for (const std::string& name : {token(t.hasName, t.name), std::string("*")}) {
+        const std::string namePrefix = ridPrefix + name + sep;
+        if (anyValue || (t.hasValue && t.value == "*")) {
+            invalidatePrefix(namePrefix);
+        } else {
+            invalidatePrefix(namePrefix + token(t.hasValue, t.value) + sep);
+            invalidatePrefix(namePrefix + "*" + sep);
+        }
+    }
+}
+
 int SqliteTripleSource::find(Triple& t, TripleContext *context)
 {
+    const std::string key = cacheKey(t, context, 'f');
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        yCTrace(SQLITETRIPLESOURCE, "Cached match %d", it->second.id);
+        return it->second.id;
+    }
+
     int out = -1;
-    sqlite3_stmt *statement = nullptr;
-    char *query = nullptr;
-    query = sqlite3_mprintf("SELECT id FROM tags WHERE %s",
-                            condition(t,context).c_str());
-    yCDebug(SQLITETRIPLESOURCE, "Query: %s", query);
-    int result = sqlite3_prepare_v2(db, query, -1, &statement, nullptr);
-    if (result!=SQLITE_OK) {
-        yCWarning(SQLITETRIPLESOURCE, "Error in query");
+    std::vector<const char*> args;
+    sqlite3_stmt *statement = prepare("SELECT id FROM tags WHERE " + condition(t, context, args));
+    if (statement == nullptr) {
+        return out;
     }
-    while (result == SQLITE_OK && sqlite3_step(statement) == SQLITE_ROW) {
+    bind(statement, 1, context, args);
+    int result = SQLITE_OK;
+    while ((result = sqlite3_step(statement)) == SQLITE_ROW) {
         if (out!=-1) {
             yCWarning(SQLITETRIPLESOURCE, "WARNING: multiple matches ignored");
         }
         out = sqlite3_column_int(statement,0);
         yCTrace(SQLITETRIPLESOURCE, "Match %d", out);
     }
+    sqlite3_reset(statement);
 
-    sqlite3_finalize(statement);
-    sqlite3_free(query);
+    if (result == SQLITE_DONE) {
+        CachedResult cached;
+        cached.id = out;
+        cacheStore(key, cached);
+    }
     return out;
 }
 
 void SqliteTripleSource::remove_query(Triple& ti, TripleContext *context)
 {
-    char *query = nullptr;
-    query = sqlite3_mprintf("DELETE FROM tags WHERE %s",condition(ti,context).c_str());
-    yCDebug(SQLITETRIPLESOURCE, "Query: %s", query);
-    int result = sqlite3_exec(db, query, nullptr, nullptr, nullptr);
-    if (result!=SQLITE_OK) {
-        yCWarning(SQLITETRIPLESOURCE, "Error in query");
+    std::vector<const char*> args;
+    sqlite3_stmt *statement = prepare("DELETE FROM tags WHERE " + condition(ti, context, args));
+    if (statement == nullptr) {
+        return;
+    }
+    bind(statement, 1, context, args);
+    bool ok = exec(statement);
+    invalidate(ti, context, false);
+    if (ok && isExact(ti)) {
+        // Nothing matches the triple anymore
+        cacheStore(cacheKey(ti, context, 'f'), CachedResult());
+        cacheStore(cacheKey(ti, context, 'q'), CachedResult());
     }
-    sqlite3_free(query);
 }
 
 void SqliteTripleSource::prune(TripleContext *context)
 {
-    char *query = nullptr;
-    query = sqlite3_mprintf("DELETE FROM tags WHERE rid IS NOT NULL AND rid  NOT IN (SELECT id FROM tags)");
-    yCDebug(SQLITETRIPLESOURCE, "Query: %s", query);
-    int result = sqlite3_exec(db, query, nullptr, nullptr, nullptr);
-    if (result!=SQLITE_OK) {
-        yCWarning(SQLITETRIPLESOURCE, "Error in query");
+    sqlite3_stmt *statement = prepare("DELETE FROM tags WHERE rid IS NOT NULL AND rid NOT IN (SELECT id FROM tags)");
+    if (statement == nullptr) {
+        return;
     }
-    sqlite3_free(query);
+    exec(statement);
+    cache.clear();
 }
 
 std::list<Triple> SqliteTripleSource::query(Triple& ti, TripleContext *context)
 {
+    const std::string key = cacheKey(ti, context, 'q');
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        yCTrace(SQLITETRIPLESOURCE, "Cached %zu matches", it->second.triples.size());
+        return it->second.triples;
+    }
+
     std::list<Triple> q;
-    sqlite3_stmt *statement = nullptr;
-    char *query = nullptr;
-    query = sqlite3_mprintf("SELECT id, ns, name, value FROM tags WHERE %s",condition(ti,context).c_str());
-    yCDebug(SQLITETRIPLESOURCE, "Query: %s", query);
-    int result = sqlite3_prepare_v2(db, query, -1, &statement, nullptr);
-    if (result!=SQLITE_OK) {
-        yCWarning(SQLITETRIPLESOURCE, "Error in query");
+    std::vector<const char*> args;
+    sqlite3_stmt *statement = prepare("SELECT id, ns, name, value FROM tags WHERE " + condition(ti, context, args));
+    if (statement == nullptr) {
+        return q;
     }
-    while (result == SQLITE_OK && sqlite3_step(statement) == SQLITE_ROW) {
+    bind(statement, 1, context, args);
+    int result = SQLITE_OK;
+    while ((result = sqlite3_step(statement)) == SQLITE_ROW) {
         //int id = sqlite3_column_int(statement,0);
         char *ns = (char *)sqlite3_column_text(statement,1);
         char *name = (char *)sqlite3_column_text(statement,2);
@@ -148,8 +280,13 @@ std::list<Triple> SqliteTripleSource::query(Triple& ti, TripleContext *context)
         }
         q.push_back(t);
     }
-    sqlite3_finalize(statement);
-    sqlite3_free(query);
+    sqlite3_reset(statement);
+
+    if (result == SQLITE_DONE) {
+        CachedResult cached;
+        cached.triples = q;
+        cacheStore(key, cached);
+    }
     return q;
 }
 
@@ -165,51 +302,68 @@ std::string SqliteTripleSource::expressContext(TripleContext *context)
 
 void SqliteTripleSource::insert(Triple& t, TripleContext *context)
 {
-    char *msg = nullptr;
-    char *query = sqlite3_mprintf("INSERT INTO tags (rid,ns,name,value) VALUES(%s,%Q,%Q,%Q)",
-                                  expressContext(context).c_str(),
-                                  t.getNs(),t.getName(),t.getValue());
-    yCDebug(SQLITETRIPLESOURCE, "Query: %s", query);
-    int result = sqlite3_exec(db, query, nullptr, nullptr, &msg);
-    if (result!=SQLITE_OK) {
-        if (msg != nullptr) {
-            yCError(SQLITETRIPLESOURCE, "Error: %s", msg);
-            yCError(SQLITETRIPLESOURCE, "(Query was): %s", query);
-            yCError(SQLITETRIPLESOURCE, "(Location): %s:%d", __FILE__, __LINE__);
-            sqlite3_free(msg);
-        }
+    sqlite3_stmt *statement = prepare("INSERT INTO tags (rid,ns,name,value) VALUES(?,?,?,?)");
+    if (statement == nullptr) {
+        return;
+    }
+    int rid = ridOf(context);
+    if (rid == -1) {
+        sqlite3_bind_null(statement, 1);
+    } else {
+        sqlite3_bind_int(statement, 1, rid);
+    }
+    SqliteStatementCache::bindText(statement, 2, t.getNs());
+    SqliteStatementCache::bindText(statement, 3, t.getName());
+    SqliteStatementCache::bindText(statement, 4, t.getValue());
+
+    // If the triple was known to be missing, the new row is the only match
+    const std::string key = cacheKey(t, context, 'f');
+    auto it = cache.find(key);
+    bool wasMissing = (it != cache.end() && it->second.id == -1);
+
+    bool ok = exec(statement);
+    invalidate(t, context, false);
+    if (ok && wasMissing && isExact(t)) {
+        CachedResult cached;
+        cached.id = static_cast<int>(sqlite3_last_insert_rowid(db));
+        cacheStore(key, cached);
     }
-    sqlite3_free(query);
 }
 
 void SqliteTripleSource::update(Triple& t, TripleContext *context)
 {
-    char *msg = nullptr;
-    char *query = nullptr;
     if (t.hasName||t.hasNs) {
         Triple t2(t);
         t2.value = "*";
-        query = sqlite3_mprintf("UPDATE tags SET value = %Q WHERE %s",
-                                t.getValue(),
-                                condition(t2,context).c_str());
+        std::vector<const char*> args;
+        sqlite3_stmt *statement = prepare("UPDATE tags SET value = ? WHERE " + condition(t2, context, args));
+        if (statement == nullptr) {
+            return;
+        }
+        SqliteStatementCache::bindText(statement, 1, t.getValue());
+        bind(statement, 2, context, args);
+        exec(statement);
+        invalidate(t, context, true);
     } else {
-        query = sqlite3_mprintf("UPDATE tags SET value = %Q WHERE id = %Q",
-                                t.getValue(),
-                                expressContext(context).c_str());
-    }
-    yCDebug(SQLITETRIPLESOURCE, "Query: %s", query);
-    int result = sqlite3_exec(db, query, nullptr, nullptr, &msg);
-    if (result!=SQLITE_OK) {
-        if (msg != nullptr) {
-            yCError(SQLITETRIPLESOURCE, "Error: %s", msg);
-            sqlite3_free(msg);
+        sqlite3_stmt *statement = prepare("UPDATE tags SET value = ? WHERE id = ?");
+        if (statement == nullptr) {
+            return;
+        }
+        SqliteStatementCache::bindText(statement, 1, t.getValue());
+        int rid = ridOf(context);
+        if (rid == -1) {
+            sqlite3_bind_null(statement, 2);
+        } else {
+            sqlite3_bind_int(statement, 2, rid);
         }
+        exec(statement);
+        // The triple updated is known only by its id
+        cache.clear();
     }
     int ct = sqlite3_changes(db);
     if (ct==0 && (t.hasName||t.hasNs)) {
         insert(t,context);
     }
-    sqlite3_free(query);
 }
 
 void SqliteTripleSource::begin(TripleContext *context)
@@ -12,9 +12,15 @@
 
 #include <yarp/serversql/impl/TripleSource.h>
 #include <yarp/serversql/impl/Triple.h>
+#include <yarp/serversql/impl/SqliteStatementCache.h>
 
 #include <sqlite3.h>
 
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
 namespace yarp {
 namespace serversql {
 namespace impl {
@@ -23,13 +29,20 @@ namespace impl {
  * Sqlite database, viewed as a collection of triples.  These are the
  * minimum functions needed by the name server to use a Sqlite
  * database.
+ *
+ * Queries are run through prepared statements, and the results of
+ * find() and query() are kept in memory until a write touches the
+ * triples they depend on, so that repeated name lookups do not reach
+ * the database.  The database must not be modified by other means
+ * while this object is in use.
  */
 class SqliteTripleSource : public TripleSource
 {
 public:
     SqliteTripleSource(sqlite3 *db);
+    ~SqliteTripleSource() override;
 
-    std::string condition(Triple& t, TripleContext *context);
+    std::string condition(Triple& t, TripleContext *context, std::vector<const char*>& args);
 
     int find(Triple& t, TripleContext *context) override;
     void remove_query(Triple& ti, TripleContext *context) override;
@@ -42,7 +55,24 @@ public:
     void end(TripleContext *context) override;
 
 private:
+    struct CachedResult
+    {
+        int id {-1};
+        std::list<Triple> triples;
+    };
+
     sqlite3 *db;
+    SqliteStatementCache statements;
+    std::map<std::string, CachedResult> cache;
+
+    sqlite3_stmt* prepare(const std::string& sql);
+    void bind(sqlite3_stmt* statement, int first, TripleContext *context, const std::vector<const char*>& args);
+    bool exec(sqlite3_stmt* statement);
+
+    std::string cacheKey(Triple& t, TripleContext *context, char op);
+    void cacheStore(const std::string& key, const CachedResult& result);
+    void invalidate(Triple& t, TripleContext *context, bool anyValue);
+    void invalidatePrefix(const std::string& prefix);
 };
 
 } // namespace impl
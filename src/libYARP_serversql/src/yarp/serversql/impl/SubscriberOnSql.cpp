@@ -166,7 +166,24 @@ bool SubscriberOnSql::open(const std::string& filename, bool fresh) {
         std::exit(1);
     }
 
+    // Subscriptions are looked up by source and destination at every
+    // registration, topics by name.
+    const char *create_indexes = "CREATE INDEX IF NOT EXISTS subscriptionsSrc on subscriptions(src);\n\
+    CREATE INDEX IF NOT EXISTS subscriptionsDest on subscriptions(dest);\n\
+    CREATE INDEX IF NOT EXISTS topicsTopic on topics(topic);";
+    result = sqlite3_exec(db, create_indexes, nullptr, nullptr, nullptr);
+    if (result!=SQLITE_OK) {
+        sqlite3_close(db);
+        yCError(SUBSCRIBERONSQL, "Failed to set up indexes");
+        std::exit(1);
+    }
+    result = sqlite3_exec(db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
+    if (result!=SQLITE_OK) {
+        yCWarning(SUBSCRIBERONSQL, "Failed to enable write-ahead logging");
+    }
+
     implementation = db;
+    statements.setDatabase(db);
     return true;
 }
 
@@ -174,6 +191,7 @@ bool SubscriberOnSql::open(const std::string& filename, bool fresh) {
 bool SubscriberOnSql::close() {
     if (implementation != nullptr) {
         auto* db = (sqlite3 *)implementation;
+        statements.clear();
         sqlite3_close(db);
         implementation = nullptr;
     }
@@ -183,6 +201,7 @@ bool SubscriberOnSql::close() {
 bool SubscriberOnSql::addSubscription(const std::string& src,
                                       const std::string& dest,
                                       const std::string& mode) {
+    std::lock_guard<std::recursive_mutex> guard(mutex);
     removeSubscription(src,dest);
     ParseName psrc, pdest;
     psrc.apply(src);
@@ -193,27 +212,27 @@ bool SubscriberOnSql::addSubscription(const std::string& src,
     if (pdest.getCarrier()=="topic") {
         setTopic(pdest.getPortName(),"",true);
     }
-    char *msg = nullptr;
     const char *zmode = mode.c_str();
     if (mode == "") zmode = nullptr;
-    char *query = sqlite3_mprintf("INSERT INTO subscriptions (src,dest,srcFull,destFull,mode) VALUES(%Q,%Q,%Q,%Q,%Q)",
-                                  psrc.getPortName().c_str(),
-                                  pdest.getPortName().c_str(),
-                                  src.c_str(),
-                                  dest.c_str(),
-                                  zmode);
+    const std::string srcName = psrc.getPortName();
+    const std::string destName = pdest.getPortName();
+    const char *query = "INSERT INTO subscriptions (src,dest,srcFull,destFull,mode) VALUES(?,?,?,?,?)";
     yCDebug(SUBSCRIBERONSQL, "Query: %s", query);
 
-    bool ok = true;
-    int result = sqlite3_exec(SQLDB(implementation), query, nullptr, nullptr, &msg);
-    if (result!=SQLITE_OK) {
-        ok = false;
-        if (msg != nullptr) {
-            yCError(SUBSCRIBERONSQL, "%s", msg);
-            sqlite3_free(msg);
+    bool ok = false;
+    sqlite3_stmt *statement = statements.prepare(query);
+    if (statement != nullptr) {
+        SqliteStatementCache::bindText(statement, 1, srcName.c_str());
+        SqliteStatementCache::bindText(statement, 2, destName.c_str());
+        SqliteStatementCache::bindText(statement, 3, src.c_str());
+        SqliteStatementCache::bindText(statement, 4, dest.c_str());
+        SqliteStatementCache::bindText(statement, 5, zmode);
+        ok = (sqlite3_step(statement) == SQLITE_DONE);
+        if (!ok) {
+            yCError(SUBSCRIBERONSQL, "%s", sqlite3_errmsg(SQLDB(implementation)));
         }
+        sqlite3_reset(statement);
     }
-    sqlite3_free(query);
     if (ok) {
         if (psrc.getCarrier()!="topic") {
             if (pdest.getCarrier()!="topic") {
@@ -236,22 +255,26 @@ bool SubscriberOnSql::addSubscription(const std::string& src,
 
 bool SubscriberOnSql::removeSubscription(const std::string& src,
                                          const std::string& dest) {
+    std::lock_guard<std::recursive_mutex> guard(mutex);
     ParseName psrc, pdest;
     psrc.apply(src);
     pdest.apply(dest);
-    char *query = sqlite3_mprintf("DELETE FROM subscriptions WHERE src = %Q AND dest = %Q",
-                                  psrc.getPortName().c_str(),
-                                  pdest.getPortName().c_str());
+    const std::string srcName = psrc.getPortName();
+    const std::string destName = pdest.getPortName();
+    const char *query = "DELETE FROM subscriptions WHERE src = ? AND dest = ?";
     yCDebug(SUBSCRIBERONSQL, "Query: %s", query);
 
-    int result = sqlite3_exec(SQLDB(implementation), query, nullptr, nullptr, nullptr);
-    bool ok = true;
-    if (result!=SQLITE_OK) {
-        yCError(SUBSCRIBERONSQL, "Error in query");
-        ok = false;
+    bool ok = false;
+    sqlite3_stmt *statement = statements.prepare(query);
+    if (statement != nullptr) {
+        SqliteStatementCache::bindText(statement, 1, srcName.c_str());
+        SqliteStatementCache::bindText(statement, 2, destName.c_str());
+        ok = (sqlite3_step(statement) == SQLITE_DONE);
+        if (!ok) {
+            yCError(SUBSCRIBERONSQL, "Error in query");
+        }
+        sqlite3_reset(statement);
     }
-    sqlite3_free(query);
-
     return ok;
 }
 
@@ -278,34 +301,30 @@ bool SubscriberOnSql::welcome(const std::string& port, int activity) {
         }
     }
 
-    char *msg = nullptr;
-    char *query;
+    const char *query;
     if (activity>0) {
-        query = sqlite3_mprintf("INSERT OR IGNORE INTO live (name,stamp) VALUES(%Q,DATETIME('now'))",
-                                port.c_str());
+        query = "INSERT OR IGNORE INTO live (name,stamp) VALUES(?,DATETIME('now'))";
     } else {
         // Port not responding.  Mark as non-live.
         if  (activity==0) {
-            query = sqlite3_mprintf("DELETE FROM live WHERE name=%Q AND stamp < DATETIME('now','-30 seconds')",
-                                    port.c_str());
+            query = "DELETE FROM live WHERE name=? AND stamp < DATETIME('now','-30 seconds')";
         } else {
             // activity = -1 -- definite dodo
-            query = sqlite3_mprintf("DELETE FROM live WHERE name=%Q",
-                                    port.c_str());
+            query = "DELETE FROM live WHERE name=?";
         }
     }
     yCDebug(SUBSCRIBERONSQL, "Query: %s", query);
 
-    bool ok = true;
-    int result = sqlite3_exec(SQLDB(implementation), query, nullptr, nullptr, &msg);
-    if (result!=SQLITE_OK) {
-        ok = false;
-        if (msg != nullptr) {
-            yCError(SUBSCRIBERONSQL, "%s", msg);
-            sqlite3_free(msg);
+    bool ok = false;
+    sqlite3_stmt *statement = statements.prepare(query);
+    if (statement != nullptr) {
+        SqliteStatementCache::bindText(statement, 1, port.c_str());
+        ok = (sqlite3_step(statement) == SQLITE_DONE);
+        if (!ok) {
+            yCError(SUBSCRIBERONSQL, "%s", sqlite3_errmsg(SQLDB(implementation)));
         }
+        sqlite3_reset(statement);
     }
-    sqlite3_free(query);
     mutex.unlock();
 
     if (activity>0) {
@@ -324,21 +343,16 @@ bool SubscriberOnSql::hookup(const std::string& port) {
         }
     }
     mutex.lock();
-    sqlite3_stmt *statement = nullptr;
-    char *query = nullptr;
-    //query = sqlite3_mprintf("SELECT * FROM subscriptions WHERE src = %Q OR dest= %Q",port, port);
-    query = sqlite3_mprintf("SELECT src,dest,srcFull,destFull FROM subscriptions WHERE (src = %Q OR dest= %Q) AND EXISTS (SELECT NULL FROM live WHERE name=src) AND EXISTS (SELECT NULL FROM live WHERE name=dest) UNION SELECT s1.src, s2.dest, s1.srcFull, s2.destFull FROM subscriptions s1, subscriptions s2, topics t WHERE (s1.dest = t.topic AND s2.src = t.topic) AND (s1.src = %Q OR s2.dest = %Q) AND EXISTS (SELECT NULL FROM live WHERE name=s1.src) AND EXISTS (SELECT NULL FROM live WHERE name=s2.dest)",port.c_str(), port.c_str(), port.c_str(), port.c_str());
+    //query = "SELECT * FROM subscriptions WHERE src = ?1 OR dest= ?1";
+    const char *query = "SELECT src,dest,srcFull,destFull FROM subscriptions WHERE (src = ?1 OR dest= ?1) AND EXISTS (SELECT NULL FROM live WHERE name=src) AND EXISTS (SELECT NULL FROM live WHERE name=dest) UNION SELECT s1.src, s2.dest, s1.srcFull, s2.destFull FROM subscriptions s1, subscriptions s2, topics t WHERE (s1.dest = t.topic AND s2.src = t.topic) AND (s1.src = ?1 OR s2.dest = ?1) AND EXISTS (SELECT NULL FROM live WHERE name=s1.src) AND EXISTS (SELECT NULL FROM live WHERE name=s2.dest)";
     //
     yCDebug(SUBSCRIBERONSQL, "Query: %s", query);
 
-    int result = sqlite3_prepare_v2(SQLDB(implementation), query, -1, &statement, nullptr);
-    if (result!=SQLITE_OK) {
-        const char *msg = sqlite3_errmsg(SQLDB(implementation));
-        if (msg != nullptr) {
-            yCError(SUBSCRIBERONSQL, "%s", msg);
-        }
+    sqlite3_stmt *statement = statements.prepare(query);
+    if (statement != nullptr) {
+        SqliteStatementCache::bindText(statement, 1, port.c_str());
     }
-    while (result == SQLITE_OK && sqlite3_step(statement) == SQLITE_ROW) {
+    while (statement != nullptr && sqlite3_step(statement) == SQLITE_ROW) {
         char *src = (char *)sqlite3_column_text(statement,0);
         char *dest = (char *)sqlite3_column_text(statement,1);
         char *srcFull = (char *)sqlite3_column_text(statement,2);
@@ -346,8 +360,9 @@ bool SubscriberOnSql::hookup(const std::string& port) {
         char *mode = (char *)sqlite3_column_text(statement,4);
         checkSubscription(src,dest,srcFull,destFull,mode?mode:"");
     }
-    sqlite3_finalize(statement);
-    sqlite3_free(query);
+    if (statement != nullptr) {
+        sqlite3_reset(statement);
+    }
     mutex.unlock();
 
     return false;
@@ -362,20 +377,15 @@ bool SubscriberOnSql::breakdown(const std::string& port) {
         }
     }
     mutex.lock();
-    sqlite3_stmt *statement = nullptr;
-    char *query = nullptr;
     // query = sqlite3_mprintf("SELECT src,dest,srcFull,destFull,mode FROM subscriptions WHERE ((src = %Q AND EXISTS (SELECT NULL FROM live WHERE name=dest)) OR (dest = %Q AND EXISTS (SELECT NULL FROM live WHERE name=src))) UNION SELECT s1.src, s2.dest, s1.srcFull, s2.destFull, NULL FROM subscriptions s1, subscriptions s2, topics t WHERE (s1.dest = t.topic AND s2.src = t.topic AND ((s1.src = %Q AND EXISTS (SELECT NULL FROM live WHERE name=s2.dest)) OR (s2.dest = %Q AND EXISTS (SELECT NULL FROM live WHERE name=s1.src))))",port, port, port, port);
-    query = sqlite3_mprintf("SELECT src,dest,srcFull,destFull,mode FROM subscriptions WHERE ((src = %Q AND (mode IS NOT NULL OR EXISTS (SELECT NULL FROM live WHERE name=dest))) OR (dest = %Q AND (mode IS NOT NULL OR EXISTS (SELECT NULL FROM live WHERE name=src)))) UNION SELECT s1.src, s2.dest, s1.srcFull, s2.destFull, NULL FROM subscriptions s1, subscriptions s2, topics t WHERE (s1.dest = t.topic AND s2.src = t.topic AND ((s1.src = %Q AND EXISTS (SELECT NULL FROM live WHERE name=s2.dest)) OR (s2.dest = %Q AND EXISTS (SELECT NULL FROM live WHERE name=s1.src))))",port.c_str(), port.c_str(), port.c_str(), port.c_str());
+    const char *query = "SELECT src,dest,srcFull,destFull,mode FROM subscriptions WHERE ((src = ?1 AND (mode IS NOT NULL OR EXISTS (SELECT NULL FROM live WHERE name=dest))) OR (dest = ?1 AND (mode IS NOT NULL OR EXISTS (SELECT NULL FROM live WHERE name=src)))) UNION SELECT s1.src, s2.dest, s1.srcFull, s2.destFull, NULL FROM subscriptions s1, subscriptions s2, topics t WHERE (s1.dest = t.topic AND s2.src = t.topic AND ((s1.src = ?1 AND EXISTS (SELECT NULL FROM live WHERE name=s2.dest)) OR (s2.dest = ?1 AND EXISTS (SELECT NULL FROM live WHERE name=s1.src))))";
     yCDebug(SUBSCRIBERONSQL, "Query: %s", query);
 
-    int result = sqlite3_prepare_v2(SQLDB(implementation), query, -1, &statement, nullptr);
-    if (result!=SQLITE_OK) {
-        const char *msg = sqlite3_errmsg(SQLDB(implementation));
-        if (msg != nullptr) {
-            yCError(SUBSCRIBERONSQL, "%s", msg);
-        }
+    sqlite3_stmt *statement = statements.prepare(query);
+    if (statement != nullptr) {
+        SqliteStatementCache::bindText(statement, 1, port.c_str());
     }
-    while (result == SQLITE_OK && sqlite3_step(statement) == SQLITE_ROW) {
+    while (statement != nullptr && sqlite3_step(statement) == SQLITE_ROW) {
         char *src = (char *)sqlite3_column_text(statement,0);
         char *dest = (char *)sqlite3_column_text(statement,1);
         char *srcFull = (char *)sqlite3_column_text(statement,2);
@@ -383,8 +393,9 @@ bool SubscriberOnSql::breakdown(const std::string& port) {
         char *mode = (char *)sqlite3_column_text(statement,4);
         breakSubscription(port,src,dest,srcFull,destFull,mode?mode:"");
     }
-    sqlite3_finalize(statement);
-    sqlite3_free(query);
+    if (statement != nullptr) {
+        sqlite3_reset(statement);
+    }
     mutex.unlock();
 
     return false;
@@ -500,24 +511,20 @@ bool SubscriberOnSql::breakSubscription(const std::string& dropper,
 bool SubscriberOnSql::listSubscriptions(const std::string& port,
                                         yarp::os::Bottle& reply) {
     mutex.lock();
-    sqlite3_stmt *statement = nullptr;
-    char *query = nullptr;
+    const char *query = nullptr;
     if (std::string(port)!="") {
-        query = sqlite3_mprintf("SELECT s.srcFull, s.DestFull, EXISTS(SELECT topic FROM topics WHERE topic = s.src), EXISTS(SELECT topic FROM topics WHERE topic = s.dest), s.mode FROM subscriptions s WHERE s.src = %Q OR s.dest= %Q ORDER BY s.src, s.dest",port.c_str(),port.c_str());
+        query = "SELECT s.srcFull, s.DestFull, EXISTS(SELECT topic FROM topics WHERE topic = s.src), EXISTS(SELECT topic FROM topics WHERE topic = s.dest), s.mode FROM subscriptions s WHERE s.src = ?1 OR s.dest= ?1 ORDER BY s.src, s.dest";
     } else {
-        query = sqlite3_mprintf("SELECT s.srcFull, s.destFull, EXISTS(SELECT topic FROM topics WHERE topic = s.src), EXISTS(SELECT topic FROM topics WHERE topic = s.dest), s.mode FROM subscriptions s ORDER BY s.src, s.dest");
+        query = "SELECT s.srcFull, s.destFull, EXISTS(SELECT topic FROM topics WHERE topic = s.src), EXISTS(SELECT topic FROM topics WHERE topic = s.dest), s.mode FROM subscriptions s ORDER BY s.src, s.dest";
     }
     yCDebug(SUBSCRIBERONSQL, "Query: %s", query);
 
-    int result = sqlite3_prepare_v2(SQLDB(implementation), query, -1, &statement, nullptr);
-   if (result!=SQLITE_OK) {
-        const char *msg = sqlite3_errmsg(SQLDB(implementation));
-        if (msg != nullptr) {
-            yCError(SUBSCRIBERONSQL, "%s", msg);
-        }
+    sqlite3_stmt *statement = statements.prepare(query);
+    if (statement != nullptr && std::string(port)!="") {
+        SqliteStatementCache::bindText(statement, 1, port.c_str());
     }
     reply.addString("subscriptions");
-    while (result == SQLITE_OK && sqlite3_step(statement) == SQLITE_ROW) {
+    while (statement != nullptr && sqlite3_step(statement) == SQLITE_ROW) {
         char *src = (char *)sqlite3_column_text(statement,0);
         char *dest = (char *)sqlite3_column_text(statement,1);
         int srcTopic = sqlite3_column_int(statement,2);
@@ -549,8 +556,9 @@ bool SubscriberOnSql::listSubscriptions(const std::string& port,
             b.addList() = btopic;
         }
     }
-    sqlite3_finalize(statement);
-    sqlite3_free(query);
+    if (statement != nullptr) {
+        sqlite3_reset(statement);
+    }
     mutex.unlock();
 
     return true;
@@ -561,17 +569,19 @@ bool SubscriberOnSql::setTopic(const std::string& port, const std::string& struc
                                bool active) {
     if (structure!="" || !active) {
         mutex.lock();
-        char *query = sqlite3_mprintf("DELETE FROM topics WHERE topic = %Q",
-                                      port.c_str());
+        const char *query = "DELETE FROM topics WHERE topic = ?";
         yCDebug(SUBSCRIBERONSQL, "Query: %s", query);
 
-        int result = sqlite3_exec(SQLDB(implementation), query, nullptr, nullptr, nullptr);
-        bool ok = true;
-        if (result!=SQLITE_OK) {
-            yCError(SUBSCRIBERONSQL, "Error in query");
-            ok = false;
+        bool ok = false;
+        sqlite3_stmt *statement = statements.prepare(query);
+        if (statement != nullptr) {
+            SqliteStatementCache::bindText(statement, 1, port.c_str());
+            ok = (sqlite3_step(statement) == SQLITE_DONE);
+            if (!ok) {
+                yCError(SUBSCRIBERONSQL, "Error in query");
+            }
+            sqlite3_reset(statement);
         }
-        sqlite3_free(query);
         mutex.unlock();
         if (!ok) return false;
         if (!active) return true;
@@ -580,43 +590,38 @@ bool SubscriberOnSql::setTopic(const std::string& port, const std::string& struc
     bool have_topic = false;
     if (structure=="") {
         mutex.lock();
-        sqlite3_stmt *statement = nullptr;
-        char *query = nullptr;
-        query = sqlite3_mprintf("SELECT topic FROM topics WHERE topic = %Q",
-                                port.c_str());
+        const char *query = "SELECT topic FROM topics WHERE topic = ?";
         yCDebug(SUBSCRIBERONSQL, "Query: %s", query);
 
-        int result = sqlite3_prepare_v2(SQLDB(implementation), query, -1, &statement, nullptr);
-        if (result!=SQLITE_OK) {
-            yCError(SUBSCRIBERONSQL, "Error in query");
-        }
-        if (result == SQLITE_OK && sqlite3_step(statement) == SQLITE_ROW) {
-            have_topic = true;
+        sqlite3_stmt *statement = statements.prepare(query);
+        if (statement != nullptr) {
+            SqliteStatementCache::bindText(statement, 1, port.c_str());
+            if (sqlite3_step(statement) == SQLITE_ROW) {
+                have_topic = true;
+            }
+            sqlite3_reset(statement);
         }
-        sqlite3_finalize(statement);
-        sqlite3_free(query);
         mutex.unlock();
     }
 
     if (structure!="" || !have_topic) {
         mutex.lock();
-        char *msg = nullptr;
         const char *pstructure = structure.c_str();
         if (structure=="") pstructure = nullptr;
-        char *query = sqlite3_mprintf("INSERT INTO topics (topic,structure) VALUES(%Q,%Q)",
-                                      port.c_str(),pstructure);
+        const char *query = "INSERT INTO topics (topic,structure) VALUES(?,?)";
         yCDebug(SUBSCRIBERONSQL, "Query: %s", query);
 
-        bool ok = true;
-        int result = sqlite3_exec(SQLDB(implementation), query, nullptr, nullptr, &msg);
-        if (result!=SQLITE_OK) {
-            ok = false;
-            if (msg != nullptr) {
-                yCError(SUBSCRIBERONSQL, "%s", msg);
-                sqlite3_free(msg);
+        bool ok = false;
+        sqlite3_stmt *statement = statements.prepare(query);
+        if (statement != nullptr) {
+            SqliteStatementCache::bindText(statement, 1, port.c_str());
+            SqliteStatementCache::bindText(statement, 2, pstructure);
+            ok = (sqlite3_step(statement) == SQLITE_DONE);
+            if (!ok) {
+                yCError(SUBSCRIBERONSQL, "%s", sqlite3_errmsg(SQLDB(implementation)));
             }
+            sqlite3_reset(statement);
         }
-        sqlite3_free(query);
         mutex.unlock();
         if (!ok) return false;
     }
@@ -625,18 +630,14 @@ bool SubscriberOnSql::setTopic(const std::string& port, const std::string& struc
 
     // go ahead and connect anything needed
     mutex.lock();
-    sqlite3_stmt *statement = nullptr;
-    char *query = sqlite3_mprintf("SELECT s1.src, s2.dest, s1.srcFull, s2.destFull FROM subscriptions s1, subscriptions s2, topics t WHERE (t.topic = %Q AND s1.dest = t.topic AND s2.src = t.topic)", port.c_str());
+    const char *query = "SELECT s1.src, s2.dest, s1.srcFull, s2.destFull FROM subscriptions s1, subscriptions s2, topics t WHERE (t.topic = ? AND s1.dest = t.topic AND s2.src = t.topic)";
     yCDebug(SUBSCRIBERONSQL, "Query: %s", query);
 
-    int result = sqlite3_prepare_v2(SQLDB(implementation), query, -1, &statement, nullptr);
-    if (result!=SQLITE_OK) {
-        const char *msg = sqlite3_errmsg(SQLDB(implementation));
-        if (msg != nullptr) {
-            yCError(SUBSCRIBERONSQL, "%s", msg);
-        }
+    sqlite3_stmt *statement = statements.prepare(query);
+    if (statement != nullptr) {
+        SqliteStatementCache::bindText(statement, 1, port.c_str());
     }
-    while (result == SQLITE_OK &&
+    while (statement != nullptr &&
            sqlite3_step(statement) == SQLITE_ROW) {
         char *src = (char *)sqlite3_column_text(statement,0);
         char *dest = (char *)sqlite3_column_text(statement,1);
@@ -651,8 +652,9 @@ bool SubscriberOnSql::setTopic(const std::string& port, const std::string& struc
         sub.emplace_back(mode?mode:"");
         subs.push_back(sub);
     }
-    sqlite3_finalize(statement);
-    sqlite3_free(query);
+    if (statement != nullptr) {
+        sqlite3_reset(statement);
+    }
     mutex.unlock();
 
     for (auto& sub : subs) {
@@ -665,21 +667,17 @@ bool SubscriberOnSql::setTopic(const std::string& port, const std::string& struc
 
 bool SubscriberOnSql::listTopics(yarp::os::Bottle& topics) {
     mutex.lock();
-    sqlite3_stmt *statement = nullptr;
-    char *query = nullptr;
-    query = sqlite3_mprintf("SELECT topic FROM topics");
+    const char *query = "SELECT topic FROM topics";
     yCDebug(SUBSCRIBERONSQL, "Query: %s", query);
 
-    int result = sqlite3_prepare_v2(SQLDB(implementation), query, -1, &statement, nullptr);
-    if (result!=SQLITE_OK) {
-        yCError(SUBSCRIBERONSQL, "Error in query");
-    }
-    while (result == SQLITE_OK && sqlite3_step(statement) == SQLITE_ROW) {
+    sqlite3_stmt *statement = statements.prepare(query);
+    while (statement != nullptr && sqlite3_step(statement) == SQLITE_ROW) {
         char *topic = (char *)sqlite3_column_text(statement,0);
         topics.addString(topic);
     }
-    sqlite3_finalize(statement);
-    sqlite3_free(query);
+    if (statement != nullptr) {
+        sqlite3_reset(statement);
+    }
     mutex.unlock();
 
     return true;
@@ -690,21 +688,22 @@ bool SubscriberOnSql::setType(const std::string& family,
                               const std::string& structure,
                               const std::string& value) {
     mutex.lock();
-    char *msg = nullptr;
-    char *query = sqlite3_mprintf("INSERT OR REPLACE INTO structures (name,%Q) VALUES(%Q,%Q)",
-                                  family.c_str(),
-                                  (structure=="") ? nullptr : structure.c_str(),
-                                  value.c_str());
+    // The family is a column name, that cannot be bound: the cache keeps
+    // a statement for each family.
+    char *query = sqlite3_mprintf("INSERT OR REPLACE INTO structures (name,%Q) VALUES(?,?)",
+                                  family.c_str());
     yCDebug(SUBSCRIBERONSQL, "Query: %s", query);
 
-    bool ok = true;
-    int result = sqlite3_exec(SQLDB(implementation), query, nullptr, nullptr, &msg);
-    if (result!=SQLITE_OK) {
-        ok = false;
-        if (msg != nullptr) {
-            yCError(SUBSCRIBERONSQL, "%s", msg);
-            sqlite3_free(msg);
+    bool ok = false;
+    sqlite3_stmt *statement = statements.prepare(query);
+    if (statement != nullptr) {
+        SqliteStatementCache::bindText(statement, 1, (structure=="") ? nullptr : structure.c_str());
+        SqliteStatementCache::bindText(statement, 2, value.c_str());
+        ok = (sqlite3_step(statement) == SQLITE_DONE);
+        if (!ok) {
+            yCError(SUBSCRIBERONSQL, "%s", sqlite3_errmsg(SQLDB(implementation)));
         }
+        sqlite3_reset(statement);
     }
     sqlite3_free(query);
     mutex.unlock();
@@ -714,21 +713,23 @@ bool SubscriberOnSql::setType(const std::string& family,
 std::string SubscriberOnSql::getType(const std::string& family,
                                      const std::string& structure) {
     mutex.lock();
-    sqlite3_stmt *statement = nullptr;
-    char *query = nullptr;
-    query = sqlite3_mprintf("SELECT %s FROM structures WHERE name = %Q",
-                            family.c_str(), structure.c_str());
+    // As in setType(), a statement for each family
+    char *query = sqlite3_mprintf("SELECT %s FROM structures WHERE name = ?",
+                                  family.c_str());
     yCDebug(SUBSCRIBERONSQL, "Query: %s", query);
 
-    int result = sqlite3_prepare_v2(SQLDB(implementation), query, -1, &statement, nullptr);
     std::string sresult;
-    if (result!=SQLITE_OK) {
-        yCError(SUBSCRIBERONSQL, "Error in query");
-    }
-    if (result == SQLITE_OK && sqlite3_step(statement) == SQLITE_ROW) {
-        sresult = (const char *)sqlite3_column_text(statement,0);
+    sqlite3_stmt *statement = statements.prepare(query);
+    if (statement != nullptr) {
+        SqliteStatementCache::bindText(statement, 1, structure.c_str());
+        if (sqlite3_step(statement) == SQLITE_ROW) {
+            const char *text = (const char *)sqlite3_column_text(statement,0);
+            if (text != nullptr) {
+                sresult = text;
+            }
+        }
+        sqlite3_reset(statement);
     }
-    sqlite3_finalize(statement);
     sqlite3_free(query);
     mutex.unlock();
 
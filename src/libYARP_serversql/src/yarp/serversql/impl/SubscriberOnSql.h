@@ -11,6 +11,7 @@
 #define YARP_SERVERSQL_IMPL_SUBSCRIBERONSQL_H
 
 #include <yarp/serversql/impl/Subscriber.h>
+#include <yarp/serversql/impl/SqliteStatementCache.h>
 
 #include <mutex>
 
@@ -90,7 +91,8 @@ public:
 
 private:
     void *implementation {nullptr};
-    std::mutex mutex;
+    SqliteStatementCache statements;
+    std::recursive_mutex mutex; ///< protect the database and the statements, taken again by nested calls
 };
 
 } // namespace impl
@@ -91,7 +91,14 @@ TripleSource *TripleSourceCreator::open(const char *filename,
     string cmd_synch = string("PRAGMA synchronous=") + (cautious?"FULL":"OFF") + ";";
     sql_enact(db,cmd_synch.c_str());
 
-    sql_enact(db,"CREATE INDEX IF NOT EXISTS tagsRidNameValue on tags(rid,name,value);");
+    // Write-ahead logging lets readers and the writer proceed together,
+    // and costs a single sync per transaction when the database is on disk.
+    sql_enact(db,"PRAGMA journal_mode=WAL;");
+
+    // Lookups always constrain rid, name, value and ns, the index covers
+    // them all (ids are part of every index).
+    sql_enact(db,"DROP INDEX IF EXISTS tagsRidNameValue;");
+    sql_enact(db,"CREATE INDEX IF NOT EXISTS tagsRidNameValueNs on tags(rid,name,value,ns);");
 
     implementation = db;
     accessor = new SqliteTripleSource(db);
@@ -10,11 +10,15 @@
 #include <yarp/os/Log.h>
 #include <yarp/sig/Image.h>
 #include <yarp/sig/impl/IplImage.h>
+#include <yarp/sig/impl/PixelKernels.h>
 
 #include <cstring>
 #include <cstdio>
+#include <type_traits>
 
 using namespace yarp::sig;
+using yarp::sig::impl::RowKernel;
+using yarp::sig::impl::pixelKernels;
 
 #define DBG if(0)
 
@@ -1197,6 +1201,62 @@ static inline void CopyPixel(const PixelInt* src, PixelInt* dest)
 //    return (rem != 0) ? (pad - rem) : rem;
 //}
 
+// Conversions that are done one row at a time by the vectorized kernels in
+// impl/PixelKernels.cpp.  The other ones use the CopyPixel functions above.
+template <class T1, class T2>
+static inline RowKernel GetRowKernel()
+{
+    return nullptr;
+}
+
+#define ROW_KERNEL(T1, T2, kernel) \
+    template <> inline RowKernel GetRowKernel<T1, T2>() { return pixelKernels().kernel; }
+
+ROW_KERNEL(PixelRgb, PixelBgr, swap3)
+ROW_KERNEL(PixelBgr, PixelRgb, swap3)
+ROW_KERNEL(PixelRgba, PixelBgra, swap4)
+ROW_KERNEL(PixelBgra, PixelRgba, swap4)
+ROW_KERNEL(PixelRgb, PixelRgba, keep3To4)
+ROW_KERNEL(PixelBgr, PixelBgra, keep3To4)
+ROW_KERNEL(PixelRgb, PixelBgra, swap3To4)
+ROW_KERNEL(PixelBgr, PixelRgba, swap3To4)
+ROW_KERNEL(PixelRgba, PixelRgb, keep4To3)
+ROW_KERNEL(PixelBgra, PixelBgr, keep4To3)
+ROW_KERNEL(PixelRgba, PixelBgr, swap4To3)
+ROW_KERNEL(PixelBgra, PixelRgb, swap4To3)
+ROW_KERNEL(PixelRgb, PixelMono, rgb3ToMono)
+ROW_KERNEL(PixelBgr, PixelMono, rgb3ToMono)
+ROW_KERNEL(PixelRgba, PixelMono, rgb4ToMono)
+ROW_KERNEL(PixelBgra, PixelMono, rgb4ToMono)
+ROW_KERNEL(PixelMono, PixelRgb, monoTo3)
+ROW_KERNEL(PixelMono, PixelBgr, monoTo3)
+ROW_KERNEL(PixelMono, PixelRgba, monoTo4)
+ROW_KERNEL(PixelMono, PixelBgra, monoTo4)
+
+#undef ROW_KERNEL
+
+// Copies a row of pixels of the same type: only the padding or the
+// orientation are different
+template <class T>
+static inline void CopyRow(const T *src, T *dest, int w, RowKernel, std::true_type)
+{
+    memcpy(dest, src, w * sizeof(T));
+}
+
+template <class T1, class T2>
+static inline void CopyRow(const T1 *src, T2 *dest, int w, RowKernel kernel, std::false_type)
+{
+    if (kernel != nullptr) {
+        kernel(reinterpret_cast<const unsigned char*>(src), reinterpret_cast<unsigned char*>(dest), w);
+    } else {
+        for (int j = 0; j < w; j++) {
+            CopyPixel(src,dest);
+            src++;
+            dest++;
+        }
+    }
+}
+
 ///
 ///
 template <class T1, class T2>
@@ -1217,13 +1277,12 @@ static void CopyPixels(const T1 *osrc, int q1, T2 *odest, int q2,
         dest = odest;
     }
 
+    const RowKernel kernel = GetRowKernel<T1, T2>();
+
     for (int i=0; i<h; i++) {
         DBG printf("x,y = %d,%d\n", 0,i);
-        for (int j = 0; j < w; j++) {
-            CopyPixel(src,dest);
-            src++;
-            dest++;
-        }
+        CopyRow(src, dest, w, kernel, std::is_same<T1, T2>{});
+        src += w;
 
         src = reinterpret_cast<const T1*>(((char *)src) + p1);
         odest = reinterpret_cast<T2*>(((char *)odest) + step2*(flip?-1:1));
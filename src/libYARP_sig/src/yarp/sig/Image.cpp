@@ -18,6 +18,7 @@
 #include <yarp/os/ConnectionReader.h>
 #include <yarp/os/ConnectionWriter.h>
 #include <yarp/os/Log.h>
+#include <yarp/os/MemoryLoan.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/Vocab.h>
 
@@ -78,6 +79,8 @@ public:
     size_t extern_type_quantum;
     size_t quantum;
     bool topIsLow;
+    bool loaned;      // allocate the data with yarp::os::MemoryLoan
+    bool loanedData;  // the current data were allocated with yarp::os::MemoryLoan
 
 protected:
     Image& owner;
@@ -123,6 +126,8 @@ public:
         is_owner = 1;
         quantum = 0;
         topIsLow = true;
+        loaned = false;
+        loanedData = false;
         extern_type_id = 0;
         extern_type_quantum = -1;
     }
@@ -136,6 +141,7 @@ public:
 
     void _alloc_complete_extern(const void *buf, size_t x, size_t y, int pixel_type,
                                 size_t quantum, bool topIsLow);
+    void setLoaned(bool loaned);
     int getTypeId();
 
 };
@@ -158,6 +164,15 @@ void ImageStorage::resize(size_t x, size_t y, int pixel_type,
     extern_type_quantum = quantum;
 }
 
+void ImageStorage::setLoaned(bool loaned)
+{
+    this->loaned = loaned;
+    // Images wrapping external data are not affected
+    if (pImage != nullptr && pImage->imageData != nullptr && is_owner && loanedData != loaned) {
+        _alloc_complete(pImage->width, pImage->height, type_id, quantum, topIsLow);
+    }
+}
+
 /**
  * @brief ImageStorage::getTypeId
  * @return The type_id value
@@ -173,6 +188,18 @@ void ImageStorage::_alloc () {
 
     _free(); // was iplDeallocateImage(pImage); but that won't work with refs
 
+    if (loaned) {
+        pImage->imageData = yarp::os::MemoryLoan::allocate(pImage->imageSize);
+        yAssert(pImage->imageData != nullptr);
+        if (pImage->origin == IPL_ORIGIN_TL) {
+            pImage->imageDataOrigin = pImage->imageData + pImage->imageSize - pImage->widthStep;
+        } else {
+            pImage->imageDataOrigin = pImage->imageData;
+        }
+        loanedData = true;
+        return;
+    }
+
     if ((type_id == VOCAB_PIXEL_MONO_FLOAT) ||
         (type_id == VOCAB_PIXEL_RGB_FLOAT)  ||
         (type_id == VOCAB_PIXEL_HSV_FLOAT)) {
@@ -239,7 +266,10 @@ void ImageStorage::_free ()
 {
     if (pImage != nullptr) {
         if (pImage->imageData != nullptr) {
-            if (is_owner) {
+            if (is_owner && loanedData) {
+                yarp::os::MemoryLoan::release(pImage->imageData);
+                delete[] Data;
+            } else if (is_owner) {
                 iplDeallocateImage (pImage);
                 delete[] Data;
             } else {
@@ -247,6 +277,7 @@ void ImageStorage::_free ()
             }
 
             is_owner = 1;
+            loanedData = false;
             Data = nullptr;
             pImage->imageData = nullptr;
         }
@@ -493,6 +524,15 @@ void Image::resize(size_t imgWidth, size_t imgHeight) {
     }
 }
 
+void Image::setLoaned(bool loaned) {
+    (static_cast<ImageStorage*>(implementation))->setLoaned(loaned);
+    synchronize();
+}
+
+bool Image::isLoaned() const {
+    return (static_cast<const ImageStorage*>(implementation))->loaned;
+}
+
 void Image::setPixelSize(size_t imgPixelSize) {
     if(imgPixelSize == pixelCode2Size.at(static_cast<YarpVocabPixelTypesEnum>(imgPixelCode))) {
         return;
@@ -717,11 +757,11 @@ bool Image::read(yarp::os::ConnectionReader& connection) {
     // Received and current images are binary incompatible do our best to convert
     //
 
-    // handle here all bayer encoding 8 bits
-    if (isBayer8(header.id))
+    // handle here all bayer encodings, 8 and 16 bits
+    if (isBayer8(header.id) || isBayer16(header.id))
     {
         FlexImage flex;
-        flex.setPixelCode(VOCAB_PIXEL_MONO);
+        flex.setPixelCode(isBayer8(header.id) ? VOCAB_PIXEL_MONO : VOCAB_PIXEL_MONO16);
         flex.setQuantum(header.quantum);
 
         bool ok = readFromConnection(flex, header, connection);
@@ -729,31 +769,14 @@ bool Image::read(yarp::os::ConnectionReader& connection) {
             return false;
         }
 
-        if (getPixelCode() == VOCAB_PIXEL_BGR && header.id==VOCAB_PIXEL_ENCODING_BAYER_GRBG8) {
-            return deBayer_GRBG8_TO_BGR(flex, *this, 3);
-        }
-        if (getPixelCode() == VOCAB_PIXEL_BGRA && header.id == VOCAB_PIXEL_ENCODING_BAYER_GRBG8) {
-            return deBayer_GRBG8_TO_BGR(flex, *this, 4);
-        }
-        if (getPixelCode() == VOCAB_PIXEL_RGB && header.id==VOCAB_PIXEL_ENCODING_BAYER_GRBG8) {
-            return deBayer_GRBG8_TO_RGB(flex, *this, 3);
-        }
-        if (getPixelCode() == VOCAB_PIXEL_RGBA && header.id == VOCAB_PIXEL_ENCODING_BAYER_GRBG8) {
-            return deBayer_GRBG8_TO_RGB(flex, *this, 4);
+        if (deBayer(flex, header.id, *this)) {
+            return true;
         }
 
         YARP_FIXME_NOTIMPLEMENTED("Conversion from bayer encoding not yet implemented\n");
         return false;
     }
 
-    // handle here all bayer encodings 16 bits
-    if (isBayer16(header.id))
-    {
-        // as bayer16 seems unlikely we defer implementation for later
-        YARP_FIXME_NOTIMPLEMENTED("Conversion from bayer encoding 16 bits not yet implemented\n");
-        return false;
-    }
-
     // Received image has valid YARP pixels and can be converted using Image primitives
     // prepare a FlexImage, set it to be compatible with the received image
     // read new image into FlexImage then copy from it.
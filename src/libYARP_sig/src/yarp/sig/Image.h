@@ -270,6 +270,23 @@ public:
      */
     void setExternal(const void *data, size_t imgWidth, size_t imgHeight);
 
+    /**
+     * Allocate the pixels with yarp::os::MemoryLoan, i.e. in memory lent
+     * by the transport layer, that carriers connecting processes on the
+     * same machine (e.g. shmring) can publish without copying it.
+     * This is useful for large images written through a BufferedPort,
+     * that keeps the image, and its memory, for the following prepare().
+     * If the image is already allocated, it is reallocated and its content
+     * is lost.  The setting is not copied with the image.
+     * @param loaned true to allocate the pixels with yarp::os::MemoryLoan
+     */
+    void setLoaned(bool loaned);
+
+    /**
+     * @return true if the pixels are allocated with yarp::os::MemoryLoan.
+     */
+    bool isLoaned() const;
+
     /**
     * Access to the internal image buffer.
     * @return pointer to the internal image buffer.
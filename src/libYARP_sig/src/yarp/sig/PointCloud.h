@@ -285,28 +285,8 @@ public:
             return m_storage.read(connection);
         }
 
-        T* tmp = m_storage.data();
-
-        yAssert(tmp != nullptr);
-
-        // Skip the vector header....
-        connection.expectInt32();
-        connection.expectInt32();
-
-        std::vector<int> recipe = getComposition(_header.pointType);
-
-        yarp::os::ManagedBytes dummy;
-        for (size_t i = 0; i < m_storage.size(); i++) {
-            for (size_t j = 0; j < recipe.size(); j++) {
-                size_t sizeToRead = pointType2Size(recipe[j]);
-                if ((header.pointType & recipe[j])) {
-                    size_t offset = getOffset(header.pointType, recipe[j]);
-                    connection.expectBlock((char*)&tmp[i] + offset, sizeToRead);
-                } else {
-                    dummy.allocateOnNeed(sizeToRead, sizeToRead);
-                    connection.expectBlock(dummy.bytes().get(), sizeToRead);
-                }
-            }
+        if (!readConvertedData(connection, reinterpret_cast<char*>(m_storage.data()), _header.pointType, m_storage.size())) {
+            return false;
         }
 
         connection.convertTextMode();
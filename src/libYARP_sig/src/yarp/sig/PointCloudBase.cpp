@@ -7,8 +7,11 @@
  */
 
 #include <yarp/sig/PointCloudBase.h>
+#include <yarp/os/ConnectionReader.h>
 #include <yarp/os/Type.h>
 
+#include <algorithm>
+
 using namespace yarp::sig;
 
 namespace {
@@ -89,6 +92,109 @@ const std::map<int, size_t> sizeMap = {
 };
 
 
+namespace {
+
+// Points converted at a time by readConvertedData(), so that the buffer
+// stays in the cache while the fields are copied.
+constexpr size_t chunkBytes = 256 * 1024;
+
+std::vector<int> composition(int type_composite)
+{
+    auto it = compositionMap.find(type_composite);
+    return (it != compositionMap.end()) ? it->second : std::vector<int>{};
+}
+
+size_t typeSize(int type)
+{
+    auto it = sizeMap.find(type);
+    return (it != sizeMap.end()) ? it->second : 0;
+}
+
+size_t typeOffset(int type_composite, int type_basic)
+{
+    auto it = offsetMap.find(std::make_pair(type_composite, type_basic));
+    return (it != offsetMap.end()) ? it->second : 0;
+}
+
+// Bytes copied from each source point to the destination one
+struct Span
+{
+    size_t srcOffset;
+    size_t dstOffset;
+    size_t size;
+};
+
+// Conversion between two point types, computed once for all the points.
+// The fields that are contiguous in both the types are merged, so that the
+// common conversions (e.g. xyz+rgba -> xyz) are a single copy per point.
+struct Conversion
+{
+    size_t srcSize {0};
+    size_t dstSize {0};
+    std::vector<Span> spans;
+};
+
+Conversion makeConversion(const std::vector<int>& recipe, int dstType)
+{
+    Conversion conv;
+    conv.dstSize = typeSize(dstType);
+    for (int field : recipe) {
+        const size_t size = typeSize(field);
+        // the padding is never copied, the destination can have a different one
+        if ((dstType & field) && field != PC_PADDING2 && field != PC_PADDING3) {
+            const size_t dstOffset = typeOffset(dstType, field);
+            if (!conv.spans.empty() &&
+                conv.spans.back().srcOffset + conv.spans.back().size == conv.srcSize &&
+                conv.spans.back().dstOffset + conv.spans.back().size == dstOffset) {
+                conv.spans.back().size += size;
+            } else {
+                conv.spans.push_back({conv.srcSize, dstOffset, size});
+            }
+        }
+        conv.srcSize += size;
+    }
+    return conv;
+}
+
+// The size is known at compile time for the common fields, so that each
+// copy becomes a few (vector) loads and stores instead of a call to memcpy.
+template <size_t N>
+void copySpan(char* dst, size_t dstStride, const char* src, size_t srcStride, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        std::memcpy(dst + i * dstStride, src + i * srcStride, N);
+    }
+}
+
+void copySpan(const Span& span, char* dst, size_t dstStride, const char* src, size_t srcStride, size_t count)
+{
+    dst += span.dstOffset;
+    src += span.srcOffset;
+    switch (span.size) {
+    case 4:  copySpan<4>(dst, dstStride, src, srcStride, count); break;
+    case 8:  copySpan<8>(dst, dstStride, src, srcStride, count); break;
+    case 12: copySpan<12>(dst, dstStride, src, srcStride, count); break;
+    case 16: copySpan<16>(dst, dstStride, src, srcStride, count); break;
+    case 20: copySpan<20>(dst, dstStride, src, srcStride, count); break;
+    case 28: copySpan<28>(dst, dstStride, src, srcStride, count); break;
+    case 32: copySpan<32>(dst, dstStride, src, srcStride, count); break;
+    default:
+        for (size_t i = 0; i < count; i++) {
+            std::memcpy(dst + i * dstStride, src + i * srcStride, span.size);
+        }
+    }
+}
+
+void convertPoints(const Conversion& conv, char* dst, const char* src, size_t count)
+{
+    for (const auto& span : conv.spans) {
+        copySpan(span, dst, conv.dstSize, src, conv.srcSize, count);
+    }
+}
+
+} // namespace
+
+
 size_t PointCloudBase::height() const
 {
     return header.height;
@@ -123,53 +229,50 @@ void PointCloudBase::copyFromRawData(const char* dst, const char* source, std::v
     }
     yCAssert(POINTCLOUDBASE, tmpSrc && tmpDst);
 
-    size_t sizeDst = pointType2Size(getPointType());
-    const size_t numPts = height() * width();
-    for (size_t i = 0; i < numPts; i++) {
-        for (int j : recipe) {
-            size_t sizeToRead = pointType2Size(j);
-            if ((header.pointType & j)) {
-                size_t offset = getOffset(header.pointType, j);
-                std::memcpy(tmpDst + i * sizeDst + offset, tmpSrc, sizeToRead);
-            }
+    convertPoints(makeConversion(recipe, getPointType()), tmpDst, tmpSrc, height() * width());
+}
+
+bool PointCloudBase::readConvertedData(yarp::os::ConnectionReader& connection, char* dst, int srcType, size_t count) const
+{
+    const Conversion conv = makeConversion(composition(srcType), getPointType());
+    if (conv.srcSize == 0 || conv.srcSize != typeSize(srcType)) {
+        yCError(POINTCLOUDBASE, "Cannot convert the points of type %d to the type %d", srcType, getPointType());
+        return false;
+    }
 
-            // increment anyways, if the field is missing in the destination, simply skip it
-            tmpSrc += sizeToRead;
+    // Skip the tag of the vector, and check its length
+    connection.expectInt32();
+    if (static_cast<size_t>(connection.expectInt32()) != count) {
+        return false;
+    }
+
+    // The points are read in large blocks, and converted in memory
+    const size_t chunkPoints = std::max<size_t>(1, chunkBytes / conv.srcSize);
+    std::vector<char> buffer(std::min(count, chunkPoints) * conv.srcSize);
+    for (size_t done = 0; done < count;) {
+        const size_t n = std::min(chunkPoints, count - done);
+        if (!connection.expectBlock(buffer.data(), n * conv.srcSize)) {
+            return false;
         }
+        convertPoints(conv, dst + done * conv.dstSize, buffer.data(), n);
+        done += n;
     }
+    return true;
 }
 
 
 std::vector<int> PointCloudBase::getComposition(int type_composite) const
 {
-    //todo probably
-    std::vector<int> ret;
-    auto it = compositionMap.find(type_composite);
-    if (it != compositionMap.end()) {
-        ret = it->second;
-    }
-    return ret;
+    return composition(type_composite);
 }
 
 
 size_t PointCloudBase::pointType2Size(int type) const
 {
-    size_t size = 0;
-
-    auto it = sizeMap.find(type);
-    if (it != sizeMap.end()) {
-        size = it->second;
-    }
-
-    return size;
+    return typeSize(type);
 }
 
 size_t PointCloudBase::getOffset(int type_composite, int type_basic) const
 {
-    size_t offset = 0;
-    auto it = offsetMap.find(std::make_pair(type_composite, type_basic));
-    if (it != offsetMap.end()) {
-        offset = it->second;
-    }
-    return offset;
+    return typeOffset(type_composite, type_basic);
 }
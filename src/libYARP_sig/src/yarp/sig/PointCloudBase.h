@@ -97,6 +97,20 @@ protected:
 
     virtual void copyFromRawData(const char* dst, const char* source, std::vector<int>& recipe);
 
+    /**
+     * @brief Read the points sent by a cloud of a different type, converting
+     * them to the type of this cloud.
+     * The points are read in a few large blocks, and the fields are copied
+     * according to a conversion computed once for the two types.  The fields
+     * that are missing in the source are left untouched.
+     * @param[in] connection, the connection to read from, after the header of the cloud.
+     * @param[out] dst, the points of this cloud.
+     * @param[in] srcType, the type of the points sent.
+     * @param[in] count, the number of points sent.
+     * @return true for success, false otherwise
+     */
+    bool readConvertedData(yarp::os::ConnectionReader& connection, char* dst, int srcType, size_t count) const;
+
     virtual std::vector<int> getComposition(int type_composite) const;
 
     virtual size_t pointType2Size(int type) const;
@@ -62,8 +62,101 @@ inline void copyColorData(yarp::sig::PointCloud<T1>& pointCloud,
 {
 }
 
+template<typename T>
+struct hasColor : std::integral_constant<bool, std::is_same<T, yarp::sig::DataXYZRGBA>::value ||
+                                               std::is_same<T, yarp::sig::DataXYZNormalRGBA>::value>
+{
+};
+
+template<typename T,
+         std::enable_if_t<hasColor<T>::value, int> = 0
+>
+inline void colorsToSoA(const yarp::sig::PointCloud<T>& pc,
+                        yarp::sig::utils::PointCloudSoA& soa)
+{
+    soa.rgba.resize(pc.size());
+    for (size_t i = 0; i < pc.size(); ++i) {
+        soa.rgba[i] = pc(i).rgba;
+    }
+}
+
+template<typename T,
+         std::enable_if_t<!hasColor<T>::value, int> = 0
+>
+inline void colorsToSoA(const yarp::sig::PointCloud<T>& pc,
+                        yarp::sig::utils::PointCloudSoA& soa)
+{
+    soa.rgba.clear();
+}
+
+template<typename T,
+         std::enable_if_t<hasColor<T>::value, int> = 0
+>
+inline void colorsFromSoA(const yarp::sig::utils::PointCloudSoA& soa,
+                          yarp::sig::PointCloud<T>& pc)
+{
+    for (size_t i = 0; i < soa.rgba.size(); ++i) {
+        pc(i).rgba = soa.rgba[i];
+    }
+}
+
+template<typename T,
+         std::enable_if_t<!hasColor<T>::value, int> = 0
+>
+inline void colorsFromSoA(const yarp::sig::utils::PointCloudSoA& soa,
+                          yarp::sig::PointCloud<T>& pc)
+{
+}
+
 } // namespace
 
+template<typename T>
+void yarp::sig::utils::toSoA(const yarp::sig::PointCloud<T>& pc,
+                             yarp::sig::utils::PointCloudSoA& soa)
+{
+    static_assert(!std::is_same<T, yarp::sig::DataXY>::value &&
+                  !std::is_same<T, yarp::sig::DataNormal>::value, "yarp::sig::utils::toSoA: T has no xyz coordinates");
+    const size_t n = pc.size();
+    soa.width = pc.width();
+    soa.height = pc.height();
+    soa.x.resize(n);
+    soa.y.resize(n);
+    soa.z.resize(n);
+    float* x = soa.x.data();
+    float* y = soa.y.data();
+    float* z = soa.z.data();
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = pc(i).x;
+        y[i] = pc(i).y;
+        z[i] = pc(i).z;
+    }
+    colorsToSoA(pc, soa);
+}
+
+template<typename T>
+bool yarp::sig::utils::fromSoA(const yarp::sig::utils::PointCloudSoA& soa,
+                               yarp::sig::PointCloud<T>& pc)
+{
+    static_assert(!std::is_same<T, yarp::sig::DataXY>::value &&
+                  !std::is_same<T, yarp::sig::DataNormal>::value, "yarp::sig::utils::fromSoA: T has no xyz coordinates");
+    const size_t n = soa.width * soa.height;
+    if (soa.x.size() != n || soa.y.size() != n || soa.z.size() != n ||
+        (!soa.rgba.empty() && soa.rgba.size() != n)) {
+        return false;
+    }
+    pc.resize(soa.width, soa.height);
+    const float* x = soa.x.data();
+    const float* y = soa.y.data();
+    const float* z = soa.z.data();
+    for (size_t i = 0; i < n; ++i) {
+        pc(i).x = x[i];
+        pc(i).y = y[i];
+        pc(i).z = z[i];
+    }
+    colorsFromSoA(soa, pc);
+    return true;
+}
+
 template<typename T1, typename T2>
 yarp::sig::PointCloud<T1> yarp::sig::utils::depthRgbToPC(const yarp::sig::ImageOf<yarp::sig::PixelFloat>& depth,
                                                          const yarp::sig::ImageOf<T2>& color,
@@ -13,6 +13,9 @@
 #include <yarp/sig/IntrinsicParams.h>
 #include <yarp/sig/PointCloud.h>
 
+#include <cstdint>
+#include <vector>
+
 namespace yarp {
 namespace sig{
 /**
@@ -31,6 +34,21 @@ struct PCL_ROI
     size_t max_y {0};
 };
 
+/**
+ * @brief The coordinates and the colors of the points of a cloud, each one in
+ * a separate contiguous array (structure of arrays), so that they can be
+ * processed several points at a time with SIMD instructions.
+ */
+struct PointCloudSoA
+{
+    size_t width {0};
+    size_t height {0};
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<std::int32_t> rgba; ///< packed as in DataRGBA, empty if the points have no color
+};
+
 /**
  * @brief depthToPC, compute the PointCloud given depth image and the intrinsic parameters of the camera.
  * @param[in] depth, the input depth image.
@@ -73,6 +91,26 @@ template<typename T1, typename T2>
 yarp::sig::PointCloud<T1> depthRgbToPC(const yarp::sig::ImageOf<yarp::sig::PixelFloat>& depth,
                                        const yarp::sig::ImageOf<T2>& color,
                                        const yarp::sig::IntrinsicParams& intrinsic);
+
+/**
+ * @brief toSoA, split the coordinates (and the colors, if any) of the points of a cloud in separate arrays.
+ * @param[in] pc, the input point cloud, whose points must have the x, y and z coordinates.
+ * @param[out] soa, the arrays, whose memory is reused when possible.
+ */
+template<typename T>
+void toSoA(const yarp::sig::PointCloud<T>& pc,
+           yarp::sig::utils::PointCloudSoA& soa);
+
+/**
+ * @brief fromSoA, set the coordinates (and the colors, if any) of the points of a cloud from separate arrays.
+ * @param[in] soa, the arrays, all of width * height elements (rgba can be empty).
+ * @param[out] pc, the output point cloud, resized to the size of the arrays.
+ * @note the other fields of the points (e.g. the normals) are not modified.
+ * @return false if the sizes of the arrays are not consistent.
+ */
+template<typename T>
+bool fromSoA(const yarp::sig::utils::PointCloudSoA& soa,
+             yarp::sig::PointCloud<T>& pc);
 } // namespace utils
 } // namespace sig
 } // namespace yarp
@@ -8,10 +8,9 @@
  */
 
 /**
- * Basic implementations of debayering functions. Used to convert Bayer images received
- * in a YARP port. Prototype implementation, in the future we should replace these functions
- * with better implementations, like the ones in the Bayer Carrier. If we decide to implement
- * debayering by chaining carriers this code could be removed completely.
+ * Debayering functions, used to convert Bayer images received in a YARP port.
+ * They use the bilinear conversion of yarp::sig::impl::demosaic(), see
+ * Demosaic.h for the other methods.
  */
 
 #ifndef YARP_SIG_IMPL_DEBAYER_H
@@ -42,7 +41,14 @@ inline bool isBayer16(int v)
 }
 
 /*
- * Nearest neighbor debayer implementation (warning: skip borders)
+ * Converts a Bayer image (8 or 16 bits) to a rgb, bgr, rgba or bgra image.
+ * bayerCode is the encoding of the source, i.e. one of the
+ * VOCAB_PIXEL_ENCODING_BAYER_* codes.
+ */
+bool deBayer(const yarp::sig::Image& source, int bayerCode, yarp::sig::Image& dest);
+
+/*
+ * Bilinear debayer implementation
  */
 bool deBayer_GRBG8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
 
@@ -51,12 +57,12 @@ bool deBayer_BGGR8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int
 bool deBayer_RGGB8_TO_RGB(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
 
 /*
- * Nearest neighbor debayer implementation (warning: skip borders)
+ * Bilinear debayer implementation
  */
 bool deBayer_GRBG8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
 
 bool deBayer_BGGR8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
 
-inline bool deBayer_RGGB8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
+bool deBayer_RGGB8_TO_BGR(yarp::sig::Image &source, yarp::sig::Image &dest, int pixelSize);
 
 #endif // YARP_SIG_IMPL_DEBAYER_H
@@ -0,0 +1,383 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/impl/Demosaic.h>
+#include <yarp/sig/impl/PixelKernels.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using yarp::sig::Image;
+using yarp::sig::impl::BayerPattern;
+using yarp::sig::impl::DemosaicMethod;
+using yarp::sig::impl::PlanarKernel;
+using yarp::sig::impl::pixelKernels;
+
+namespace {
+
+// Bands smaller than this are not worth a thread
+constexpr size_t minBandRows = 32;
+
+// Threads in the pool, including the caller
+constexpr size_t maxThreads = 8;
+
+/******************************************************************************/
+// Pool of threads converting the bands of an image.  The thread that calls
+// run() converts bands too, and when the pool is already busy with another
+// image it converts all of them by itself.
+class BandPool
+{
+public:
+    static BandPool& instance()
+    {
+        static BandPool pool;
+        return pool;
+    }
+
+    size_t size() const
+    {
+        return workers.size() + 1;
+    }
+
+    void run(size_t count, const std::function<void(size_t)>& f)
+    {
+        std::unique_lock<std::mutex> owner(busy, std::try_to_lock);
+        if (!owner.owns_lock() || count == 1) {
+            for (size_t i = 0; i < count; i++) {
+                f(i);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &f;
+            bands = count;
+            nextBand = 0;
+            pending = count;
+            generation++;
+        }
+        wake.notify_all();
+
+        runBands();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this]() { return pending == 0; });
+        job = nullptr;
+    }
+
+private:
+    BandPool()
+    {
+        size_t n = std::min<size_t>(std::thread::hardware_concurrency(), maxThreads);
+        for (size_t i = 1; i < n; i++) {
+            workers.emplace_back(&BandPool::work, this);
+        }
+    }
+
+    ~BandPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    void runBands()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (job != nullptr && nextBand < bands) {
+            const size_t i = nextBand++;
+            const auto* f = job;
+            lock.unlock();
+            (*f)(i);
+            lock.lock();
+            if (--pending == 0) {
+                finished.notify_all();
+            }
+        }
+    }
+
+    void work()
+    {
+        unsigned long seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [&]() { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            lock.unlock();
+            runBands();
+            lock.lock();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex busy;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(size_t)>* job {nullptr};
+    size_t bands {0};
+    size_t nextBand {0};
+    size_t pending {0};
+    unsigned long generation {0};
+    bool stopping {false};
+};
+
+// Splits the rows of the destination in bands, and converts them in parallel
+template <typename F>
+void convertBands(size_t rows, size_t threads, const F& convert)
+{
+    BandPool& pool = BandPool::instance();
+    size_t n = (threads == 0) ? pool.size() : std::min(threads, pool.size());
+    n = std::max<size_t>(1, std::min(n, rows / minBandRows));
+    const std::function<void(size_t)> job = [&](size_t i) {
+        convert(rows * i / n, rows * (i + 1) / n);
+    };
+    pool.run(n, job);
+}
+
+
+/******************************************************************************/
+// The conversions work on one row at a time.  Each source row is copied in a
+// buffer with an extra pixel on each side, reflected so that the color of the
+// filter is the same of the pixel it replaces, and the three channels are
+// computed in separate rows, interleaved at the end by the pixel kernels.
+// The inner loops have no branches and are vectorized by the compiler.
+
+struct Layout
+{
+    size_t redRow {0};                // position of red in the 2x2 blocks
+    size_t redCol {0};
+    bool rgbOrder {true};             // rgb(a) or bgr(a) destination
+    PlanarKernel interleave {nullptr};
+};
+
+bool makeLayout(const Image& src, BayerPattern pattern, const Image& dest, Layout& layout)
+{
+    switch (pattern) {
+    case BayerPattern::GRBG: layout.redRow = 0; layout.redCol = 1; break;
+    case BayerPattern::BGGR: layout.redRow = 1; layout.redCol = 1; break;
+    case BayerPattern::GBRG: layout.redRow = 1; layout.redCol = 0; break;
+    case BayerPattern::RGGB: layout.redRow = 0; layout.redCol = 0; break;
+    }
+
+    switch (dest.getPixelCode()) {
+    case VOCAB_PIXEL_RGB:  layout.rgbOrder = true;  layout.interleave = pixelKernels().planarTo3; break;
+    case VOCAB_PIXEL_BGR:  layout.rgbOrder = false; layout.interleave = pixelKernels().planarTo3; break;
+    case VOCAB_PIXEL_RGBA: layout.rgbOrder = true;  layout.interleave = pixelKernels().planarTo4; break;
+    case VOCAB_PIXEL_BGRA: layout.rgbOrder = false; layout.interleave = pixelKernels().planarTo4; break;
+    default:
+        return false;
+    }
+
+    return (src.getPixelSize() == 1 || src.getPixelSize() == 2) && src.width() > 0 && src.height() > 0;
+}
+
+size_t reflect(long y, size_t h)
+{
+    if (y < 0) {
+        return (h > 1) ? 1 : 0;
+    }
+    if (static_cast<size_t>(y) >= h) {
+        return (h > 1) ? h - 2 : h - 1;
+    }
+    return static_cast<size_t>(y);
+}
+
+template <typename T>
+void loadRow(const Image& src, size_t y, T* padded)
+{
+    const size_t w = src.width();
+    memcpy(padded + 1, src.getRow(y), w * sizeof(T));
+    padded[0] = (w > 1) ? padded[2] : padded[1];
+    padded[w + 1] = (w > 1) ? padded[w - 1] : padded[w];
+}
+
+// Computes a row with the color a in the columns with parity aCol, and green
+// in the other ones.  The third color o is on the rows above and below.
+template <typename T, bool edgeAware>
+void interpolateRow(const T* up, const T* cur, const T* dn, size_t w, size_t aCol,
+                    unsigned char* a, unsigned char* g, unsigned char* o)
+{
+    constexpr unsigned int shift = (sizeof(T) - 1) * 8;
+    for (size_t x = 0; x < w; x++) {
+        const size_t i = x + 1;
+        const unsigned int c = cur[i];
+        const unsigned int l = cur[i - 1];
+        const unsigned int r = cur[i + 1];
+        const unsigned int u = up[i];
+        const unsigned int d = dn[i];
+        const unsigned int h = (l + r + 1) >> 1;
+        const unsigned int v = (u + d + 1) >> 1;
+        const unsigned int diag = (up[i - 1] + up[i + 1] + dn[i - 1] + dn[i + 1] + 2) >> 2;
+        unsigned int cross = (l + r + u + d + 2) >> 2;
+        if (edgeAware) {
+            const unsigned int dh = (l > r) ? l - r : r - l;
+            const unsigned int dv = (u > d) ? u - d : d - u;
+            cross = (dh < dv) ? h : ((dv < dh) ? v : cross);
+        }
+        const bool native = (x & 1) == aCol;
+        a[x] = static_cast<unsigned char>((native ? c : h) >> shift);
+        g[x] = static_cast<unsigned char>((native ? cross : c) >> shift);
+        o[x] = static_cast<unsigned char>((native ? diag : v) >> shift);
+    }
+}
+
+template <typename T, bool edgeAware>
+void demosaicBand(const Image& src, const Layout& layout, Image& dest, size_t y0, size_t y1)
+{
+    const size_t w = src.width();
+    const size_t h = src.height();
+    std::vector<T> rows(3 * (w + 2));
+    std::vector<unsigned char> planes(3 * w);
+    T* up = rows.data();
+    T* cur = up + w + 2;
+    T* dn = cur + w + 2;
+    unsigned char* a = planes.data();
+    unsigned char* g = a + w;
+    unsigned char* o = g + w;
+
+    loadRow(src, reflect(static_cast<long>(y0) - 1, h), up);
+    loadRow(src, y0, cur);
+    for (size_t y = y0; y < y1; y++) {
+        loadRow(src, reflect(static_cast<long>(y) + 1, h), dn);
+
+        const bool redRow = (y & 1) == layout.redRow;
+        interpolateRow<T, edgeAware>(up, cur, dn, w, redRow ? layout.redCol : 1 - layout.redCol, a, g, o);
+        const unsigned char* red = redRow ? a : o;
+        const unsigned char* blue = redRow ? o : a;
+        layout.interleave(layout.rgbOrder ? red : blue, g, layout.rgbOrder ? blue : red, dest.getRow(y), w);
+
+        std::swap(up, cur);
+        std::swap(cur, dn);
+    }
+}
+
+template <typename T>
+void demosaicHalfBand(const Image& src, const Layout& layout, Image& dest, size_t y0, size_t y1)
+{
+    constexpr unsigned int shift = (sizeof(T) - 1) * 8;
+    const size_t w = dest.width();
+    std::vector<T> rows(4 * w);
+    std::vector<unsigned char> planes(3 * w);
+    T* quad[2] = {rows.data(), rows.data() + 2 * w};
+    unsigned char* r = planes.data();
+    unsigned char* g = r + w;
+    unsigned char* b = g + w;
+    const size_t rr = layout.redRow;
+    const size_t rc = layout.redCol;
+
+    for (size_t y = y0; y < y1; y++) {
+        memcpy(quad[0], src.getRow(2 * y), 2 * w * sizeof(T));
+        memcpy(quad[1], src.getRow(2 * y + 1), 2 * w * sizeof(T));
+        for (size_t x = 0; x < w; x++) {
+            const unsigned int g1 = quad[rr][2 * x + 1 - rc];
+            const unsigned int g2 = quad[1 - rr][2 * x + rc];
+            r[x] = static_cast<unsigned char>(quad[rr][2 * x + rc] >> shift);
+            g[x] = static_cast<unsigned char>(((g1 + g2 + 1) >> 1) >> shift);
+            b[x] = static_cast<unsigned char>(quad[1 - rr][2 * x + 1 - rc] >> shift);
+        }
+        layout.interleave(layout.rgbOrder ? r : b, g, layout.rgbOrder ? b : r, dest.getRow(y), w);
+    }
+}
+
+} // namespace
+
+
+bool yarp::sig::impl::bayerPattern(int pixelCode, BayerPattern& pattern)
+{
+    switch (pixelCode) {
+    case VOCAB_PIXEL_ENCODING_BAYER_GRBG8:
+    case VOCAB_PIXEL_ENCODING_BAYER_GRBG16:
+        pattern = BayerPattern::GRBG;
+        return true;
+    case VOCAB_PIXEL_ENCODING_BAYER_BGGR8:
+    case VOCAB_PIXEL_ENCODING_BAYER_BGGR16:
+        pattern = BayerPattern::BGGR;
+        return true;
+    case VOCAB_PIXEL_ENCODING_BAYER_GBRG8:
+    case VOCAB_PIXEL_ENCODING_BAYER_GBRG16:
+        pattern = BayerPattern::GBRG;
+        return true;
+    case VOCAB_PIXEL_ENCODING_BAYER_RGGB8:
+    case VOCAB_PIXEL_ENCODING_BAYER_RGGB16:
+        pattern = BayerPattern::RGGB;
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool yarp::sig::impl::demosaic(const Image& src,
+                               BayerPattern pattern,
+                               Image& dest,
+                               DemosaicMethod method,
+                               size_t threads)
+{
+    Layout layout;
+    if (!makeLayout(src, pattern, dest, layout)) {
+        return false;
+    }
+    if (dest.width() != src.width() || dest.height() != src.height()) {
+        dest.resize(src.width(), src.height());
+    }
+
+    const bool wide = (src.getPixelSize() == 2);
+    const bool edgeAware = (method == DemosaicMethod::EdgeAware);
+    convertBands(src.height(), threads, [&](size_t y0, size_t y1) {
+        if (wide && edgeAware) {
+            demosaicBand<std::uint16_t, true>(src, layout, dest, y0, y1);
+        } else if (wide) {
+            demosaicBand<std::uint16_t, false>(src, layout, dest, y0, y1);
+        } else if (edgeAware) {
+            demosaicBand<std::uint8_t, true>(src, layout, dest, y0, y1);
+        } else {
+            demosaicBand<std::uint8_t, false>(src, layout, dest, y0, y1);
+        }
+    });
+    return true;
+}
+
+bool yarp::sig::impl::demosaicHalf(const Image& src,
+                                   BayerPattern pattern,
+                                   Image& dest,
+                                   size_t threads)
+{
+    Layout layout;
+    if (!makeLayout(src, pattern, dest, layout)) {
+        return false;
+    }
+    if (dest.width() != src.width() / 2 || dest.height() != src.height() / 2) {
+        dest.resize(src.width() / 2, src.height() / 2);
+    }
+
+    const bool wide = (src.getPixelSize() == 2);
+    convertBands(dest.height(), threads, [&](size_t y0, size_t y1) {
+        if (wide) {
+            demosaicHalfBand<std::uint16_t>(src, layout, dest, y0, y1);
+        } else {
+            demosaicHalfBand<std::uint8_t>(src, layout, dest, y0, y1);
+        }
+    });
+    return true;
+}
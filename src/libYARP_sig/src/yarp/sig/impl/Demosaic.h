@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SIG_IMPL_DEMOSAIC_H
+#define YARP_SIG_IMPL_DEMOSAIC_H
+
+#include <yarp/sig/api.h>
+#include <yarp/sig/Image.h>
+
+#include <cstddef>
+
+namespace yarp {
+namespace sig {
+namespace impl {
+
+/**
+ * Order of the color filters in the first two rows of a Bayer image.
+ */
+enum class BayerPattern
+{
+    GRBG,
+    BGGR,
+    GBRG,
+    RGGB
+};
+
+enum class DemosaicMethod
+{
+    /// the missing colors are the average of the nearest pixels of that color
+    Bilinear,
+    /// like Bilinear, but green is interpolated along the direction with the
+    /// smallest gradient, avoiding the zipper artifacts on the edges
+    EdgeAware
+};
+
+/**
+ * Converts the pixel code of a Bayer image (e.g. VOCAB_PIXEL_ENCODING_BAYER_GRBG8)
+ * to the order of its filters.
+ *
+ * @return false if the code is not a Bayer encoding
+ */
+YARP_sig_API bool bayerPattern(int pixelCode, BayerPattern& pattern);
+
+/**
+ * Demosaics a Bayer image.
+ *
+ * The source can be 8 bit (VOCAB_PIXEL_MONO) or 16 bit (VOCAB_PIXEL_MONO16),
+ * the latter is scaled to 8 bits.  The destination must be a rgb, bgr, rgba
+ * or bgra image, and it is resized to the size of the source.  The borders
+ * are reflected, so that all the pixels are converted.
+ *
+ * The image is split in bands of rows, converted in parallel by a pool of
+ * threads shared by all the callers.
+ *
+ * @param threads the maximum number of threads used, 0 to use all the ones
+ *                available
+ * @return false if the formats are not supported
+ */
+YARP_sig_API bool demosaic(const yarp::sig::Image& src,
+                           BayerPattern pattern,
+                           yarp::sig::Image& dest,
+                           DemosaicMethod method = DemosaicMethod::Bilinear,
+                           size_t threads = 0);
+
+/**
+ * Demosaics a Bayer image at half resolution, each 2x2 block of filters
+ * becoming a pixel of the destination, that is resized to half the size of
+ * the source.
+ *
+ * @see demosaic
+ */
+YARP_sig_API bool demosaicHalf(const yarp::sig::Image& src,
+                               BayerPattern pattern,
+                               yarp::sig::Image& dest,
+                               size_t threads = 0);
+
+} // namespace impl
+} // namespace sig
+} // namespace yarp
+
+#endif // YARP_SIG_IMPL_DEMOSAIC_H
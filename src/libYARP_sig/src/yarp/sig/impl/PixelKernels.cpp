@@ -0,0 +1,622 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/impl/PixelKernels.h>
+
+#include <yarp/conf/environment.h>
+
+#include <algorithm>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#  define YARP_PIXEL_KERNELS_X86
+#  include <immintrin.h>
+#  if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#    define YARP_PIXEL_KERNELS_TARGET(x)
+#  else
+#    define YARP_PIXEL_KERNELS_TARGET(x) __attribute__((target(x)))
+#  endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+// NEON is always available on aarch64, and on 32 bit arm only when the
+// compiler was told that it is, therefore it is selected at compile time.
+#  define YARP_PIXEL_KERNELS_NEON
+#  include <arm_neon.h>
+#endif
+
+using yarp::sig::impl::PixelKernels;
+
+namespace {
+
+// (r+g+b)/3 is computed as ((r+g+b)*div3Mul)>>16, that gives the same result
+// for all the sums up to 3*255
+constexpr unsigned short div3Mul = 21846;
+
+/******************************************************************************/
+// Portable kernels, also used for the pixels at the end of the rows
+
+template <size_t inBpp, size_t outBpp, bool swap>
+void convertScalar(const unsigned char* src, unsigned char* dest, size_t w)
+{
+    for (size_t j = 0; j < w; j++, src += inBpp, dest += outBpp) {
+        dest[0] = src[swap ? 2 : 0];
+        dest[1] = src[1];
+        dest[2] = src[swap ? 0 : 2];
+        if (outBpp == 4) {
+            dest[3] = (inBpp == 4) ? src[3] : 255;
+        }
+    }
+}
+
+template <size_t inBpp>
+void toMonoScalar(const unsigned char* src, unsigned char* dest, size_t w)
+{
+    for (size_t j = 0; j < w; j++, src += inBpp) {
+        dest[j] = static_cast<unsigned char>((src[0] + src[1] + src[2]) / 3);
+    }
+}
+
+template <size_t outBpp>
+void fromMonoScalar(const unsigned char* src, unsigned char* dest, size_t w)
+{
+    for (size_t j = 0; j < w; j++, dest += outBpp) {
+        dest[0] = src[j];
+        dest[1] = src[j];
+        dest[2] = src[j];
+        if (outBpp == 4) {
+            dest[3] = 255;
+        }
+    }
+}
+
+template <size_t outBpp>
+void fromPlanarScalar(const unsigned char* c0, const unsigned char* c1, const unsigned char* c2, unsigned char* dest, size_t w)
+{
+    for (size_t j = 0; j < w; j++, dest += outBpp) {
+        dest[0] = c0[j];
+        dest[1] = c1[j];
+        dest[2] = c2[j];
+        if (outBpp == 4) {
+            dest[3] = 255;
+        }
+    }
+}
+
+const PixelKernels scalarKernels {
+    "scalar",
+    convertScalar<3, 3, true>,
+    convertScalar<4, 4, true>,
+    convertScalar<3, 4, false>,
+    convertScalar<3, 4, true>,
+    convertScalar<4, 3, false>,
+    convertScalar<4, 3, true>,
+    toMonoScalar<3>,
+    toMonoScalar<4>,
+    fromMonoScalar<3>,
+    fromMonoScalar<4>,
+    fromPlanarScalar<3>,
+    fromPlanarScalar<4>
+};
+
+
+#if defined(YARP_PIXEL_KERNELS_X86)
+
+/******************************************************************************/
+// x86 kernels, built with the instruction set they need and selected at run
+// time.  All the loads and the stores are unaligned and 16 bytes wide (or 32),
+// also when a block of pixels is smaller than that, and the extra bytes
+// written are overwritten by the next block.
+
+// Number of pixels converted with a 16 bytes shuffle
+constexpr size_t blockPixels(size_t inBpp, size_t outBpp)
+{
+    return (inBpp == 3 && outBpp == 3) ? 5 : 4;
+}
+
+// Fills the pshufb mask that converts a block of pixels, and the bytes that
+// are or-ed to the result (i.e. the alpha channel when there is none in the
+// source)
+void shuffleMask(size_t inBpp, size_t outBpp, bool swap, char* mask, char* fill)
+{
+    const size_t block = blockPixels(inBpp, outBpp);
+    for (size_t k = 0; k < 16; k++) {
+        const size_t p = k / outBpp;
+        const size_t c = k % outBpp;
+        mask[k] = static_cast<char>(0x80);
+        fill[k] = 0;
+        if (p >= block) {
+            continue;
+        }
+        if (c == 3) {
+            if (inBpp == 4) {
+                mask[k] = static_cast<char>(p * 4 + 3);
+            } else {
+                fill[k] = static_cast<char>(0xff);
+            }
+        } else {
+            mask[k] = static_cast<char>(p * inBpp + (swap ? 2 - c : c));
+        }
+    }
+}
+
+template <size_t inBpp, size_t outBpp, bool swap>
+YARP_PIXEL_KERNELS_TARGET("ssse3")
+void convertSsse3(const unsigned char* src, unsigned char* dest, size_t w)
+{
+    constexpr size_t block = blockPixels(inBpp, outBpp);
+    alignas(16) char m[16];
+    alignas(16) char f[16];
+    shuffleMask(inBpp, outBpp, swap, m, f);
+    const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(m));
+    const __m128i fill = _mm_load_si128(reinterpret_cast<const __m128i*>(f));
+
+    // Both the load and the store of a block must stay in the row
+    constexpr size_t bpp = std::min(inBpp, outBpp);
+    size_t j = 0;
+    for (; j * bpp + 16 <= w * bpp; j += block) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j * inBpp));
+        v = _mm_or_si128(_mm_shuffle_epi8(v, mask), fill);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + j * outBpp), v);
+    }
+    convertScalar<inBpp, outBpp, swap>(src + j * inBpp, dest + j * outBpp, w - j);
+}
+
+template <size_t inBpp>
+YARP_PIXEL_KERNELS_TARGET("ssse3")
+void toMonoSsse3(const unsigned char* src, unsigned char* dest, size_t w)
+{
+    // 3 bytes pixels are expanded to 4 bytes, then r+g and b+0 are summed by
+    // pmaddubsw, and the two halves by phaddw
+    alignas(16) char m[16];
+    alignas(16) char f[16];
+    shuffleMask(3, 4, false, m, f);
+    const __m128i expand = _mm_load_si128(reinterpret_cast<const __m128i*>(m));
+    const __m128i weights = _mm_setr_epi8(1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0);
+    const __m128i third = _mm_set1_epi16(static_cast<short>(div3Mul));
+
+    size_t j = 0;
+    for (; (j + 4) * inBpp + 16 <= w * inBpp && j + 8 <= w; j += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j * inBpp));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (j + 4) * inBpp));
+        if (inBpp == 3) {
+            a = _mm_shuffle_epi8(a, expand);
+            b = _mm_shuffle_epi8(b, expand);
+        }
+        __m128i sum = _mm_hadd_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights));
+        sum = _mm_mulhi_epu16(sum, third);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dest + j), _mm_packus_epi16(sum, sum));
+    }
+    toMonoScalar<inBpp>(src + j * inBpp, dest + j, w - j);
+}
+
+template <size_t outBpp>
+YARP_PIXEL_KERNELS_TARGET("ssse3")
+void fromMonoSsse3(const unsigned char* src, unsigned char* dest, size_t w)
+{
+    // 16 pixels are written as outBpp blocks of 16 bytes
+    __m128i mask[outBpp];
+    alignas(16) char m[16];
+    alignas(16) char f[16];
+    for (size_t q = 0; q < outBpp; q++) {
+        for (size_t k = 0; k < 16; k++) {
+            const size_t c = (q * 16 + k) % outBpp;
+            m[k] = (c == 3) ? static_cast<char>(0x80) : static_cast<char>((q * 16 + k) / outBpp);
+            f[k] = (c == 3) ? static_cast<char>(0xff) : 0;
+        }
+        mask[q] = _mm_load_si128(reinterpret_cast<const __m128i*>(m));
+    }
+    const __m128i fill = _mm_load_si128(reinterpret_cast<const __m128i*>(f));
+
+    size_t j = 0;
+    for (; j + 16 <= w; j += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j));
+        for (size_t q = 0; q < outBpp; q++) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + j * outBpp + q * 16),
+                             _mm_or_si128(_mm_shuffle_epi8(v, mask[q]), fill));
+        }
+    }
+    fromMonoScalar<outBpp>(src + j, dest + j * outBpp, w - j);
+}
+
+YARP_PIXEL_KERNELS_TARGET("ssse3")
+void planarTo3Ssse3(const unsigned char* c0, const unsigned char* c1, const unsigned char* c2, unsigned char* dest, size_t w)
+{
+    // each of the 3 blocks of 16 bytes takes some bytes from each channel
+    __m128i mask[3][3];
+    alignas(16) char m[16];
+    for (size_t q = 0; q < 3; q++) {
+        for (size_t c = 0; c < 3; c++) {
+            for (size_t k = 0; k < 16; k++) {
+                const size_t n = q * 16 + k;
+                m[k] = (n % 3 == c) ? static_cast<char>(n / 3) : static_cast<char>(0x80);
+            }
+            mask[q][c] = _mm_load_si128(reinterpret_cast<const __m128i*>(m));
+        }
+    }
+
+    size_t j = 0;
+    for (; j + 16 <= w; j += 16) {
+        const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c0 + j));
+        const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c1 + j));
+        const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c2 + j));
+        for (size_t q = 0; q < 3; q++) {
+            const __m128i v = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(v0, mask[q][0]),
+                                                        _mm_shuffle_epi8(v1, mask[q][1])),
+                                           _mm_shuffle_epi8(v2, mask[q][2]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + j * 3 + q * 16), v);
+        }
+    }
+    fromPlanarScalar<3>(c0 + j, c1 + j, c2 + j, dest + j * 3, w - j);
+}
+
+YARP_PIXEL_KERNELS_TARGET("ssse3")
+void planarTo4Ssse3(const unsigned char* c0, const unsigned char* c1, const unsigned char* c2, unsigned char* dest, size_t w)
+{
+    const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xff));
+
+    size_t j = 0;
+    for (; j + 16 <= w; j += 16) {
+        const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c0 + j));
+        const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c1 + j));
+        const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c2 + j));
+        const __m128i lo01 = _mm_unpacklo_epi8(v0, v1);
+        const __m128i hi01 = _mm_unpackhi_epi8(v0, v1);
+        const __m128i lo2a = _mm_unpacklo_epi8(v2, alpha);
+        const __m128i hi2a = _mm_unpackhi_epi8(v2, alpha);
+        __m128i* d = reinterpret_cast<__m128i*>(dest + j * 4);
+        _mm_storeu_si128(d, _mm_unpacklo_epi16(lo01, lo2a));
+        _mm_storeu_si128(d + 1, _mm_unpackhi_epi16(lo01, lo2a));
+        _mm_storeu_si128(d + 2, _mm_unpacklo_epi16(hi01, hi2a));
+        _mm_storeu_si128(d + 3, _mm_unpackhi_epi16(hi01, hi2a));
+    }
+    fromPlanarScalar<4>(c0 + j, c1 + j, c2 + j, dest + j * 4, w - j);
+}
+
+const PixelKernels ssse3Kernels {
+    "ssse3",
+    convertSsse3<3, 3, true>,
+    convertSsse3<4, 4, true>,
+    convertSsse3<3, 4, false>,
+    convertSsse3<3, 4, true>,
+    convertSsse3<4, 3, false>,
+    convertSsse3<4, 3, true>,
+    toMonoSsse3<3>,
+    toMonoSsse3<4>,
+    fromMonoSsse3<3>,
+    fromMonoSsse3<4>,
+    planarTo3Ssse3,
+    planarTo4Ssse3
+};
+
+// The AVX2 kernels convert two blocks at once, one in each 128 bit lane
+template <size_t inBpp, size_t outBpp, bool swap>
+YARP_PIXEL_KERNELS_TARGET("avx2")
+void convertAvx2(const unsigned char* src, unsigned char* dest, size_t w)
+{
+    constexpr size_t block = blockPixels(inBpp, outBpp);
+    alignas(16) char m[16];
+    alignas(16) char f[16];
+    shuffleMask(inBpp, outBpp, swap, m, f);
+    const __m256i mask = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(m)));
+    const __m256i fill = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(f)));
+
+    // Both the load and the store of the second block must stay in the row
+    constexpr size_t bpp = std::min(inBpp, outBpp);
+    size_t j = 0;
+    for (; (j + block) * bpp + 16 <= w * bpp; j += 2 * block) {
+        const unsigned char* s = src + j * inBpp;
+        unsigned char* d = dest + j * outBpp;
+        __m256i v;
+        if (block * inBpp == 16) {
+            v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+        } else {
+            v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s))),
+                                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + block * inBpp)),
+                                        1);
+        }
+        v = _mm256_or_si256(_mm256_shuffle_epi8(v, mask), fill);
+        if (block * outBpp == 16) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d), v);
+        } else {
+            // the second store overwrites the extra bytes of the first one
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d), _mm256_castsi256_si128(v));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + block * outBpp), _mm256_extracti128_si256(v, 1));
+        }
+    }
+    convertScalar<inBpp, outBpp, swap>(src + j * inBpp, dest + j * outBpp, w - j);
+}
+
+template <size_t inBpp>
+YARP_PIXEL_KERNELS_TARGET("avx2")
+void toMonoAvx2(const unsigned char* src, unsigned char* dest, size_t w)
+{
+    alignas(16) char m[16];
+    alignas(16) char f[16];
+    shuffleMask(3, 4, false, m, f);
+    const __m256i expand = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(m)));
+    const __m256i weights = _mm256_set1_epi32(0x00010101);
+    const __m256i third = _mm256_set1_epi16(static_cast<short>(div3Mul));
+    // phaddw works inside the lanes, the sums are in the order 0-3 8-11 | 4-7 12-15
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 0, 0, 0, 0);
+
+    size_t j = 0;
+    for (; (j + 12) * inBpp + 16 <= w * inBpp && j + 16 <= w; j += 16) {
+        const unsigned char* s = src + j * inBpp;
+        __m256i a;
+        __m256i b;
+        if (inBpp == 4) {
+            a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+            b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 32));
+        } else {
+            a = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s))),
+                                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 12)),
+                                        1);
+            b = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 24))),
+                                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 36)),
+                                        1);
+            a = _mm256_shuffle_epi8(a, expand);
+            b = _mm256_shuffle_epi8(b, expand);
+        }
+        __m256i sum = _mm256_hadd_epi16(_mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+        sum = _mm256_mulhi_epu16(sum, third);
+        sum = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(sum, sum), order);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + j), _mm256_castsi256_si128(sum));
+    }
+    toMonoScalar<inBpp>(src + j * inBpp, dest + j, w - j);
+}
+
+YARP_PIXEL_KERNELS_TARGET("avx2")
+void monoTo4Avx2(const unsigned char* src, unsigned char* dest, size_t w)
+{
+    // 16 pixels are broadcast to both the lanes, and written as 2 blocks of 32 bytes
+    alignas(32) char m[2][32];
+    alignas(32) char f[32];
+    for (size_t q = 0; q < 2; q++) {
+        for (size_t k = 0; k < 32; k++) {
+            const size_t p = q * 8 + (k / 16) * 4 + (k % 16) / 4;
+            m[q][k] = (k % 4 == 3) ? static_cast<char>(0x80) : static_cast<char>(p);
+            f[k] = (k % 4 == 3) ? static_cast<char>(0xff) : 0;
+        }
+    }
+    const __m256i mask0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(m[0]));
+    const __m256i mask1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(m[1]));
+    const __m256i fill = _mm256_load_si256(reinterpret_cast<const __m256i*>(f));
+
+    size_t j = 0;
+    for (; j + 16 <= w; j += 16) {
+        const __m256i v = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + j * 4), _mm256_or_si256(_mm256_shuffle_epi8(v, mask0), fill));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + j * 4 + 32), _mm256_or_si256(_mm256_shuffle_epi8(v, mask1), fill));
+    }
+    fromMonoScalar<4>(src + j, dest + j * 4, w - j);
+}
+
+// mono -> rgb and the planar conversions are already limited by the stores,
+// and use the SSSE3 kernels
+const PixelKernels avx2Kernels {
+    "avx2",
+    convertAvx2<3, 3, true>,
+    convertAvx2<4, 4, true>,
+    convertAvx2<3, 4, false>,
+    convertAvx2<3, 4, true>,
+    convertAvx2<4, 3, false>,
+    convertAvx2<4, 3, true>,
+    toMonoAvx2<3>,
+    toMonoAvx2<4>,
+    fromMonoSsse3<3>,
+    monoTo4Avx2,
+    planarTo3Ssse3,
+    planarTo4Ssse3
+};
+
+#if defined(_MSC_VER) && !defined(__clang__)
+bool hasSsse3()
+{
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+}
+
+bool hasAvx2()
+{
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    // the OS must also save the ymm registers
+    __cpuid(info, 1);
+    const int osxsaveAndAvx = (1 << 27) | (1 << 28);
+    if ((info[2] & osxsaveAndAvx) != osxsaveAndAvx || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+}
+#else
+bool hasSsse3()
+{
+    return __builtin_cpu_supports("ssse3");
+}
+
+bool hasAvx2()
+{
+    return __builtin_cpu_supports("avx2");
+}
+#endif
+
+#endif // YARP_PIXEL_KERNELS_X86
+
+
+#if defined(YARP_PIXEL_KERNELS_NEON)
+
+/******************************************************************************/
+// NEON kernels: the interleaved loads and stores split the pixels in their
+// channels, 16 pixels at a time
+
+template <size_t inBpp, size_t outBpp, bool swap>
+void convertNeon(const unsigned char* src, unsigned char* dest, size_t w)
+{
+    size_t j = 0;
+    for (; j + 16 <= w; j += 16) {
+        uint8x16_t c[4];
+        if (inBpp == 3) {
+            const uint8x16x3_t v = vld3q_u8(src + j * 3);
+            c[0] = v.val[0];
+            c[1] = v.val[1];
+            c[2] = v.val[2];
+            c[3] = vdupq_n_u8(255);
+        } else {
+            const uint8x16x4_t v = vld4q_u8(src + j * 4);
+            c[0] = v.val[0];
+            c[1] = v.val[1];
+            c[2] = v.val[2];
+            c[3] = v.val[3];
+        }
+        if (outBpp == 3) {
+            uint8x16x3_t v;
+            v.val[0] = c[swap ? 2 : 0];
+            v.val[1] = c[1];
+            v.val[2] = c[swap ? 0 : 2];
+            vst3q_u8(dest + j * 3, v);
+        } else {
+            uint8x16x4_t v;
+            v.val[0] = c[swap ? 2 : 0];
+            v.val[1] = c[1];
+            v.val[2] = c[swap ? 0 : 2];
+            v.val[3] = c[3];
+            vst4q_u8(dest + j * 4, v);
+        }
+    }
+    convertScalar<inBpp, outBpp, swap>(src + j * inBpp, dest + j * outBpp, w - j);
+}
+
+inline uint8x8_t div3Neon(uint16x8_t sum)
+{
+    const uint16x4_t k = vdup_n_u16(div3Mul);
+    const uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(sum), k), 16);
+    const uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(sum), k), 16);
+    return vmovn_u16(vcombine_u16(lo, hi));
+}
+
+template <size_t inBpp>
+void toMonoNeon(const unsigned char* src, unsigned char* dest, size_t w)
+{
+    size_t j = 0;
+    for (; j + 16 <= w; j += 16) {
+        uint8x16_t c[3];
+        if (inBpp == 3) {
+            const uint8x16x3_t v = vld3q_u8(src + j * 3);
+            c[0] = v.val[0];
+            c[1] = v.val[1];
+            c[2] = v.val[2];
+        } else {
+            const uint8x16x4_t v = vld4q_u8(src + j * 4);
+            c[0] = v.val[0];
+            c[1] = v.val[1];
+            c[2] = v.val[2];
+        }
+        const uint16x8_t lo = vaddw_u8(vaddl_u8(vget_low_u8(c[0]), vget_low_u8(c[1])), vget_low_u8(c[2]));
+        const uint16x8_t hi = vaddw_u8(vaddl_u8(vget_high_u8(c[0]), vget_high_u8(c[1])), vget_high_u8(c[2]));
+        vst1q_u8(dest + j, vcombine_u8(div3Neon(lo), div3Neon(hi)));
+    }
+    toMonoScalar<inBpp>(src + j * inBpp, dest + j, w - j);
+}
+
+template <size_t outBpp>
+void fromMonoNeon(const unsigned char* src, unsigned char* dest, size_t w)
+{
+    size_t j = 0;
+    for (; j + 16 <= w; j += 16) {
+        const uint8x16_t m = vld1q_u8(src + j);
+        if (outBpp == 3) {
+            uint8x16x3_t v;
+            v.val[0] = m;
+            v.val[1] = m;
+            v.val[2] = m;
+            vst3q_u8(dest + j * 3, v);
+        } else {
+            uint8x16x4_t v;
+            v.val[0] = m;
+            v.val[1] = m;
+            v.val[2] = m;
+            v.val[3] = vdupq_n_u8(255);
+            vst4q_u8(dest + j * 4, v);
+        }
+    }
+    fromMonoScalar<outBpp>(src + j, dest + j * outBpp, w - j);
+}
+
+template <size_t outBpp>
+void fromPlanarNeon(const unsigned char* c0, const unsigned char* c1, const unsigned char* c2, unsigned char* dest, size_t w)
+{
+    size_t j = 0;
+    for (; j + 16 <= w; j += 16) {
+        if (outBpp == 3) {
+            uint8x16x3_t v;
+            v.val[0] = vld1q_u8(c0 + j);
+            v.val[1] = vld1q_u8(c1 + j);
+            v.val[2] = vld1q_u8(c2 + j);
+            vst3q_u8(dest + j * 3, v);
+        } else {
+            uint8x16x4_t v;
+            v.val[0] = vld1q_u8(c0 + j);
+            v.val[1] = vld1q_u8(c1 + j);
+            v.val[2] = vld1q_u8(c2 + j);
+            v.val[3] = vdupq_n_u8(255);
+            vst4q_u8(dest + j * 4, v);
+        }
+    }
+    fromPlanarScalar<outBpp>(c0 + j, c1 + j, c2 + j, dest + j * outBpp, w - j);
+}
+
+const PixelKernels neonKernels {
+    "neon",
+    convertNeon<3, 3, true>,
+    convertNeon<4, 4, true>,
+    convertNeon<3, 4, false>,
+    convertNeon<3, 4, true>,
+    convertNeon<4, 3, false>,
+    convertNeon<4, 3, true>,
+    toMonoNeon<3>,
+    toMonoNeon<4>,
+    fromMonoNeon<3>,
+    fromMonoNeon<4>,
+    fromPlanarNeon<3>,
+    fromPlanarNeon<4>
+};
+
+#endif // YARP_PIXEL_KERNELS_NEON
+
+const PixelKernels& selectKernels()
+{
+    const std::string requested = yarp::conf::environment::getEnvironment("YARP_PIXEL_KERNELS");
+    if (requested == "scalar") {
+        return scalarKernels;
+    }
+#if defined(YARP_PIXEL_KERNELS_X86)
+    if (requested != "ssse3" && hasAvx2()) {
+        return avx2Kernels;
+    }
+    if (hasSsse3()) {
+        return ssse3Kernels;
+    }
+#elif defined(YARP_PIXEL_KERNELS_NEON)
+    return neonKernels;
+#endif
+    return scalarKernels;
+}
+
+} // namespace
+
+
+const PixelKernels& yarp::sig::impl::pixelKernels()
+{
+    static const PixelKernels& kernels = selectKernels();
+    return kernels;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SIG_IMPL_PIXELKERNELS_H
+#define YARP_SIG_IMPL_PIXELKERNELS_H
+
+#include <cstddef>
+
+namespace yarp {
+namespace sig {
+namespace impl {
+
+/**
+ * Converts a row of \c w pixels from \c src to \c dest.
+ * The rows must not overlap.
+ */
+using RowKernel = void (*)(const unsigned char* src, unsigned char* dest, size_t w);
+
+/**
+ * Interleaves a row of \c w pixels, whose channels are in the separate rows
+ * \c c0, \c c1 and \c c2.
+ */
+using PlanarKernel = void (*)(const unsigned char* c0,
+                              const unsigned char* c1,
+                              const unsigned char* c2,
+                              unsigned char* dest,
+                              size_t w);
+
+/**
+ * Row conversions between the 8 bit pixel types that are used the most
+ * (mono, rgb, bgr, rgba and bgra).
+ *
+ * The results are exactly the same as the ones of the per pixel conversions
+ * in Image.copyPixels.cpp, i.e. mono is (r+g+b)/3 and alpha is 255 when the
+ * source has no alpha channel.
+ */
+struct PixelKernels
+{
+    const char*  name;
+    RowKernel    swap3;      ///< rgb <-> bgr
+    RowKernel    swap4;      ///< rgba <-> bgra
+    RowKernel    keep3To4;   ///< rgb -> rgba, bgr -> bgra
+    RowKernel    swap3To4;   ///< rgb -> bgra, bgr -> rgba
+    RowKernel    keep4To3;   ///< rgba -> rgb, bgra -> bgr
+    RowKernel    swap4To3;   ///< rgba -> bgr, bgra -> rgb
+    RowKernel    rgb3ToMono; ///< rgb -> mono, bgr -> mono
+    RowKernel    rgb4ToMono; ///< rgba -> mono, bgra -> mono
+    RowKernel    monoTo3;    ///< mono -> rgb, mono -> bgr
+    RowKernel    monoTo4;    ///< mono -> rgba, mono -> bgra
+    PlanarKernel planarTo3;  ///< planar -> rgb, bgr
+    PlanarKernel planarTo4;  ///< planar -> rgba, bgra (alpha is 255)
+};
+
+/**
+ * Returns the fastest kernels supported by the cpu (AVX2, SSSE3 or NEON, or
+ * the portable ones), selected the first time that it is called.
+ *
+ * The selection can be overridden by setting the YARP_PIXEL_KERNELS
+ * environment variable to "scalar", "ssse3" or "avx2".
+ */
+const PixelKernels& pixelKernels();
+
+} // namespace impl
+} // namespace sig
+} // namespace yarp
+
+#endif // YARP_SIG_IMPL_PIXELKERNELS_H
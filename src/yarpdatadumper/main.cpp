@@ -8,11 +8,18 @@
  */
 
 #include <yarp/os/BufferedPort.h>
+#include <yarp/os/DummyConnector.h>
+#include <yarp/os/NetFloat64.h>
+#include <yarp/os/NetInt32.h>
+#include <yarp/os/OutputStream.h>
 #include <yarp/os/PeriodicThread.h>
 #include <yarp/os/PortInfo.h>
 #include <yarp/os/ResourceFinder.h>
 #include <yarp/os/RFModule.h>
 #include <yarp/os/Stamp.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/os/Thread.h>
+#include <yarp/os/impl/BufferedConnectionWriter.h>
 #include <yarp/sig/all.h>
 
 #include <iostream>
@@ -21,10 +28,25 @@
 #include <sstream>
 #include <string>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <deque>
 #include <utility>
 #include <mutex>
 #include <algorithm>
+#include <vector>
+
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#    include <io.h>
+#else
+#    include <unistd.h>
+#endif
 
 #ifdef ADD_VIDEO
 #    include <opencv2/opencv.hpp>
@@ -215,6 +237,10 @@ public:
 
     void setRxStamp(const double stamp) { rxStamp=stamp; rxOk=true; }
     void setTxStamp(const double stamp) { txStamp=stamp; txOk=true; }
+    bool hasRxStamp() const { return rxOk; }
+    bool hasTxStamp() const { return txOk; }
+    double getRxStamp() const { return rxStamp; }
+    double getTxStamp() const { return txStamp; }
     double getStamp() const
     {
         if (txOk)
@@ -268,6 +294,156 @@ public:
 };
 
 
+// Binary container (data.bin)
+// The file begins with a DumpFileHeader, followed by one chunk per item:
+// a DumpChunkHeader and the item in the wire format used by the ports.
+// All the fields are little endian.
+/**************************************************************************/
+constexpr char dumpMagic[8]={'Y','A','R','P','D','U','M','P'};
+constexpr int  dumpVersion=1;
+constexpr int  dumpTxStamp=1;
+constexpr int  dumpRxStamp=2;
+
+struct DumpFileHeader
+{
+    char     magic[8];
+    NetInt32 version;
+    NetInt32 format;    // DumpFormat of the items
+};
+
+struct DumpChunkHeader
+{
+    NetInt32   length;  // size of the item following the header
+    NetInt32   seqNumber;
+    NetInt32   flags;   // dumpTxStamp | dumpRxStamp
+    NetInt32   reserved;
+    NetFloat64 txStamp;
+    NetFloat64 rxStamp;
+};
+
+
+// Single producer single consumer queue of chunks, filled by the port and
+// emptied by the writer without locks.  The buffers of the slots are
+// reused, so that no memory is allocated once the queue is warm.  The lock
+// is taken only to put the producer to sleep when the queue is full, or the
+// consumer when it is empty.
+/**************************************************************************/
+class DumpChunkQueue
+{
+private:
+    vector<vector<char>> slots;
+    std::atomic<size_t>  head{0};  // next slot to be read
+    std::atomic<size_t>  tail{0};  // next slot to be written
+    std::atomic<bool>    producerWaiting{false};
+    std::atomic<bool>    consumerWaiting{false};
+    bool                 woken{false};
+    std::mutex           mutex;
+    std::condition_variable space;  // a slot was freed
+    std::condition_variable items;  // a chunk was pushed, or wake() called
+
+public:
+    explicit DumpChunkQueue(size_t capacity) : slots(capacity) { }
+
+    size_t size() const { return tail.load(std::memory_order_acquire)-head.load(std::memory_order_acquire); }
+
+    // producer side
+    vector<char> *back()
+    {
+        size_t t=tail.load(std::memory_order_relaxed);
+        if (t-head.load(std::memory_order_acquire)==slots.size())
+            return nullptr;
+        return &slots[t%slots.size()];
+    }
+    void push()
+    {
+        tail.store(tail.load(std::memory_order_relaxed)+1,std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumerWaiting.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            items.notify_one();
+        }
+    }
+
+    // wait until the consumer frees a slot
+    vector<char> *waitBack()
+    {
+        vector<char> *chunk=back();
+        if (chunk!=nullptr)
+            return chunk;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        producerWaiting.store(true);
+        // pairs with the fence in pop(): either the consumer sees the flag,
+        // or the slot it freed is seen here
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        space.wait(lock,[&]() { return (chunk=back())!=nullptr; });
+        producerWaiting.store(false,std::memory_order_relaxed);
+        return chunk;
+    }
+
+    // consumer side
+    vector<char> *front()
+    {
+        size_t h=head.load(std::memory_order_relaxed);
+        if (h==tail.load(std::memory_order_acquire))
+            return nullptr;
+        return &slots[h%slots.size()];
+    }
+    void pop()
+    {
+        head.store(head.load(std::memory_order_relaxed)+1,std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (producerWaiting.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            space.notify_one();
+        }
+    }
+
+    // wait until the producer pushes a chunk, wake() is called, or timeout
+    // seconds have passed
+    void waitFront(double timeout)
+    {
+        if (front()!=nullptr)
+            return;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        consumerWaiting.store(true);
+        // pairs with the fence in push()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        items.wait_for(lock,std::chrono::duration<double>(timeout),
+                       [&]() { return woken || (front()!=nullptr); });
+        consumerWaiting.store(false,std::memory_order_relaxed);
+    }
+
+    // stop waiting in waitFront(), now and from now on
+    void wake()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        woken=true;
+        items.notify_all();
+    }
+};
+
+
+// Appends the serialized items to the chunk being prepared
+/**************************************************************************/
+class DumpChunkStream : public OutputStream
+{
+private:
+    vector<char> *chunk{nullptr};
+
+public:
+    void attach(vector<char> &c) { chunk=&c; }
+
+    using OutputStream::write;
+    void write(const Bytes &b) override { chunk->insert(chunk->end(),b.get(),b.get()+b.length()); }
+    void close() override { }
+    bool isOk() const override { return true; }
+};
+
+
 /**************************************************************************/
 template <class T>
 class DumpPort : public BufferedPort<T>
@@ -282,10 +458,18 @@ public:
         cnt=0;
         itemformat = _dataformat;
         firstIncomingData=true;
+        chunks=nullptr;
+        serializer.reset(false);
     }
 
+    // store the items in the binary container instead of the queue
+    void setChunkQueue(DumpChunkQueue &Q) { chunks=&Q; }
+
 private:
     DumpQueue &buf;
+    DumpChunkQueue *chunks;
+    yarp::os::impl::BufferedConnectionWriter serializer;
+    DumpChunkStream chunkStream;
     unsigned int dwnsample;
     unsigned int cnt;
     bool firstIncomingData;
@@ -316,6 +500,13 @@ private:
             if (rxTime || !info.isValid())
                 item.timeStamp.setRxStamp(Time::now());
 
+            if (chunks!=nullptr)
+            {
+                pushChunk(item,obj);
+                cnt=0;
+                return;
+            }
+
             item.obj=factory(obj);
             item.obj->attachFormat(itemformat);
 
@@ -326,6 +517,31 @@ private:
             cnt=0;
         }
     }
+
+    void pushChunk(const DumpItem &item, T &obj)
+    {
+        // if the writer is behind, sleep until it frees a slot: the strict
+        // port keeps the incoming data meanwhile, as the text mode does
+        vector<char> *chunk=chunks->waitBack();
+
+        DumpChunkHeader header;
+        header.seqNumber=item.seqNumber;
+        header.flags=(item.timeStamp.hasTxStamp()?dumpTxStamp:0)|
+                     (item.timeStamp.hasRxStamp()?dumpRxStamp:0);
+        header.reserved=0;
+        header.txStamp=item.timeStamp.getTxStamp();
+        header.rxStamp=item.timeStamp.getRxStamp();
+
+        chunk->resize(sizeof(header));
+        serializer.restart();
+        obj.write(serializer);
+        chunkStream.attach(*chunk);
+        serializer.write(chunkStream);
+
+        header.length=(int)(chunk->size()-sizeof(header));
+        memcpy(chunk->data(),&header,sizeof(header));
+        chunks->push();
+    }
 };
 
 
@@ -350,6 +566,7 @@ private:
     string          videoType;
     bool            rxTime;
     bool            txTime;
+    bool            binary;
     bool            closing;
 
 #ifdef ADD_VIDEO
@@ -365,7 +582,7 @@ private:
 public:
     DumpThread(DumpFormat _type, DumpQueue &Q, const string &_dirName, const int szToWrite,
                const bool _saveData, const bool _videoOn, const string &_videoType,
-               const bool _rxTime, const bool _txTime) :
+               const bool _rxTime, const bool _txTime, const bool _binary) :
         PeriodicThread(0.05),
         buf(Q),
         type(_type),
@@ -379,6 +596,7 @@ public:
         videoType(std::move(_videoType)),
         rxTime(_rxTime),
         txTime(_txTime),
+        binary(_binary),
         closing(false)
     {
         infoFile=dirName;
@@ -467,6 +685,10 @@ public:
             finfo<<"rx;";
         finfo<<endl;
 
+        // the items are stored in data.bin by the DumpWriter
+        if (binary)
+            return true;
+
         fdata.open(dataFile.c_str());
         if (!fdata.is_open())
         {
@@ -580,7 +802,8 @@ public:
         run();
 
         finfo.close();
-        fdata.close();
+        if (fdata.is_open())
+            fdata.close();
 
     #ifdef ADD_VIDEO
         if (videoOn)
@@ -590,6 +813,229 @@ public:
 };
 
 
+// Writes the chunks produced by the port to data.bin
+/**************************************************************************/
+class DumpWriter : public Thread
+{
+private:
+    DumpChunkQueue &chunks;
+    DumpFormat      type;
+    string          dataFile;
+    double          syncPeriod;
+    FILE           *fdata;
+    unsigned int    cumulSize;
+
+    void sync()
+    {
+        fflush(fdata);
+    #ifdef _WIN32
+        _commit(_fileno(fdata));
+    #else
+        fsync(fileno(fdata));
+    #endif
+    }
+
+    unsigned int drain()
+    {
+        unsigned int n=0;
+        vector<char> *chunk;
+        while ((chunk=chunks.front())!=nullptr)
+        {
+            fwrite(chunk->data(),1,chunk->size(),fdata);
+            chunks.pop();
+            n++;
+        }
+        return n;
+    }
+
+public:
+    DumpWriter(DumpFormat _type, DumpChunkQueue &Q, const string &dirName, const double _syncPeriod) :
+        chunks(Q),
+        type(_type),
+        dataFile(dirName+"/data.bin"),
+        syncPeriod(_syncPeriod),
+        fdata(nullptr),
+        cumulSize(0)
+    {
+    }
+
+    bool threadInit() override
+    {
+        fdata=fopen(dataFile.c_str(),"wb");
+        if (fdata==nullptr)
+        {
+            yError() << "unable to open file: " << dataFile;
+            return false;
+        }
+        setvbuf(fdata,nullptr,_IOFBF,1<<20);
+
+        DumpFileHeader header;
+        memcpy(header.magic,dumpMagic,sizeof(header.magic));
+        header.version=dumpVersion;
+        header.format=(int)type;
+        fwrite(&header,sizeof(header),1,fdata);
+        return true;
+    }
+
+    void run() override
+    {
+        double oldTime=Time::now();
+        double syncTime=oldTime;
+        unsigned int sz=0;
+        bool stopping=false;
+        while (!stopping)
+        {
+            // the port is closed before stopping: whatever is in the
+            // queue at this point is the last batch
+            stopping=isStopping();
+            unsigned int n=drain();
+            if (n>0)
+                fflush(fdata);
+            sz+=n;
+
+            double curTime=Time::now();
+            if ((syncPeriod>0.0) && (curTime-syncTime>=syncPeriod))
+            {
+                sync();
+                syncTime=curTime;
+            }
+
+            // report each 10 seconds, as the text log does
+            if (((curTime-oldTime>10.0) || stopping) && (sz>0))
+            {
+                cumulSize+=sz;
+                yInfo() << sz << " items stored [cumul #: " << cumulSize << "]";
+                sz=0;
+                oldTime=curTime;
+            }
+
+            // sleep until there is something to write, the next sync, the
+            // next report, or the thread is stopped
+            if ((n==0) && !stopping)
+                chunks.waitFront((syncPeriod>0.0)?std::min(syncPeriod,10.0):10.0);
+        }
+    }
+
+    void onStop() override
+    {
+        chunks.wake();
+    }
+
+    void threadRelease() override
+    {
+        sync();
+        fclose(fdata);
+    }
+};
+
+
+// Converts a binary container into the plain text log (and image files)
+// produced when dumping without --binary
+/**************************************************************************/
+template <class T>
+DumpObj *readChunk(const vector<char> &data)
+{
+    DummyConnector con;
+    con.getWriter().appendExternalBlock(data.data(),data.size());
+    T obj;
+    if (!obj.read(con.getReader()))
+        return nullptr;
+    return factory(obj);
+}
+
+bool exportData(const string &dirName)
+{
+    string binFile=dirName+"/data.bin";
+    string dataFile=dirName+"/data.log";
+
+    FILE *fbin=fopen(binFile.c_str(),"rb");
+    if (fbin==nullptr)
+    {
+        yError() << "unable to open file: " << binFile;
+        return false;
+    }
+
+    DumpFileHeader fileHeader;
+    if ((fread(&fileHeader,sizeof(fileHeader),1,fbin)!=1) ||
+        (memcmp(fileHeader.magic,dumpMagic,sizeof(dumpMagic))!=0) ||
+        (fileHeader.version!=dumpVersion))
+    {
+        yError() << binFile << " is not a valid data file";
+        fclose(fbin);
+        return false;
+    }
+    auto type=(DumpFormat)(int)fileHeader.format;
+
+    // the chunk lengths are checked against the size of the file, so that
+    // a corrupted length does not make us allocate a huge buffer
+#ifdef _WIN32
+    struct _stat64 st;
+    bool sized=(_stat64(binFile.c_str(),&st)==0);
+#else
+    struct stat st;
+    bool sized=(stat(binFile.c_str(),&st)==0);
+#endif
+    if (!sized)
+    {
+        yError() << "unable to get the size of file: " << binFile;
+        fclose(fbin);
+        return false;
+    }
+    auto left=(uint64_t)st.st_size-sizeof(fileHeader);
+
+    ofstream fdata(dataFile.c_str());
+    if (!fdata.is_open())
+    {
+        yError() << "unable to open file: " << dataFile;
+        fclose(fbin);
+        return false;
+    }
+
+    unsigned int counter=0;
+    DumpChunkHeader header;
+    vector<char> data;
+    bool ok=true;
+    while (fread(&header,sizeof(header),1,fbin)==1)
+    {
+        left-=sizeof(header);
+        ok=(header.length>=0) && ((uint64_t)header.length<=left);
+        if (ok)
+        {
+            data.resize(header.length);
+            ok=(fread(data.data(),1,data.size(),fbin)==data.size());
+            left-=data.size();
+        }
+        if (!ok)
+        {
+            yError() << binFile << " is truncated or corrupted after" << counter << "items";
+            break;
+        }
+
+        DumpTimeStamp timeStamp;
+        if (header.flags&dumpTxStamp)
+            timeStamp.setTxStamp(header.txStamp);
+        if (header.flags&dumpRxStamp)
+            timeStamp.setRxStamp(header.rxStamp);
+
+        DumpObj *obj=(type==DumpFormat::bottle)?readChunk<Bottle>(data):readChunk<Image>(data);
+        if (obj==nullptr)
+        {
+            yError() << "unable to read item" << counter << "of" << binFile;
+            ok=false;
+            break;
+        }
+        obj->attachFormat(type);
+        fdata << header.seqNumber << ' ' << timeStamp.getString() << ' ';
+        fdata << obj->toFile(dirName,counter++) << endl;
+        delete obj;
+    }
+
+    yInfo() << counter << " items exported to " << dataFile;
+    fclose(fbin);
+    return ok;
+}
+
+
 /**************************************************************************/
 class DumpReporter : public PortReport
 {
@@ -612,9 +1058,11 @@ class DumpModule: public RFModule
 {
 private:
     DumpQueue        *q{nullptr};
+    DumpChunkQueue   *chunks{nullptr};
     DumpPort<Bottle> *p_bottle{nullptr};
     DumpPort<Image>  *p_image{nullptr};
     DumpThread       *t{nullptr};
+    DumpWriter       *w{nullptr};
     DumpReporter      reporter;
     Port              rpcPort;
     DumpFormat        dumptype{ DumpFormat::bottle};
@@ -709,6 +1157,19 @@ public:
             dumptype = DumpFormat::bottle;
         }
 
+        bool binary=rf.check("binary");
+        if (binary && !saveData)
+        {
+            yError() << "Error: --binary cannot be used to dump only the video";
+            return false;
+        }
+        if (binary && videoOn)
+        {
+            yWarning() << "--addVideo is ignored when dumping in binary format";
+            videoOn=false;
+        }
+        double syncPeriod=rf.check("fsync",Value(0.0)).asFloat64();
+
         dwnsample=rf.check("downsample",Value(1)).asInt32();
         rxTime=rf.check("rxTime");
         txTime=rf.check("txTime");
@@ -740,7 +1201,7 @@ public:
         yarp::os::mkdir_p(dirName.c_str());
 
         q=new DumpQueue();
-        t=new DumpThread(dumptype,*q,dirName,100,saveData,videoOn,videoType,rxTime,txTime);
+        t=new DumpThread(dumptype,*q,dirName,100,saveData,videoOn,videoType,rxTime,txTime,binary);
 
         if (!t->start())
         {
@@ -750,11 +1211,29 @@ public:
             return false;
         }
 
+        if (binary)
+        {
+            chunks=new DumpChunkQueue(1024);
+            w=new DumpWriter(dumptype,*chunks,dirName,syncPeriod);
+            if (!w->start())
+            {
+                t->stop();
+                delete w;
+                delete chunks;
+                delete t;
+                delete q;
+
+                return false;
+            }
+        }
+
         reporter.setThread(t);
 
         if (dumptype == DumpFormat::bottle)
         {
             p_bottle=new DumpPort<Bottle>(*q,dwnsample,rxTime,txTime, DumpFormat::bottle);
+            if (binary)
+                p_bottle->setChunkQueue(*chunks);
             p_bottle->useCallback();
             p_bottle->open(portName);
             p_bottle->setStrict();
@@ -763,6 +1242,8 @@ public:
         else
         {
             p_image=new DumpPort<Image>(*q,dwnsample,rxTime,txTime, dumptype);
+            if (binary)
+                p_image->setChunkQueue(*chunks);
             p_image->useCallback();
             p_image->open(portName);
             p_image->setStrict();
@@ -815,6 +1296,14 @@ public:
         rpcPort.interrupt();
         rpcPort.close();
 
+        // the ports are closed: the writer can store the last chunks
+        if (w!=nullptr)
+        {
+            w->stop();
+            delete w;
+            delete chunks;
+        }
+
         delete t;
         delete q;
 
@@ -851,11 +1340,17 @@ int main(int argc, char *argv[])
         yInfo() << "\t--downsample    n: downsample rate (default: 1 => downsample disabled)";
         yInfo() << "\t--rxTime         : dump the receiver time instead of the sender time";
         yInfo() << "\t--txTime         : dump the sender time straightaway";
+        yInfo() << "\t--binary         : store the data in the binary container data.bin";
+        yInfo() << "\t--fsync   period: with --binary, sync data.bin to disk every period seconds (default: 0 => disabled)";
+        yInfo() << "\t--export     dir: convert dir/data.bin to the plain text dir/data.log and exit";
         yInfo();
 
         return 0;
     }
 
+    if (rf.check("export"))
+        return exportData(rf.find("export").asString())?0:1;
+
     if (!yarp.checkNetwork())
     {
         yError()<<"YARP server not available!";
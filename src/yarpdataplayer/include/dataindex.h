@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef DATAINDEX_H
+#define DATAINDEX_H
+
+#include <yarp/os/Bottle.h>
+#include <yarp/sig/Vector.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**********************************************************/
+class DataIndex
+{
+public:
+    DataIndex() = default;
+    DataIndex(const DataIndex&) = delete;
+    DataIndex& operator=(const DataIndex&) = delete;
+    ~DataIndex();
+
+    /**
+    * function that maps a data.log file and indexes its lines. The index is
+    * read from (or saved to) the sidecar file <logFile>.idx, and rebuilt when
+    * it does not match the log. The time stamp of each line (the column
+    * timeStampCol) is stored in timestamps. Blank lines and lines without a
+    * valid time stamp are skipped.
+    */
+    bool open(const std::string& logFile, int timeStampCol, yarp::sig::Vector& timestamps);
+    /**
+    * function that unmaps the file
+    */
+    void close();
+    /**
+    * function that returns the number of lines
+    */
+    size_t size() const { return offsets.size(); }
+    /**
+    * function that returns whether the time stamps are in increasing order
+    */
+    bool isSorted() const { return sorted; }
+    /**
+    * function that parses a line of the log
+    */
+    bool read(size_t frame, yarp::os::Bottle& line) const;
+    /**
+    * function that asks the system to load the next lines in memory
+    */
+    void prefetch(size_t frame, size_t count) const;
+    /**
+    * function that returns the first frame with time stamp not less than t,
+    * with a binary search when the time stamps are sorted
+    */
+    size_t find(const yarp::sig::Vector& timestamps, double t) const;
+
+private:
+    bool loadIndex(const std::string& indexFile, int timeStampCol, yarp::sig::Vector& timestamps);
+    void buildIndex(int timeStampCol, yarp::sig::Vector& timestamps);
+    void saveIndex(const std::string& indexFile, int timeStampCol, const yarp::sig::Vector& timestamps) const;
+    size_t lineEnd(size_t frame) const;
+
+    const char*           data{nullptr};    //the mapped log
+    size_t                length{0};        //the size of the log
+    int64_t               modified{0};      //the modification time of the log
+    std::vector<uint64_t> offsets;          //the beginning of each line
+    bool                  sorted{true};     //the time stamps are in increasing order
+#if defined(_WIN32)
+    void*                 mapping{nullptr}; //the handle of the file mapping
+#endif
+};
+
+#endif
@@ -31,6 +31,7 @@
 #include <yarp/os/Network.h>
 #include <yarp/os/RpcClient.h>
 #include "include/worker.h"
+#include "include/dataindex.h"
 
 class WorkerClass;
 class MasterThread;
@@ -47,14 +48,15 @@ struct partsData
     std::string             type;                               //string containing the type of the data
     int                     currFrame;                          //integer containing the current frame
     int                     maxFrame;                           //integer containing the maxFrame
-    yarp::os::Bottle        bot;                                //yarp Bottle containing all the data
+    DataIndex               index;                              //index of the lines of the mapped logFile
     yarp::sig::Vector       timestamp;                          //yarp Vector containing all the timestamps
+    bool                    hasStrings;                         //boolean true if the data are strings (not numbers)
     yarp::os::Contactable*  outputPort;                         //yarp port for sending out data
     std::string             portName;                           //the name of the port
     int                     sent;                               //integer used for step from command
     bool                    hasNotified;                        //boolean used for individual part notification that it has reached eof
 
-    partsData() { outputPort = nullptr; worker = nullptr;}
+    partsData() { outputPort = nullptr; worker = nullptr; hasStrings = false;}
 };
 
 struct RowInfo {
@@ -120,6 +122,10 @@ public:
     */
     bool setupDataFromParts(partsData &part);
     /**
+    * function that parses a line of the data of a part
+    */
+    bool getFrame(partsData &part, int frame, yarp::os::Bottle &line);
+    /**
     * function that configures and opens all the ports required
     */
     bool configurePorts(partsData &part);
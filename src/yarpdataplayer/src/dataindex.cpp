@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "include/dataindex.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_WIN32)
+    #include <windows.h>
+    #include <sys/stat.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace yarp::os;
+using namespace yarp::sig;
+using namespace std;
+
+namespace {
+
+// Layout of the sidecar file: the header, the offsets of the lines and
+// their time stamps, in the byte order of the machine that wrote it
+struct IndexHeader
+{
+    char     magic[8];
+    uint32_t byteOrder;
+    int32_t  timeStampCol;
+    uint64_t logLength;
+    int64_t  logModified;
+    uint64_t count;
+};
+
+constexpr char indexMagic[8] = {'Y','A','R','P','I','D','X','2'};
+constexpr uint32_t indexByteOrder = 0x01020304;
+
+}
+
+/**********************************************************/
+DataIndex::~DataIndex()
+{
+    close();
+}
+
+/**********************************************************/
+bool DataIndex::open(const string& logFile, int timeStampCol, Vector& timestamps)
+{
+    close();
+
+#if defined(_WIN32)
+    struct _stat64 st;
+    if (_stat64(logFile.c_str(), &st) != 0) {
+        return false;
+    }
+    length = (size_t)st.st_size;
+    modified = (int64_t)st.st_mtime;
+    if (length > 0) {
+        HANDLE file = CreateFileA(logFile.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr) {
+            return false;
+        }
+        data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr) {
+            CloseHandle(mapping);
+            mapping = nullptr;
+            return false;
+        }
+    }
+#else
+    int fd = ::open(logFile.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    length = (size_t)st.st_size;
+    modified = (int64_t)st.st_mtime;
+    if (length > 0) {
+        void* addr = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        data = (const char*)addr;
+    }
+    ::close(fd);
+#endif
+
+    string indexFile = logFile + ".idx";
+    if (!loadIndex(indexFile, timeStampCol, timestamps)) {
+        buildIndex(timeStampCol, timestamps);
+        saveIndex(indexFile, timeStampCol, timestamps);
+    }
+    const double* first = timestamps.data();
+    sorted = std::is_sorted(first, first + timestamps.size());
+    return true;
+}
+
+/**********************************************************/
+void DataIndex::close()
+{
+    if (data != nullptr) {
+#if defined(_WIN32)
+        UnmapViewOfFile(data);
+        CloseHandle(mapping);
+        mapping = nullptr;
+#else
+        munmap((void*)data, length);
+#endif
+    }
+    data = nullptr;
+    length = 0;
+    offsets.clear();
+    sorted = true;
+}
+
+/**********************************************************/
+bool DataIndex::loadIndex(const string& indexFile, int timeStampCol, Vector& timestamps)
+{
+    FILE* f = fopen(indexFile.c_str(), "rb");
+    if (f == nullptr) {
+        return false;
+    }
+
+    IndexHeader header;
+    bool ok = (fread(&header, sizeof(header), 1, f) == 1) &&
+              (memcmp(header.magic, indexMagic, sizeof(indexMagic)) == 0) &&
+              (header.byteOrder == indexByteOrder) &&
+              (header.timeStampCol == timeStampCol) &&
+              (header.logLength == length) &&
+              (header.logModified == modified);
+    if (ok) {
+        offsets.resize(header.count);
+        timestamps.resize(header.count);
+        ok = (fread(offsets.data(), sizeof(uint64_t), offsets.size(), f) == offsets.size()) &&
+             (fread(timestamps.data(), sizeof(double), timestamps.size(), f) == timestamps.size());
+    }
+    fclose(f);
+
+    if (!ok) {
+        offsets.clear();
+        timestamps.clear();
+    }
+    return ok;
+}
+
+/**********************************************************/
+void DataIndex::buildIndex(int timeStampCol, Vector& timestamps)
+{
+    offsets.clear();
+    timestamps.clear();
+
+    size_t pos = 0;
+    while (pos < length) {
+        const char* begin = data + pos;
+        const char* newline = (const char*)memchr(begin, '\n', length - pos);
+        const char* end = (newline != nullptr) ? newline : data + length;
+
+        // only the time stamp is parsed, the line is parsed when it is sent
+        const char* p = begin;
+        for (int col = 0; col <= timeStampCol && p < end; col++) {
+            while (p < end && (*p == ' ' || *p == '\t')) {
+                p++;
+            }
+            if (col == timeStampCol) {
+                break;
+            }
+            while (p < end && *p != ' ' && *p != '\t') {
+                p++;
+            }
+        }
+        char token[64];
+        size_t n = 0;
+        while (p + n < end && n < sizeof(token) - 1 && p[n] != ' ' && p[n] != '\t' && p[n] != '\r') {
+            token[n] = p[n];
+            n++;
+        }
+        token[n] = '\0';
+
+        // skip the blank lines, and the ones without a time stamp, that
+        // would be played at time 0
+        char* parsed = nullptr;
+        double timestamp = strtod(token, &parsed);
+        if (n > 0 && parsed == token + n) {
+            offsets.push_back(pos);
+            timestamps.push_back(timestamp);
+        }
+
+        pos = (size_t)(end - data) + 1;
+    }
+}
+
+/**********************************************************/
+void DataIndex::saveIndex(const string& indexFile, int timeStampCol, const Vector& timestamps) const
+{
+    // the index is only a cache: nothing to do if it cannot be written
+    FILE* f = fopen(indexFile.c_str(), "wb");
+    if (f == nullptr) {
+        return;
+    }
+
+    IndexHeader header;
+    memcpy(header.magic, indexMagic, sizeof(indexMagic));
+    header.byteOrder = indexByteOrder;
+    header.timeStampCol = timeStampCol;
+    header.logLength = length;
+    header.logModified = modified;
+    header.count = offsets.size();
+
+    bool ok = (fwrite(&header, sizeof(header), 1, f) == 1) &&
+              (fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), f) == offsets.size()) &&
+              (fwrite(timestamps.data(), sizeof(double), timestamps.size(), f) == timestamps.size());
+    fclose(f);
+
+    if (!ok) {
+        remove(indexFile.c_str());
+    }
+}
+
+/**********************************************************/
+size_t DataIndex::lineEnd(size_t frame) const
+{
+    // the next line in the index is not always the next one in the log
+    size_t begin = (size_t)offsets[frame];
+    const char* newline = (const char*)memchr(data + begin, '\n', length - begin);
+    size_t end = (newline != nullptr) ? (size_t)(newline - data) : length;
+    while (end > offsets[frame] && (data[end - 1] == '\n' || data[end - 1] == '\r')) {
+        end--;
+    }
+    return end;
+}
+
+/**********************************************************/
+bool DataIndex::read(size_t frame, Bottle& line) const
+{
+    if (frame >= offsets.size()) {
+        line.clear();
+        return false;
+    }
+    size_t begin = offsets[frame];
+    line.fromString(string(data + begin, lineEnd(frame) - begin));
+    return true;
+}
+
+/**********************************************************/
+void DataIndex::prefetch(size_t frame, size_t count) const
+{
+#if !defined(_WIN32)
+    if (frame >= offsets.size() || count == 0) {
+        return;
+    }
+    size_t last = std::min(frame + count, offsets.size()) - 1;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t begin = (size_t)offsets[frame] / page * page;
+    size_t end = lineEnd(last);
+    if (end > begin) {
+        madvise((void*)(data + begin), end - begin, MADV_WILLNEED);
+    }
+#else
+    (void)frame;
+    (void)count;
+#endif
+}
+
+/**********************************************************/
+size_t DataIndex::find(const Vector& timestamps, double t) const
+{
+    const double* first = timestamps.data();
+    const double* last = first + timestamps.size();
+    if (sorted) {
+        return (size_t)(std::lower_bound(first, last, t) - first);
+    }
+    return (size_t)(std::find_if(first, last, [t](double ts) { return ts >= t; }) - first);
+}
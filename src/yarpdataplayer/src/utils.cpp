@@ -56,6 +56,11 @@ using namespace yarp::os;
 using namespace yarp::sig;
 using namespace std;
 
+namespace {
+// number of lines of the log loaded in advance during the playback
+constexpr int readAhead = 256;
+}
+
 /**********************************************************/
 Utilities::~Utilities()
 {
@@ -294,30 +299,25 @@ bool Utilities::setupDataFromParts(partsData &part)
 
     // data part
     LOG("opening file %s\n", part.logFile.c_str() );
-    str.open (part.logFile.c_str(), ios_base::in);//, ios::binary);
 
-    //read throughout
-    if (str.is_open()){
-        string line;
-        int itr = 0;
-        while( getline( str, line ) ){
-            Bottle b( line );
-            part.bot.addList() = b;
-            int timeStampCol = 1;
-            if (withExtraColumn){
-                timeStampCol = column;
-            }
-
-            part.timestamp.push_back( b.get(timeStampCol).asFloat64() );
-            itr++;
-        }
-        allTimeStamps.push_back( part.timestamp[0] );   //save all first timeStamps dumped for later ease of use
-        part.maxFrame= itr-1;                           //set max frame to the total iteration minus first line type;
-        part.currFrame = 0;                             //initialize current frame to 0
-        str.close();                                    //close the file
-    } else {
+    // the lines are parsed only when they are sent
+    int timeStampCol = 1;
+    if (withExtraColumn){
+        timeStampCol = column;
+    }
+    if (!part.index.open(part.logFile, timeStampCol, part.timestamp) || part.index.size() == 0){
         return false;
     }
+    if (!part.index.isSorted()){
+        LOG_ERROR("the time stamps of %s are not in increasing order\n", part.logFile.c_str());
+    }
+    Bottle line;
+    if (getFrame(part, 1, line)){
+        part.hasStrings = line.get(2).isString();
+    }
+    allTimeStamps.push_back( part.timestamp[0] );   //save all first timeStamps dumped for later ease of use
+    part.maxFrame = (int)part.index.size()-1;       //set max frame to the total iteration minus first line type;
+    part.currFrame = 0;                             //initialize current frame to 0
 
     return true;
 }
@@ -354,13 +354,23 @@ void Utilities::getMinTimeStamp()
 /**********************************************************/
 int Utilities::amendPartFrames(partsData &part)
 {
-    while (part.timestamp[part.currFrame] < maxTimeStamp){
-        part.currFrame++;
-    }
+    part.currFrame = (int)part.index.find(part.timestamp, maxTimeStamp);
     LOG("the first frame of part %s is %d\n",part.name.c_str(), part.currFrame);
     return part.currFrame;
 }
 /**********************************************************/
+bool Utilities::getFrame(partsData &part, int frame, Bottle &line)
+{
+    if (!part.index.read(frame, line)){
+        return false;
+    }
+    // read ahead the next lines, a block at a time
+    if (frame % readAhead == 0){
+        part.index.prefetch(frame + 1, 2 * readAhead);
+    }
+    return true;
+}
+/**********************************************************/
 void Utilities::resetMaxTimeStamp()
 {
     allTimeStamps.clear();
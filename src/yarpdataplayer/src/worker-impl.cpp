@@ -33,12 +33,16 @@
 template <class T>
 int WorkerClass::sendGenericData(int part, int id)
 {
+    yarp::os::Bottle line;
+    if (!utilities->getFrame(utilities->partDetails[part], id, line)) {
+        return -1;
+    }
     yarp::os::Bottle tmp;
     if (utilities->withExtraColumn) {
-        tmp = utilities->partDetails[part].bot.get(id).asList()->tail().tail().tail();
+        tmp = line.tail().tail().tail();
     }
     else {
-        tmp = utilities->partDetails[part].bot.get(id).asList()->tail().tail();
+        tmp = line.tail().tail();
     }
 
     yarp::os::BufferedPort<T>* the_port = dynamic_cast<yarp::os::BufferedPort<T>*> (utilities->partDetails[part].outputPort);
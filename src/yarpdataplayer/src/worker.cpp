@@ -181,12 +181,16 @@ double WorkerClass::getTimeTaken()
 /**********************************************************/
 int WorkerClass::sendBottle(int part, int frame)
 {
+    Bottle line;
+    if (!utilities->getFrame(utilities->partDetails[part], frame, line)) {
+        return -1;
+    }
     Bottle tmp;
     if (utilities->withExtraColumn) {
-        tmp = utilities->partDetails[part].bot.get(frame).asList()->tail().tail().tail();
+        tmp = line.tail().tail().tail();
     }
     else {
-        tmp = utilities->partDetails[part].bot.get(frame).asList()->tail().tail();
+        tmp = line.tail().tail();
     }
 
     yarp::os::BufferedPort<Bottle>* the_port = dynamic_cast<yarp::os::BufferedPort<yarp::os::Bottle>*> (utilities->partDetails[part].outputPort);
@@ -215,12 +219,16 @@ int WorkerClass::sendImages(int part, int frame)
     string tmpPath = utilities->partDetails[part].path;
     string tmpName, tmp;
     bool fileValid = false;
+    Bottle line;
+    if (!utilities->getFrame(utilities->partDetails[part], frame, line)) {
+        return -1;
+    }
     if (utilities->withExtraColumn) {
-        tmpName = utilities->partDetails[part].bot.get(frame).asList()->tail().tail().get(1).asString();
-        tmp = utilities->partDetails[part].bot.get(frame).asList()->tail().tail().tail().tail().toString();
+        tmpName = line.tail().tail().get(1).asString();
+        tmp = line.tail().tail().tail().tail().toString();
     } else {
-        tmpName = utilities->partDetails[part].bot.get(frame).asList()->tail().tail().get(0).asString();
-        tmp = utilities->partDetails[part].bot.get(frame).asList()->tail().tail().tail().toString();
+        tmpName = line.tail().tail().get(0).asString();
+        tmp = line.tail().tail().tail().toString();
     }
 
     int code = 0;
@@ -29,6 +29,8 @@
 #include <yarp/os/ResourceFinder.h>
 #include <yarp/os/RpcServer.h>
 
+#include <thread>
+
 #if defined(YARP_HAS_EXECINFO_H) && !defined(__APPLE__) && !defined(__arm__) && !defined(__aarch64__)
 #  include <csignal>
 #  include <cstring>
@@ -146,6 +148,13 @@ bool yarprobotinterface::Module::configure(yarp::os::ResourceFinder& rf)
 
     mPriv->robot.setVerbose(verbosity);
     mPriv->robot.setAllowDeprecatedDevices(rf.check("allow-deprecated-devices"));
+    if (rf.check("parallel-open")) {
+        int threads = rf.find("parallel-open").asInt32();
+        if (threads <= 0) {
+            threads = static_cast<int>(std::thread::hardware_concurrency());
+        }
+        mPriv->robot.setParallelOpen(static_cast<unsigned int>(threads));
+    }
 
     std::string rpcPortName("/" + getName() + "/yarprobotinterface");
     mPriv->rpcPort.open(rpcPortName);
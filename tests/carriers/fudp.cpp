@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Port.h>
+#include <yarp/os/SystemClock.h>
+
+#include <yarp/sig/Image.h>
+
+#include <catch.hpp>
+#include <harness.h>
+
+#include <string>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+namespace {
+
+// Datagrams can be lost, a blocking read could wait forever
+template <typename T>
+T* timedRead(BufferedPort<T>& in, double timeout = 5.0)
+{
+    const double start = SystemClock::nowSystem();
+    while (in.getPendingReads() == 0 && SystemClock::nowSystem() - start < timeout) {
+        SystemClock::delaySystem(0.001);
+    }
+    return in.read(false);
+}
+
+} // namespace
+
+TEST_CASE("carriers::fudp", "[carriers]")
+{
+    YARP_REQUIRE_PLUGIN("fudp", "carrier");
+
+    Network::setLocalMode(true);
+
+    SECTION("small messages are received in order")
+    {
+        Port out;
+        BufferedPort<Bottle> in;
+        in.setStrict();
+        REQUIRE(out.open("/fudp/out"));
+        REQUIRE(in.open("/fudp/in"));
+        REQUIRE(Network::connect(out.getName(), in.getName(), "fudp"));
+
+        for (int i = 0; i < 20; i++) {
+            Bottle b;
+            b.addInt32(i);
+            b.addString("hello");
+            out.write(b);
+            Bottle* r = timedRead(in);
+            REQUIRE(r != nullptr);
+            CHECK(r->get(0).asInt32() == i);
+            CHECK(r->get(1).asString() == "hello");
+        }
+
+        out.close();
+        in.close();
+    }
+
+    SECTION("messages bigger than a datagram are reassembled")
+    {
+        BufferedPort<ImageOf<PixelRgb>> out;
+        BufferedPort<ImageOf<PixelRgb>> in;
+        in.setStrict();
+        REQUIRE(out.open("/fudp/out"));
+        REQUIRE(in.open("/fudp/in"));
+        REQUIRE(Network::connect(out.getName(), in.getName(), "fudp+fragment_size.1000"));
+
+        for (int i = 0; i < 10; i++) {
+            ImageOf<PixelRgb>& img = out.prepare();
+            img.resize(160, 120);
+            for (size_t x = 0; x < img.width(); x++) {
+                for (size_t y = 0; y < img.height(); y++) {
+                    img.pixel(x, y) = PixelRgb(i, x, y);
+                }
+            }
+            out.write(true);
+            ImageOf<PixelRgb>* r = timedRead(in);
+            REQUIRE(r != nullptr);
+            REQUIRE(r->width() == 160);
+            REQUIRE(r->height() == 120);
+            CHECK(r->pixel(0, 0).r == i);
+            CHECK(r->pixel(150, 100).g == 150);
+            CHECK(r->pixel(150, 100).b == 100);
+            CHECK(r->pixel(159, 119).r == i);
+        }
+
+        out.close();
+        in.close();
+    }
+
+    SECTION("lost datagrams are rebuilt from the parity")
+    {
+        Port out;
+        BufferedPort<Bottle> in;
+        in.setStrict();
+        REQUIRE(out.open("/fudp/out"));
+        REQUIRE(in.open("/fudp/in"));
+        // Groups of 4 datagrams and a parity, one datagram out of 7 is lost
+        REQUIRE(Network::connect(out.getName(), in.getName(), "fudp+fragment_size.512+fec.4+drop.7"));
+
+        for (int i = 0; i < 10; i++) {
+            Bottle b;
+            b.addInt32(i);
+            b.addString(std::string(10000 + i * 100, static_cast<char>('a' + i)));
+            out.write(b);
+            Bottle* r = timedRead(in);
+            REQUIRE(r != nullptr);
+            CHECK(r->get(0).asInt32() == i);
+            CHECK(r->get(1).asString() == b.get(1).asString());
+        }
+
+        out.close();
+        in.close();
+    }
+
+    SECTION("messages bigger than max_size are not sent")
+    {
+        Port out;
+        BufferedPort<Bottle> in;
+        in.setStrict();
+        REQUIRE(out.open("/fudp/out"));
+        REQUIRE(in.open("/fudp/in"));
+        REQUIRE(Network::connect(out.getName(), in.getName(), "fudp+fragment_size.512+max_size.4000"));
+
+        Bottle big;
+        big.addInt32(0);
+        big.addString(std::string(5000, 'x'));
+        out.write(big);
+        Bottle small;
+        small.addInt32(1);
+        small.addString(std::string(3000, 'y'));
+        out.write(small);
+        Bottle* r = timedRead(in);
+        REQUIRE(r != nullptr);
+        CHECK(r->get(0).asInt32() == 1);
+        CHECK(r->get(1).asString() == small.get(1).asString());
+
+        out.close();
+        in.close();
+    }
+
+    Network::setLocalMode(false);
+}
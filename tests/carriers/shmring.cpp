@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Port.h>
+
+#include <yarp/sig/Image.h>
+
+#include <catch.hpp>
+#include <harness.h>
+
+#include <string>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+TEST_CASE("carriers::shmring", "[carriers]")
+{
+    YARP_REQUIRE_PLUGIN("shmring", "carrier");
+
+    Network::setLocalMode(true);
+
+    SECTION("messages are received in order")
+    {
+        Port out;
+        BufferedPort<Bottle> in;
+        in.setStrict();
+        REQUIRE(out.open("/shmring/out"));
+        REQUIRE(in.open("/shmring/in"));
+        REQUIRE(Network::connect(out.getName(), in.getName(), "shmring"));
+
+        for (int i = 0; i < 100; i++) {
+            Bottle b;
+            b.addInt32(i);
+            b.addString("hello");
+            out.write(b);
+        }
+        for (int i = 0; i < 100; i++) {
+            Bottle* b = in.read();
+            REQUIRE(b != nullptr);
+            CHECK(b->get(0).asInt32() == i);
+            CHECK(b->get(1).asString() == "hello");
+        }
+
+        out.close();
+        in.close();
+    }
+
+    SECTION("messages bigger than a slot")
+    {
+        Port out;
+        BufferedPort<Bottle> in;
+        in.setStrict();
+        REQUIRE(out.open("/shmring/out"));
+        REQUIRE(in.open("/shmring/in"));
+        REQUIRE(Network::connect(out.getName(), in.getName(), "shmring+slots.4+slot_size.1024"));
+
+        for (int i = 0; i < 10; i++) {
+            Bottle b;
+            b.addInt32(i);
+            b.addString(std::string(2000 + i * 100, static_cast<char>('a' + i)));
+            out.write(b);
+            Bottle* r = in.read();
+            REQUIRE(r != nullptr);
+            CHECK(r->get(0).asInt32() == i);
+            CHECK(r->get(1).asString() == b.get(1).asString());
+        }
+
+        // Does not fit in the ring, the message is dropped
+        Bottle big;
+        big.addString(std::string(5000, 'x'));
+        out.write(big);
+        Bottle small;
+        small.addInt32(42);
+        out.write(small);
+        Bottle* r = in.read();
+        REQUIRE(r != nullptr);
+        CHECK(r->get(0).asInt32() == 42);
+
+        out.close();
+        in.close();
+    }
+
+    SECTION("several readers share the ring")
+    {
+        Port out;
+        BufferedPort<Bottle> in1;
+        BufferedPort<Bottle> in2;
+        in1.setStrict();
+        in2.setStrict();
+        REQUIRE(out.open("/shmring/out"));
+        REQUIRE(in1.open("/shmring/in1"));
+        REQUIRE(in2.open("/shmring/in2"));
+        REQUIRE(Network::connect(out.getName(), in1.getName(), "shmring"));
+        REQUIRE(Network::connect(out.getName(), in2.getName(), "shmring"));
+
+        for (int i = 0; i < 50; i++) {
+            Bottle b;
+            b.addInt32(i);
+            out.write(b);
+        }
+        for (int i = 0; i < 50; i++) {
+            Bottle* b1 = in1.read();
+            Bottle* b2 = in2.read();
+            REQUIRE(b1 != nullptr);
+            REQUIRE(b2 != nullptr);
+            CHECK(b1->get(0).asInt32() == i);
+            CHECK(b2->get(0).asInt32() == i);
+        }
+
+        // The remaining reader keeps working after a disconnection
+        REQUIRE(Network::disconnect(out.getName(), in1.getName()));
+        Bottle b;
+        b.addInt32(100);
+        out.write(b);
+        Bottle* b2 = in2.read();
+        REQUIRE(b2 != nullptr);
+        CHECK(b2->get(0).asInt32() == 100);
+
+        out.close();
+        in1.close();
+        in2.close();
+    }
+
+    SECTION("loaned images are not copied in the ring")
+    {
+        BufferedPort<ImageOf<PixelRgb>> out;
+        BufferedPort<ImageOf<PixelRgb>> in;
+        in.setStrict();
+        REQUIRE(out.open("/shmring/out"));
+        REQUIRE(in.open("/shmring/in"));
+        // The images do not fit in the ring, only their position is written
+        REQUIRE(Network::connect(out.getName(), in.getName(), "shmring+slots.4+slot_size.4096"));
+
+        for (int i = 0; i < 10; i++) {
+            ImageOf<PixelRgb>& img = out.prepare();
+            img.setLoaned(true);
+            img.resize(320, 240);
+            for (size_t x = 0; x < img.width(); x++) {
+                for (size_t y = 0; y < img.height(); y++) {
+                    img.pixel(x, y) = PixelRgb(i, x % 256, y);
+                }
+            }
+            out.write(true);
+            ImageOf<PixelRgb>* r = in.read();
+            REQUIRE(r != nullptr);
+            REQUIRE(r->width() == 320);
+            REQUIRE(r->height() == 240);
+            CHECK(r->pixel(0, 0).r == i);
+            CHECK(r->pixel(300, 200).g == 300 % 256);
+            CHECK(r->pixel(300, 200).b == 200);
+            CHECK(r->pixel(319, 239).r == i);
+        }
+
+        out.close();
+        in.close();
+    }
+
+    Network::setLocalMode(false);
+}
@@ -0,0 +1,81 @@
+#!/bin/bash
+
+# Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+# All rights reserved.
+#
+# This software may be modified and distributed under the terms of the
+# BSD-3-Clause license. See the accompanying LICENSE file for details.
+
+SCRIPT_DIR=$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )
+source $SCRIPT_DIR/test-helper.sh
+require_name_server
+
+port_name=/datadumper/$$
+dump_dir=datadumper_$$
+count=100
+
+function wait_port {
+    while ! ${YARP_BIN}/yarp exists $1 > /dev/null 2>&1; do
+        sleep 0.1
+    done
+}
+
+function expected_items {
+    for (( k=0; k<$1; k++ )); do
+        echo "$k hello (list $k) 3.5"
+    done
+}
+
+# The items of a data.log, without the sequence number and the time stamp
+function exported_items {
+    cut -d ' ' -f 3- $1/data.log
+}
+
+########################################################################
+header "Dump bottles in the binary container"
+
+rm -rf $dump_dir ${dump_dir}_truncated ${dump_dir}_corrupted
+${YARP_BIN}/yarpdatadumper --name $port_name --dir $dump_dir --overwrite --binary --rxTime &
+add_helper $!
+wait_port $port_name
+wait_port $port_name/rpc
+expected_items $count | ${YARP_BIN}/yarp write $port_name/writer $port_name
+echo quit | ${YARP_BIN}/yarp rpc $port_name/rpc
+wait_port_gone $port_name
+cleanup_helper
+test -s $dump_dir/data.bin
+
+########################################################################
+header "Export the binary container"
+
+${YARP_BIN}/yarpdatadumper --export $dump_dir
+diff <(expected_items $count) <(exported_items $dump_dir)
+
+########################################################################
+header "Export a truncated binary container"
+
+# The last item is incomplete: the others are exported, and the export fails
+mkdir ${dump_dir}_truncated
+size=$(wc -c < $dump_dir/data.bin)
+head -c $((size - 5)) $dump_dir/data.bin > ${dump_dir}_truncated/data.bin
+if ${YARP_BIN}/yarpdatadumper --export ${dump_dir}_truncated; then
+    echo "The export of a truncated file should fail"
+    exit 1
+fi
+diff <(expected_items $((count - 1))) <(exported_items ${dump_dir}_truncated)
+
+########################################################################
+header "Export a binary container with a corrupted length"
+
+# The length of the first item (after the 16 bytes of the file header) is
+# set to 2 GiB, more than the size of the file
+mkdir ${dump_dir}_corrupted
+cp $dump_dir/data.bin ${dump_dir}_corrupted/data.bin
+printf '\xff\xff\xff\x7f' | dd of=${dump_dir}_corrupted/data.bin bs=1 seek=16 conv=notrunc 2> /dev/null
+if ${YARP_BIN}/yarpdatadumper --export ${dump_dir}_corrupted; then
+    echo "The export of a corrupted file should fail"
+    exit 1
+fi
+test ! -s ${dump_dir}_corrupted/data.log
+
+rm -rf $dump_dir ${dump_dir}_truncated ${dump_dir}_corrupted
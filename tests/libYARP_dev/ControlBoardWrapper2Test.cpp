@@ -10,11 +10,16 @@
 #include <yarp/dev/PolyDriver.h>
 
 #include <yarp/os/Network.h>
+#include <yarp/os/Port.h>
+#include <yarp/os/PortReader.h>
 #include <yarp/dev/FrameGrabberInterfaces.h>
 #include <yarp/dev/ControlBoardInterfaces.h>
 #include <yarp/dev/IMultipleWrapper.h>
 
+#include <atomic>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <catch.hpp>
 #include <harness.h>
@@ -23,6 +28,35 @@ using namespace yarp::os;
 using namespace yarp::sig;
 using namespace yarp::dev;
 
+namespace {
+
+// Forwards the rpc requests to the wrapper, counting the batches
+class RpcSpy : public PortReader
+{
+public:
+    Port forward;
+    std::atomic<int> batches{0};
+
+    bool read(ConnectionReader& connection) override
+    {
+        Bottle cmd, reply;
+        if (!cmd.read(connection)) {
+            return false;
+        }
+        forward.write(cmd, reply);
+        if (cmd.get(0).asVocab() == VOCAB_BATCH && reply.get(0).asVocab() == VOCAB_BATCH) {
+            batches++;
+        }
+        ConnectionWriter* writer = connection.getWriter();
+        if (writer != nullptr) {
+            reply.write(*writer);
+        }
+        return true;
+    }
+};
+
+} // namespace
+
 TEST_CASE("dev::ControlBoardWrapper2", "[yarp::dev]")
 {
     YARP_REQUIRE_PLUGIN("group", "device");
@@ -68,4 +102,113 @@ TEST_CASE("dev::ControlBoardWrapper2", "[yarp::dev]")
         CHECK(dd.close()); // close dd reported successful
         CHECK(dd2.close()); // close dd2 reported successful
     }
+
+    SECTION("test concurrent rpc requests to the controlboardwrapper2 device")
+    {
+        PolyDriver dd;
+        Property p;
+        p.put("device","controlboardwrapper2");
+        p.put("subdevice","fakeMotor");
+        p.put("name","/motor");
+        p.put("axes",16);
+        REQUIRE(dd.open(p)); // controlboardwrapper open reported successful
+
+        PolyDriver dd2;
+        Property p2;
+        p2.put("device","remote_controlboard");
+        p2.put("remote","/motor");
+        p2.put("local","/motor/client");
+        p2.put("carrier","tcp");
+        REQUIRE(dd2.open(p2)); // remote_controlboard open reported successful
+
+        // The requests of the client go through the spy
+        RpcSpy spy;
+        Port spyPort;
+        spyPort.setReader(spy);
+        REQUIRE(spy.forward.open("/spy/rpc:o"));
+        REQUIRE(spyPort.open("/spy/rpc:i"));
+        REQUIRE(Network::connect("/spy/rpc:o", "/motor/rpc:i"));
+        REQUIRE(Network::disconnect("/motor/client/rpc:o", "/motor/rpc:i"));
+        REQUIRE(Network::connect("/motor/client/rpc:o", "/spy/rpc:i"));
+
+        IPositionControl *pos = nullptr;
+        REQUIRE(dd2.view(pos)); // interface reported
+        for (int j = 0; j < 16; j++) {
+            CHECK(pos->setRefSpeed(j, 10.0 + j));
+        }
+
+        // The requests made at the same time are sent in batches, each
+        // thread must get its own reply
+        std::atomic<int> errors{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; t++) {
+            threads.emplace_back([pos, t, &errors]() {
+                for (int i = 0; i < 50; i++) {
+                    int j = (i + t) % 16;
+                    double speed = 0.0;
+                    int axes = 0;
+                    if (!pos->getRefSpeed(j, &speed) || speed != 10.0 + j) {
+                        errors++;
+                    }
+                    if (!pos->getAxes(&axes) || axes != 16) {
+                        errors++;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        CHECK(errors == 0); // all the replies are correct
+        CHECK(spy.batches > 0); // some requests were sent in a batch
+
+        CHECK(dd2.close()); // close dd2 reported successful
+        spyPort.close();
+        spy.forward.close();
+        CHECK(dd.close()); // close dd reported successful
+    }
+
+    SECTION("test a batch of rpc requests to the controlboardwrapper2 device")
+    {
+        PolyDriver dd;
+        Property p;
+        p.put("device","controlboardwrapper2");
+        p.put("subdevice","fakeMotor");
+        p.put("name","/motor");
+        p.put("axes",16);
+        REQUIRE(dd.open(p)); // controlboardwrapper open reported successful
+
+        Port client;
+        REQUIRE(client.open("/motor/batch/rpc:o"));
+        REQUIRE(Network::connect(client.getName(), "/motor/rpc:i"));
+
+        Bottle cmd, reply;
+        cmd.addVocab(VOCAB_BATCH);
+        Bottle& axes = cmd.addList();
+        axes.addVocab(VOCAB_GET);
+        axes.addVocab(VOCAB_AXES);
+        Bottle& nested = cmd.addList();
+        nested.addVocab(VOCAB_BATCH);
+        nested.addList() = axes;
+        cmd.addInt32(42);
+        REQUIRE(client.write(cmd, reply));
+
+        // [btch] (reply1) (reply2) (reply3) [ok]
+        REQUIRE(reply.size() == 5);
+        CHECK(reply.get(0).asVocab() == VOCAB_BATCH);
+        Bottle* axesReply = reply.get(1).asList();
+        REQUIRE(axesReply != nullptr);
+        CHECK(axesReply->get(2).asInt32() == 16);
+        CHECK(axesReply->get(axesReply->size() - 1).asVocab() == VOCAB_OK);
+        Bottle* nestedReply = reply.get(2).asList();
+        REQUIRE(nestedReply != nullptr);
+        CHECK(nestedReply->get(0).asVocab() == VOCAB_FAILED); // nested batches are rejected
+        Bottle* invalidReply = reply.get(3).asList();
+        REQUIRE(invalidReply != nullptr);
+        CHECK(invalidReply->get(0).asVocab() == VOCAB_FAILED); // requests must be lists
+        CHECK(reply.get(4).asVocab() == VOCAB_OK);
+
+        client.close();
+        CHECK(dd.close()); // close dd reported successful
+    }
 }
@@ -11,9 +11,12 @@
 #include <yarp/sig/Matrix.h>
 #include <yarp/sig/Vector.h>
 #include <yarp/math/Quaternion.h>
+#include <yarp/math/FrameTransform.h>
+#include <yarp/dev/GenericVocabs.h>
 #include <yarp/dev/IFrameTransform.h>
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/os/Network.h>
+#include <yarp/os/Port.h>
 #include <yarp/os/Time.h>
 #include <yarp/math/Math.h>
 
@@ -412,6 +415,154 @@ TEST_CASE("dev::FrameTransformClientTest", "[yarp::dev]")
             CHECK(isEqual(mt1, eyemat, precision));
         }
 
+        //test 14 (transforms at a given time)
+        {
+            itf->clear();
+            yarp::os::Time::delay(0.1);
+            yarp::sig::Matrix ma(4, 4); ma.eye();
+            yarp::sig::Matrix mb(4, 4); mb.eye();
+            mb[0][3] = 1.0;
+            double t0 = yarp::os::Time::now();
+            CHECK(itf->setTransform("time_child", "time_root", ma));
+            double t1 = yarp::os::Time::now();
+            yarp::os::Time::delay(0.2);
+            double t2 = yarp::os::Time::now();
+            CHECK(itf->setTransform("time_child", "time_root", mb));
+            double t3 = yarp::os::Time::now();
+            CHECK(itf->setTransformStatic("time_static", "time_root", m1));
+            yarp::os::Time::delay(0.1);
+
+            // Between the two samples the translation is interpolated
+            yarp::sig::Matrix mt;
+            double mid = (t1 + t2) / 2;
+            CHECK(itf->getTransform("time_child", "time_root", mid, mt));
+            // The samples are stamped by the server between t0 and t1, and
+            // between t2 and t3
+            double expected_min = (mid - t1) / (t3 - t1);
+            double expected_max = (mid - t0) / (t2 - t0);
+            INFO("Interpolated translation: " << mt[0][3] << " expected in [" << expected_min << ", " << expected_max << "]");
+            CHECK(mt[0][3] >= expected_min);
+            CHECK(mt[0][3] <= expected_max);
+            CHECK(mt[1][3] == Approx(0.0));
+            CHECK(isEqual(mt.submatrix(0, 2, 0, 2), ma.submatrix(0, 2, 0, 2), precision));
+
+            // After the latest sample
+            CHECK(itf->getTransform("time_child", "time_root", yarp::os::Time::now() + 1.0, mt));
+            CHECK(isEqual(mt, mb, precision));
+
+            // Before the history
+            CHECK_FALSE(itf->getTransform("time_child", "time_root", t0 - 1.0, mt));
+
+            // A static transform has a single sample, valid at any time
+            CHECK(itf->getTransform("time_static", "time_root", t0 - 100.0, mt));
+            CHECK(isEqual(mt, m1, precision));
+            CHECK(itf->getTransform("time_static", "time_root", yarp::os::Time::now() + 100.0, mt));
+            CHECK(isEqual(mt, m1, precision));
+
+            // Both the edges of the path are looked up at the given time
+            CHECK_FALSE(itf->getTransform("time_static", "time_child", t0 - 100.0, mt));
+            CHECK(itf->getTransform("time_static", "time_child", yarp::os::Time::now() + 1.0, mt));
+            CHECK(isEqual(mt, SE3inv(mb) * m1, precision));
+        }
+
+        //test 15 (tree with more levels)
+        {
+            itf->clear();
+            yarp::os::Time::delay(0.1);
+            // tree_root -> tree_a -> tree_b -> tree_c -> tree_d
+            //                     -> tree_e -> tree_f
+            CHECK(itf->setTransformStatic("tree_a", "tree_root", m1));
+            CHECK(itf->setTransformStatic("tree_b", "tree_a", m2));
+            CHECK(itf->setTransformStatic("tree_c", "tree_b", sibiling));
+            CHECK(itf->setTransformStatic("tree_d", "tree_c", m1));
+            CHECK(itf->setTransformStatic("tree_e", "tree_a", sibiling));
+            CHECK(itf->setTransformStatic("tree_f", "tree_e", m2));
+            yarp::os::Time::delay(0.1);
+
+            yarp::sig::Matrix to_d = m1 * m2 * sibiling * m1;
+            yarp::sig::Matrix to_f = m1 * sibiling * m2;
+            yarp::sig::Matrix mt;
+            CHECK(itf->getTransform("tree_d", "tree_root", mt));
+            CHECK(isEqual(mt, to_d, precision)); // four levels down
+            CHECK(itf->getTransform("tree_root", "tree_d", mt));
+            CHECK(isEqual(mt, SE3inv(to_d), precision)); // four levels up
+
+            // Frames in different branches, through their common ancestor tree_a
+            CHECK(itf->getTransform("tree_f", "tree_d", mt));
+            CHECK(isEqual(mt, SE3inv(to_d) * to_f, precision));
+            CHECK(itf->getTransform("tree_d", "tree_f", mt));
+            CHECK(isEqual(mt, SE3inv(to_f) * to_d, precision));
+            CHECK(itf->getTransform("tree_b", "tree_e", mt));
+            CHECK(isEqual(mt, SE3inv(m1 * sibiling) * (m1 * m2), precision));
+            // An ancestor and a descendant
+            CHECK(itf->getTransform("tree_d", "tree_b", mt));
+            CHECK(isEqual(mt, sibiling * m1, precision));
+
+            // The paths are cached, a change of the topology must invalidate them
+            CHECK(itf->deleteTransform("tree_d", "tree_c"));
+            yarp::os::Time::delay(0.1);
+            CHECK_FALSE(itf->canTransform("tree_d", "tree_root"));
+            CHECK(itf->setTransformStatic("tree_d", "tree_f", m1));
+            yarp::os::Time::delay(0.1);
+            yarp::sig::Matrix to_d_moved = to_f * m1;
+            CHECK(itf->getTransform("tree_d", "tree_root", mt));
+            CHECK(isEqual(mt, to_d_moved, precision));
+            CHECK(itf->getTransform("tree_d", "tree_c", mt));
+            CHECK(isEqual(mt, SE3inv(m1 * m2 * sibiling) * to_d_moved, precision));
+            std::string parent;
+            CHECK(itf->getParent("tree_d", parent));
+            CHECK(parent == "tree_f");
+        }
+
+        //test 16 (cycle)
+        {
+            itf->clear();
+            yarp::os::Time::delay(0.1);
+            // The client refuses to close a cycle, so the transforms are
+            // sent directly to the server
+            yarp::os::Port rpc;
+            REQUIRE(rpc.open("/transformClientTest/cycle/rpc"));
+            REQUIRE(Network::connect(rpc.getName(), "/transformServer/rpc"));
+            auto setRaw = [&rpc](const std::string& src, const std::string& dst, const yarp::sig::Matrix& m)
+            {
+                yarp::math::FrameTransform tf;
+                tf.fromMatrix(m);
+                yarp::os::Bottle b;
+                yarp::os::Bottle resp;
+                b.addVocab(VOCAB_ITRANSFORM);
+                b.addVocab(VOCAB_TRANSFORM_SET);
+                b.addString(src);
+                b.addString(dst);
+                b.addFloat64(-1); // static
+                b.addFloat64(tf.translation.tX);
+                b.addFloat64(tf.translation.tY);
+                b.addFloat64(tf.translation.tZ);
+                b.addFloat64(tf.rotation.w());
+                b.addFloat64(tf.rotation.x());
+                b.addFloat64(tf.rotation.y());
+                b.addFloat64(tf.rotation.z());
+                return rpc.write(b, resp) && resp.get(0).asVocab() == VOCAB_OK;
+            };
+            CHECK(setRaw("cycle_a", "cycle_b", m1));
+            CHECK(setRaw("cycle_b", "cycle_c", m2));
+            CHECK(setRaw("cycle_c", "cycle_a", sibiling));
+            CHECK(setRaw("cycle_c", "cycle_d", m1));
+            yarp::os::Time::delay(0.1);
+
+            // The cycle is broken on one of its edges, the frames are still
+            // connected and the queries terminate
+            yarp::sig::Matrix mt;
+            CHECK(itf->canTransform("cycle_b", "cycle_a"));
+            CHECK(itf->getTransform("cycle_b", "cycle_a", mt));
+            CHECK((isEqual(mt, m1, precision) || isEqual(mt, SE3inv(m2 * sibiling), precision)));
+            CHECK(itf->canTransform("cycle_d", "cycle_a"));
+            CHECK(itf->getTransform("cycle_d", "cycle_c", mt));
+            CHECK(isEqual(mt, m1, precision));
+            CHECK_FALSE(itf->canTransform("cycle_d", "not_existing_frame"));
+
+            rpc.close();
+        }
+
         // Close devices
         CHECK(ddtransformclient.close()); // ddtransformclient successfully closed
         CHECK(ddtransformserver.close()); // ddtransformserver successfully closed
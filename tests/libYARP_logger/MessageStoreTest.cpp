@@ -0,0 +1,309 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/logger/impl/MessageStore.h>
+#include <yarp/logger/YarpLogger.h>
+
+#include <catch.hpp>
+#include <harness.h>
+
+#include <cstdio>
+#include <list>
+#include <string>
+#include <vector>
+
+#if defined(YARP_HAS_ZLIB)
+#  include <zlib.h>
+#endif
+
+using yarp::yarpLogger::LogLevelEnum;
+using yarp::yarpLogger::MessageEntry;
+using yarp::yarpLogger::impl::MessageSpill;
+using yarp::yarpLogger::impl::MessageStore;
+using yarp::yarpLogger::impl::StringPool;
+
+namespace {
+
+MessageEntry makeEntry(int i, LogLevelEnum level = yarp::yarpLogger::LOGLEVEL_INFO)
+{
+    MessageEntry entry;
+    entry.level = level;
+    entry.text = "message " + std::to_string(i);
+    entry.filename = "file.cpp";
+    entry.line = static_cast<unsigned int>(i);
+    entry.function = "function";
+    entry.hostname = "host";
+    entry.cmd = "cmd";
+    entry.args = "";
+    entry.pid = 42;
+    entry.thread_id = 1;
+    entry.component = "component";
+    entry.systemtime = i;
+    entry.networktime = i;
+    entry.externaltime = 0.0;
+    entry.yarprun_timestamp = std::to_string(i);
+    entry.local_timestamp = std::to_string(i);
+    return entry;
+}
+
+// The levels of the test messages: every third message is an error
+LogLevelEnum levelOf(int i)
+{
+    return (i % 3 == 0) ? yarp::yarpLogger::LOGLEVEL_ERROR : yarp::yarpLogger::LOGLEVEL_INFO;
+}
+
+std::vector<std::string> texts(const std::list<MessageEntry>& messages)
+{
+    std::vector<std::string> ret;
+    for (const auto& m : messages) {
+        ret.push_back(m.text);
+    }
+    return ret;
+}
+
+std::vector<std::string> readLines(const std::string& filename)
+{
+    std::vector<std::string> lines;
+    char buf[1024];
+#if defined(YARP_HAS_ZLIB)
+    gzFile in = gzopen(filename.c_str(), "rb");
+    if (in == nullptr) {
+        return lines;
+    }
+    while (gzgets(in, buf, sizeof(buf)) != nullptr) {
+        lines.emplace_back(buf);
+    }
+    gzclose(in);
+#else
+    FILE* in = fopen(filename.c_str(), "r");
+    if (in == nullptr) {
+        return lines;
+    }
+    while (fgets(buf, sizeof(buf), in) != nullptr) {
+        lines.emplace_back(buf);
+    }
+    fclose(in);
+#endif
+    return lines;
+}
+
+} // namespace
+
+TEST_CASE("logger::MessageStoreTest", "[yarp::logger]")
+{
+    StringPool pool;
+
+    SECTION("drop the oldest segment at max size")
+    {
+        // 16 messages, dropped 2 at a time
+        MessageStore store(16);
+        for (int i = 0; i < 16; i++) {
+            store.append(makeEntry(i), pool);
+        }
+        CHECK(store.size() == 16);
+        CHECK(store.begin() == 0);
+        CHECK(store.end() == 16);
+
+        store.append(makeEntry(16), pool);
+        CHECK(store.size() == 15);
+        CHECK(store.begin() == 2);
+        CHECK(store.end() == 17);
+
+        std::uint64_t cursor = 0;
+        std::list<MessageEntry> messages;
+        store.get(cursor, messages);
+        CHECK(cursor == 17);
+        REQUIRE(messages.size() == 15);
+        CHECK(messages.front().text == "message 2");
+        CHECK(messages.back().text == "message 16");
+        CHECK(messages.front().filename == "file.cpp");
+        CHECK(messages.front().line == 2);
+
+        // The strings are shared by all the messages
+        CHECK(pool.size() == 6);
+    }
+
+    SECTION("no limit when the max size is disabled")
+    {
+        MessageStore store(4, false);
+        for (int i = 0; i < 100; i++) {
+            store.append(makeEntry(i), pool);
+        }
+        CHECK(store.size() == 100);
+        CHECK(store.begin() == 0);
+
+        store.setMaxSizeEnabled(true);
+        CHECK(store.size() <= 4);
+        CHECK(store.end() == 100);
+    }
+
+    SECTION("a cursor skips the dropped messages")
+    {
+        MessageStore store(16);
+        std::uint64_t cursor = 0;
+        std::list<MessageEntry> messages;
+
+        for (int i = 0; i < 5; i++) {
+            store.append(makeEntry(i), pool);
+        }
+        store.get(cursor, messages);
+        CHECK(cursor == 5);
+        CHECK(messages.size() == 5);
+
+        // Only the new messages are returned
+        messages.clear();
+        store.append(makeEntry(5), pool);
+        store.get(cursor, messages);
+        CHECK(cursor == 6);
+        CHECK(texts(messages) == std::vector<std::string>{"message 5"});
+
+        // The reader falls behind: messages 6..39 are received, and the
+        // ones up to 23 are dropped before it reads them again
+        for (int i = 6; i < 40; i++) {
+            store.append(makeEntry(i), pool);
+        }
+        REQUIRE(store.begin() > cursor);
+        messages.clear();
+        store.get(cursor, messages);
+        CHECK(cursor == 40);
+        REQUIRE(messages.size() == store.size());
+        CHECK(messages.front().text == "message " + std::to_string(store.begin()));
+        CHECK(messages.back().text == "message 39");
+
+        // Nothing new
+        messages.clear();
+        store.get(cursor, messages);
+        CHECK(cursor == 40);
+        CHECK(messages.empty());
+    }
+
+    SECTION("get by level after a drop")
+    {
+        MessageStore store(16);
+        std::uint64_t cursor = 0;
+        std::list<MessageEntry> messages;
+
+        for (int i = 0; i < 8; i++) {
+            store.append(makeEntry(i, levelOf(i)), pool);
+        }
+        store.getByLevel(yarp::yarpLogger::LOGLEVEL_ERROR, cursor, messages);
+        CHECK(cursor == 8);
+        CHECK(texts(messages) == (std::vector<std::string>{"message 0", "message 3", "message 6"}));
+
+        for (int i = 8; i < 30; i++) {
+            store.append(makeEntry(i, levelOf(i)), pool);
+        }
+        REQUIRE(store.begin() > cursor);
+
+        messages.clear();
+        store.getByLevel(yarp::yarpLogger::LOGLEVEL_ERROR, cursor, messages);
+        CHECK(cursor == 30);
+        std::vector<std::string> expected;
+        for (auto i = static_cast<int>(store.begin()); i < 30; i++) {
+            if (levelOf(i) == yarp::yarpLogger::LOGLEVEL_ERROR) {
+                expected.push_back("message " + std::to_string(i));
+            }
+        }
+        CHECK(texts(messages) == expected);
+        for (const auto& m : messages) {
+            CHECK(m.level == yarp::yarpLogger::LOGLEVEL_ERROR);
+        }
+
+        // A cursor in the middle of a segment
+        cursor = 27;
+        messages.clear();
+        store.getByLevel(yarp::yarpLogger::LOGLEVEL_INFO, cursor, messages);
+        CHECK(texts(messages) == (std::vector<std::string>{"message 28", "message 29"}));
+
+        // An invalid level only moves the cursor
+        cursor = 0;
+        messages.clear();
+        store.getByLevel(MessageStore::levels, cursor, messages);
+        CHECK(cursor == 30);
+        CHECK(messages.empty());
+    }
+
+    SECTION("shrink the max size")
+    {
+        MessageStore store(64);
+        for (int i = 0; i < 64; i++) {
+            store.append(makeEntry(i), pool);
+        }
+        CHECK(store.size() == 64);
+
+        store.setMaxSize(10);
+        CHECK(store.getMaxSize() == 10);
+        CHECK(store.size() <= 10);
+        CHECK(store.end() == 64);
+
+        std::uint64_t cursor = 0;
+        std::list<MessageEntry> messages;
+        store.get(cursor, messages);
+        REQUIRE(messages.size() == store.size());
+        CHECK(messages.back().text == "message 63");
+
+        // The new messages use the new size
+        for (int i = 64; i < 100; i++) {
+            store.append(makeEntry(i), pool);
+            CHECK(store.size() <= 10);
+        }
+
+        // A store with no room drops everything
+        store.setMaxSize(0);
+        CHECK(store.size() == 0);
+        store.append(makeEntry(100), pool);
+        CHECK(store.size() == 0);
+        CHECK(store.begin() == store.end());
+
+        store.clear();
+        CHECK(store.begin() == 0);
+        CHECK(store.end() == 0);
+    }
+
+    SECTION("spill the dropped messages")
+    {
+        const std::string filename = "_yarp_logger_spill.log";
+        std::remove(filename.c_str());
+
+        MessageSpill spill;
+        CHECK_FALSE(spill.isOpen());
+        REQUIRE(spill.open(filename));
+        CHECK(spill.isOpen());
+        CHECK(spill.getFilename() == filename);
+
+        MessageStore store(16);
+        store.setSpill(&spill, "/source");
+        for (int i = 0; i < 20; i++) {
+            store.append(makeEntry(i, levelOf(i)), pool);
+        }
+        const auto dropped = static_cast<size_t>(store.begin());
+        CHECK(dropped == 4);
+
+        // Messages dropped without a spill file are lost
+        store.setSpill(nullptr, "");
+        store.setMaxSize(8);
+        spill.close();
+        CHECK_FALSE(spill.isOpen());
+
+        auto lines = readLines(filename);
+        REQUIRE(lines.size() == dropped);
+        for (size_t i = 0; i < dropped; i++) {
+            auto entry = makeEntry(static_cast<int>(i), levelOf(static_cast<int>(i)));
+            CHECK(lines[i] == "/source " + entry.yarprun_timestamp + " " + entry.local_timestamp + " " + entry.level.toString() + " " + entry.text + " \n");
+        }
+
+        // Opening the file again appends to it
+        REQUIRE(spill.open(filename));
+        store.setSpill(&spill, "/source");
+        store.setMaxSize(2);
+        spill.close();
+        CHECK(readLines(filename).size() > dropped);
+
+        std::remove(filename.c_str());
+    }
+}
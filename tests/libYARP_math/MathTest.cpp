@@ -701,6 +701,21 @@ TEST_CASE("math::MathTest", "[yarp::math]")
         CHECK_EQUAL(vz_out, vz); // check toAxisAngle
 
         INFO( string("check toString() method: ") + q1.toString());
+
+        Quaternion q_start;
+        Quaternion q_end;
+        Quaternion q_half;
+        Vector vz2(4);
+        vz2[0] = 0; vz2[1] = 0; vz2[2] = 1; vz2[3] = M_PI / 2;
+        Vector vz4(4);
+        vz4[0] = 0; vz4[1] = 0; vz4[2] = 1; vz4[3] = M_PI / 4;
+        q_end.fromAxisAngle(vz2);
+        q_half.fromAxisAngle(vz4);
+        CHECK_EQUAL(Quaternion::slerp(q_start, q_end, 0.0).toVector(), q_start.toVector()); // check slerp at t = 0
+        CHECK_EQUAL(Quaternion::slerp(q_start, q_end, 1.0).toVector(), q_end.toVector()); // check slerp at t = 1
+        CHECK_EQUAL(Quaternion::slerp(q_start, q_end, 0.5).toVector(), q_half.toVector()); // check slerp at t = 0.5
+        Quaternion q_neg(-q_end.x(), -q_end.y(), -q_end.z(), -q_end.w());
+        CHECK_EQUAL(Quaternion::slerp(q_start, q_neg, 0.5).toVector(), q_half.toVector()); // check slerp takes the shortest arc
     }
 
     SECTION("check Matrix concatenations")
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/BottleView.h>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/DummyConnector.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Port.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/Time.h>
+#include <yarp/os/Vocab.h>
+
+#include <catch.hpp>
+#include <harness.h>
+
+#include <cstring>
+
+using namespace yarp::os;
+
+namespace {
+
+Bottle makeSample()
+{
+    Bottle b;
+    b.addInt32(42);
+    b.addFloat64(3.5);
+    b.addString("hello");
+    b.addVocab(yarp::os::createVocab('s', 'e', 't'));
+    b.addInt8(-3);
+    b.addInt64(1234567890123LL);
+    Bottle& pos = b.addList();
+    pos.addString("pos");
+    pos.addFloat64(1.5);
+    Bottle& values = b.addList();
+    values.addFloat64(1.0);
+    values.addFloat64(2.0);
+    values.addFloat64(3.0);
+    b.addString("speed");
+    b.addInt32(7);
+    return b;
+}
+
+void checkSample(const BottleView& view)
+{
+    REQUIRE(view.isValid());
+    REQUIRE(view.size() == 10);
+    CHECK(view.get(0).isInt32());
+    CHECK(view.get(0).asInt32() == 42);
+    CHECK(view.get(0).asFloat64() == 42.0);
+    CHECK(view.get(1).isFloat64());
+    CHECK(view.get(1).asFloat64() == 3.5);
+    CHECK(view.get(2).isString());
+    CHECK(view.get(2).asString() == "hello");
+    CHECK(view.get(3).isVocab());
+    CHECK(view.get(3).asVocab() == yarp::os::createVocab('s', 'e', 't'));
+    CHECK(view.get(4).asInt8() == -3);
+    CHECK(view.get(5).asInt64() == 1234567890123LL);
+    CHECK(view.get(6).isList());
+    CHECK(view.get(6).asList().size() == 2);
+    CHECK(view.get(6).asList().get(1).asFloat64() == 1.5);
+    BottleView values = view.get(7).asList();
+    REQUIRE(values.size() == 3);
+    CHECK(values.get(2).asFloat64() == 3.0);
+    CHECK(view.get(10).isNull());
+    CHECK(view.get(1).asString().empty());
+    CHECK(view.get(2).asInt32() == 0);
+
+    CHECK(view.find("pos").asFloat64() == 1.5);
+    CHECK(view.find("speed").asInt32() == 7);
+    CHECK(view.check("speed"));
+    CHECK_FALSE(view.check("missing"));
+    CHECK(view.find("missing").isNull());
+}
+
+} // namespace
+
+
+TEST_CASE("os::BottleViewTest", "[yarp::os]")
+{
+    SECTION("reading from a connection")
+    {
+        Bottle b = makeSample();
+        DummyConnector con;
+        b.write(con.getWriter());
+        BottleView view;
+        CHECK(view.read(con.getReader()));
+        checkSample(view);
+        CHECK(view.toString() == b.toString());
+    }
+
+    SECTION("reading in text mode")
+    {
+        Bottle b = makeSample();
+        DummyConnector con;
+        con.setTextMode(true);
+        b.write(con.getWriter());
+        BottleView view;
+        CHECK(view.read(con.getReader()));
+        checkSample(view);
+    }
+
+    SECTION("viewing memory without copying")
+    {
+        Bottle b = makeSample();
+        size_t len = 0;
+        const char* bin = b.toBinary(&len);
+        BottleView view;
+        CHECK(view.fromBinary(bin, len));
+        checkSample(view);
+        const char* str = view.get(2).asBlob();
+        CHECK(str >= bin);
+        CHECK(str < bin + len);
+        CHECK(view.get(2).asBlobLength() == 5);
+        CHECK(std::memcmp(str, "hello", 5) == 0);
+    }
+
+    SECTION("rejecting invalid data")
+    {
+        Bottle b = makeSample();
+        size_t len = 0;
+        const char* bin = b.toBinary(&len);
+        BottleView view;
+        CHECK_FALSE(view.fromBinary(bin, len - 1));
+        CHECK_FALSE(view.isValid());
+        CHECK(view.size() == 0);
+        CHECK(view.get(0).isNull());
+
+        DummyConnector con;
+        con.getWriter().appendInt32(BOTTLE_TAG_LIST);
+        con.getWriter().appendInt32(1);
+        con.getWriter().appendInt32(BOTTLE_TAG_STRING);
+        con.getWriter().appendInt32(1000);
+        CHECK_FALSE(view.read(con.getReader()));
+    }
+
+    SECTION("writing back and copying")
+    {
+        Bottle b = makeSample();
+        DummyConnector con;
+        b.write(con.getWriter());
+        BottleView view;
+        REQUIRE(view.read(con.getReader()));
+
+        BottleView copy(view);
+        checkSample(copy);
+
+        Bottle b2;
+        CHECK(b2.read(view));
+        CHECK(b2.toString() == b.toString());
+
+        Bottle b3;
+        CHECK(b3.read(view.get(7).asList()));
+        CHECK(b3.toString() == "1.0 2.0 3.0");
+    }
+
+    SECTION("dictionaries")
+    {
+        Bottle b;
+        Property& p = b.addDict();
+        p.put("x", 10);
+        p.put("y", "text");
+        DummyConnector con;
+        b.write(con.getWriter());
+        BottleView view;
+        REQUIRE(view.read(con.getReader()));
+        REQUIRE(view.size() == 1);
+        CHECK(view.get(0).isDict());
+        BottleView dict = view.get(0).asList();
+        CHECK(dict.find("x").asInt32() == 10);
+        CHECK(dict.find("y").asString() == "text");
+    }
+
+    SECTION("reading from a port")
+    {
+        NetworkBase::setLocalMode(true);
+        Port out;
+        BufferedPort<BottleView> in;
+        REQUIRE(out.open("/bottleview/out"));
+        REQUIRE(in.open("/bottleview/in"));
+        REQUIRE(NetworkBase::connect("/bottleview/out", "/bottleview/in"));
+        Bottle b = makeSample();
+        out.write(b);
+        BottleView* view = in.read();
+        REQUIRE(view != nullptr);
+        checkSample(*view);
+        out.close();
+        in.close();
+        NetworkBase::setLocalMode(false);
+    }
+}
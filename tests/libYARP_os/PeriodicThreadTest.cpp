@@ -15,6 +15,7 @@
 #endif // YARP_NO_DEPRECATED
 
 #include <yarp/os/impl/NameServer.h>
+#include <yarp/os/impl/PeriodicThreadExecutor.h>
 #include <yarp/os/Network.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/Clock.h>
@@ -23,6 +24,10 @@
 #include <catch.hpp>
 #include <harness.h>
 
+#include <cmath>
+#include <memory>
+#include <vector>
+
 using namespace yarp::os;
 using namespace yarp::os::impl;
 
@@ -247,6 +252,29 @@ public:
     }
 };
 
+// Enables the executor, and restores the previous state even when a
+// REQUIRE fails, so that the other tests use dedicated threads again
+class ExecutorEnabler
+{
+public:
+    ExecutorEnabler() :
+            wasEnabled(PeriodicThreadExecutor::isEnabled())
+    {
+        PeriodicThreadExecutor::setEnabled(true);
+    }
+
+    ~ExecutorEnabler()
+    {
+        PeriodicThreadExecutor::setEnabled(wasEnabled);
+    }
+
+    ExecutorEnabler(const ExecutorEnabler&) = delete;
+    ExecutorEnabler& operator=(const ExecutorEnabler&) = delete;
+
+private:
+    bool wasEnabled;
+};
+
 double test(double period, double delay)
 {
     double estPeriod=0;
@@ -421,3 +449,87 @@ TEST_CASE("os::PeriodicThreadTest", "[yarp::os]")
         }
     }
 };
+
+TEST_CASE("os::PeriodicThreadTest::executor", "[yarp::os]")
+{
+#if defined(DISABLE_FAILING_TESTS)
+    YARP_SKIP_TEST("Skipping failing tests")
+#endif
+
+    ExecutorEnabler enabler;
+    PeriodicThreadExecutor& executor = PeriodicThreadExecutor::getInstance();
+
+    SECTION("many threads share the workers")
+    {
+        constexpr size_t n = 50;
+        constexpr double period = 0.010;
+        std::vector<std::unique_ptr<PeriodicThread5>> threads;
+        for (size_t i = 0; i < n; i++) {
+            threads.emplace_back(new PeriodicThread5(period));
+            REQUIRE(threads.back()->start());
+        }
+        CHECK(executor.getTaskCount() == n);
+        SystemClock::delaySystem(1.0);
+
+        for (auto& t : threads) {
+            CHECK(t->isRunning());
+            CHECK(t->count > 50);
+            CHECK(t->getIterations() > 50);
+            double av;
+            double std;
+            t->getEstimatedPeriod(av, std);
+            if (std::fabs(av - period) > period * 0.1) {
+                WARN("Estimated period " << av << " NOT within range of 10%");
+            }
+            CHECK(t->getEstimatedUsed() < period);
+            t->stop();
+            CHECK(!t->isRunning());
+        }
+        CHECK(executor.getTaskCount() == 0);
+        CHECK(executor.getWorkerCount() > 0);
+    }
+
+    SECTION("checking init failure/success notification")
+    {
+        PeriodicThread2 t(0.200);
+        t.threadWillFail(false);
+        t.start();
+        CHECK(t.isRunning());
+        CHECK(t.state == 0);
+        t.stop();
+        CHECK(!t.isRunning());
+        CHECK(t.state == 1);
+
+        t.threadWillFail(true);
+        CHECK(!t.start());
+        CHECK(!t.isRunning());
+        CHECK(t.state == -1);
+    }
+
+    SECTION("testing askToStop() from run()")
+    {
+        PeriodicThread4 thread(0.010);
+        thread.start();
+        for (int i = 0; i < 20 && thread.isRunning(); i++) {
+            SystemClock::delaySystem(0.1);
+        }
+        CHECK(!thread.isRunning());
+        CHECK(thread.count == 0);
+        thread.stop();
+    }
+
+    SECTION("testing start() askForStop() start() sequence...")
+    {
+        AskForStopThread test;
+        int ct = 0;
+        while (ct < 10) {
+            if (!test.isRunning()) {
+                test.start();
+                CHECK(test.isRunning());
+                test.done = true;
+                ct++;
+            }
+        }
+        test.stop();
+    }
+}
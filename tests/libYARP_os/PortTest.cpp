@@ -34,6 +34,8 @@
 
 #include <yarp/companion/impl/Companion.h>
 
+#include <atomic>
+
 #include <catch.hpp>
 #include <harness.h>
 
@@ -244,15 +246,20 @@ public:
     int ct;
     int oct;
     int ict;
+    size_t dropped;
+    size_t conflated;
 
     MyReport() {
         ict = oct = ct = 0;
+        dropped = conflated = 0;
     }
 
     virtual void report(const PortInfo& info) override {
         if (info.tag == PortInfo::PORTINFO_CONNECTION) {
             if (info.incoming == false) {
                 oct++;
+                dropped += info.dropped;
+                conflated += info.conflated;
             } else {
                 ict++;
             }
@@ -261,6 +268,25 @@ public:
     }
 };
 
+class SlowReader : public PortReader
+{
+public:
+    std::atomic<int> count {0};
+    std::atomic<int> last {-1};
+    double delay {0.0};
+
+    bool read(ConnectionReader& connection) override {
+        Bottle b;
+        if (!b.read(connection)) {
+            return false;
+        }
+        last = b.get(0).asInt32();
+        count++;
+        Time::delay(delay);
+        return true;
+    }
+};
+
 class WriteReader : public Thread
 {
 public:
@@ -1037,6 +1063,67 @@ TEST_CASE("os::PortTest", "[yarp::os]")
         p2.close();
     }
 
+    SECTION("check latest-only output policy with a slow reader")
+    {
+        Port p1;
+        Port p2;
+        SlowReader slow;
+        slow.delay = 0.05;
+        p2.setReader(slow);
+        p1.open("/foo");
+        p2.open("/bar");
+        Network::connect("/foo", "/bar", "tcp+qos.latest");
+        Network::sync("/foo");
+        Network::sync("/bar");
+        double start = Time::now();
+        for (int i = 0; i < 20; i++) {
+            Bottle b;
+            b.addInt32(i);
+            p1.write(b);
+        }
+        CHECK(Time::now() - start < 0.5); // the writer did not wait for the reader
+        for (int i = 0; i < 100 && slow.last != 19; i++) {
+            Time::delay(0.02);
+        }
+        CHECK(slow.last == 19); // the latest message is always sent
+        CHECK(slow.count < 20);
+        MyReport report;
+        p1.getReport(report);
+        CHECK(report.conflated > 0);
+        CHECK(report.conflated + slow.count == 20);
+        CHECK(report.dropped == 0);
+        p1.close();
+        p2.close();
+    }
+
+    SECTION("check max-rate output policy")
+    {
+        Port p1;
+        Port p2;
+        SlowReader reader;
+        p2.setReader(reader);
+        p1.open("/foo");
+        p2.open("/bar");
+        Network::connect("/foo", "/bar", "tcp+rate.10");
+        Network::sync("/foo");
+        Network::sync("/bar");
+        for (int i = 0; i < 20; i++) {
+            Bottle b;
+            b.addInt32(i);
+            p1.write(b);
+            Time::delay(0.01);
+        }
+        Time::delay(0.2);
+        CHECK(reader.count > 0);
+        CHECK(reader.count < 10);
+        MyReport report;
+        p1.getReport(report);
+        CHECK(report.dropped > 10);
+        CHECK(report.dropped + reader.count == 20);
+        p1.close();
+        p2.close();
+    }
+
     SECTION("check port status report with rpc client (test 1)")
     {
         RpcClient p1;
@@ -10,9 +10,13 @@
 
 #include <yarp/os/impl/BottleImpl.h>
 
+#include <yarp/conf/environment.h>
+
 #include <yarp/os/ManagedBytes.h>
 #include <yarp/os/Vocab.h>
 
+#include <set>
+
 #include <catch.hpp>
 #include <harness.h>
 
@@ -101,4 +105,28 @@ TEST_CASE("os::BottleImplTest", "[yarp::os::impl]")
         CHECK(!BottleImpl::isComplete("(1 2 3"));
         CHECK(BottleImpl::isComplete("(1 2 3)"));
     }
+
+    SECTION("testing storage reuse")
+    {
+        BottleImpl bot;
+        for (int i = 0; i < 100; i++) {
+            bot.addFloat64(i);
+        }
+        std::set<const void*> items;
+        for (size_t i = 0; i < bot.size(); i++) {
+            items.insert(&bot.get(i));
+        }
+        bot.clear();
+        for (int i = 0; i < 100; i++) {
+            bot.addFloat64(i);
+        }
+        size_t reused = 0;
+        for (size_t i = 0; i < bot.size(); i++) {
+            reused += items.count(&bot.get(i));
+        }
+        if (yarp::conf::environment::getEnvironment("YARP_BOTTLE_POOL") != "0") {
+            CHECK(reused == bot.size()); // "items reuse the storage released by clear()"
+        }
+        CHECK(bot.get(99).asFloat64() == 99.0);
+    }
 }
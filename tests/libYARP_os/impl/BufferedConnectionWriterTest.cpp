@@ -26,6 +26,22 @@ typedef PortablePair<PortablePair<PortablePair<Bottle, ImageOf<PixelRgb> >,
                                   PortablePair<ImageOf<PixelRgb>, Stamp> >,
                      Bottle> Monster;
 
+namespace {
+class BlockCountingStream : public StringOutputStream
+{
+public:
+    size_t calls {0};
+    size_t blocks {0};
+
+    void writeBlocks(const Bytes* b, size_t count) override
+    {
+        calls++;
+        blocks += count;
+        StringOutputStream::writeBlocks(b, count);
+    }
+};
+} // namespace
+
 TEST_CASE("os::impl::BufferedConnectionWriterTest", "[yarp::os][yarp::os::impl]")
 {
 
@@ -145,4 +161,19 @@ TEST_CASE("os::impl::BufferedConnectionWriterTest", "[yarp::os][yarp::os::impl]"
             INFO("pool size of " << Bottle::toString(pool_sizes[i]) << " had " << Bottle::toString(bbr.bufferCount()) << " buffers");
         }
     }
+
+    SECTION("test writing all the buffers at once")
+    {
+        BlockCountingStream sos;
+        BufferedConnectionWriter bbr;
+        bbr.reset(false);
+        ImageOf<PixelRgb> img;
+        img.resize(32, 24);
+        img.zero();
+        img.write(bbr);
+        bbr.write(sos);
+        CHECK(sos.calls == 1); // a single call for the whole message
+        CHECK(sos.blocks > 1); // header and external image data
+        CHECK(sos.toString().length() == bbr.dataSize());
+    }
 }
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/LogRing.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os::impl;
+
+TEST_CASE("os::impl::LogRingTest", "[yarp::os][yarp::os::impl]")
+{
+    SECTION("messages are popped in order")
+    {
+        LogRing ring(4);
+        CHECK(ring.capacity() == 4);
+        std::string message;
+        CHECK_FALSE(ring.pop(message));
+        CHECK(ring.push("a"));
+        CHECK(ring.push("b"));
+        CHECK(ring.size() == 2);
+        REQUIRE(ring.pop(message));
+        CHECK(message == "a");
+        REQUIRE(ring.pop(message));
+        CHECK(message == "b");
+        CHECK_FALSE(ring.pop(message));
+        CHECK(ring.takeDropped() == 0);
+    }
+
+    SECTION("the oldest messages are dropped")
+    {
+        LogRing ring(3);
+        for (int i = 0; i < 6; i++) {
+            ring.push(std::to_string(i));
+        }
+        CHECK(ring.takeDropped() == 2);
+        CHECK(ring.takeDropped() == 0);
+        std::string message;
+        REQUIRE(ring.pop(message));
+        CHECK(message == "2");
+    }
+
+    SECTION("the newest messages are dropped")
+    {
+        LogRing ring(4, LogRing::OverflowPolicy::DropNewest);
+        for (int i = 0; i < 6; i++) {
+            ring.push(std::to_string(i));
+        }
+        CHECK(ring.takeDropped() == 2);
+        std::string message;
+        REQUIRE(ring.pop(message));
+        CHECK(message == "0");
+    }
+
+    SECTION("many threads push concurrently")
+    {
+        constexpr int producers = 4;
+        constexpr int count = 10000;
+        LogRing ring(64);
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&ring, p]() {
+                for (int i = 0; i < count; i++) {
+                    ring.push(std::to_string(p) + " " + std::to_string(i));
+                }
+            });
+        }
+
+        // Each producer's messages must be received in order
+        std::vector<int> last(producers, -1);
+        size_t received = 0;
+        bool ordered = true;
+        auto receive = [&]() {
+            std::string message;
+            while (ring.pop(message)) {
+                int p = std::stoi(message);
+                int i = std::stoi(message.substr(message.find(' ') + 1));
+                ordered = ordered && (i > last[p]);
+                last[p] = i;
+                received++;
+            }
+        };
+        std::atomic<bool> running {true};
+        std::thread consumer([&]() {
+            while (running) {
+                receive();
+            }
+        });
+        for (auto& t : threads) {
+            t.join();
+        }
+        running = false;
+        consumer.join();
+        receive();
+
+        CHECK(ordered);
+        CHECK(received + ring.takeDropped() == producers * count);
+    }
+
+    SECTION("a full ring popped by many threads never blocks a push")
+    {
+        // With a tiny ring, the pushers often find the slot they freed busy
+        // or refilled by another thread, and give up on the new message
+        constexpr int producers = 4;
+        constexpr int consumers = 4;
+        constexpr int count = 20000;
+        LogRing ring(2);
+        std::atomic<bool> running {true};
+        std::atomic<size_t> received {0};
+        std::vector<std::thread> threads;
+        for (int c = 0; c < consumers; c++) {
+            threads.emplace_back([&]() {
+                std::string message;
+                while (running) {
+                    if (ring.pop(message)) {
+                        received++;
+                    }
+                }
+            });
+        }
+        std::vector<std::thread> pushers;
+        for (int p = 0; p < producers; p++) {
+            pushers.emplace_back([&ring]() {
+                for (int i = 0; i < count; i++) {
+                    ring.push(std::to_string(i));
+                }
+            });
+        }
+        for (auto& t : pushers) {
+            t.join();
+        }
+        running = false;
+        for (auto& t : threads) {
+            t.join();
+        }
+        std::string message;
+        while (ring.pop(message)) {
+            received++;
+        }
+
+        CHECK(received + ring.takeDropped() == producers * count);
+    }
+}
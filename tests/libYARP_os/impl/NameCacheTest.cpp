@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/NameCache.h>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/os/Vocab.h>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+using namespace yarp::os::impl;
+
+TEST_CASE("os::impl::NameCacheTest", "[yarp::os][yarp::os::impl]")
+{
+    const std::string server = "tcp://127.0.0.1:10000/";
+    Contact address("/foo", "tcp", "127.0.0.1", 10010);
+
+    NameCache cache;
+    cache.setTimeout(60, 60);
+
+    SECTION("addresses are cached")
+    {
+        Contact c;
+        CHECK_FALSE(cache.lookup(server, "/foo", c));
+        cache.store(server, "/foo", address);
+        REQUIRE(cache.lookup(server, "/foo", c));
+        CHECK(c.isValid());
+        CHECK(c.getPort() == 10010);
+        CHECK(c.getRegName() == "/foo");
+        CHECK(cache.getHits() == 1);
+        CHECK(cache.getMisses() == 1);
+
+        // another name server
+        CHECK_FALSE(cache.lookup("tcp://127.0.0.1:10001/", "/foo", c));
+        CHECK(cache.getMisses() == 2);
+    }
+
+    SECTION("unregistered names are cached")
+    {
+        Contact c = address;
+        cache.store(server, "/bar", Contact());
+        REQUIRE(cache.lookup(server, "/bar", c));
+        CHECK_FALSE(c.isValid());
+    }
+
+    SECTION("entries expire")
+    {
+        cache.setTimeout(60, 0.01);
+        cache.store(server, "/foo", address);
+        cache.store(server, "/bar", Contact());
+        SystemClock::delaySystem(0.05);
+        Contact c;
+        CHECK(cache.lookup(server, "/foo", c));
+        CHECK_FALSE(cache.lookup(server, "/bar", c));
+    }
+
+    SECTION("entries are invalidated")
+    {
+        cache.store(server, "/foo", address);
+        cache.store(server, "/bar", address);
+        CHECK(cache.invalidate("/foo"));
+        CHECK_FALSE(cache.invalidate("/foo"));
+        CHECK(cache.getInvalidations() == 1);
+
+        Bottle event;
+        event.addVocab(createVocab('d', 'e', 'l'));
+        event.addString("/bar");
+        cache.onEvent(event);
+        CHECK(cache.getInvalidations() == 2);
+        CHECK(cache.size() == 0);
+    }
+
+    SECTION("the cache can be disabled")
+    {
+        cache.setTimeout(0, 0);
+        cache.store(server, "/foo", address);
+        Contact c;
+        CHECK_FALSE(cache.lookup(server, "/foo", c));
+        CHECK(cache.size() == 0);
+    }
+}
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/PluginIndex.h>
+
+#include <yarp/conf/environment.h>
+#include <yarp/conf/filesystem.h>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Os.h>
+
+#include <cstdio>
+#include <string>
+
+#if defined(_WIN32)
+#  include <sys/utime.h>
+#else
+#  include <utime.h>
+#endif
+
+#include <catch.hpp>
+#include <harness.h>
+
+using yarp::os::Bottle;
+using yarp::os::impl::PluginIndex;
+
+namespace {
+
+const std::string slash = std::string{yarp::conf::filesystem::preferred_separator};
+
+class EnvironmentGuard
+{
+public:
+    explicit EnvironmentGuard(const std::string& key) :
+            key(key)
+    {
+        value = yarp::conf::environment::getEnvironment(key.c_str(), &found);
+    }
+
+    ~EnvironmentGuard()
+    {
+        if (found) {
+            yarp::conf::environment::setEnvironment(key, value);
+        } else {
+            yarp::conf::environment::unsetEnvironment(key);
+        }
+    }
+
+    EnvironmentGuard(const EnvironmentGuard&) = delete;
+    EnvironmentGuard& operator=(const EnvironmentGuard&) = delete;
+
+private:
+    std::string key;
+    std::string value;
+    bool found {false};
+};
+
+std::string readFile(const std::string& fname)
+{
+    std::string txt;
+    FILE* fin = fopen(fname.c_str(), "r");
+    if (fin == nullptr) {
+        return txt;
+    }
+    char buf[1024];
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), fin)) > 0) {
+        txt.append(buf, len);
+    }
+    fclose(fin);
+    return txt;
+}
+
+void writeFile(const std::string& fname, const std::string& txt)
+{
+    FILE* fout = fopen(fname.c_str(), "w");
+    REQUIRE(fout != nullptr);
+    fwrite(txt.c_str(), 1, txt.length(), fout);
+    fclose(fout);
+}
+
+std::string pluginIni(const std::string& name)
+{
+    return "[plugin " + name + "]\n"
+           "type device\n"
+           "name " + name + "\n"
+           "library yarp_" + name + "\n"
+           "part " + name + "\n";
+}
+
+bool hasPlugin(const PluginIndex::Snapshot& snapshot, const std::string& name)
+{
+    for (size_t i = 0; i < snapshot.plugins.size(); i++) {
+        Bottle* group = snapshot.plugins.get(i).asList();
+        if (group != nullptr && group->find("name").asString() == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Add a plugin to the cache file, keeping its key
+void addToCache(const std::string& fname, const std::string& name)
+{
+    Bottle cache(readFile(fname));
+    Bottle* plugins = cache.find("plugins").asList();
+    REQUIRE(plugins != nullptr);
+    plugins->addList().fromString("(name " + name + ") (type device)");
+    writeFile(fname, cache.toString());
+}
+
+} // namespace
+
+TEST_CASE("os::impl::PluginIndexTest", "[yarp::os][yarp::os::impl]")
+{
+    EnvironmentGuard data_dirs("YARP_DATA_DIRS");
+    EnvironmentGuard data_home("YARP_DATA_HOME");
+    EnvironmentGuard cache_enabled("YARP_PLUGIN_INDEX_CACHE");
+
+    // A plugin directory with a single .ini file, and an empty data home
+    // where the cache is written
+    char buf[1000];
+    REQUIRE(yarp::os::getcwd(buf, sizeof(buf)) != nullptr);
+    const std::string base = std::string(buf) + slash + "__test_dir_plugin_index";
+    const std::string plugins_dir = base + slash + "data" + slash + "plugins";
+    const std::string home = base + slash + "home";
+    const std::string ini = plugins_dir + slash + "fakeplugin.ini";
+    const std::string cache_file = home + slash + "cache" + slash + "plugin_index.txt";
+    yarp::os::mkdir_p(plugins_dir.c_str());
+    yarp::os::mkdir_p(home.c_str());
+    std::remove(cache_file.c_str());
+    writeFile(ini, pluginIni("fakeplugin"));
+
+    yarp::conf::environment::setEnvironment("YARP_DATA_DIRS", base + slash + "data");
+    yarp::conf::environment::setEnvironment("YARP_DATA_HOME", home);
+    yarp::conf::environment::unsetEnvironment("YARP_PLUGIN_INDEX_CACHE");
+    PluginIndex::reset();
+
+    auto first = PluginIndex::get(true);
+    REQUIRE(first != nullptr);
+    CHECK(first->plugins.size() == 1);
+    CHECK(hasPlugin(*first, "fakeplugin"));
+
+    SECTION("the index is kept until the files change")
+    {
+        // Nothing changed
+        auto same = PluginIndex::get(true);
+        CHECK(same == first);
+        CHECK(same->generation == first->generation);
+
+        // The modification time changes, but not the size
+        struct utimbuf times;
+        times.actime = 1000000000;
+        times.modtime = 1000000000;
+        REQUIRE(utime(ini.c_str(), &times) == 0);
+
+        // Not checked again unless asked, or 5 seconds have passed
+        CHECK(PluginIndex::get() == first);
+
+        auto touched = PluginIndex::get(true);
+        CHECK(touched != first);
+        CHECK(touched->generation > first->generation);
+        CHECK(hasPlugin(*touched, "fakeplugin"));
+
+        // The size changes, with a new plugin in the same file
+        writeFile(ini, pluginIni("fakeplugin") + pluginIni("fakeplugin2"));
+        times.actime = 1000000000;
+        times.modtime = 1000000000;
+        REQUIRE(utime(ini.c_str(), &times) == 0);
+        auto resized = PluginIndex::get(true);
+        CHECK(resized->generation > touched->generation);
+        CHECK(resized->plugins.size() == 2);
+        CHECK(hasPlugin(*resized, "fakeplugin2"));
+
+        // A new .ini file
+        writeFile(plugins_dir + slash + "otherplugin.ini", pluginIni("otherplugin"));
+        auto added = PluginIndex::get(true);
+        CHECK(added->plugins.size() == 3);
+        CHECK(hasPlugin(*added, "otherplugin"));
+        std::remove((plugins_dir + slash + "otherplugin.ini").c_str());
+    }
+
+    SECTION("a new process reads the cache file")
+    {
+        REQUIRE_FALSE(readFile(cache_file).empty());
+
+        // If the cache is read instead of parsing the .ini files, the
+        // plugin added to it is found
+        addToCache(cache_file, "fromcache");
+        PluginIndex::reset();
+        auto cached = PluginIndex::get();
+        CHECK(cached->plugins.size() == 2);
+        CHECK(hasPlugin(*cached, "fakeplugin"));
+        CHECK(hasPlugin(*cached, "fromcache"));
+    }
+
+    SECTION("a cache file with a stale key is ignored")
+    {
+        addToCache(cache_file, "fromcache");
+
+        writeFile(ini, pluginIni("fakeplugin") + "# a comment that changes the size\n");
+        PluginIndex::reset();
+        auto parsed = PluginIndex::get();
+        CHECK(parsed->plugins.size() == 1);
+        CHECK(hasPlugin(*parsed, "fakeplugin"));
+        CHECK_FALSE(hasPlugin(*parsed, "fromcache"));
+
+        // The cache is written again with the new key
+        Bottle cache(readFile(cache_file));
+        Bottle* plugins = cache.find("plugins").asList();
+        REQUIRE(plugins != nullptr);
+        CHECK(plugins->size() == 1);
+
+        PluginIndex::reset();
+        CHECK(PluginIndex::get()->plugins.size() == 1);
+    }
+
+    SECTION("the cache file can be disabled")
+    {
+        yarp::conf::environment::setEnvironment("YARP_PLUGIN_INDEX_CACHE", "0");
+
+        // The cache file is not read
+        addToCache(cache_file, "fromcache");
+        PluginIndex::reset();
+        auto parsed = PluginIndex::get();
+        CHECK(parsed->plugins.size() == 1);
+        CHECK_FALSE(hasPlugin(*parsed, "fromcache"));
+
+        // ...and it is not written
+        std::remove(cache_file.c_str());
+        writeFile(ini, pluginIni("fakeplugin") + pluginIni("fakeplugin2"));
+        auto changed = PluginIndex::get(true);
+        CHECK(changed->plugins.size() == 2);
+        CHECK(readFile(cache_file).empty());
+    }
+
+    std::remove(cache_file.c_str());
+    std::remove(ini.c_str());
+    PluginIndex::reset();
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/PortCorePackets.h>
+#include <yarp/os/Bottle.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+using namespace yarp::os::impl;
+
+namespace {
+
+class CountingWriter : public Bottle
+{
+public:
+    mutable std::atomic<int> completions{0};
+
+    void onCompletion() const override
+    {
+        completions++;
+    }
+};
+
+} // namespace
+
+TEST_CASE("os::impl::PortCorePacketsTest", "[yarp::os][yarp::os::impl]")
+{
+    SECTION("packets are recycled")
+    {
+        PortCorePackets packets;
+        CHECK(packets.getCount() == 0);
+        PortCorePacket* p1 = packets.getFreePacket();
+        PortCorePacket* p2 = packets.getFreePacket();
+        CHECK(p1 != p2);
+        CHECK(packets.getCount() == 2);
+        CHECK(packets.getCapacity() == PortCorePackets::chunkSize);
+        CHECK(reinterpret_cast<std::uintptr_t>(p1) % PortCorePackets::cacheLineSize == 0);
+        CHECK(reinterpret_cast<std::uintptr_t>(p2) % PortCorePackets::cacheLineSize == 0);
+
+        CountingWriter writer;
+        p1->setContent(&writer);
+        p1->inc();
+        CHECK_FALSE(packets.releasePacket(p1)); // "still used by a connection"
+        CHECK(writer.completions == 0);
+        CHECK(packets.releasePacket(p1)); // "last use released"
+        CHECK(writer.completions == 1);
+        CHECK(packets.getCount() == 1);
+
+        PortCorePacket* p3 = packets.getFreePacket();
+        CHECK(p3 == p1); // "free packet reused"
+        CHECK(p3->getContent() == nullptr);
+        packets.freePacket(p2);
+        packets.freePacket(p3);
+        CHECK(packets.getCount() == 0);
+    }
+
+    SECTION("capacity grows by chunks")
+    {
+        PortCorePackets packets;
+        std::vector<PortCorePacket*> used;
+        for (size_t i = 0; i < PortCorePackets::chunkSize + 1; i++) {
+            used.push_back(packets.getFreePacket());
+        }
+        CHECK(packets.getCapacity() == 2 * PortCorePackets::chunkSize);
+        for (auto* packet : used) {
+            packets.freePacket(packet);
+        }
+        CHECK(packets.getCount() == 0);
+    }
+
+    SECTION("packets beyond the chunks are allocated one by one")
+    {
+        PortCorePackets packets;
+        constexpr size_t limit = PortCorePackets::maxChunks * PortCorePackets::chunkSize;
+        std::vector<PortCorePacket*> used;
+        for (size_t i = 0; i < limit + 10; i++) {
+            used.push_back(packets.getFreePacket());
+        }
+        CHECK(std::find(used.begin(), used.end(), nullptr) == used.end());
+        CHECK(packets.getCapacity() == limit);
+        CHECK(packets.getOverflowCount() == 10);
+        CHECK(packets.getCount() == limit + 10);
+
+        CountingWriter writer;
+        PortCorePacket* last = used.back();
+        last->setContent(&writer);
+        CHECK(packets.releasePacket(last)); // "overflow packet released"
+        CHECK(writer.completions == 1);
+        used.pop_back();
+        CHECK(packets.getOverflowCount() == 9);
+
+        for (auto* packet : used) {
+            packets.freePacket(packet);
+        }
+        CHECK(packets.getCount() == 0);
+        CHECK(packets.getOverflowCount() == 0);
+    }
+
+    SECTION("concurrent use")
+    {
+        constexpr int threads = 4;
+        constexpr int readers = 3;
+        constexpr int messages = 20000;
+
+        PortCorePackets packets;
+        CountingWriter writer;
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&]() {
+                for (int i = 0; i < messages; i++) {
+                    PortCorePacket* packet = packets.getFreePacket();
+                    packet->setContent(&writer);
+                    for (int r = 0; r < readers; r++) {
+                        packet->inc();
+                    }
+                    for (int r = 0; r < readers + 1; r++) {
+                        packets.releasePacket(packet);
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        CHECK(writer.completions == threads * messages); // "each message completed once"
+        CHECK(packets.getCount() == 0);
+        CHECK(packets.getCapacity() <= threads * PortCorePackets::chunkSize);
+    }
+}
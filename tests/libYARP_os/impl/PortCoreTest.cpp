@@ -12,7 +12,13 @@
 #include <yarp/os/Carriers.h>
 #include <yarp/os/PortReader.h>
 #include <yarp/os/impl/BottleImpl.h>
+#include <yarp/os/impl/PortCoreOutputPool.h>
 #include <yarp/os/Network.h>
+#include <yarp/os/Semaphore.h>
+
+#include <yarp/conf/environment.h>
+
+#include <atomic>
 
 #include <catch.hpp>
 #include <harness.h>
@@ -20,6 +26,43 @@
 using namespace yarp::os;
 using namespace yarp::os::impl;
 
+class StalledReader : public PortReader {
+public:
+    Semaphore entered{0};
+    Semaphore resume{0};
+
+    bool read(ConnectionReader& reader) override {
+        if (!reader.isValid()) {
+            return false;
+        }
+        BottleImpl bot;
+        bot.read(reader);
+        // The acknowledgement is sent after this returns, the writer
+        // waits for it.
+        entered.post();
+        resume.wait();
+        return true;
+    }
+};
+
+class LatestReader : public PortReader {
+public:
+    std::atomic<int> count {0};
+    std::atomic<int> last {-1};
+
+    bool read(ConnectionReader& reader) override {
+        if (!reader.isValid()) {
+            return false;
+        }
+        BottleImpl bot;
+        bot.read(reader);
+        last = bot.get(0).asInt32();
+        count++;
+        Time::delay(0.05);
+        return true;
+    }
+};
+
 class PortCoreTest : public PortReader {
 public:
     int safePort() { return Network::getDefaultPortRange()+100; }
@@ -162,6 +205,210 @@ public:
         sender.close();
         receiver.close();
     }
+
+    void testSharedPayload() {
+        expectation = "";
+        receives = 0;
+
+        Contact write = NetworkBase::registerContact(Contact("/write", "tcp", "127.0.0.1", safePort()));
+        Contact read1 = NetworkBase::registerContact(Contact("/read1", "tcp", "127.0.0.1", safePort()+1));
+        Contact read2 = NetworkBase::registerContact(Contact("/read2", "tcp", "127.0.0.1", safePort()+2));
+
+        PortCore sender;
+        sender.setSharedPayload(true);
+        PortCore receiver1;
+        PortCore receiver2;
+        receiver1.setReadHandler(*this);
+        receiver2.setReadHandler(*this);
+        sender.listen(write);
+        receiver1.listen(read1);
+        receiver2.listen(read2);
+        sender.start();
+        receiver1.start();
+        receiver2.start();
+        NetworkBase::connect("/write", "/read1");
+        NetworkBase::connect("/write", "/read2");
+        Time::delay(0.3);
+
+        Bottle bot;
+        bot.addInt32(0);
+        bot.addString("Hello world");
+        expectation = bot.toString();
+        sender.send(bot);
+        for (int i=0; i<1000; i++) {
+            if (receives==2) break;
+            Time::delay(0.3);
+        }
+        CHECK(receives == 2); // "message received on both connections"
+
+        size_t serializations = 0;
+        size_t reuses = 0;
+        size_t savedBytes = 0;
+        sender.getSharedPayloadStats(serializations, reuses, savedBytes);
+        CHECK(serializations == 1); // "message serialized once"
+        CHECK(reuses == 1); // "serialization reused by the second connection"
+        CHECK(savedBytes > 0);
+
+        sender.close();
+        receiver1.close();
+        receiver2.close();
+    }
+
+    void testOutputPool() {
+        expectation = "";
+        receives = 0;
+
+        Contact write = NetworkBase::registerContact(Contact("/write", "tcp", "127.0.0.1", safePort()));
+        Contact read1 = NetworkBase::registerContact(Contact("/read1", "tcp", "127.0.0.1", safePort()+1));
+        Contact read2 = NetworkBase::registerContact(Contact("/read2", "tcp", "127.0.0.1", safePort()+2));
+
+        PortCore sender;
+        sender.setWaitBeforeSend(false);
+        sender.setWaitAfterSend(false);
+        sender.setOutputPool(true);
+        PortCore receiver1;
+        PortCore receiver2;
+        receiver1.setReadHandler(*this);
+        receiver2.setReadHandler(*this);
+        sender.listen(write);
+        receiver1.listen(read1);
+        receiver2.listen(read2);
+        sender.start();
+        receiver1.start();
+        receiver2.start();
+        NetworkBase::connect("/write", "/read1");
+        NetworkBase::connect("/write", "/read2");
+        Time::delay(0.3);
+
+        Bottle bot;
+        bot.addInt32(0);
+        bot.addString("Hello world");
+        expectation = bot.toString();
+        sender.send(bot);
+        for (int i=0; i<1000; i++) {
+            if (receives==2) break;
+            Time::delay(0.3);
+        }
+        CHECK(receives == 2); // "message received on both connections"
+        CHECK(PortCoreOutputPool::getInstance().getWorkerCount() > 0); // "pool started"
+
+        sender.close();
+        receiver1.close();
+        receiver2.close();
+        CHECK(PortCoreOutputPool::getInstance().getWorkerCount() == 0); // "pool stopped with the last connection"
+    }
+
+    void testOutputPoolQos() {
+        Contact write = NetworkBase::registerContact(Contact("/write", "tcp", "127.0.0.1", safePort()));
+        Contact read = NetworkBase::registerContact(Contact("/read", "tcp", "127.0.0.1", safePort()+1));
+
+        LatestReader latest;
+        PortCore sender;
+        sender.setWaitBeforeSend(false);
+        sender.setWaitAfterSend(false);
+        sender.setOutputPool(true);
+        PortCore receiver;
+        receiver.setReadHandler(latest);
+        sender.listen(write);
+        receiver.listen(read);
+        sender.start();
+        receiver.start();
+        NetworkBase::connect("/write", "/read", "tcp+qos.latest+rate.20");
+        Time::delay(0.3);
+
+        // Writing in background, the messages must live until they are
+        // sent
+        Bottle bots[20];
+        double start = Time::now();
+        for (int i=0; i<20; i++) {
+            bots[i].addInt32(i);
+            sender.send(bots[i]);
+            Time::delay(0.01);
+        }
+        CHECK(Time::now() - start < 1.0); // "the writer did not wait for the reader"
+        for (int i=0; i<100 && latest.last != 19; i++) {
+            Time::delay(0.02);
+        }
+        CHECK(latest.last == 19); // "the latest message is sent when the rate allows it"
+        CHECK(latest.count < 10);
+        CHECK(PortCoreOutputPool::getInstance().getWorkerCount() > 0); // "sent by the pool"
+
+        sender.close();
+        receiver.close();
+    }
+
+    void testOutputPoolStalled() {
+        expectation = "";
+        receives = 0;
+
+        // A single worker, that the stalled reader keeps busy
+        std::string poolSize = yarp::conf::environment::getEnvironment("YARP_OUTPUT_POOL_SIZE");
+        yarp::conf::environment::setEnvironment("YARP_OUTPUT_POOL_SIZE", "1");
+
+        Contact write = NetworkBase::registerContact(Contact("/write", "tcp", "127.0.0.1", safePort()));
+        Contact read1 = NetworkBase::registerContact(Contact("/read1", "tcp", "127.0.0.1", safePort()+1));
+        Contact read2 = NetworkBase::registerContact(Contact("/read2", "tcp", "127.0.0.1", safePort()+2));
+
+        StalledReader stalled;
+        PortCore sender;
+        sender.setWaitBeforeSend(false);
+        sender.setWaitAfterSend(false);
+        sender.setOutputPool(true);
+        PortCore receiver1;
+        PortCore receiver2;
+        receiver1.setReadHandler(stalled);
+        receiver2.setReadHandler(*this);
+        sender.listen(write);
+        receiver1.listen(read1);
+        receiver2.listen(read2);
+        sender.start();
+        receiver1.start();
+        receiver2.start();
+        NetworkBase::connect("/write", "/read1");
+        NetworkBase::connect("/write", "/read2");
+        Time::delay(0.3);
+
+        Bottle bot;
+        bot.addInt32(0);
+        bot.addString("Hello world");
+        expectation = bot.toString();
+        sender.send(bot);
+        CHECK(stalled.entered.waitWithTimeout(5.0)); // "stalled reader got the message"
+
+        // The stalled connection is skipped, the healthy one must not wait
+        // for it.
+        for (int i=0; i<3; i++) {
+            for (int j=0; j<100; j++) {
+                if (receives==i+1) break;
+                Time::delay(0.05);
+            }
+            CHECK(receives == i+1); // "healthy reader not blocked"
+            sender.send(bot);
+        }
+        for (int j=0; j<100; j++) {
+            if (receives==4) break;
+            Time::delay(0.05);
+        }
+        CHECK(receives == 4); // "all messages received by the healthy reader"
+        CHECK(PortCoreOutputPool::getInstance().getStalledCount() == 1); // "one worker stalled"
+        CHECK(PortCoreOutputPool::getInstance().getWorkerCount() == 2); // "stalled worker replaced"
+
+        stalled.resume.post();
+        for (int j=0; j<100; j++) {
+            if (PortCoreOutputPool::getInstance().getWorkerCount() == 1) break;
+            Time::delay(0.05);
+        }
+        CHECK(PortCoreOutputPool::getInstance().getWorkerCount() == 1); // "extra worker exited"
+
+        sender.close();
+        receiver1.close();
+        receiver2.close();
+        if (poolSize.empty()) {
+            yarp::conf::environment::unsetEnvironment("YARP_OUTPUT_POOL_SIZE");
+        } else {
+            yarp::conf::environment::setEnvironment("YARP_OUTPUT_POOL_SIZE", poolSize);
+        }
+    }
 };
 
 TEST_CASE("os::impl::PortCoreTest", "[yarp::os][yarp::os::impl]")
@@ -184,5 +431,25 @@ TEST_CASE("os::impl::PortCoreTest", "[yarp::os][yarp::os::impl]")
         thePortCoreTest.testBackground();
     }
 
+    SECTION("shared payload transmission check")
+    {
+        thePortCoreTest.testSharedPayload();
+    }
+
+    SECTION("output pool transmission check")
+    {
+        thePortCoreTest.testOutputPool();
+    }
+
+    SECTION("output pool with an output policy")
+    {
+        thePortCoreTest.testOutputPoolQos();
+    }
+
+    SECTION("output pool with a stalled reader")
+    {
+        thePortCoreTest.testOutputPoolStalled();
+    }
+
     Network::setLocalMode(false);
 }
@@ -16,6 +16,12 @@
 #include <catch.hpp>
 #include <harness.h>
 
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 TEST_CASE("robotinterface::experimental::ParamTest", "[yarp::robotinterface]")
 {
     SECTION("Check yarp::robotinterface::experimental::Param")
@@ -48,6 +54,28 @@ struct GlobalState
     bool mockWrapperWasClosed;
     bool mockDriverWasClosed;
 
+    // The open() calls, in order, and how long the driver takes to open
+    std::mutex mutex;
+    std::vector<std::string> events;
+    std::chrono::milliseconds mockDriverOpenDelay;
+
+    void event(const std::string& e)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        events.push_back(e);
+    }
+
+    size_t eventIndex(const std::string& e)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < events.size(); i++) {
+            if (events[i] == e) {
+                return i;
+            }
+        }
+        return events.size();
+    }
+
     void reset()
     {
         mockDriverWasOpened = false;
@@ -56,6 +84,8 @@ struct GlobalState
         mockDetachWasCalled = false;
         mockWrapperWasClosed = false;
         mockDriverWasClosed = false;
+        events.clear();
+        mockDriverOpenDelay = std::chrono::milliseconds(0);
     }
 };
 
@@ -78,7 +108,10 @@ yarp::dev::RobotInterfaceTestMockDriver::~RobotInterfaceTestMockDriver()
 
 bool yarp::dev::RobotInterfaceTestMockDriver::open(yarp::os::Searchable& config)
 {
+    globalState.event("driver open started");
+    std::this_thread::sleep_for(globalState.mockDriverOpenDelay);
     globalState.mockDriverWasOpened = true;
+    globalState.event("driver open finished");
     return true;
 }
 
@@ -110,6 +143,7 @@ yarp::dev::RobotInterfaceTestMockWrapper::~RobotInterfaceTestMockWrapper()
 
 bool yarp::dev::RobotInterfaceTestMockWrapper::open(yarp::os::Searchable&)
 {
+    globalState.event("wrapper open started");
     globalState.mockWrapperWasOpened = true;
     return true;
 }
@@ -238,6 +272,92 @@ TEST_CASE("robotinterface::experimental::XMLReaderTest", "[yarp::robotinterface]
         CHECK(globalState.mockDriverWasClosed);
     }
 
+    SECTION("Check valid robot file with two devices opened in parallel")
+    {
+        // Reset test flags, and make the driver slow to open, so that the
+        // wrapper would be opened before it is ready if the dependency
+        // was not respected
+        globalState.reset();
+        globalState.mockDriverOpenDelay = std::chrono::milliseconds(200);
+
+        // Add dummy devices to YARP drivers factory
+        yarp::dev::Drivers::factory().add(new yarp::dev::DriverCreatorOf<yarp::dev::RobotInterfaceTestMockDriver>("robotinterface_test_mock_device", "", "RobotInterfaceTestMockDriver"));
+        yarp::dev::Drivers::factory().add(new yarp::dev::DriverCreatorOf<yarp::dev::RobotInterfaceTestMockWrapper>("robotinterface_test_mock_wrapper", "", "RobotInterfaceTestMockWrapper"));
+
+        // Load XML configuration file with a wrapper attached to a device
+        std::string XMLString = "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"
+                                "<!DOCTYPE robot PUBLIC \"-//YARP//DTD yarprobotinterface 3.0//EN\" \"http://www.yarp.it/DTD/yarprobotinterfaceV3.0.dtd\">\n"
+                                "<robot name=\"RobotWithTwoDevices\" prefix=\"RobotWithTwoDevices\">\n"
+                                "  <devices>\n"
+                                "    <device name=\"dummy_device\" type=\"robotinterface_test_mock_device\">\n"
+                                "    </device>\n"
+                                "    <device name=\"dummy_wrapper\" type=\"robotinterface_test_mock_wrapper\">\n"
+                                "      <action phase=\"startup\" level=\"5\" type=\"attach\">\n"
+                                "        <paramlist name=\"networks\">\n"
+                                "          <elem name=\"attached_device\">  dummy_device </elem>\n"
+                                "        </paramlist>\n"
+                                "      </action>\n"
+                                "      <action phase=\"shutdown\" level=\"5\" type=\"detach\" />\n"
+                                "    </device>\n"
+                                "  </devices>\n"
+                                "</robot>\n";
+
+        yarp::robotinterface::experimental::XMLReader reader;
+        yarp::robotinterface::experimental::XMLReaderResult result = reader.getRobotFromString(XMLString);
+
+        // Check parsing succeeds
+        CHECK(result.parsingIsSuccessful);
+
+        // Verify that both devices have been loaded
+        CHECK(result.robot.devices().size() == 2);
+
+        // Verify that the devices were not opened and the attach was not called
+        CHECK(!globalState.mockDriverWasOpened);
+        CHECK(!globalState.mockWrapperWasOpened);
+        CHECK(!globalState.mockAttachWasCalled);
+        CHECK(!globalState.mockDetachWasCalled);
+        CHECK(!globalState.mockWrapperWasClosed);
+        CHECK(!globalState.mockDriverWasClosed);
+
+        // Open the devices on several threads
+        result.robot.setParallelOpen(4);
+
+        // Start the robot (open the devices and call "attach" actions)
+        bool ok = result.robot.enterPhase(yarp::robotinterface::experimental::ActionPhaseStartup);
+        CHECK(ok);
+
+        // Check that the wrapper was opened only after the device it
+        // attaches to finished opening
+        size_t driverOpened = globalState.eventIndex("driver open finished");
+        size_t wrapperStarted = globalState.eventIndex("wrapper open started");
+        CHECK(globalState.events.size() == 3);
+        CHECK(globalState.eventIndex("driver open started") < driverOpened);
+        CHECK(driverOpened < wrapperStarted);
+        CHECK(wrapperStarted < globalState.events.size());
+
+        // Check that the devices were opened and attach called
+        CHECK(globalState.mockDriverWasOpened);
+        CHECK(globalState.mockWrapperWasOpened);
+        CHECK(globalState.mockAttachWasCalled);
+        CHECK(!globalState.mockDetachWasCalled);
+        CHECK(!globalState.mockWrapperWasClosed);
+        CHECK(!globalState.mockDriverWasClosed);
+
+        // Stop the robot
+        ok = result.robot.enterPhase(yarp::robotinterface::experimental::ActionPhaseInterrupt1);
+        CHECK(ok);
+        ok = result.robot.enterPhase(yarp::robotinterface::experimental::ActionPhaseShutdown);
+        CHECK(ok);
+
+        // Check that the devices were closed and detach called
+        CHECK(globalState.mockDriverWasOpened);
+        CHECK(globalState.mockWrapperWasOpened);
+        CHECK(globalState.mockAttachWasCalled);
+        CHECK(globalState.mockDetachWasCalled);
+        CHECK(globalState.mockWrapperWasClosed);
+        CHECK(globalState.mockDriverWasClosed);
+    }
+
     SECTION("Check valid robot file with one device attaching to an external device")
     {
         // Reset test flags
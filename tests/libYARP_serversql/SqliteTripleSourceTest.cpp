@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/serversql/impl/TripleSource.h>
+#include <yarp/serversql/impl/TripleSourceCreator.h>
+
+#include <catch.hpp>
+#include <harness.h>
+
+#include <list>
+#include <string>
+
+using namespace yarp::serversql::impl;
+
+namespace {
+
+std::string valueOf(TripleSource& db, const char* name, TripleContext* context)
+{
+    Triple t;
+    t.setNameValue(name, "*");
+    std::list<Triple> lst = db.query(t, context);
+    return lst.empty() ? std::string() : lst.front().value;
+}
+
+} // namespace
+
+TEST_CASE("serversql::SqliteTripleSourceTest", "[yarp::serversql]")
+{
+    TripleSourceCreator creator;
+    TripleSource* db = creator.open(":memory:");
+    REQUIRE(db != nullptr);
+
+    Triple port;
+    port.setNameValue("port", "/check/a");
+
+    SECTION("lookups see every write")
+    {
+        CHECK(db->find(port, nullptr) == -1);
+        db->insert(port, nullptr);
+        int id = db->find(port, nullptr);
+        CHECK(id != -1);
+        CHECK(db->find(port, nullptr) == id);
+
+        TripleContext context;
+        context.setRid(id);
+        Triple t;
+        t.setNameValue("host", "first");
+        db->update(t, &context);
+        CHECK(valueOf(*db, "host", &context) == "first");
+        t.setNameValue("host", "second");
+        db->update(t, &context);
+        CHECK(valueOf(*db, "host", &context) == "second");
+        CHECK(valueOf(*db, "host", nullptr).empty());
+
+        db->remove_query(port, nullptr);
+        CHECK(db->find(port, nullptr) == -1);
+        db->insert(port, nullptr);
+        int id2 = db->find(port, nullptr);
+        CHECK(id2 != -1);
+        CHECK(id2 != id);
+    }
+
+    SECTION("wildcard lookups see every write")
+    {
+        Triple all;
+        all.setNameValue("port", "*");
+        CHECK(db->query(all, nullptr).empty());
+        db->insert(port, nullptr);
+        CHECK(db->query(all, nullptr).size() == 1);
+        Triple other;
+        other.setNameValue("port", "/check/b");
+        db->insert(other, nullptr);
+        CHECK(db->query(all, nullptr).size() == 2);
+        db->remove_query(port, nullptr);
+        std::list<Triple> lst = db->query(all, nullptr);
+        REQUIRE(lst.size() == 1);
+        CHECK(lst.front().value == "/check/b");
+    }
+
+    SECTION("removing all the triples of a context")
+    {
+        db->insert(port, nullptr);
+        TripleContext context;
+        context.setRid(db->find(port, nullptr));
+        Triple t;
+        t.setNameValue("host", "localhost");
+        db->update(t, &context);
+        t.setNameValue("socket", "10000");
+        db->update(t, &context);
+        CHECK(valueOf(*db, "socket", &context) == "10000");
+
+        t.setNsNameValue("*", "*", "*");
+        db->remove_query(t, &context);
+        CHECK(valueOf(*db, "host", &context).empty());
+        CHECK(valueOf(*db, "socket", &context).empty());
+    }
+
+    creator.close();
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/serversql/impl/SubscriberOnSql.h>
+
+#include <yarp/os/Bottle.h>
+
+#include <catch.hpp>
+#include <harness.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using yarp::os::Bottle;
+using yarp::serversql::impl::SubscriberOnSql;
+
+TEST_CASE("serversql::SubscriberOnSqlTest", "[yarp::serversql]")
+{
+    SubscriberOnSql sub;
+    REQUIRE(sub.open(":memory:"));
+
+    SECTION("topics and types")
+    {
+        CHECK(sub.setTopic("/topic", "", true));
+        Bottle topics;
+        CHECK(sub.listTopics(topics));
+        CHECK(topics.get(0).asString() == "/topic");
+        CHECK(sub.setTopic("/topic", "", false));
+        topics.clear();
+        CHECK(sub.listTopics(topics));
+        CHECK(topics.size() == 0);
+
+        CHECK(sub.setType("yarp", "std_msgs/String", "string data"));
+        CHECK(sub.setType("yarp", "std_msgs/Int32", "int32 data"));
+        CHECK(sub.getType("yarp", "std_msgs/String") == "string data");
+        CHECK(sub.getType("yarp", "std_msgs/Int32") == "int32 data");
+        CHECK(sub.getType("yarp", "std_msgs/Bool").empty());
+    }
+
+    SECTION("concurrent subscriptions")
+    {
+        constexpr int threads = 4;
+        constexpr int count = 50;
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&sub, t]() {
+                for (int i = 0; i < count; i++) {
+                    std::string src = "/src" + std::to_string(t);
+                    std::string dest = "/dest" + std::to_string(i);
+                    sub.addSubscription(src, dest, "");
+                    if (i % 2 == 1) {
+                        sub.removeSubscription(src, dest);
+                    }
+                    Bottle reply;
+                    sub.listSubscriptions(src, reply);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        Bottle reply;
+        CHECK(sub.listSubscriptions("", reply));
+        CHECK(reply.size() == 1 + threads * count / 2);
+        reply.clear();
+        CHECK(sub.listSubscriptions("/src0", reply));
+        CHECK(reply.size() == 1 + count / 2);
+    }
+
+    sub.close();
+}
@@ -7,26 +7,35 @@
  * BSD-3-Clause license. See the accompanying LICENSE file for details.
  */
 
+#include <yarp/os/DummyConnector.h>
 #include <yarp/os/NetType.h>
 #include <yarp/os/impl/BufferedConnectionWriter.h>
 #include <yarp/sig/Image.h>
 #include <yarp/sig/ImageDraw.h>
 #include <yarp/sig/ImageUtils.h>
+#include <yarp/sig/impl/Demosaic.h>
 #include <yarp/os/Network.h>
 #include <yarp/os/PortReaderBuffer.h>
 #include <yarp/os/Port.h>
 #include <yarp/os/Bottle.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/Log.h>
+#include <yarp/os/MemoryLoan.h>
 #include <yarp/os/PeriodicThread.h>
 
 #include <catch.hpp>
 #include <harness.h>
 
+#include <cstdint>
+#include <cstring>
+#include <string>
+
 using namespace yarp::os::impl;
 using namespace yarp::sig;
 using namespace yarp::sig::draw;
 using namespace yarp::os;
+using yarp::sig::impl::BayerPattern;
+using yarp::sig::impl::DemosaicMethod;
 
 class readWriteTest : public yarp::os::PeriodicThread
 {
@@ -67,6 +76,126 @@ void passImage(ImageOf<PixelRgb> img)
     yInfo("passed a blank image ok");
 }
 
+// Channels of the 8 bit pixels, as expected by the conversions in copyPixels
+struct Channels
+{
+    int r;
+    int g;
+    int b;
+    int a;
+};
+
+Channels channels(const PixelMono& p) { return {p, p, p, 255}; }
+Channels channels(const PixelRgb& p) { return {p.r, p.g, p.b, 255}; }
+Channels channels(const PixelBgr& p) { return {p.r, p.g, p.b, 255}; }
+Channels channels(const PixelRgba& p) { return {p.r, p.g, p.b, p.a}; }
+Channels channels(const PixelBgra& p) { return {p.r, p.g, p.b, p.a}; }
+
+bool converted(const PixelMono& p, const Channels& c) { return p == (c.r + c.g + c.b) / 3; }
+bool converted(const PixelRgb& p, const Channels& c) { return p.r == c.r && p.g == c.g && p.b == c.b; }
+bool converted(const PixelBgr& p, const Channels& c) { return p.r == c.r && p.g == c.g && p.b == c.b; }
+bool converted(const PixelRgba& p, const Channels& c) { return p.r == c.r && p.g == c.g && p.b == c.b && p.a == c.a; }
+bool converted(const PixelBgra& p, const Channels& c) { return p.r == c.r && p.g == c.g && p.b == c.b && p.a == c.a; }
+
+// Converts images of several widths (to exercise both the vectorized part of
+// the rows and the pixels left at the end), to images with padding and with
+// the other orientation.
+template <class T1, class T2>
+bool checkConversion()
+{
+    for (size_t w : {1, 3, 5, 6, 8, 11, 16, 17, 31, 33, 47, 64, 67}) {
+        for (int flip = 0; flip < 2; flip++) {
+            ImageOf<T1> src;
+            src.setQuantum(1);
+            src.resize(w, 3);
+            auto* raw = src.getRawImage();
+            for (size_t i = 0; i < src.getRawImageSize(); i++) {
+                raw[i] = static_cast<unsigned char>(i * 37 + (i >> 8) * 101);
+            }
+
+            ImageOf<T2> dest;
+            dest.setQuantum(8);
+            dest.setTopIsLowIndex(flip == 0);
+            dest.copy(src);
+
+            for (size_t y = 0; y < src.height(); y++) {
+                for (size_t x = 0; x < w; x++) {
+                    if (!converted(dest.pixel(x, y), channels(src.pixel(x, y)))) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// A linear color field, that the bilinear and the edge aware demosaicing
+// reconstruct exactly far from the borders.
+Channels field(size_t x, size_t y)
+{
+    return {static_cast<int>(2 * x + 2 * y + 10),
+            static_cast<int>(2 * x + y + 20),
+            static_cast<int>(x + 2 * y + 5),
+            255};
+}
+
+// Samples the field with the filters of the Bayer encoding (8 or 16 bit).
+FlexImage mosaic(int code, size_t w, size_t h)
+{
+    BayerPattern pattern;
+    bayerPattern(code, pattern);
+    // row and column of the red filter in the first 2x2 block
+    const size_t redRow = (pattern == BayerPattern::GRBG || pattern == BayerPattern::RGGB) ? 0 : 1;
+    const size_t redCol = (pattern == BayerPattern::GRBG || pattern == BayerPattern::BGGR) ? 1 : 0;
+    const bool wide = (code == VOCAB_PIXEL_ENCODING_BAYER_GRBG16 || code == VOCAB_PIXEL_ENCODING_BAYER_BGGR16 ||
+                       code == VOCAB_PIXEL_ENCODING_BAYER_GBRG16 || code == VOCAB_PIXEL_ENCODING_BAYER_RGGB16);
+
+    FlexImage img;
+    img.setPixelCode(code);
+    img.resize(w, h);
+    for (size_t y = 0; y < h; y++) {
+        for (size_t x = 0; x < w; x++) {
+            Channels c = field(x, y);
+            int v = c.g;
+            if ((y & 1) == redRow && (x & 1) == redCol) {
+                v = c.r;
+            } else if ((y & 1) != redRow && (x & 1) != redCol) {
+                v = c.b;
+            }
+            if (wide) {
+                reinterpret_cast<unsigned short*>(img.getPixelAddress(x, y))[0] = static_cast<unsigned short>((v << 8) | 0x5a);
+            } else {
+                img.getPixelAddress(x, y)[0] = static_cast<unsigned char>(v);
+            }
+        }
+    }
+    return img;
+}
+
+// Sends a Bayer image to a connection, and checks the color image received.
+template <class T>
+bool checkDebayer(int code)
+{
+    const size_t w = 37;
+    const size_t h = 22;
+    FlexImage src = mosaic(code, w, h);
+    DummyConnector con;
+    src.write(con.getWriter());
+    ImageOf<T> dest;
+    if (!dest.read(con.getReader()) || dest.width() != w || dest.height() != h) {
+        return false;
+    }
+    for (size_t y = 1; y + 1 < h; y++) {
+        for (size_t x = 1; x + 1 < w; x++) {
+            if (!converted(dest.pixel(x, y), field(x, y))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 TEST_CASE("sig::ImageTest", "[yarp::sig]")
 {
     NetworkBase::setLocalMode(true);
@@ -235,6 +364,52 @@ TEST_CASE("sig::ImageTest", "[yarp::sig]")
     }
 
 
+    SECTION("test loaned image.")
+    {
+        ImageOf<PixelRgb> img1;
+        img1.setLoaned(true);
+        CHECK(img1.isLoaned());
+        img1.resize(64, 48);
+        unsigned char* raw = img1.getRawImage();
+        REQUIRE(raw != nullptr);
+        CHECK(reinterpret_cast<std::uintptr_t>(raw) % MemoryLoan::alignment == 0);
+#if !defined(_WIN32)
+        std::string name;
+        size_t offset = 1;
+        CHECK(MemoryLoan::find(reinterpret_cast<char*>(raw), img1.getRawImageSize(), name, offset));
+        CHECK(offset == 0);
+#endif
+
+        // The memory is kept while the size does not change
+        img1.resize(64, 48);
+        CHECK(img1.getRawImage() == raw);
+
+        for (size_t x = 0; x < img1.width(); x++) {
+            for (size_t y = 0; y < img1.height(); y++) {
+                img1.pixel(x, y) = PixelRgb(x, y, 7);
+            }
+        }
+        ImageOf<PixelRgb> img2(img1);
+        CHECK_FALSE(img2.isLoaned());
+        CHECK(img2.pixel(10, 20).r == 10);
+        CHECK(img2.pixel(10, 20).g == 20);
+
+        DummyConnector con;
+        img1.write(con.getWriter());
+        ImageOf<PixelRgb> img3;
+        REQUIRE(img3.read(con.getReader()));
+        CHECK(img3.width() == img1.width());
+        CHECK(img3.pixel(63, 47).r == 63);
+        CHECK(img3.pixel(63, 47).b == 7);
+
+        img1.setLoaned(false);
+        CHECK_FALSE(img1.isLoaned());
+        CHECK(img1.width() == 64);
+        CHECK(img1.height() == 48);
+        std::string other;
+        CHECK_FALSE(MemoryLoan::find(reinterpret_cast<char*>(img1.getRawImage()), 1, other, offset));
+    }
+
     SECTION("test image transmission.")
     {
         ImageOf<PixelRgb> img1;
@@ -501,6 +676,72 @@ TEST_CASE("sig::ImageTest", "[yarp::sig]")
         CHECK(img2(4,2).r == 10); // r level copied
     }
 
+    SECTION("check vectorized conversions.")
+    {
+        CHECK((checkConversion<PixelRgb, PixelBgr>()));
+        CHECK((checkConversion<PixelBgr, PixelRgb>()));
+        CHECK((checkConversion<PixelRgba, PixelBgra>()));
+        CHECK((checkConversion<PixelBgra, PixelRgba>()));
+        CHECK((checkConversion<PixelRgb, PixelRgba>()));
+        CHECK((checkConversion<PixelRgb, PixelBgra>()));
+        CHECK((checkConversion<PixelBgr, PixelRgba>()));
+        CHECK((checkConversion<PixelBgr, PixelBgra>()));
+        CHECK((checkConversion<PixelRgba, PixelRgb>()));
+        CHECK((checkConversion<PixelRgba, PixelBgr>()));
+        CHECK((checkConversion<PixelBgra, PixelRgb>()));
+        CHECK((checkConversion<PixelBgra, PixelBgr>()));
+        CHECK((checkConversion<PixelRgb, PixelMono>()));
+        CHECK((checkConversion<PixelBgr, PixelMono>()));
+        CHECK((checkConversion<PixelRgba, PixelMono>()));
+        CHECK((checkConversion<PixelBgra, PixelMono>()));
+        CHECK((checkConversion<PixelMono, PixelRgb>()));
+        CHECK((checkConversion<PixelMono, PixelBgr>()));
+        CHECK((checkConversion<PixelMono, PixelRgba>()));
+        CHECK((checkConversion<PixelMono, PixelBgra>()));
+        CHECK((checkConversion<PixelRgb, PixelRgb>()));
+    }
+
+    SECTION("check debayering.")
+    {
+        CHECK(checkDebayer<PixelRgb>(VOCAB_PIXEL_ENCODING_BAYER_GRBG8));
+        CHECK(checkDebayer<PixelRgb>(VOCAB_PIXEL_ENCODING_BAYER_BGGR8));
+        CHECK(checkDebayer<PixelBgr>(VOCAB_PIXEL_ENCODING_BAYER_GBRG8));
+        CHECK(checkDebayer<PixelBgra>(VOCAB_PIXEL_ENCODING_BAYER_RGGB8));
+        CHECK(checkDebayer<PixelRgb>(VOCAB_PIXEL_ENCODING_BAYER_GRBG16));
+        CHECK(checkDebayer<PixelRgba>(VOCAB_PIXEL_ENCODING_BAYER_BGGR16));
+        CHECK(checkDebayer<PixelBgr>(VOCAB_PIXEL_ENCODING_BAYER_GBRG16));
+        CHECK(checkDebayer<PixelRgb>(VOCAB_PIXEL_ENCODING_BAYER_RGGB16));
+
+        // the bands converted by the other threads are the same as the ones
+        // converted by the caller
+        FlexImage src = mosaic(VOCAB_PIXEL_ENCODING_BAYER_GRBG8, 101, 150);
+        src.setPixelCode(VOCAB_PIXEL_MONO);
+        for (auto method : {DemosaicMethod::Bilinear, DemosaicMethod::EdgeAware}) {
+            ImageOf<PixelRgb> serial;
+            ImageOf<PixelRgb> parallel;
+            CHECK(demosaic(src, BayerPattern::GRBG, serial, method, 1));
+            CHECK(demosaic(src, BayerPattern::GRBG, parallel, method, 0));
+            REQUIRE(serial.height() == parallel.height());
+            bool same = true;
+            for (size_t y = 0; y < serial.height(); y++) {
+                same = same && memcmp(serial.getRow(y), parallel.getRow(y), serial.width() * sizeof(PixelRgb)) == 0;
+            }
+            CHECK(same);
+        }
+
+        ImageOf<PixelRgb> half;
+        CHECK(demosaicHalf(src, BayerPattern::GRBG, half));
+        CHECK(half.width() == 50);
+        CHECK(half.height() == 75);
+        // red, average of the greens and blue of the top left block
+        CHECK(half.pixel(0, 0).r == field(1, 0).r);
+        CHECK(half.pixel(0, 0).g == (field(0, 0).g + field(1, 1).g + 1) / 2);
+        CHECK(half.pixel(0, 0).b == field(0, 1).b);
+
+        ImageOf<PixelMono> mono;
+        CHECK_FALSE(demosaic(src, BayerPattern::GRBG, mono));
+    }
+
     SECTION("check origin.")
     {
 
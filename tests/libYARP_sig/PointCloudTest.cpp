@@ -11,6 +11,7 @@
 
 #include <yarp/os/Bottle.h>
 #include <yarp/os/BufferedPort.h>
+#include <yarp/os/DummyConnector.h>
 #include <yarp/os/NetType.h>
 #include <yarp/os/Network.h>
 #include <yarp/os/Port.h>
@@ -190,6 +191,115 @@ TEST_CASE("sig::PointCloudTest", "[yarp::sig]")
 
     }
 
+    SECTION("check read/write mismatch 3.")
+    {
+        INFO("Testing the conversion of a cloud larger than the blocks read, with padding in both the types");
+        PointCloud<DataXYZRGBA> testPC;
+        int width  = 200;
+        int height = 64;
+        testPC.resize(width, height);
+
+        for (int i=0; i<width*height; i++)
+        {
+            testPC(i).x = static_cast<float>(i);
+            testPC(i).y = static_cast<float>(i + 1);
+            testPC(i).z = static_cast<float>(i + 2);
+            testPC(i).r = '1';
+            testPC(i).g = '2';
+            testPC(i).b = '3';
+            testPC(i).a = '4';
+        }
+
+        DummyConnector con;
+        CHECK(testPC.write(con.getWriter()));
+        PointCloud<DataXYZNormal> inCloud;
+        CHECK(inCloud.read(con.getReader()));
+
+        CHECK(inCloud.width() == testPC.width()); // Checking width
+        CHECK(inCloud.height() == testPC.height()); // Checking height
+
+        bool ok = true;
+        for (int i=0; i<width*height; i++)
+        {
+            ok &= inCloud(i).x == i;
+            ok &= inCloud(i).y == i + 1;
+            ok &= inCloud(i).z == i + 2;
+            ok &= inCloud(i).normal_x == 0;
+            ok &= inCloud(i).normal_y == 0;
+            ok &= inCloud(i).normal_z == 0;
+            ok &= inCloud(i).curvature == 0;
+        }
+
+        CHECK(ok); // Checking data validity
+
+        PointCloud<DataXYZNormalRGBA> inCloud2;
+        inCloud2.copy(testPC);
+        ok = true;
+        for (int i=0; i<width*height; i++)
+        {
+            ok &= inCloud2(i).x == i;
+            ok &= inCloud2(i).z == i + 2;
+            ok &= inCloud2(i).r == '1';
+            ok &= inCloud2(i).a == '4';
+        }
+        CHECK(ok); // Checking copy between types
+    }
+
+    SECTION("check structure of arrays.")
+    {
+        PointCloud<DataXYZRGBA> testPC;
+        int width  = 13;
+        int height = 7;
+        testPC.resize(width, height);
+        for (int i=0; i<width*height; i++)
+        {
+            testPC(i).x = static_cast<float>(i);
+            testPC(i).y = static_cast<float>(i * 2);
+            testPC(i).z = static_cast<float>(i * 3);
+            testPC(i).rgba = i * 7;
+        }
+
+        utils::PointCloudSoA soa;
+        utils::toSoA(testPC, soa);
+        CHECK(soa.width == testPC.width());
+        CHECK(soa.height == testPC.height());
+        REQUIRE(soa.x.size() == testPC.size());
+        REQUIRE(soa.rgba.size() == testPC.size());
+        bool ok = true;
+        for (int i=0; i<width*height; i++)
+        {
+            ok &= soa.x[i] == i;
+            ok &= soa.y[i] == i * 2;
+            ok &= soa.z[i] == i * 3;
+            ok &= soa.rgba[i] == i * 7;
+        }
+        CHECK(ok); // Checking the arrays
+
+        for (auto& z : soa.z) {
+            z += 1;
+        }
+        PointCloud<DataXYZRGBA> outPC;
+        CHECK(utils::fromSoA(soa, outPC));
+        CHECK(outPC.width() == testPC.width());
+        CHECK(outPC.height() == testPC.height());
+        ok = true;
+        for (int i=0; i<width*height; i++)
+        {
+            ok &= outPC(i).x == i;
+            ok &= outPC(i).z == i * 3 + 1;
+            ok &= outPC(i).rgba == i * 7;
+        }
+        CHECK(ok); // Checking the cloud
+
+        PointCloud<DataXYZ> xyzPC;
+        utils::toSoA(xyzPC, soa);
+        CHECK(soa.x.empty());
+        CHECK(soa.rgba.empty()); // no colors
+
+        soa.x.resize(3);
+        CHECK_FALSE(utils::fromSoA(soa, xyzPC)); // inconsistent sizes
+    }
+
     SECTION("check copy and assignment.")
     {
         INFO("Testing the copy constructor with PC of the same type");